@@ -20,6 +20,7 @@ BufferPoolManager::~BufferPoolManager() {
 }
 
 Page *BufferPoolManager::FetchPage(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   // 1.     Search the page table for the requested page (P).
   // 1.1    If P exists, pin it and return it immediately.
   // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
@@ -68,6 +69,7 @@ Page *BufferPoolManager::FetchPage(page_id_t page_id) {
 }
 
 Page *BufferPoolManager::NewPage(page_id_t &page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   // 0.   Make sure you call AllocatePage!
   // 1.   If all the pages in the buffer pool are pinned, return nullptr.
   // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
@@ -113,6 +115,7 @@ Page *BufferPoolManager::NewPage(page_id_t &page_id) {
 }
 
 bool BufferPoolManager::DeletePage(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   // 0.   Make sure you call DeallocatePage!
   // 1.   Search the page table for the requested page (P).
   // 1.   If P does not exist, return true.
@@ -120,28 +123,27 @@ bool BufferPoolManager::DeletePage(page_id_t page_id) {
   // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
   auto temp = page_table_.find(page_id);
   if (temp != page_table_.end()) {
-    DeallocatePage(page_id);
     auto frame_id = temp->second;
     Page *page_pointer = &pages_[frame_id];
     if (page_pointer->GetPinCount() != 0) {
       // If P exists, but has a non-zero pin-count, return false. Someone is using the page.
       return false;
     }
-    if (page_pointer->is_dirty_) {
-      // dirty, write it to disk
-      disk_manager_->WritePage(page_id, page_pointer->GetData());
-      page_pointer->is_dirty_ = false;
-    }
+    DeallocatePage(page_id);
+    // the page is free, its dirty data is dropped instead of written back
+    page_pointer->is_dirty_ = false;
     page_table_.erase(page_id);
     replacer_->Pin(frame_id);
     free_list_.push_back(frame_id);
     return true;
   }
-  // not exist, return true
+  // not in the pool, e.g. a page deleted without being read, only its disk page is freed
+  DeallocatePage(page_id);
   return true;
 }
 
 bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   auto temp = page_table_.find(page_id);
   if (temp != page_table_.end()) {
     auto frame_id = temp->second;
@@ -159,6 +161,7 @@ bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
 }
 // 将page的信息写入磁盘，无论其是否为脏页
 bool BufferPoolManager::FlushPage(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   auto temp = page_table_.find(page_id);
   if (temp != page_table_.end()) {
     auto frame_id = temp->second;
@@ -1,5 +1,7 @@
 #include "catalog/catalog.h"
 
+#include <algorithm>
+
 uint POLYNOMIAL = 0xEDB88320;
 int have_table = 0;
 double pi = 3.14159265359;
@@ -155,12 +157,21 @@ CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManag
                 exit(1);
             }
         }
+        //the indexes are loaded first, so they follow the rows that leave their pages
+        for(auto &iter: tables_)
+        {
+            if(iter.second->GetTableMetaData()->HasLegacyRows() && UpgradeTable(iter.second, nullptr) != DB_SUCCESS)
+            {
+                exit(1);
+            }
+        }
     }
 }
 
 CatalogManager::~CatalogManager() {
  /** After you finish the code for the CatalogManager section,
  *  you can uncomment the commented code. Otherwise it will affect b+tree test **/
+  FlushTableMetaPages();
   FlushCatalogMetaPage();
   delete catalog_meta_;
   for (auto iter : tables_) {
@@ -175,18 +186,42 @@ CatalogManager::~CatalogManager() {
 * TODO: Student Implement
 */
 dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schema,
-                                    Transaction *txn, TableInfo *&table_info) {
+                                    Transaction *txn, TableInfo *&table_info, TableLayout layout,
+                                    const std::vector<uint32_t> &dictionary_columns) {
   // ASSERT(false, "Not Implemented yet");
   //if has been created
   if(table_names_.find(table_name) != table_names_.end())
   {
       return DB_TABLE_ALREADY_EXIST;
   }
+  //a pax page reserves the full width of every column, at least one tuple has to fit
+  if(layout == TableLayout::kPax && PaxLayout(schema).GetSlotCapacity() == 0)
+  {
+      return DB_FAILED;
+  }
+  for(auto column_index: dictionary_columns)
+  {
+      if(column_index >= schema->GetColumnCount() || schema->GetColumn(column_index)->GetType() != TypeId::kTypeChar)
+      {
+          return DB_FAILED;
+      }
+  }
   //init the table_heap_root page and id
   //init the table heap and table mata data and table info
   Schema *new_schema = schema->DeepCopySchema(schema);
-  TableHeap *table_heap = table_heap->Create(buffer_pool_manager_, new_schema, txn, log_manager_, lock_manager_);
-  TableMetadata *table_meta_data = table_meta_data->Create(next_table_id_, table_name, table_heap->GetFirstPageId(), new_schema);
+  //the dictionaries change the tuple layout, so they are attached before the heap is created
+  vector<ColumnDictionary *> dictionaries(new_schema->GetColumnCount(), nullptr);
+  for(auto column_index: dictionary_columns)
+  {
+      if(dictionaries[column_index] == nullptr)
+      {
+          dictionaries[column_index] = new ColumnDictionary();
+          new_schema->SetDictionary(column_index, dictionaries[column_index]);
+      }
+  }
+  TableHeap *table_heap = table_heap->Create(buffer_pool_manager_, new_schema, txn, log_manager_, lock_manager_, layout);
+  TableMetadata *table_meta_data = table_meta_data->Create(next_table_id_, table_name, table_heap->GetFirstPageId(),
+                                                           new_schema, layout, dictionaries);
   table_info = table_info->Create();
   table_info->Init(table_meta_data, table_heap);
 
@@ -200,6 +235,7 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
   tables_[next_table_id_] = table_info;
   table_names_[table_name] = next_table_id_;
   catalog_meta_->table_meta_pages_[next_table_id_] = table_meta_id;
+  BindDictionaryWriter(table_info);
   next_table_id_ = catalog_meta_->GetNextTableId();
 
   //update the catalog meta page
@@ -243,7 +279,8 @@ dberr_t CatalogManager::GetTables(vector<TableInfo *> &tables) const {
  */
 dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string &index_name,
                                     const std::vector<std::string> &index_keys, Transaction *txn,
-                                    IndexInfo *&index_info, const string &index_type) {
+                                    IndexInfo *&index_info, const string &index_type, bool unique,
+                                    const std::vector<std::string> &include_columns) {
   // ASSERT(false, "Not Implemented yet");
   //if not find the table
   if(table_names_.find(table_name) == table_names_.end())
@@ -254,6 +291,14 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
   {
       return DB_INDEX_ALREADY_EXIST;
   }
+  else if(index_type != "bptree" && index_type != "hash")
+  {
+      return DB_FAILED;
+  }// a hash index only looks up full keys, it has no room for other columns
+  else if(index_type == "hash" && !include_columns.empty())
+  {
+      return DB_FAILED;
+  }
 
   //map the index_keys into tuple
   table_id_t table_id = table_names_[table_name];
@@ -271,25 +316,37 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
           return DB_COLUMN_NAME_NOT_EXIST;
       }
   }
+  //the included columns follow the key, a column already in the key is covered by it
+  uint32_t key_count = key_map.size();
+  for(const auto & include_column : include_columns)
+  {
+      uint32_t column_id;
+      if(table_info->GetSchema()->GetColumnIndex(include_column, column_id) != DB_SUCCESS)
+      {
+          return DB_COLUMN_NAME_NOT_EXIST;
+      }
+      if(std::find(key_map.begin(), key_map.end(), column_id) == key_map.end())
+      {
+          key_map.push_back(column_id);
+      }
+  }
 
   //create index meta data and index info
   index_id_t index_id = next_index_id_;
-  IndexMetadata *index_meta_data = index_meta_data->Create(index_id, index_name, table_id, key_map, index_type);
+  IndexMetadata *index_meta_data =
+      index_meta_data->Create(index_id, index_name, table_id, key_map, index_type, unique, key_count);
   index_info = index_info->Create();
   index_info->Init(index_meta_data, table_info, buffer_pool_manager_);
-
-  //init the index tree
-  vector<Field> key_fields;
-  for(auto iter = table_info->GetTableHeap()->Begin(txn); iter != table_info->GetTableHeap()->End(); iter++)
+  //the key, with its included columns, may be too wide for the index
+  if(index_info->GetIndex() == nullptr)
   {
-    for(auto id: key_map)
-      {
-      key_fields.emplace_back(*static_cast<Row>(*iter).GetField(id));
-    }
-    Row index_row(key_fields);
-    index_info->GetIndex()->InsertEntry(index_row, static_cast<Row>(*iter).GetRowId(), txn);
-    key_fields.clear();
+      delete index_info;
+      index_info = nullptr;
+      return DB_FAILED;
   }
+
+  //init the index tree
+  BuildIndex(index_info, table_info, key_map, txn);
   //init the index meta page
   page_id_t index_meta_id;
   Page *index_meta_page = buffer_pool_manager_->NewPage(index_meta_id);
@@ -402,8 +459,11 @@ dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_
       return DB_INDEX_NOT_FOUND;
   }
 
-  //delete the catalog meta data about the index
+  //free the pages of the index and its record in the index roots page
   index_id_t index_id = index_names_[table_name][index_name];
+  indexes_[index_id]->GetIndex()->Destroy();
+
+  //delete the catalog meta data about the index
   buffer_pool_manager_->DeletePage(catalog_meta_->index_meta_pages_[index_id]);
   catalog_meta_->index_meta_pages_.erase(index_id);
   next_index_id_ = catalog_meta_->GetNextIndexId();
@@ -419,6 +479,48 @@ dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_
   return DB_SUCCESS;
 }
 
+dberr_t CatalogManager::VacuumTable(const string &table_name, Transaction *txn, uint32_t &freed_pages) {
+  TableInfo *table_info = nullptr;
+  if(GetTable(table_name, table_info) != DB_SUCCESS)
+  {
+      return DB_TABLE_NOT_EXIST;
+  }
+  vector<pair<RowId, RowId>> moved;
+  freed_pages = table_info->GetTableHeap()->Vacuum(moved, txn);
+  RepointIndexes(table_info, moved, txn);
+  return DB_SUCCESS;
+}
+
+dberr_t CatalogManager::UpgradeTable(TableInfo *table_info, Transaction *txn) {
+  vector<pair<RowId, RowId>> moved;
+  table_info->GetTableHeap()->UpgradeRows(moved, txn);
+  RepointIndexes(table_info, moved, txn);
+  //the new metadata tells the next load that there is nothing left to rewrite
+  table_info->GetTableMetaData()->ClearLegacyRows();
+  return FlushTableMetaPage(table_info->GetTableId());
+}
+
+void CatalogManager::RepointIndexes(TableInfo *table_info, const vector<pair<RowId, RowId>> &moved, Transaction *txn) {
+  if(moved.empty())
+  {
+      return;
+  }
+  vector<IndexInfo *> indexes;
+  GetTableIndexes(table_info->GetTableName(), indexes);
+  for(auto &move: moved)
+  {
+      Row row(move.second);
+      table_info->GetTableHeap()->GetTuple(&row, txn);
+      for(auto index: indexes)
+      {
+          Row key_row;
+          row.GetKeyFromRow(table_info->GetSchema(), index->GetIndexKeySchema(), key_row);
+          index->GetIndex()->RemoveEntry(key_row, move.first, txn);
+          index->GetIndex()->InsertEntry(key_row, move.second, txn);
+      }
+  }
+}
+
 /**
  * TODO: Student Implement
  */
@@ -438,6 +540,45 @@ dberr_t CatalogManager::FlushCatalogMetaPage() const {
   return DB_SUCCESS;
 }
 
+dberr_t CatalogManager::FlushTableMetaPages() {
+  for(auto &iter: tables_)
+  {
+      TableMetadata *table_meta_data = iter.second->GetTableMetaData();
+      if(!table_meta_data->HasDirtyDictionary())
+      {
+          continue;
+      }
+      if(FlushTableMetaPage(iter.first) != DB_SUCCESS)
+      {
+          return DB_FAILED;
+      }
+  }
+  return DB_SUCCESS;
+}
+
+void CatalogManager::BindDictionaryWriter(TableInfo *table_info) {
+  table_id_t table_id = table_info->GetTableId();
+  table_info->GetTableHeap()->SetDictionaryWriter([this, table_id] {
+      return FlushTableMetaPage(table_id) == DB_SUCCESS;
+  });
+}
+
+dberr_t CatalogManager::FlushTableMetaPage(table_id_t table_id) {
+  page_id_t page_id = catalog_meta_->table_meta_pages_[table_id];
+  Page *table_meta_page = buffer_pool_manager_->FetchPage(page_id);
+  if(table_meta_page == nullptr)
+  {
+      return DB_FAILED;
+  }
+  tables_[table_id]->GetTableMetaData()->SerializeTo(table_meta_page->GetData());
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  if(!buffer_pool_manager_->FlushPage(page_id))
+  {
+      return DB_FAILED;
+  }
+  return DB_SUCCESS;
+}
+
 /**
  * TODO: Student Implement
  */
@@ -454,11 +595,12 @@ dberr_t CatalogManager::LoadTable(const table_id_t table_id, const page_id_t pag
       return DB_FAILED;
   }
   TableHeap *table_heap = table_heap->Create(buffer_pool_manager_, table_meta_data->GetFirstPageId(), table_meta_data->GetSchema(),
-                                             nullptr, nullptr);
+                                             nullptr, nullptr, table_meta_data->GetLayout());
   TableInfo *table_info = table_info->Create();
   table_info->Init(table_meta_data, table_heap);
   table_names_[table_meta_data->GetTableName()] = table_id;
   tables_[table_id] = table_info;
+  BindDictionaryWriter(table_info);
 
   return DB_SUCCESS;
 }
@@ -483,17 +625,7 @@ dberr_t CatalogManager::LoadIndex(const index_id_t index_id, const page_id_t pag
        index_info->Init(index_meta_data, table->second, buffer_pool_manager_);
 
        //init the index tree
-       vector<Field> key_fields;
-       for(auto iter = table->second->GetTableHeap()->Begin(nullptr); iter != table->second->GetTableHeap()->End(); iter++)
-       {
-         for(auto id: index_meta_data->GetKeyMapping())
-          {
-           key_fields.emplace_back(*static_cast<Row>(*iter).GetField(id));
-         }
-         Row index_row(key_fields);
-         index_info->GetIndex()->InsertEntry(index_row, static_cast<Row>(*iter).GetRowId(), nullptr);
-         key_fields.clear();
-       }
+       BuildIndex(index_info, table->second, index_meta_data->GetKeyMapping(), nullptr);
 
        index_names_[table->second->GetTableName()][index_meta_data->GetIndexName()] = index_id;
        indexes_[index_id] = index_info;
@@ -505,6 +637,33 @@ dberr_t CatalogManager::LoadIndex(const index_id_t index_id, const page_id_t pag
    return DB_SUCCESS;
 }
 
+dberr_t CatalogManager::BuildIndex(IndexInfo *index_info, TableInfo *table_info, const std::vector<uint32_t> &key_map,
+                                   Transaction *txn)
+{
+  TableHeap *table_heap = table_info->GetTableHeap();
+  auto iter = table_heap->Begin(txn);
+  auto end = table_heap->End();
+  auto next = [&](Row &key, RowId &row_id)
+  {
+    if(iter == end)
+    {
+      return false;
+    }
+    const Row &row = *iter;
+    vector<Field> key_fields;
+    key_fields.reserve(key_map.size());
+    for(auto id: key_map)
+    {
+      key_fields.emplace_back(*row.GetField(id));
+    }
+    key = Row(std::move(key_fields));
+    row_id = row.GetRowId();
+    iter++;
+    return true;
+  };
+  return index_info->GetIndex()->BuildFrom(next, txn);
+}
+
 /**
  * TODO: Student Implement
  */
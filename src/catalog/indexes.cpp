@@ -1,12 +1,20 @@
 #include "catalog/indexes.h"
 
 IndexMetadata::IndexMetadata(const index_id_t index_id, const std::string &index_name, const table_id_t table_id,
-                             const std::vector<uint32_t> &key_map, const std::string &index_type)
-    : index_id_(index_id), index_name_(index_name), table_id_(table_id), key_map_(key_map), index_type_(index_type) {}
+                             const std::vector<uint32_t> &key_map, const std::string &index_type, bool unique,
+                             uint32_t key_count)
+    : index_id_(index_id),
+      index_name_(index_name),
+      table_id_(table_id),
+      key_map_(key_map),
+      index_type_(index_type),
+      unique_(unique),
+      key_count_(key_count == 0 ? key_map.size() : key_count) {}
 
 IndexMetadata *IndexMetadata::Create(const index_id_t index_id, const string &index_name, const table_id_t table_id,
-                                     const vector<uint32_t> &key_map, const string &index_type) {
-  return new IndexMetadata(index_id, index_name, table_id, key_map, index_type);
+                                     const vector<uint32_t> &key_map, const string &index_type, bool unique,
+                                     uint32_t key_count) {
+  return new IndexMetadata(index_id, index_name, table_id, key_map, index_type, unique, key_count);
 }
 
 uint32_t IndexMetadata::SerializeTo(char *buf) const {
@@ -14,7 +22,7 @@ uint32_t IndexMetadata::SerializeTo(char *buf) const {
     uint32_t ofs = GetSerializedSize();
     ASSERT(ofs <= PAGE_SIZE, "Failed to serialize index info.");
     // magic num
-    MACH_WRITE_UINT32(buf, INDEX_METADATA_MAGIC_NUM);
+    MACH_WRITE_UINT32(buf, INDEX_METADATA_INCLUDE_MAGIC_NUM);
     buf += 4;
     // index id
     MACH_WRITE_TO(index_id_t, buf, index_id_);
@@ -40,6 +48,12 @@ uint32_t IndexMetadata::SerializeTo(char *buf) const {
     buf += 4;
     MACH_WRITE_STRING(buf, index_type_);
     buf += index_type_.length();
+    // unique
+    MACH_WRITE_UINT32(buf, unique_);
+    buf += 4;
+    // key column count
+    MACH_WRITE_UINT32(buf, key_count_);
+    buf += 4;
 
     ASSERT(buf - p == ofs, "Unexpected serialize size.");
     return ofs;
@@ -49,10 +63,11 @@ uint32_t IndexMetadata::SerializeTo(char *buf) const {
  * TODO: Student Implement
  */
 uint32_t IndexMetadata::GetSerializedSize() const {
-    /* the size of INDEX_METADATA_MAGIC_NUM, index_id_, index_name_.length(), index_name_, table_id_ and key_map_,size() and key_map_*/
+    /* the size of INDEX_METADATA_MAGIC_NUM, index_id_, index_name_.length(), index_name_, table_id_,
+     * key_map_,size(), key_map_, index_type_.length(), index_type_, unique_ and key_count_ */
     uint32_t len = index_name_.length() + index_type_.length() + key_map_.size() * sizeof(uint32_t);
 
-    return 6 * sizeof(uint32_t) + len;
+    return 8 * sizeof(uint32_t) + len;
 }
 
 uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta) {
@@ -63,7 +78,9 @@ uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta) {
     // magic num
     uint32_t magic_num = MACH_READ_UINT32(buf);
     buf += 4;
-    ASSERT(magic_num == INDEX_METADATA_MAGIC_NUM, "Failed to deserialize index info.");
+    ASSERT(magic_num == INDEX_METADATA_MAGIC_NUM || magic_num == INDEX_METADATA_UNIQUE_MAGIC_NUM ||
+               magic_num == INDEX_METADATA_INCLUDE_MAGIC_NUM,
+           "Failed to deserialize index info.");
     // index id
     index_id_t index_id = MACH_READ_FROM(index_id_t, buf);
     buf += 4;
@@ -90,33 +107,47 @@ uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta) {
     buf += 4;
     std::string index_type(buf, len);
     buf += len;
+    // unique, every index was unique before the flag was written
+    bool unique = true;
+    if (magic_num != INDEX_METADATA_MAGIC_NUM) {
+        unique = MACH_READ_UINT32(buf) != 0;
+        buf += 4;
+    }
+    // key column count, every column was a key column before included columns were written
+    uint32_t key_count = key_map.size();
+    if (magic_num == INDEX_METADATA_INCLUDE_MAGIC_NUM) {
+        key_count = MACH_READ_UINT32(buf);
+        buf += 4;
+    }
     // allocate space for index meta data
-    index_meta = new IndexMetadata(index_id, index_name, table_id, key_map, index_type);
+    index_meta = new IndexMetadata(index_id, index_name, table_id, key_map, index_type, unique, key_count);
     return buf - p;
 }
 
 Index *IndexInfo::CreateIndex(BufferPoolManager *buffer_pool_manager, const string &index_type) {
-  size_t max_size = 0;
-  for (auto col : key_schema_->GetColumns()) {
-    max_size += col->GetLength();
+  size_t max_size = KeyManager::GetEncodedSize(key_schema_);
+  if (index_type == "hash") {
+    // the buckets keep a pair per row id, the key needs no row id
+    return new HashIndex(meta_data_->index_id_, key_schema_, max_size, buffer_pool_manager, meta_data_->IsUnique());
+  }
+  // a non unique key ends with the row id
+  if (!meta_data_->IsUnique()) {
+    max_size += KeyManager::ROW_ID_SUFFIX_SIZE;
   }
 
   if (index_type == "bptree") {
+    // keys of up to 8 bytes are packed, their nodes are searched as 64 bit integers. Longer keys take their own width
+    // rounded up to 4 bytes, which keeps the page ids after the keys of an internal page aligned
     if (max_size <= 8)
-      max_size = 16;
-    else if (max_size <= 24)
-      max_size = 32;
-    else if (max_size <= 56)
-      max_size = 64;
-    else if (max_size <= 120)
-      max_size = 128;
-    else if (max_size <= 248)
-      max_size = 256;
+      max_size = 8;
+    else if (max_size <= 256)
+      max_size = (max_size + 3) / 4 * 4;
     else {
       return nullptr;
     }
   } else {
     return nullptr;
   }
-  return new BPlusTreeIndex(meta_data_->index_id_, key_schema_, max_size, buffer_pool_manager);
+  return new BPlusTreeIndex(meta_data_->index_id_, key_schema_, max_size, buffer_pool_manager,
+                            meta_data_->IsUnique());
 }
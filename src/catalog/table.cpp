@@ -5,7 +5,7 @@ uint32_t TableMetadata::SerializeTo(char *buf) const {
     uint32_t ofs = GetSerializedSize();
     ASSERT(ofs <= PAGE_SIZE, "Failed to serialize table info.");
     // magic num
-    MACH_WRITE_UINT32(buf, TABLE_METADATA_MAGIC_NUM);
+    MACH_WRITE_UINT32(buf, TABLE_METADATA_DICTIONARY_MAGIC_NUM);
     buf += 4;
     // table id
     MACH_WRITE_TO(table_id_t, buf, table_id_);
@@ -29,6 +29,24 @@ uint32_t TableMetadata::SerializeTo(char *buf) const {
         MACH_WRITE_STRING(buf, iter);
         buf += iter.length();
     }
+    // page layout
+    MACH_WRITE_UINT32(buf, static_cast<uint32_t>(layout_));
+    buf += 4;
+    // column dictionaries
+    uint32_t dictionary_count = 0;
+    char *count_buf = buf;
+    buf += 4;
+    for (uint32_t i = 0; i < dictionaries_.size(); i++) {
+        if (dictionaries_[i] == nullptr) {
+            continue;
+        }
+        MACH_WRITE_UINT32(buf, i);
+        buf += 4;
+        buf += dictionaries_[i]->SerializeTo(buf);
+        dictionaries_[i]->ClearDirty();
+        dictionary_count++;
+    }
+    MACH_WRITE_UINT32(count_buf, dictionary_count);
     ASSERT(buf - p == ofs, "Unexpected serialize size.");
     return ofs;
 }
@@ -38,7 +56,8 @@ uint32_t TableMetadata::SerializeTo(char *buf) const {
  * TODO: Student Implement
  */
 uint32_t TableMetadata::GetSerializedSize() const {
-    /* the size of TABLE_METADATA_MAGIC_NUM, table_id_, table_name_.length(), table_name_, root_page_id_ and schema_*/
+    /* the size of TABLE_METADATA_MAGIC_NUM, table_id_, table_name_.length(), table_name_, root_page_id_, schema_,
+     * layout_ and the dictionaries */
     uint32_t len = table_name_.length() + schema_->GetSerializedSize();
     for(const auto& iter: primary_key_)
     {
@@ -46,7 +65,15 @@ uint32_t TableMetadata::GetSerializedSize() const {
         len += sizeof(uint32_t);
     }
     len += sizeof(uint32_t);
-    return  4 * sizeof(uint32_t) + len;
+    len += sizeof(uint32_t);
+    for(auto dictionary: dictionaries_)
+    {
+        if(dictionary != nullptr)
+        {
+            len += sizeof(uint32_t) + dictionary->GetSerializedSize();
+        }
+    }
+    return  5 * sizeof(uint32_t) + len;
 }
 
 uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta) {
@@ -57,7 +84,8 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta) {
     // magic num
     uint32_t magic_num = MACH_READ_UINT32(buf);
     buf += 4;
-    ASSERT(magic_num == TABLE_METADATA_MAGIC_NUM, "Failed to deserialize table info.");
+    ASSERT(magic_num == TABLE_METADATA_MAGIC_NUM || magic_num == TABLE_METADATA_LAYOUT_MAGIC_NUM ||
+           magic_num == TABLE_METADATA_DICTIONARY_MAGIC_NUM, "Failed to deserialize table info.");
     // table id
     table_id_t table_id = MACH_READ_FROM(table_id_t, buf);
     buf += 4;
@@ -83,9 +111,28 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta) {
         buf += key_length;
         primary_key.push_back(key_name);
     }
+    // page layout, metadata written before layouts existed describes a row table
+    TableLayout layout = TableLayout::kRow;
+    if (magic_num != TABLE_METADATA_MAGIC_NUM) {
+        layout = static_cast<TableLayout>(MACH_READ_UINT32(buf));
+        buf += 4;
+    }
+    // column dictionaries
+    std::vector<ColumnDictionary *> dictionaries(schema->GetColumnCount(), nullptr);
+    if (magic_num == TABLE_METADATA_DICTIONARY_MAGIC_NUM) {
+        uint32_t dictionary_count = MACH_READ_UINT32(buf);
+        buf += 4;
+        for (uint32_t i = 0; i < dictionary_count; i++) {
+            uint32_t column_index = MACH_READ_UINT32(buf);
+            buf += 4;
+            buf += ColumnDictionary::DeserializeFrom(buf, dictionaries[column_index]);
+        }
+    }
     // allocate space for table metadata
-    table_meta = new TableMetadata(table_id, table_name, root_page_id, schema);
+    table_meta = new TableMetadata(table_id, table_name, root_page_id, schema, layout, dictionaries);
     table_meta->primary_key_ = primary_key;
+    // the row format changed together with the dictionaries, older row tables still have to be rewritten
+    table_meta->legacy_rows_ = magic_num != TABLE_METADATA_DICTIONARY_MAGIC_NUM && layout == TableLayout::kRow;
     return buf - p;
 }
 
@@ -95,10 +142,51 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta) {
  * @param heap Memory heap passed by TableInfo
  */
 TableMetadata *TableMetadata::Create(table_id_t table_id, std::string table_name, page_id_t root_page_id,
-                                     TableSchema *schema) {
+                                     TableSchema *schema, TableLayout layout,
+                                     std::vector<ColumnDictionary *> dictionaries) {
   // allocate space for table metadata
-  return new TableMetadata(table_id, table_name, root_page_id, schema);
+  return new TableMetadata(table_id, table_name, root_page_id, schema, layout, std::move(dictionaries));
+}
+
+TableMetadata::TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema,
+                             TableLayout layout, std::vector<ColumnDictionary *> dictionaries)
+    : table_id_(table_id), table_name_(table_name), root_page_id_(root_page_id), schema_(schema), layout_(layout),
+      dictionaries_(std::move(dictionaries)) {
+  dictionaries_.resize(schema_->GetColumnCount(), nullptr);
+  for (uint32_t i = 0; i < dictionaries_.size(); i++) {
+    if (dictionaries_[i] != nullptr) {
+      schema_->SetDictionary(i, dictionaries_[i]);
+    }
+  }
+  AssignDictionaryBudgets();
+}
+
+bool TableMetadata::HasDirtyDictionary() const {
+  for (auto dictionary : dictionaries_) {
+    if (dictionary != nullptr && dictionary->IsDirty()) {
+      return true;
+    }
+  }
+  return false;
 }
 
-TableMetadata::TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema)
-    : table_id_(table_id), table_name_(table_name), root_page_id_(root_page_id), schema_(schema){}
+void TableMetadata::AssignDictionaryBudgets() {
+  uint32_t count = 0;
+  uint32_t dictionary_bytes = 0;
+  for (auto dictionary : dictionaries_) {
+    if (dictionary != nullptr) {
+      count++;
+      dictionary_bytes += dictionary->GetSerializedSize();
+    }
+  }
+  if (count == 0) {
+    return;
+  }
+  uint32_t other_bytes = GetSerializedSize() - dictionary_bytes + METADATA_PAGE_RESERVE;
+  uint32_t budget = other_bytes < PAGE_SIZE ? (PAGE_SIZE - other_bytes) / count : 0;
+  for (auto dictionary : dictionaries_) {
+    if (dictionary != nullptr) {
+      dictionary->SetMaxBytes(budget);
+    }
+  }
+}
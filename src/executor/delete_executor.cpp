@@ -37,7 +37,7 @@ bool DeleteExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
         for(auto id: column_ids){
           fields.emplace_back(*update_row.GetField(id));
         }
-        Row index_row(fields);
+        Row index_row(std::move(fields));
         vector<RowId> temp_result;
         index->GetIndex()->RemoveEntry(index_row, update_rowid, exec_ctx_->GetTransaction());
       }
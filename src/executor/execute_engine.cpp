@@ -1,9 +1,11 @@
 #include "executor/execute_engine.h"
 
 #include <dirent.h>
+#include <strings.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <chrono>
 
 #include "common/result_writer.h"
@@ -84,6 +86,13 @@ dberr_t ExecuteEngine::ExecutePlan(const AbstractPlanNodeRef &plan, std::vector<
                                    ExecuteContext *exec_ctx) {
   // Construct the executor for the abstract plan node
   auto executor = CreateExecutor(exec_ctx, plan);
+  // parallel workers read pages while the rows are consumed, so only a plan that writes nothing gets them
+  if (plan->GetType() == PlanType::SeqScan && exec_ctx->GetParallelDegree() > 1) {
+    worker_pool_.Reserve(exec_ctx->GetParallelDegree());
+    exec_ctx->SetWorkerPool(&worker_pool_);
+  } else {
+    exec_ctx->SetWorkerPool(nullptr);
+  }
 
   try {
     executor->Init();
@@ -91,6 +100,7 @@ dberr_t ExecuteEngine::ExecutePlan(const AbstractPlanNodeRef &plan, std::vector<
     Row row{};
     while (executor->Next(&row, &rid)) {
       if (result_set != nullptr) {
+        // the row may refer to the arena of the executor, the copy owns its data
         result_set->push_back(row);
       }
     }
@@ -110,8 +120,10 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
   }
   auto start_time = std::chrono::system_clock::now();
   unique_ptr<ExecuteContext> context(nullptr);
-  if(!current_db_.empty())
+  if(!current_db_.empty()) {
     context = dbs_[current_db_]->MakeExecuteContext(nullptr);
+    context->SetParallelDegree(parallel_degree_);
+  }
   switch (ast->type_) {
     case kNodeCreateDB:
       return ExecuteCreateDatabase(ast, context.get());
@@ -143,6 +155,10 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
       return ExecuteExecfile(ast, context.get());
     case kNodeQuit:
       return ExecuteQuit(ast, context.get());
+    case kNodeVacuum:
+      return ExecuteVacuum(ast, context.get());
+    case kNodeSetVariable:
+      return ExecuteSetVariable(ast, context.get());
     default:
       break;
   }
@@ -396,6 +412,7 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
 
   vector<Column *> columns;
   vector<string> primary_key;
+  vector<uint32_t> dictionary_columns;
   uint32_t index = 0;
 
   while(ast_ptr != nullptr){
@@ -404,6 +421,7 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
     uint32_t length;
     bool nullable = true;
     bool unique = false;
+    string option;
 
     // constraint
     if(ast_ptr->val_ != nullptr) {
@@ -456,12 +474,25 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
             type = kTypeFloat;
           }
           break;
+        case kNodeColumnOption:
+          option = temp_ptr->child_->val_;
+          break;
         default:
           break;
       }
       temp_ptr = temp_ptr->next_;
     }
 
+    //column option, only dictionary encoding of char columns for now
+    if(!option.empty()){
+      if(strcasecmp(option.c_str(), "dictionary") != 0 || type != kTypeChar){
+        cout << "Unknown option '" + option + "' of column '" + column_name + "'." << endl;
+        for(auto column: columns) delete column;
+        return DB_FAILED;
+      }
+      dictionary_columns.push_back(index);
+    }
+
     if(type != kTypeChar)
       columns.push_back(new Column(column_name, type, index, nullable, unique));
     else
@@ -471,10 +502,30 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
     ast_ptr = ast_ptr->next_;
   }
 
+  //get the page layout
+  TableLayout layout = TableLayout::kRow;
+  pSyntaxNode layout_ptr = create_table_ast->next_->next_;
+  if(layout_ptr != nullptr){
+    string layout_name = layout_ptr->child_->val_;
+    std::transform(layout_name.begin(), layout_name.end(), layout_name.begin(), ::tolower);
+    if(layout_name == "pax"){
+      layout = TableLayout::kPax;
+    }
+    else if(layout_name != "row"){
+      cout << "Table layout '" + layout_name + "' not supported, use row or pax." << endl;
+      for(auto column: columns) delete column;
+      return DB_FAILED;
+    }
+  }
+
   //create schema and table
   auto schema = make_shared<Schema>(columns, true);
   TableInfo *table_info = nullptr;
-  dberr_t result =  context->GetCatalog()->CreateTable(table_name, schema.get(), context->GetTransaction(), table_info);
+  dberr_t result =  context->GetCatalog()->CreateTable(table_name, schema.get(), context->GetTransaction(), table_info, layout,
+                                                       dictionary_columns);
+  if(result == DB_FAILED && layout == TableLayout::kPax){
+    cout << "A row of '" + table_name + "' does not fit into a pax page." << endl;
+  }
   if(result == DB_SUCCESS){
     //update the primary key
     if(!primary_key.empty()){
@@ -516,6 +567,42 @@ dberr_t ExecuteEngine::ExecuteDropTable(pSyntaxNode ast, ExecuteContext *context
   return result;
 }
 
+dberr_t ExecuteEngine::ExecuteVacuum(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteVacuum" << std::endl;
+#endif
+  if(current_db_.empty()){
+    return DB_NOT_SELECT;
+  }
+  string table_name = ast->child_->val_;
+  uint32_t freed_pages = 0;
+  //statements are executed one at a time, which gives the vacuum the exclusive access to the table it needs
+  dberr_t result = context->GetCatalog()->VacuumTable(table_name, context->GetTransaction(), freed_pages);
+  if(result == DB_SUCCESS){
+    cout << "Table '" + table_name + "' vacuumed, " << freed_pages << " page(s) freed." << endl;
+  }
+  return result;
+}
+
+dberr_t ExecuteEngine::ExecuteSetVariable(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteSetVariable" << std::endl;
+#endif
+  string variable = ast->child_->val_;
+  pSyntaxNode value = ast->child_->next_;
+  if(variable == "parallel_degree"){
+    if(value->type_ != kNodeNumber || atoi(value->val_) < 1){
+      cout << "parallel_degree must be a positive integer." << endl;
+      return DB_FAILED;
+    }
+    parallel_degree_ = atoi(value->val_);
+    cout << "parallel_degree set to " << parallel_degree_ << "." << endl;
+    return DB_SUCCESS;
+  }
+  cout << "Unknown variable '" + variable + "'." << endl;
+  return DB_FAILED;
+}
+
 /**
  * TODO: Student Implement
  */
@@ -566,13 +653,19 @@ dberr_t ExecuteEngine::ExecuteShowIndexes(pSyntaxNode ast, ExecuteContext *conte
     return DB_SUCCESS;
   }
 
+  //an included column is marked after its name
+  auto column_name = [](IndexInfo *index, uint32_t i){
+    string name = index->GetIndexKeySchema()->GetColumn(i)->GetName();
+    return i < index->GetKeyColumnCount() ? name : name + " (included)";
+  };
+
   //update the length
   for(const auto &iter: indexes){
     for(const auto &index: iter.second){
       column_length[0] = max(column_length[0], uint32_t(iter.first.length()));
       column_length[1] = max(column_length[1], uint32_t(index->GetIndexName().length()));
-      for(const auto &column: index->GetIndexKeySchema()->GetColumns()){
-        column_length[3] = max(column_length[3], uint32_t(column->GetName().length()));
+      for(uint32_t i = 0; i < index->GetIndexKeySchema()->GetColumnCount(); i++){
+        column_length[3] = max(column_length[3], uint32_t(column_name(index, i).length()));
       }
       column_length[4] = max(column_length[4], uint32_t(index->GetIndexType().length()));
     }
@@ -591,7 +684,7 @@ dberr_t ExecuteEngine::ExecuteShowIndexes(pSyntaxNode ast, ExecuteContext *conte
     for(const auto &index: iter.second){
       for(int i=0; i < index->GetIndexKeySchema()->GetColumns().size(); i++){
         cout << "| " << setw(column_length[0]) << iter.first << " | " << setw(column_length[1]) << index->GetIndexName() << " | " <<
-            setw(column_length[2]) << i+1 << " | " << setw(column_length[3]) << index->GetIndexKeySchema()->GetColumns()[i]->GetName() << " | " <<
+            setw(column_length[2]) << i+1 << " | " << setw(column_length[3]) << column_name(index, i) << " | " <<
             setw(column_length[4]) << index->GetIndexType() << " |" << endl;
       }
     }
@@ -628,40 +721,53 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
     ptr = ptr->next_;
   }
 
+  //an index on a unique column or on the primary key is unique, any other index takes duplicate keys
   TableInfo *table_info = nullptr;
-  context->GetCatalog()->GetTable(table_name, table_info);
-  if(index_keys.size() == 1){
+  if(context->GetCatalog()->GetTable(table_name, table_info) != DB_SUCCESS){
+    return DB_TABLE_NOT_EXIST;
+  }
+  bool unique = false;
+  for(const auto& index : index_keys){
     uint32_t col_index;
-    if(table_info->GetSchema()->GetColumnIndex(index_keys[0], col_index) == DB_SUCCESS){
-      const Column *column = table_info->GetSchema()->GetColumn(col_index);
+    if(table_info->GetSchema()->GetColumnIndex(index, col_index) == DB_SUCCESS &&
+       table_info->GetSchema()->GetColumn(col_index)->IsUnique()){
+      unique = true;
     }
   }
-  else{
-    for(const auto& index : index_keys){
-      uint32_t col_index;
-      if(table_info->GetSchema()->GetColumnIndex(index, col_index) == DB_SUCCESS){
-        const Column *column = table_info->GetSchema()->GetColumn(col_index);
-        if(column->IsUnique()){
-          break;
-        }
-        if(index == index_keys[index_keys.size()-1]){
-          cout << "The indexes don't have unique index." << endl;
-          return DB_FAILED;
-        }
-      }
-    }
+  const auto &primary_key = table_info->GetTableMetaData()->primary_key_;
+  if(!primary_key.empty() && std::all_of(primary_key.begin(), primary_key.end(), [&](const string &column){
+       return std::find(index_keys.begin(), index_keys.end(), column) != index_keys.end();
+     })){
+    unique = true;
   }
 
-  //get the index type
-  pSyntaxNode index_type_ptr = index_key_ptr->next_;
+  //get the included columns and the index type
+  vector<string> include_columns;
   string index_type = "bptree";
-  if(index_type_ptr != nullptr){
-    index_type = index_type_ptr->child_->val_;
+  for(pSyntaxNode option_ptr = index_key_ptr->next_; option_ptr != nullptr; option_ptr = option_ptr->next_){
+    if(option_ptr->type_ == kNodeColumnList){
+      for(ptr = option_ptr->child_; ptr != nullptr; ptr = ptr->next_){
+        include_columns.emplace_back(ptr->val_);
+      }
+    }
+    else if(option_ptr->type_ == kNodeIndexType){
+      index_type = option_ptr->child_->val_;
+      std::transform(index_type.begin(), index_type.end(), index_type.begin(), ::tolower);
+    }
+  }
+  if(index_type != "bptree" && index_type != "hash"){
+    cout << "Index type '" + index_type + "' not supported, use bptree or hash." << endl;
+    return DB_FAILED;
+  }
+  if(index_type == "hash" && !include_columns.empty()){
+    cout << "A hash index can not include columns, use bptree." << endl;
+    return DB_FAILED;
   }
 
   //create index
   IndexInfo *index_info = nullptr;
-  dberr_t result = context->GetCatalog()->CreateIndex(table_name, index_name, index_keys, context->GetTransaction(), index_info, index_type);
+  dberr_t result = context->GetCatalog()->CreateIndex(table_name, index_name, index_keys, context->GetTransaction(),
+                                                      index_info, index_type, unique, include_columns);
   if(result == DB_SUCCESS){
     cout << "Index '" + index_name + "' created." << endl;
   }
@@ -13,7 +13,19 @@ bool CompareRowId(RowId &a, RowId &b){
 
 void IndexScanExecutor::Init() {
   vector<shared_ptr<AbstractExpression>> plan_ptr;
-  if(plan_->GetPredicate() != nullptr){
+  result.clear();
+  cursor = 0;
+  scan_ = nullptr;
+  // the key range folded by the planner is read as the rows are asked for
+  const IndexScanRange &range = plan_->range_;
+  if(range.index_ != nullptr){
+    Row lower(range.lower_);
+    Row upper(range.upper_);
+    scan_ = range.index_->GetIndex()->Scan(range.lower_.empty() ? nullptr : &lower,
+                                           range.upper_.empty() ? nullptr : &upper, range.lower_inclusive_,
+                                           range.upper_inclusive_, exec_ctx_->GetTransaction());
+  }
+  else if(plan_->GetPredicate() != nullptr){
     auto first_plan_ptr = plan_->GetPredicate();
     if(first_plan_ptr->GetType() == ExpressionType::ComparisonExpression){
       plan_ptr.push_back(first_plan_ptr);
@@ -36,8 +48,8 @@ void IndexScanExecutor::Init() {
           if(index->GetIndexKeySchema()->GetColumn(0)->GetTableInd() == col_id){
             auto &num_value = reinterpret_cast<ConstantValueExpression *>(const_num.get())->val_;
             Row *key = new Row(*new vector<Field>(1, num_value));
-            auto bp_tree = reinterpret_cast<BPlusTreeIndex *>(index->GetIndex());
-            bp_tree->ScanKey(*key, new_result, exec_ctx_->GetTransaction(), operator_value);
+            auto key_index = index->GetIndex();
+            key_index->ScanKey(*key, new_result, exec_ctx_->GetTransaction(), operator_value);
 
             sort(new_result.begin(), new_result.end());
             sort(result.begin(), result.end());
@@ -62,8 +74,8 @@ void IndexScanExecutor::Init() {
         if(index->GetIndexKeySchema()->GetColumn(0)->GetTableInd() == col_id){
           auto &num_value = reinterpret_cast<ConstantValueExpression *>(const_num.get())->val_;
           Row *key = new Row(*new vector<Field>(1, num_value));
-          auto bp_tree = reinterpret_cast<BPlusTreeIndex *>(index->GetIndex());
-          bp_tree->ScanKey(*key, new_result, exec_ctx_->GetTransaction(), operator_value);
+          auto key_index = index->GetIndex();
+          key_index->ScanKey(*key, new_result, exec_ctx_->GetTransaction(), operator_value);
 
           if(result.empty()){
             result.assign(new_result.begin(), new_result.end());
@@ -93,8 +105,8 @@ void IndexScanExecutor::Init() {
           if(index->GetIndexKeySchema()->GetColumn(0)->GetTableInd() == col_id){
             auto &num_value = reinterpret_cast<ConstantValueExpression *>(const_num.get())->val_;
             Row *key = new Row(*new vector<Field>(1, num_value));
-            auto bp_tree = reinterpret_cast<BPlusTreeIndex *>(index->GetIndex());
-            bp_tree->ScanKey(*key, new_result, exec_ctx_->GetTransaction(), operator_value);
+            auto key_index = index->GetIndex();
+            key_index->ScanKey(*key, new_result, exec_ctx_->GetTransaction(), operator_value);
 
             if(result.empty()){
               result.assign(new_result.begin(), new_result.end());
@@ -113,56 +125,79 @@ void IndexScanExecutor::Init() {
     }
   }
 
-  Row *new_row;
-  while(cursor != result.size()){
-    RowId row_id = result[cursor];
-    new_row = new Row(row_id);
-    TableInfo *table_info = nullptr;
-    exec_ctx_->GetCatalog()->GetTable(plan_->table_name_, table_info);
-    if(table_info->GetTableHeap()->GetTuple(new_row, exec_ctx_->GetTransaction())){
-      if(plan_->need_filter_){
-        Field field = plan_->GetPredicate()->Evaluate(new_row);
-        if (!field.CompareEquals(Field(kTypeInt, 1))) {
-          result.erase(result.begin()+cursor);
-        }
-        else{
-          cursor++;
-        }
-      }
-      else{
-        break;
-      }
+  exec_ctx_->GetCatalog()->GetTable(plan_->table_name_, table_info_);
+  column_map_.clear();
+  for(auto column: plan_->OutputSchema()->GetColumns())
+    for(auto old_column: table_info_->GetSchema()->GetColumns()){
+      if(column->GetName() == old_column->GetName())
+        column_map_.push_back(old_column->GetTableInd());
+    }
+  // the position in the index key of every table column, -1 for the columns the index does not store
+  key_position_.clear();
+  if(plan_->index_only_){
+    key_position_.assign(table_info_->GetSchema()->GetColumnCount(), -1);
+    const Schema *key_schema = range.index_->GetIndexKeySchema();
+    for(uint32_t i = 0; i < key_schema->GetColumnCount(); i++){
+      key_position_[key_schema->GetColumn(i)->GetTableInd()] = static_cast<int>(i);
     }
   }
-  cursor = 0;
 }
 
-bool IndexScanExecutor::Next(Row *row, RowId *rid){
-
-  Row *new_row = nullptr;
-  TableInfo *table_info = nullptr;
-  if(cursor != result.size()) {
-    RowId row_id = result[cursor];
-    new_row = new Row(row_id);
-    exec_ctx_->GetCatalog()->GetTable(plan_->table_name_, table_info);
-    if (!table_info->GetTableHeap()->GetTuple(new_row, exec_ctx_->GetTransaction())) {
-      return false;
+void IndexScanExecutor::RowFromKey(Row *row) {
+  auto &fields = row->GetFields();
+  fields.reserve(key_position_.size());
+  for(uint32_t i = 0; i < key_position_.size(); i++){
+    if(key_position_[i] < 0){
+      fields.emplace_back(table_info_->GetSchema()->GetColumn(i)->GetType());
+    }
+    else{
+      fields.emplace_back(*key_.GetField(key_position_[i]));
     }
   }
-  else{
-    return false;
+}
+
+bool IndexScanExecutor::FetchTuple(Row *row) {
+  if(plan_->GetNeededColumns().empty()){
+    return table_info_->GetTableHeap()->GetTuple(row, exec_ctx_->GetTransaction());
   }
+  return table_info_->GetTableHeap()->GetTuple(row, plan_->GetNeededColumns(), exec_ctx_->GetTransaction());
+}
 
-  vector<Field> fields;
-  const Schema *schema = plan_->OutputSchema();
-  for(auto column: schema->GetColumns())
-    for(auto old_column: table_info->GetSchema()->GetColumns()){
-      if(column->GetName() == old_column->GetName())
-        fields.push_back(*new_row->GetField(old_column->GetTableInd()));
+bool IndexScanExecutor::Next(Row *row, RowId *rid){
+  RowId row_id;
+  while(true){
+    if(scan_ != nullptr){
+      bool found = plan_->index_only_ ? scan_->NextEntry(&row_id, &key_) : scan_->Next(&row_id);
+      if(!found){
+        // unpin the last index page before the executor is destroyed
+        scan_ = nullptr;
+        return false;
+      }
+    }
+    else{
+      if(cursor == result.size()) {
+        return false;
+      }
+      row_id = result[cursor++];
     }
-  *row = Row(fields);
-  *rid = RowId(new_row->GetRowId());
-  delete new_row;
-  cursor++;
-  return true;
+    // the fetched tuple only lives until its fields are copied out, keep it off the global heap
+    heap_.Reset();
+    Row new_row(row_id, &heap_);
+    if(plan_->index_only_){
+      RowFromKey(&new_row);
+    }
+    else if (!FetchTuple(&new_row)) {
+      return false;
+    }
+    if(plan_->need_filter_ && plan_->GetPredicate()->EvaluatePredicate(&new_row) != CmpBool::kTrue){
+      continue;
+    }
+
+    row->destroy();
+    for(auto id: column_map_)
+      row->AppendField(*new_row.GetField(id));
+    row->SetRowId(new_row.GetRowId());
+    *rid = new_row.GetRowId();
+    return true;
+  }
 }
@@ -23,10 +23,15 @@ bool InsertExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
     //find if has the duplicate key
     vector<IndexInfo *>indexes;
     if(exec_ctx_->GetCatalog()->GetTableIndexes(plan_->GetTableName(),indexes) == DB_SUCCESS){
-      //traverse the indexes
+      //traverse the unique indexes
       for(auto index: indexes){
+        if(!index->IsUnique()){
+          continue;
+        }
         vector<uint32_t>column_ids;
         vector<Column *>index_columns = index->GetIndexKeySchema()->GetColumns();
+        //the included columns take no part in the key
+        index_columns.resize(index->GetKeyColumnCount());
         //init the column id in the original table
         for(auto index_column: index_columns){
           uint32_t index_column_id;
@@ -39,7 +44,7 @@ bool InsertExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
         for(auto id: column_ids){
           fields.emplace_back(*insert_row.GetField(id));
         }
-        Row index_row(fields);
+        Row index_row(std::move(fields));
         vector<RowId> temp_result;
 
         //if find the duplicate key
@@ -76,7 +81,7 @@ bool InsertExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
         for(auto id: column_ids){
           fields.emplace_back(*insert_row.GetField(id));
         }
-        Row index_row(fields);
+        Row index_row(std::move(fields));
         index->GetIndex()->InsertEntry(index_row, insert_rid, exec_ctx_->GetTransaction());
       }
     }
@@ -4,6 +4,7 @@
 #include "executor/executors/seq_scan_executor.h"
 #include "planner/expressions/column_value_expression.h"
 #include "planner/expressions/comparison_expression.h"
+#include "record/column_dictionary.h"
 #include "algorithm"
 
 /**
@@ -13,45 +14,256 @@ SeqScanExecutor::SeqScanExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode
     : AbstractExecutor(exec_ctx),
       plan_(plan){}
 
+SeqScanExecutor::~SeqScanExecutor() {
+  StopParallelScan();
+}
+
 void SeqScanExecutor::Init() {
+  StopParallelScan();
   if(exec_ctx_->GetCatalog()->GetTable(plan_->GetTableName(), table_info) != DB_SUCCESS)
   {
     // LOG(WARNING) << "Get table name fail.";
     exit(1);
   }
-  iter = table_info->GetTableHeap()->Begin(exec_ctx_->GetTransaction());
+  column_map_.clear();
+  for(auto column: plan_->OutputSchema()->GetColumns())
+    for(auto old_column: table_info->GetSchema()->GetColumns())
+    {
+      if(column->GetName() == old_column->GetName())
+        column_map_.push_back(old_column->GetTableInd());
+    }
+  decoder_ = table_info->GetRowDecoder();
+  projected_decoder_.reset();
+  buffers_.columns_.reset();
+  if(decoder_ != nullptr)
+  {
+    if(!plan_->GetNeededColumns().empty())
+    {
+      projected_decoder_ = std::make_unique<RowDecoder>(table_info->GetSchema(), plan_->GetNeededColumns());
+      decoder_ = projected_decoder_.get();
+    }
+    buffers_.columns_ = std::make_unique<ColumnBatch>(table_info->GetSchema());
+  }
+  batch_.clear();
+  batch_heap_->Reset();
+  cursor_ = 0;
+  morsel_pages_.clear();
+  morsel_count_ = 0;
+  next_page_id_ = table_info->GetTableHeap()->GetFirstPageId();
+  for(auto &filter: plan_->GetDictionaryFilters())
+  {
+    if(filter.equal_ && filter.code_ == ColumnDictionary::INVALID_CODE)
+    {
+      // the constant is in no tuple, nothing qualifies
+      next_page_id_ = INVALID_PAGE_ID;
+      return;
+    }
+  }
+  if(exec_ctx_->GetParallelDegree() > 1 && exec_ctx_->GetWorkerPool() != nullptr)
+  {
+    StartParallelScan(exec_ctx_->GetParallelDegree(), exec_ctx_->GetWorkerPool());
+  }
 }
 
 bool SeqScanExecutor::Next(Row *row, RowId *rid) {
-  const Row &temp_row = *iter;
-  TableHeap *table_heap = table_info->GetTableHeap();
-  if(plan_->GetPredicate() != nullptr)
+  // refill the batch from the next morsel or the next page, each page is pinned once for all of its tuples
+  while(cursor_ == batch_.size())
   {
-    for(; iter != table_heap->End(); iter++)
+    batch_.clear();
+    batch_heap_->Reset();
+    cursor_ = 0;
+    if(next_morsel_ < morsel_count_)
     {
-      Field field = plan_->GetPredicate()->Evaluate(&temp_row);
-      if (field.CompareEquals(Field(kTypeInt, 1)))
+      std::unique_lock<std::mutex> lock(morsel_latch_);
+      MorselSlot &slot = morsel_slots_[next_morsel_ % MAX_PENDING_MORSELS];
+      morsel_cv_.wait(lock, [this, &slot] { return slot.ready_ || error_ != nullptr; });
+      if(error_ != nullptr)
       {
-        break;
+        std::rethrow_exception(error_);
       }
+      // the emptied batch and its heap go back to the slot for the morsel which reuses it
+      batch_.swap(slot.rows_);
+      batch_heap_.swap(slot.heap_);
+      slot.ready_ = false;
+      next_morsel_++;
+      morsel_cv_.notify_all();
+      continue;
+    }
+    if(next_page_id_ == INVALID_PAGE_ID)
+    {
+      return false;
     }
+    next_page_id_ = ScanPageInto(next_page_id_, batch_, batch_heap_.get(), &buffers_);
   }
+  // long char data stays in batch_heap_, so the row is only valid until the batch is refilled
+  *row = std::move(batch_[cursor_++]);
+  *rid = row->GetRowId();
+  return true;
+}
 
-  if(iter == table_heap->End())
+page_id_t SeqScanExecutor::ScanPageInto(page_id_t page_id, std::vector<Row> &out, ArenaHeap *heap,
+                                        ScanBuffers *buffers) {
+  return table_info->GetTableHeap()->ScanPage(page_id, [this, &out, heap, buffers](const vector<TupleView> &views) {
+    if(buffers->columns_ != nullptr)
+    {
+      DecodePageInto(views, out, heap, buffers);
+      return true;
+    }
+    for(auto &view: views)
+    {
+      if(!MatchDictionaryFilters(view))
+      {
+        continue;
+      }
+      Row temp_row(heap);
+      if(plan_->GetNeededColumns().empty())
+      {
+        view.Materialize(&temp_row);
+      }
+      else
+      {
+        view.Materialize(&temp_row, plan_->GetNeededColumns());
+      }
+      if(plan_->GetPredicate() != nullptr)
+      {
+        if(plan_->GetPredicate()->EvaluatePredicate(&temp_row) != CmpBool::kTrue)
+        {
+          continue;
+        }
+      }
+      out.emplace_back(view.GetRowId(), heap);
+      for(auto id: column_map_)
+      {
+        out.back().AppendField(*temp_row.GetField(id));
+      }
+    }
+    return true;
+  }, exec_ctx_->GetTransaction());
+}
+
+void SeqScanExecutor::DecodePageInto(const std::vector<TupleView> &views, std::vector<Row> &out, ArenaHeap *heap,
+                                     ScanBuffers *buffers) {
+  auto &tuples = buffers->tuples_;
+  auto &rids = buffers->rids_;
+  ColumnBatch *columns = buffers->columns_.get();
+  tuples.clear();
+  rids.clear();
+  for(auto &view: views)
   {
-    return false;
+    if(MatchDictionaryFilters(view))
+    {
+      tuples.push_back(view.GetData());
+      rids.push_back(view.GetRowId());
+    }
   }
-  vector<Field> fields;
-  const Schema *schema = plan_->OutputSchema();
-  for(auto column: schema->GetColumns())
-    for(auto old_column: table_info->GetSchema()->GetColumns())
+  // char values of the batch point into the page, which stays pinned until the callback returns
+  columns->Clear();
+  decoder_->Decode(tuples.data(), static_cast<uint32_t>(tuples.size()), columns);
+  for(uint32_t i = 0; i < columns->GetRowCount(); i++)
+  {
+    if(plan_->GetPredicate() != nullptr)
     {
-      if(column->GetName() == old_column->GetName())
-        fields.push_back(*temp_row.GetField(old_column->GetTableInd()));
+      // the predicate reads the batch in place, nothing is copied for a tuple which does not qualify
+      columns->View(i, &buffers->row_);
+      if(plan_->GetPredicate()->EvaluatePredicate(&buffers->row_) != CmpBool::kTrue)
+      {
+        continue;
+      }
     }
+    out.emplace_back(rids[i], heap);
+    for(auto id: column_map_)
+    {
+      out.back().AppendField(columns->GetField(id, i));
+    }
+  }
+}
 
-  *row = Row(fields);
-  *rid = RowId(temp_row.GetRowId());
-  iter++;
+bool SeqScanExecutor::MatchDictionaryFilters(const TupleView &view) const {
+  for(auto &filter: plan_->GetDictionaryFilters())
+  {
+    if(view.IsNull(filter.column_) || (view.GetCode(filter.column_) == filter.code_) != filter.equal_)
+    {
+      return false;
+    }
+  }
   return true;
 }
+
+void SeqScanExecutor::StartParallelScan(uint32_t parallel_degree, WorkerPool *pool) {
+  table_info->GetTableHeap()->GetPageIds(morsel_pages_);
+  size_t morsel_count = (morsel_pages_.size() + MORSEL_PAGES - 1) / MORSEL_PAGES;
+  if(morsel_count < 2)
+  {
+    // not worth a thread, leave it to the serial scan
+    morsel_pages_.clear();
+    return;
+  }
+  morsel_count_ = morsel_count;
+  morsel_slots_.resize(std::min(morsel_count, MAX_PENDING_MORSELS));
+  for(auto &slot: morsel_slots_)
+  {
+    slot.rows_.clear();
+    slot.heap_->Reset();
+    slot.ready_ = false;
+  }
+  next_morsel_ = 0;
+  claimed_morsels_ = 0;
+  cancelled_ = false;
+  error_ = nullptr;
+  next_page_id_ = INVALID_PAGE_ID;
+  uint32_t worker_count = static_cast<uint32_t>(std::min<size_t>(parallel_degree, morsel_count));
+  active_workers_ = worker_count;
+  for(uint32_t i = 0; i < worker_count; i++)
+  {
+    pool->Submit([this] { ScanMorsels(); });
+  }
+}
+
+void SeqScanExecutor::ScanMorsels() {
+  ScanBuffers buffers;
+  if(decoder_ != nullptr)
+  {
+    buffers.columns_ = std::make_unique<ColumnBatch>(table_info->GetSchema());
+  }
+  std::unique_lock<std::mutex> lock(morsel_latch_);
+  while(true)
+  {
+    // a morsel may only be claimed once the slot it reuses has been taken by Next
+    morsel_cv_.wait(lock, [this] {
+      return cancelled_ || claimed_morsels_ == morsel_count_ || claimed_morsels_ < next_morsel_ + MAX_PENDING_MORSELS;
+    });
+    if(cancelled_ || claimed_morsels_ == morsel_count_)
+    {
+      break;
+    }
+    size_t morsel = claimed_morsels_++;
+    MorselSlot &slot = morsel_slots_[morsel % MAX_PENDING_MORSELS];
+    lock.unlock();
+    try
+    {
+      size_t end = std::min(morsel_pages_.size(), (morsel + 1) * MORSEL_PAGES);
+      for(size_t i = morsel * MORSEL_PAGES; i < end; i++)
+      {
+        ScanPageInto(morsel_pages_[i], slot.rows_, slot.heap_.get(), &buffers);
+      }
+      lock.lock();
+      slot.ready_ = true;
+    }
+    catch(...)
+    {
+      lock.lock();
+      error_ = std::current_exception();
+      cancelled_ = true;
+    }
+    morsel_cv_.notify_all();
+  }
+  active_workers_--;
+  morsel_cv_.notify_all();
+}
+
+void SeqScanExecutor::StopParallelScan() {
+  std::unique_lock<std::mutex> lock(morsel_latch_);
+  cancelled_ = true;
+  morsel_cv_.notify_all();
+  morsel_cv_.wait(lock, [this] { return active_workers_ == 0; });
+}
@@ -14,13 +14,23 @@ UpdateExecutor::UpdateExecutor(ExecuteContext *exec_ctx, const UpdatePlanNode *p
 */
 void UpdateExecutor::Init() {
   child_executor_->Init();
+  //a grown tuple moves to a later page, where the scan would meet it again, so every target is read before updating
+  targets_.clear();
+  next_target_ = 0;
+  Row target{};
+  RowId target_rowid{};
+  while(child_executor_->Next(&target, &target_rowid))
+  {
+    targets_.push_back(target);
+    targets_.back().SetRowId(target_rowid);
+  }
 }
 
 bool UpdateExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
-  Row update_row{};
-  RowId update_rowid{};
-  if(child_executor_->Next(&update_row, &update_rowid))
+  if(next_target_ < targets_.size())
   {
+    const Row &update_row = targets_[next_target_++];
+    RowId update_rowid = update_row.GetRowId();
     Row new_row = GenerateUpdatedTuple(update_row);
     new_row.SetRowId(update_rowid);
 
@@ -34,11 +44,17 @@ bool UpdateExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
     vector<IndexInfo *>indexes;
     if(exec_ctx_->GetCatalog()->GetTableIndexes(plan_->GetTableName(),indexes) == DB_SUCCESS)
     {
-      //traverse the indexes
+      //traverse the unique indexes
       for(auto index: indexes)
       {
+        if(!index->IsUnique())
+        {
+          continue;
+        }
         vector<uint32_t>column_ids;
         vector<Column *>index_columns = index->GetIndexKeySchema()->GetColumns();
+        //the included columns take no part in the key
+        index_columns.resize(index->GetKeyColumnCount());
         //init the column ids in table
         for(auto index_column: index_columns)
         {
@@ -62,7 +78,7 @@ bool UpdateExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
         {
           continue;
         }
-        Row index_row(fields);
+        Row index_row(std::move(fields));
         vector<RowId> temp_result;
         //if find the duplicate key
         if(index->GetIndex()->ScanKey(index_row, temp_result, exec_ctx_->GetTransaction(), "=") == DB_SUCCESS)
@@ -73,7 +89,12 @@ bool UpdateExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
       }
     }
 
-    //if no duplicate key, we update the index
+    //if no duplicate key, we update the tuple, it may move to another page when it grows
+    if(!table_info->GetTableHeap()->UpdateTuple(new_row, update_rowid, exec_ctx_->GetTransaction()))
+    {
+      return false;
+    }
+    //the entries of the old key and rid move to the new key and rid
     if(!indexes.empty())
     {
       for(auto index: indexes)
@@ -89,19 +110,19 @@ bool UpdateExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
             column_ids.emplace_back(index_column_id);
           }
         }
-        //init the fields for index
+        vector<Field> old_fields;
         vector<Field> fields;
         for(auto id: column_ids)
         {
+          old_fields.emplace_back(*update_row.GetField(id));
           fields.emplace_back(*new_row.GetField(id));
         }
-        Row index_row(fields);
-        //if find the duplicate key
-        index->GetIndex()->RemoveEntry(index_row, new_row.GetRowId(), exec_ctx_->GetTransaction());
+        Row old_index_row(std::move(old_fields));
+        Row index_row(std::move(fields));
+        index->GetIndex()->RemoveEntry(old_index_row, update_rowid, exec_ctx_->GetTransaction());
         index->GetIndex()->InsertEntry(index_row, new_row.GetRowId(), exec_ctx_->GetTransaction());
       }
     }
-    table_info->GetTableHeap()->UpdateTuple(new_row, new_row.GetRowId(), exec_ctx_->GetTransaction());
 
     return true;
   }
@@ -136,6 +157,6 @@ Row UpdateExecutor::GenerateUpdatedTuple(const Row &src_row) {
   {
     // LOG(ERROR) << "Error generate tuple.";
   }
-  Row new_row(new_fields);
+  Row new_row(std::move(new_fields));
   return new_row;
 }
\ No newline at end of file
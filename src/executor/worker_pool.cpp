@@ -0,0 +1,42 @@
+#include "executor/worker_pool.h"
+
+WorkerPool::~WorkerPool() {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkerPool::Reserve(uint32_t thread_count) {
+  while (threads_.size() < thread_count) {
+    threads_.emplace_back(&WorkerPool::WorkerLoop, this);
+  }
+}
+
+void WorkerPool::Submit(std::function<void()> task) {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    tasks_.push_back(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+void WorkerPool::WorkerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
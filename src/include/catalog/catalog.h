@@ -79,15 +79,25 @@ class CatalogManager {
     return FlushCatalogMetaPage();
   }
 
-  dberr_t CreateTable(const std::string &table_name, TableSchema *schema, Transaction *txn, TableInfo *&table_info);
+  /**
+   * @param dictionary_columns char columns stored as codes of a per-column dictionary, see ColumnDictionary
+   */
+  dberr_t CreateTable(const std::string &table_name, TableSchema *schema, Transaction *txn, TableInfo *&table_info,
+                      TableLayout layout = TableLayout::kRow, const std::vector<uint32_t> &dictionary_columns = {});
 
   dberr_t GetTable(const std::string &table_name, TableInfo *&table_info);
 
   dberr_t GetTables(std::vector<TableInfo *> &tables) const;
 
+  /**
+   * @param unique whether the key identifies a row, a non unique index takes rows of equal keys
+   * @param include_columns columns stored in the entries after the key, so that a scan reading only them and the key
+   *        skips the table. Only a bptree index takes them
+   */
   dberr_t CreateIndex(const std::string &table_name, const std::string &index_name,
                       const std::vector<std::string> &index_keys, Transaction *txn, IndexInfo *&index_info,
-                      const string &index_type);
+                      const string &index_type, bool unique = true,
+                      const std::vector<std::string> &include_columns = {});
 
   dberr_t GetIndex(const std::string &table_name, const std::string &index_name, IndexInfo *&index_info) const;
 
@@ -97,15 +107,54 @@ class CatalogManager {
 
   dberr_t DropIndex(const std::string &table_name, const std::string &index_name);
 
+  /**
+   * Compact the table heap and repoint the index entries of every relocated tuple.
+   * Tuples are moved without taking row locks and there is no table lock to hold, so the caller must
+   * have exclusive access to the table: no other statement may read or write it until this returns.
+   * @param[out] freed_pages number of pages released by the compaction
+   */
+  dberr_t VacuumTable(const std::string &table_name, Transaction *txn, uint32_t &freed_pages);
+
  private:
   dberr_t DropTable(table_id_t table_id);
 
   dberr_t FlushCatalogMetaPage() const;
 
+  /**
+   * Rewrite the metadata page of every table whose dictionaries grew since it was written.
+   */
+  dberr_t FlushTableMetaPages();
+
+  /**
+   * Write the metadata of the table, dictionaries included, through to its page on disk.
+   */
+  dberr_t FlushTableMetaPage(table_id_t table_id);
+
+  /**
+   * Have the heap of the table write the metadata page as soon as an insert or update grows a dictionary.
+   */
+  void BindDictionaryWriter(TableInfo *table_info);
+
+  /**
+   * Rewrite the rows of a table created before the current row format, once, see TableHeap::UpgradeRows.
+   */
+  dberr_t UpgradeTable(TableInfo *table_info, Transaction *txn);
+
+  /**
+   * Move the index entries of every relocated tuple of the table from its old rid to its new one.
+   */
+  void RepointIndexes(TableInfo *table_info, const std::vector<std::pair<RowId, RowId>> &moved, Transaction *txn);
+
   dberr_t LoadTable(const table_id_t table_id, const page_id_t page_id);
 
   dberr_t LoadIndex(const index_id_t index_id, const page_id_t page_id);
 
+  /**
+   * Fill a new index with the key_map columns of every row of the table.
+   */
+  dberr_t BuildIndex(IndexInfo *index_info, TableInfo *table_info, const std::vector<uint32_t> &key_map,
+                     Transaction *txn);
+
   dberr_t GetTable(const table_id_t table_id, TableInfo *&table_info);
 
  private:
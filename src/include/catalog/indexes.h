@@ -8,14 +8,21 @@
 #include "common/rowid.h"
 #include "index/b_plus_tree_index.h"
 #include "index/generic_key.h"
+#include "index/hash_index.h"
 #include "record/schema.h"
 
 class IndexMetadata {
   friend class IndexInfo;
 
  public:
+  /**
+   * @param unique whether no two rows share a key, a non unique index keeps the key of a row with its row id
+   * @param key_count number of key columns at the front of key_map, the columns after them are included in the
+   *        entries without being part of the key, 0 if every column is a key column
+   */
   static IndexMetadata *Create(const index_id_t index_id, const std::string &index_name, const table_id_t table_id,
-                               const std::vector<uint32_t> &key_map, const std::string &index_type);
+                               const std::vector<uint32_t> &key_map, const std::string &index_type,
+                               bool unique = true, uint32_t key_count = 0);
 
   uint32_t SerializeTo(char *buf) const;
 
@@ -34,19 +41,31 @@ class IndexMetadata {
   inline index_id_t GetIndexId() const { return index_id_; }
 
   inline std::string GetIndexType() const { return index_type_; }
+
+  inline bool IsUnique() const { return unique_; }
+
+  /** @return number of key columns, the other columns of the key mapping are included columns */
+  inline uint32_t GetKeyColumnCount() const { return key_count_; }
  private:
   IndexMetadata() = delete;
 
   explicit IndexMetadata(const index_id_t index_id, const std::string &index_name, const table_id_t table_id,
-                         const std::vector<uint32_t> &key_map, const std::string &index_type);
+                         const std::vector<uint32_t> &key_map, const std::string &index_type, bool unique,
+                         uint32_t key_count);
 
  private:
   static constexpr uint32_t INDEX_METADATA_MAGIC_NUM = 344528;
+  /** metadata written with this magic number carries whether the index is unique after the index type */
+  static constexpr uint32_t INDEX_METADATA_UNIQUE_MAGIC_NUM = 344529;
+  /** metadata written with this magic number also carries the number of key columns after the unique flag */
+  static constexpr uint32_t INDEX_METADATA_INCLUDE_MAGIC_NUM = 344530;
   index_id_t index_id_;
   std::string index_name_;
   table_id_t table_id_;
   std::vector<uint32_t> key_map_; /** The mapping of index key to tuple key */
   std::string index_type_;
+  bool unique_;
+  uint32_t key_count_;
 };
 
 /**
@@ -80,6 +99,14 @@ class IndexInfo {
 
   std::string GetIndexType() { return meta_data_->GetIndexType(); }
 
+  bool IsUnique() const { return meta_data_->IsUnique(); }
+
+  /**
+   * @return number of key columns, the leading columns of the key schema. The columns after them are included
+   *         columns: they are stored in the entries for index-only scans, but neither order nor identify them
+   */
+  uint32_t GetKeyColumnCount() const { return meta_data_->GetKeyColumnCount(); }
+
   std::string GetIndexName() { return meta_data_->GetIndexName(); }
 
   IndexSchema *GetIndexKeySchema() { return key_schema_; }
@@ -4,6 +4,8 @@
 #include <memory>
 
 #include "glog/logging.h"
+#include "record/column_dictionary.h"
+#include "record/row_decoder.h"
 #include "record/schema.h"
 #include "storage/table_heap.h"
 
@@ -11,7 +13,12 @@ class TableMetadata {
   friend class TableInfo;
 
  public:
-  ~TableMetadata() { delete schema_; }
+  ~TableMetadata() {
+    delete schema_;
+    for (auto dictionary : dictionaries_) {
+      delete dictionary;
+    }
+  }
 
   uint32_t SerializeTo(char *buf) const;
 
@@ -21,9 +28,12 @@ class TableMetadata {
 
   /*
    * will create new table schema and owned by mem heap
+   * @param dictionaries one entry per column, the dictionary of a dictionary-encoded column or nullptr. The
+   * metadata takes them over and attaches them to schema.
    */
   static TableMetadata *Create(table_id_t table_id, std::string table_name, page_id_t root_page_id,
-                               TableSchema *schema);
+                               TableSchema *schema, TableLayout layout = TableLayout::kRow,
+                               std::vector<ColumnDictionary *> dictionaries = {});
 
   inline table_id_t GetTableId() const { return table_id_; }
 
@@ -33,19 +43,48 @@ class TableMetadata {
 
   inline Schema *GetSchema() const { return schema_; }
 
+  inline TableLayout GetLayout() const { return layout_; }
+
+  /**
+   * @return whether a dictionary grew since the metadata was last serialized
+   */
+  bool HasDirtyDictionary() const;
+
+  /**
+   * @return whether the metadata was written before the current row format, the heap may hold rows in the old one
+   */
+  inline bool HasLegacyRows() const { return legacy_rows_; }
+
+  inline void ClearLegacyRows() { legacy_rows_ = false; }
+
   std::vector<std::string> primary_key_;
 
  private:
   TableMetadata() = delete;
 
-  TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema);
+  TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema,
+                TableLayout layout, std::vector<ColumnDictionary *> dictionaries);
+
+  /**
+   * Share the space of the metadata page left by everything else among the dictionaries.
+   */
+  void AssignDictionaryBudgets();
 
  private:
   static constexpr uint32_t TABLE_METADATA_MAGIC_NUM = 344528;
+  /** metadata written with this magic number carries the page layout after the primary key */
+  static constexpr uint32_t TABLE_METADATA_LAYOUT_MAGIC_NUM = 344529;
+  /** metadata written with this magic number also carries the column dictionaries after the page layout */
+  static constexpr uint32_t TABLE_METADATA_DICTIONARY_MAGIC_NUM = 344530;
+  /** bytes of the metadata page kept free for later changes such as the primary key */
+  static constexpr uint32_t METADATA_PAGE_RESERVE = 256;
   table_id_t table_id_;
   std::string table_name_;
   page_id_t root_page_id_;
   Schema *schema_;
+  TableLayout layout_{TableLayout::kRow};
+  std::vector<ColumnDictionary *> dictionaries_; /** one per column, nullptr unless dictionary-encoded */
+  bool legacy_rows_{false};
 };
 
 /**
@@ -63,6 +102,9 @@ class TableInfo {
   void Init(TableMetadata *table_meta, TableHeap *table_heap) {
     table_meta_ = table_meta;
     table_heap_ = table_heap;
+    if (table_meta->GetLayout() == TableLayout::kRow) {
+      row_decoder_ = std::make_unique<RowDecoder>(table_meta->GetSchema());
+    }
   }
 
   inline TableHeap *GetTableHeap() const { return table_heap_; }
@@ -76,12 +118,18 @@ class TableInfo {
   inline page_id_t GetRootPageId() const { return table_meta_->root_page_id_; }
 
   inline TableMetadata *GetTableMetaData () const { return table_meta_; }
+
+  /**
+   * @return decoder of every column compiled when the table was loaded, nullptr for a PAX table
+   */
+  inline const RowDecoder *GetRowDecoder() const { return row_decoder_.get(); }
  private:
   explicit TableInfo(){};
 
  private:
   TableMetadata *table_meta_;
   TableHeap *table_heap_;
+  std::unique_ptr<RowDecoder> row_decoder_;
 };
 
 #endif  // MINISQL_TABLE_H
@@ -16,6 +16,9 @@ static constexpr int INDEX_ROOTS_PAGE_ID = 1;   // logical page id of the index
 static constexpr int PAGE_SIZE = 4096;                  // size of a data page in byte
 static constexpr int DEFAULT_BUFFER_POOL_SIZE = 65536;  // default size of buffer pool
 
+static constexpr double INDEX_FILL_FACTOR = 0.9;            // share of a page filled by an index bulk build
+static constexpr size_t INDEX_SORT_BUFFER_SIZE = 64 << 20;  // memory of the index build sort before spilling
+
 static constexpr uint32_t FIELD_NULL_LEN = UINT32_MAX;
 static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;  // max length of varchar
 
@@ -8,6 +8,7 @@
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/catalog.h"
 #include "common/macros.h"
+#include "executor/worker_pool.h"
 #include "transaction/transaction.h"
 
 class ExecuteContext {
@@ -33,6 +34,16 @@ class ExecuteContext {
 
   /** @return the buffer pool manager */
   BufferPoolManager *GetBufferPoolManager() { return bpm_; }
+
+  /** @return the number of worker threads a scan may use */
+  uint32_t GetParallelDegree() const { return parallel_degree_; }
+
+  void SetParallelDegree(uint32_t parallel_degree) { parallel_degree_ = parallel_degree; }
+
+  /** @return the threads a parallel scan runs on, nullptr if the query must be executed serially */
+  WorkerPool *GetWorkerPool() const { return worker_pool_; }
+
+  void SetWorkerPool(WorkerPool *worker_pool) { worker_pool_ = worker_pool; }
   bool flag_quit_{false};//added
  private:
   /** The transaction context associated with this executor context */
@@ -41,6 +52,10 @@ class ExecuteContext {
   CatalogManager *catalog_;
   /** The buffer pool manager associated with this executor context */
   BufferPoolManager *bpm_;
+  /** Degree of parallelism of the session which runs the query */
+  uint32_t parallel_degree_{1};
+  /** Threads of the engine that runs the query, owned by the engine */
+  WorkerPool *worker_pool_{nullptr};
 };
 
 #endif  // MINISQL_EXECUTE_CONTEXT_H
@@ -10,6 +10,7 @@
 #include "executor/execute_context.h"
 #include "executor/executors/abstract_executor.h"
 #include "executor/plans/abstract_plan.h"
+#include "executor/worker_pool.h"
 #include "record/row.h"
 #include "transaction/transaction.h"
 
@@ -73,10 +74,16 @@ class ExecuteEngine {
 
   dberr_t ExecuteQuit(pSyntaxNode ast, ExecuteContext *context);
 
+  dberr_t ExecuteVacuum(pSyntaxNode ast, ExecuteContext *context);
+
+  dberr_t ExecuteSetVariable(pSyntaxNode ast, ExecuteContext *context);
+
   void PrintLine(std::vector<uint32_t> &column_length);//added
  private:
   std::unordered_map<std::string, DBStorageEngine *> dbs_; /** all opened databases */
   std::string current_db_;                                 /** current database */
+  uint32_t parallel_degree_{1};                            /** scan threads of this session, SET parallel_degree */
+  WorkerPool worker_pool_;                                 /** threads of the parallel scans, kept across queries */
 };
 
 #endif  // MINISQL_EXECUTE_ENGINE_H
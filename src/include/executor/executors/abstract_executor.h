@@ -25,7 +25,8 @@ class AbstractExecutor {
   virtual void Init() = 0;
 
   /**
-   * Yield the next row from this executor.
+   * Yield the next row from this executor. The row may refer to storage of the executor, it is only valid until
+   * the next call and has to be copied to be kept.
    * @param[out] row The next row produced by this executor
    * @param[out] rid The next row RID produced by this executor
    * @return `true` if a row was produced, `false` if there are no more rows
@@ -40,9 +40,29 @@ class IndexScanExecutor : public AbstractExecutor {
 //    else return false;
 //  }
  private:
+  /**
+   * Read the tuple of row->GetRowId(), only the columns needed by the plan are decoded.
+   */
+  bool FetchTuple(Row *row);
+
+  /**
+   * Fill row with the columns of the key read last by an index-only scan, the other columns are null placeholders.
+   */
+  void RowFromKey(Row *row);
 
   /** The sequential scan plan node to be executed */
   const IndexScanPlanNode *plan_;
+  /** Scan of the key range of the plan, otherwise the row ids collected from the indexes */
+  std::unique_ptr<IndexScanCursor> scan_;
   vector<RowId> result;
   uint32_t cursor{0};
+  TableInfo *table_info_{nullptr};
+  /** Table column of every output column */
+  std::vector<uint32_t> column_map_;
+  /** Storage of the tuple fetched by Next */
+  ArenaHeap heap_;
+  /** Key of the entry read last by an index-only scan */
+  Row key_;
+  /** Position in the index key of every table column of an index-only scan, -1 if the index does not store it */
+  std::vector<int> key_position_;
 };
\ No newline at end of file
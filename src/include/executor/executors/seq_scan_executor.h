@@ -5,11 +5,16 @@
 #ifndef MINISQL_SEQ_SCAN_EXECUTOR_H
 #define MINISQL_SEQ_SCAN_EXECUTOR_H
 
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include "executor/execute_context.h"
 #include "executor/executors/abstract_executor.h"
 #include "executor/plans/seq_scan_plan.h"
+#include "record/row_decoder.h"
 
 /**
  * The SeqScanExecutor executor executes a sequential table scan.
@@ -23,11 +28,15 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   SeqScanExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode *plan);
 
+  /** Stop the workers of a parallel scan that was not read to the end */
+  ~SeqScanExecutor() override;
+
   /** Initialize the sequential scan */
   void Init() override;
 
   /**
-   * Yield the next row from the sequential scan.
+   * Yield the next row from the sequential scan. Long char values of the row are kept in the batch arena, the row
+   * is valid until the next call.
    * @param[out] row The next row produced by the scan
    * @param[out] rid The next row RID produced by the scan
    * @return `true` if a row was produced, `false` if there are no more rows
@@ -38,11 +47,98 @@ class SeqScanExecutor : public AbstractExecutor {
   const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
 
  private:
+  /** Scratch space of one scanning thread, reused from page to page */
+  struct ScanBuffers {
+    /** Columns decoded from the last scanned page, nullptr for a PAX table */
+    std::unique_ptr<ColumnBatch> columns_;
+    /** Tuples of the page which pass the dictionary filters, and their rids */
+    std::vector<const char *> tuples_;
+    std::vector<RowId> rids_;
+    /** Tuple the predicate is evaluated on, its fields refer to columns_ */
+    Row row_;
+  };
+
+  /**
+   * Evaluate the predicate on every tuple of a page and append the projected qualifying rows to out. The long char
+   * values of the rows of out are allocated from heap. Tuples of a row format table are first decoded into the
+   * columns of buffers. Safe to call from several threads at once as long as they use different heaps, batches
+   * and buffers.
+   * @return id of the next page in the chain
+   */
+  page_id_t ScanPageInto(page_id_t page_id, std::vector<Row> &out, ArenaHeap *heap, ScanBuffers *buffers);
+
+  /**
+   * Append the qualifying rows among the tuples of a row format page to out, see ScanPageInto. Only the rows which
+   * pass the predicate are materialized.
+   */
+  void DecodePageInto(const std::vector<TupleView> &views, std::vector<Row> &out, ArenaHeap *heap,
+                      ScanBuffers *buffers);
+
+  /**
+   * @return whether the codes stored in view satisfy every dictionary filter of the plan
+   */
+  bool MatchDictionaryFilters(const TupleView &view) const;
+
+  /**
+   * Split the page list into morsels and start parallel_degree workers of the pool on them. Next takes the morsel
+   * batches in page order as they are finished, so the output order is the same as the one of the serial scan.
+   */
+  void StartParallelScan(uint32_t parallel_degree, WorkerPool *pool);
+
+  /**
+   * Scan morsels until there is none left or the scan is stopped, run by each worker of a parallel scan.
+   */
+  void ScanMorsels();
+
+  /**
+   * Cancel the morsels nobody has started and wait until every worker has returned.
+   */
+  void StopParallelScan();
+
+  /** Pages per morsel handed to a parallel scan worker */
+  static constexpr size_t MORSEL_PAGES = 4;
+  /** Morsels a parallel scan may have scanned ahead of Next, bounds the rows held in memory */
+  static constexpr size_t MAX_PENDING_MORSELS = 8;
+
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
 
-  TableIterator iter = TableIterator(nullptr, RowId(), nullptr);
   TableInfo *table_info = nullptr;
+  /** Table column of every output column */
+  std::vector<uint32_t> column_map_;
+  /** Decoder of the needed columns of a row format table, nullptr for a PAX table */
+  const RowDecoder *decoder_{nullptr};
+  /** Decoder compiled for this scan when it does not need every column */
+  std::unique_ptr<RowDecoder> projected_decoder_;
+  /** Scratch space of the serial scan */
+  ScanBuffers buffers_;
+  /** Qualifying rows of the last scanned page, already projected */
+  std::vector<Row> batch_;
+  /** Storage of the tuples decoded for batch_, released in bulk once the batch is consumed */
+  std::unique_ptr<ArenaHeap> batch_heap_{std::make_unique<ArenaHeap>()};
+  size_t cursor_{0};
+  /** Next page to scan, the table is read one page at a time */
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  /** Batch of a morsel of a parallel scan, a slot is reused by every MAX_PENDING_MORSELS-th morsel */
+  struct MorselSlot {
+    std::vector<Row> rows_;
+    std::unique_ptr<ArenaHeap> heap_{std::make_unique<ArenaHeap>()};
+    bool ready_{false};
+  };
+  /** Pages of a parallel scan, empty for a serial scan */
+  std::vector<page_id_t> morsel_pages_;
+  size_t morsel_count_{0};
+  /** Bounded queue of finished morsels, morsel m goes to slot m % MAX_PENDING_MORSELS */
+  std::vector<MorselSlot> morsel_slots_;
+  /** Next morsel handed to Next and next morsel handed to a worker */
+  size_t next_morsel_{0};
+  size_t claimed_morsels_{0};
+  uint32_t active_workers_{0};
+  bool cancelled_{false};
+  std::exception_ptr error_{nullptr};
+  /** Protects the state of the parallel scan above */
+  std::mutex morsel_latch_;
+  std::condition_variable morsel_cv_;
 };
 
 #endif  // MINISQL_SEQ_SCAN_EXECUTOR_H
@@ -57,6 +57,10 @@ class UpdateExecutor : public AbstractExecutor {
   std::vector<IndexInfo *> index_info_;
   /** The child executor to obtain value from */
   std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The rows to update with their rids, all read from the child in Init */
+  std::vector<Row> targets_;
+  /** Index of the next row of targets_ to update */
+  size_t next_target_{0};
 };
 
 #endif  // MINISQL_UPDATE_EXECUTOR_H
@@ -7,6 +7,18 @@
 #include "catalog/catalog.h"
 #include "planner/expressions/abstract_expression.h"
 
+/**
+ * Key range read from one index by an index scan. A bound holds the values of the first key columns, a bound without
+ * fields leaves its end of the range open.
+ */
+struct IndexScanRange {
+  IndexInfo *index_{nullptr};
+  std::vector<Field> lower_;
+  std::vector<Field> upper_;
+  bool lower_inclusive_{true};
+  bool upper_inclusive_{true};
+};
+
 /**
  * IndexScanPlanNode identifies a table that should be scanned with an optional predicate.
  */
@@ -16,14 +28,22 @@ class IndexScanPlanNode : public AbstractPlanNode {
    * Creates a new index scan plan node.
    * @param output the output format of this scan plan node
    * @param table_name The identifier of table to be scanned
+   * @param needed_columns Table columns read by the output and the predicate, empty to read every column
+   * @param range Key range the rows are read from, without an index the row ids of the indexes are intersected
+   * @param index_only Whether the needed columns are all in the entries of the range index, the rows are then built
+   *        from its keys and the table is not read
    */
   IndexScanPlanNode(const Schema *output, std::string table_name, std::vector<IndexInfo *> indexes, bool need_filter,
-                    AbstractExpressionRef filter_predicate = nullptr)
+                    AbstractExpressionRef filter_predicate = nullptr, std::vector<uint32_t> needed_columns = {},
+                    IndexScanRange range = {}, bool index_only = false)
       : AbstractPlanNode(output, {}),
         table_name_(std::move(table_name)),
         indexes_(std::move(indexes)),
         need_filter_(need_filter),
-        filter_predicate_(std::move(filter_predicate)) {}
+        filter_predicate_(std::move(filter_predicate)),
+        needed_columns_(std::move(needed_columns)),
+        range_(std::move(range)),
+        index_only_(index_only) {}
 
   /** @return The type of the plan node */
   PlanType GetType() const override { return PlanType::IndexScan; }
@@ -33,6 +53,8 @@ class IndexScanPlanNode : public AbstractPlanNode {
 
   AbstractExpressionRef GetPredicate() const { return filter_predicate_; }
 
+  const std::vector<uint32_t> &GetNeededColumns() const { return needed_columns_; }
+
   /** The table name */
   std::string table_name_;
 
@@ -44,4 +66,13 @@ class IndexScanPlanNode : public AbstractPlanNode {
 
   /** The predicate to filter in IndexScan.*/
   AbstractExpressionRef filter_predicate_;
+
+  /** Ascending table columns to decode, the other columns of a fetched row are null placeholders.*/
+  std::vector<uint32_t> needed_columns_;
+
+  /** The key range of a single index read by the scan.*/
+  IndexScanRange range_;
+
+  /** Whether the rows are built from the entries of the range index alone.*/
+  bool index_only_ = false;
 };
\ No newline at end of file
@@ -9,17 +9,34 @@
 #include "catalog/catalog.h"
 #include "planner/expressions/abstract_expression.h"
 
+/**
+ * column = constant or column <> constant on a dictionary-encoded column, decided on the code stored in the tuple
+ * before the tuple is decoded. A null value never qualifies.
+ */
+struct DictionaryFilter {
+  uint32_t column_;
+  /** code of the constant, ColumnDictionary::INVALID_CODE if the constant is not in the dictionary */
+  uint16_t code_;
+  /** true for =, false for <> */
+  bool equal_;
+};
+
 class SeqScanPlanNode : public AbstractPlanNode {
  public:
   /**
    * Construct a new SeqScanPlanNode instance.
    * @param output The output schema of this sequential scan plan node
    * @param table_name The identifier of table to be scanned
+   * @param needed_columns Table columns read by the output and the predicate, empty to read every column
+   * @param dictionary_filters Conjuncts of the WHERE clause taken out of filter_predicate, see DictionaryFilter
    */
-  SeqScanPlanNode(const Schema *output, std::string table_name, AbstractExpressionRef filter_predicate = nullptr)
+  SeqScanPlanNode(const Schema *output, std::string table_name, AbstractExpressionRef filter_predicate = nullptr,
+                  std::vector<uint32_t> needed_columns = {}, std::vector<DictionaryFilter> dictionary_filters = {})
       : AbstractPlanNode(output, {}),
         table_name_(std::move(table_name)),
-        filter_predicate_(std::move(filter_predicate)) {}
+        filter_predicate_(std::move(filter_predicate)),
+        needed_columns_(std::move(needed_columns)),
+        dictionary_filters_(std::move(dictionary_filters)) {}
 
   /** @return The type of the plan node */
   PlanType GetType() const override { return PlanType::SeqScan; }
@@ -29,11 +46,21 @@ class SeqScanPlanNode : public AbstractPlanNode {
 
   AbstractExpressionRef GetPredicate() const { return filter_predicate_; }
 
+  const std::vector<uint32_t> &GetNeededColumns() const { return needed_columns_; }
+
+  const std::vector<DictionaryFilter> &GetDictionaryFilters() const { return dictionary_filters_; }
+
   /** The table name */
   std::string table_name_;
 
   /** The predicate to filter in SeqScan.*/
   AbstractExpressionRef filter_predicate_;
+
+  /** Ascending table columns to decode, the other columns of a scanned row are null placeholders.*/
+  std::vector<uint32_t> needed_columns_;
+
+  /** Checked on every tuple before filter_predicate_, all of them have to hold.*/
+  std::vector<DictionaryFilter> dictionary_filters_;
 };
 
 #endif  // MINISQL_SEQ_SCAN_PLAN_H
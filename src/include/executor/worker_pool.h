@@ -0,0 +1,50 @@
+#ifndef MINISQL_WORKER_POOL_H
+#define MINISQL_WORKER_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/macros.h"
+
+/**
+ * Threads kept alive across queries to run the tasks of parallel scans, so a scan does not pay for starting its
+ * workers. Tasks run in submission order on whichever thread is free.
+ */
+class WorkerPool {
+ public:
+  WorkerPool() = default;
+
+  /**
+   * Stop the threads once the queued tasks have run
+   */
+  ~WorkerPool();
+
+  DISALLOW_COPY_AND_MOVE(WorkerPool);
+
+  /**
+   * Start threads until the pool has at least thread_count of them, the pool never shrinks
+   */
+  void Reserve(uint32_t thread_count);
+
+  /**
+   * Queue task for the next free thread
+   */
+  void Submit(std::function<void()> task);
+
+  inline uint32_t GetThreadCount() const { return static_cast<uint32_t>(threads_.size()); }
+
+ private:
+  void WorkerLoop();
+
+  std::vector<std::thread> threads_;
+  std::deque<std::function<void()>> tasks_;
+  std::mutex latch_;
+  std::condition_variable cv_;
+  bool stop_{false};
+};
+
+#endif  // MINISQL_WORKER_POOL_H
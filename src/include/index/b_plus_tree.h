@@ -1,11 +1,14 @@
 #ifndef MINISQL_B_PLUS_TREE_H
 #define MINISQL_B_PLUS_TREE_H
 
+#include <mutex>
 #include <queue>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 
 #include "index/index_iterator.h"
+#include "index/key_sorter.h"
 #include "page/b_plus_tree_internal_page.h"
 #include "page/b_plus_tree_leaf_page.h"
 #include "page/b_plus_tree_page.h"
@@ -19,6 +22,15 @@
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ * (5) Nodes keep their keys in a contiguous array, searched as 64 bit integers for packed keys
+ *     (see index/key_search.h). Max sizes left undefined fill a page with keys of the key size. A leaf stores the
+ *     prefix its keys share once (see page/b_plus_tree_leaf_page.h), so it takes more pairs of keys sharing more
+ *     bytes, and leaves of keys sharing few bytes may stay below their min size when neither can take the other's
+ *     pairs.
+ * (6) Thread safe with latch crabbing. Lookups read latch down the tree. Inserts and removes first try an
+ *     optimistic pass which read latches the internal pages and write latches only the leaf; when the leaf would
+ *     split or underflow they restart with a pessimistic pass which keeps the unsafe pages of the path write latched.
+ * (7) An empty tree is built bottom up from sorted entries by BulkLoad.
  */
 class BPlusTree {
   using InternalPage = BPlusTreeInternalPage;
@@ -26,7 +38,10 @@ class BPlusTree {
 
  public:
   explicit BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager, const KeyManager &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = UNDEFINED_SIZE, int internal_max_size = UNDEFINED_SIZE);
+
+  /** Delete the freed pages readers kept pinned until the last write */
+  ~BPlusTree() { DeleteFreedPages(nullptr); }
 
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
@@ -37,6 +52,13 @@ class BPlusTree {
   // Remove a key and its value from this B+ tree.
   void Remove(const GenericKey *key, Transaction *transaction = nullptr);
 
+  /**
+   * Build the tree bottom up from the sorted entries of sorter. The leaves are written left to right, each filled to
+   * fill_factor of its max size, then each internal level is built over the first keys of the level below. A tree
+   * which is not empty inserts the entries one by one.
+   */
+  void BulkLoad(KeySorter *sorter, double fill_factor = INDEX_FILL_FACTOR, Transaction *transaction = nullptr);
+
   // return the value associated with a given key
   bool GetValue(const GenericKey *key, std::vector<RowId> &result, Transaction *transaction = nullptr);
 
@@ -46,13 +68,19 @@ class BPlusTree {
 
   IndexIterator End();
 
-  // expose for test purpose
+  // expose for test purpose, the pages are not latched
   Page *FindLeafPage(const GenericKey *key, page_id_t page_id = INVALID_PAGE_ID, bool leftMost = false);
 
-  // used to check whether all pages are unpinned
+  /**
+   * Used to check whether all pages are unpinned, and that every page freed by a write could be deleted. Deletes the
+   * freed pages which were still pinned by a reader when their write released them.
+   */
   bool Check();
 
-  // destroy the b plus tree
+  /**
+   * Delete every page below and including current_page_id, by default every page of the tree and its record in the
+   * index roots page. The pages are freed directly, each internal page is read once and the leaves are not read.
+   */
   void Destroy(page_id_t current_page_id = INVALID_PAGE_ID);
 
   void PrintTree(std::ofstream &out) {
@@ -68,29 +96,90 @@ class BPlusTree {
   }
 
  private:
+  enum class Operation { kRead, kInsert, kRemove };
+
+  /**
+   * Pages write latched by a pessimistic insert or remove from the highest unsafe page down to the leaf, and the
+   * pages it frees once they are released.
+   */
+  struct WriteContext {
+    bool root_latched_{false};
+    std::vector<Page *> latched_;
+    std::vector<page_id_t> deleted_;
+  };
+
+  /**
+   * Descend with read latches, the leaf is read latched for kRead and write latched otherwise.
+   * @return the pinned and latched leaf, nullptr if the tree is empty
+   */
+  Page *LatchLeafPage(const GenericKey *key, Operation op, bool leftMost = false);
+
+  /**
+   * Descend with write latches, keeping the latches of a page until a safe page is below it. The caller holds the
+   * root latch exclusively and the tree is not empty.
+   * @return the leaf, the last latched page of context
+   */
+  Page *LatchPathToLeaf(const GenericKey *key, Operation op, WriteContext *context);
+
+  /** @return true if op of key on a page below node can not change node */
+  static bool IsSafe(BPlusTreePage *node, Operation op, const GenericKey *key);
+
+  /** unlatch the pages above the last latched one, and the root latch */
+  void ReleaseAncestors(WriteContext *context);
+
+  /** unlatch every page of context, then delete the freed pages */
+  void ReleaseWriteContext(WriteContext *context);
+
+  /**
+   * Delete the pages in freed (may be nullptr) and the ones left by earlier writes. A reader which fetched a page
+   * before it was freed keeps it pinned for a while, such a page is kept in pending_deletes_ for the next call.
+   * @return number of pages still waiting to be deleted
+   */
+  size_t DeleteFreedPages(std::vector<page_id_t> *freed);
+
+  /** @return number of entries a bulk build puts in a page of max_size, at least its min size */
+  static int FillSize(int max_size, bool leaf, double fill_factor);
+
+  /**
+   * Build the internal pages over children, keys[i] is the first key below children[i]. Both are replaced by the
+   * first keys and the pages of the new level.
+   */
+  void BuildInternalLevel(std::vector<char> *keys, std::vector<page_id_t> *children, double fill_factor);
+
   void StartNewTree(GenericKey *key, const RowId &value);
 
-  bool InsertIntoLeaf(GenericKey *key, const RowId &value, Transaction *transaction = nullptr);
+  bool InsertIntoLeaf(LeafPage *leaf, GenericKey *key, const RowId &value, Transaction *transaction = nullptr);
 
   void InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlusTreePage *new_node,
                         Transaction *transaction = nullptr);
 
-  LeafPage *Split(LeafPage *node, Transaction *transaction);
+  /** move the pairs of node from index on to a new leaf after it */
+  LeafPage *Split(LeafPage *node, int index, Transaction *transaction);
 
   InternalPage *Split(InternalPage *node, Transaction *transaction);
 
   template <typename N>
-  bool CoalesceOrRedistribute(N *&node, Transaction *transaction = nullptr);
+  bool CoalesceOrRedistribute(N *&node, WriteContext *context);
 
   bool Coalesce(InternalPage *&neighbor_node, InternalPage *&node, InternalPage *&parent, int index,
-                Transaction *transaction = nullptr);
+                WriteContext *context);
+
+  bool Coalesce(LeafPage *&neighbor_node, LeafPage *&node, InternalPage *&parent, int index, WriteContext *context);
+
+  /** @return true if right, the page after left, can be merged into left */
+  bool CanCoalesce(LeafPage *left, LeafPage *right);
+
+  bool CanCoalesce(InternalPage *left, InternalPage *right);
+
+  /** @return true if node can take a pair of neighbor_node, which stays at its min size or above */
+  bool CanRedistribute(LeafPage *neighbor_node, LeafPage *node, int index);
 
-  bool Coalesce(LeafPage *&neighbor_node, LeafPage *&node, InternalPage *&parent, int index,
-                Transaction *transaction = nullptr);
+  /** Always true, internal pages hold a fixed number of pairs and a neighbor too full to merge has one to spare */
+  bool CanRedistribute(InternalPage *neighbor_node, InternalPage *node, int index);
 
-  void Redistribute(LeafPage *neighbor_node, LeafPage *node, int index);
+  void Redistribute(LeafPage *neighbor_node, LeafPage *node, InternalPage *parent, int index);
 
-  void Redistribute(InternalPage *neighbor_node, InternalPage *node, int index);
+  void Redistribute(InternalPage *neighbor_node, InternalPage *node, InternalPage *parent, int index);
 
   bool AdjustRoot(BPlusTreePage *node);
 
@@ -104,10 +193,15 @@ class BPlusTree {
   // member variable
   index_id_t index_id_;
   page_id_t root_page_id_{INVALID_PAGE_ID};
+  // guards root_page_id_, held until the root is latched or known to stay the root
+  std::shared_mutex root_latch_;
   BufferPoolManager *buffer_pool_manager_;
   KeyManager processor_;
   int leaf_max_size_;
   int internal_max_size_;
+  /** freed pages a reader still had pinned when they were deleted, guarded by pending_latch_ */
+  std::vector<page_id_t> pending_deletes_;
+  std::mutex pending_latch_;
 };
 
 #endif  // MINISQL_B_PLUS_TREE_H
@@ -5,24 +5,44 @@
 #include "index/generic_key.h"
 #include "index/index.h"
 
+/**
+ * Index of a B+ tree. The tree keeps unique keys, so the key of a non unique index is followed by the row id (see
+ * KeyManager), and a lookup of a key reads the leaves holding the keys of every row id.
+ */
 class BPlusTreeIndex : public Index {
  public:
-  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size, BufferPoolManager *buffer_pool_manager);
+  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size, BufferPoolManager *buffer_pool_manager,
+                 bool unique = true);
 
   dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
 
   dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) override;
 
+  /**
+   * Collect the row ids of the keys which compare to key by compare_operator, one of =, <>, <, <=, > and >=.
+   */
   dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn, string compare_operator = "=") override;
 
+  std::unique_ptr<IndexScanCursor> Scan(const Row *lower, const Row *upper, bool lower_inclusive = true,
+                                        bool upper_inclusive = true, Transaction *txn = nullptr) override;
+
   dberr_t Destroy() override;
 
+  /**
+   * Sort the entries by key, spilling sorted runs to disk past INDEX_SORT_BUFFER_SIZE, then bulk load the tree.
+   */
+  dberr_t BuildFrom(const EntrySource &next, Transaction *txn) override;
+
   IndexIterator GetBeginIterator();
 
   IndexIterator GetBeginIterator(GenericKey *key);
 
   IndexIterator GetEndIterator();
 
+ private:
+  /** serialize key, followed by row_id in a non unique index */
+  void SerializeKey(GenericKey *index_key, const Row &key, const RowId &row_id) const;
+
  protected:
   // comparator for key
   KeyManager processor_;
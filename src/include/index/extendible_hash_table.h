@@ -0,0 +1,113 @@
+#ifndef MINISQL_EXTENDIBLE_HASH_TABLE_H
+#define MINISQL_EXTENDIBLE_HASH_TABLE_H
+
+#include <functional>
+#include <shared_mutex>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "index/generic_key.h"
+#include "page/hash_table_bucket_page.h"
+#include "page/hash_table_directory_page.h"
+
+/**
+ * Disk based extendible hash table of (key, RowId) pairs, every page lives in the buffer pool.
+ *
+ * (1) A lookup reads the directory page, then the bucket page of the key, whatever the number of keys.
+ * (2) A full bucket is split in two by one more bit of the hash, the directory doubles when the bucket was held by a
+ *     single slot. The pairs a split can not tell apart, all of the same hash, go to an overflow page instead.
+ * (3) An emptied bucket is merged with its split image and the directory halves once no bucket needs every slot.
+ * (4) A unique table keeps one pair per key, otherwise one pair per (key, RowId).
+ * (5) Lookups share the table latch, inserts and removes take it exclusively.
+ * (6) The directory is created by the first insert and its page id is kept in the index roots page.
+ */
+class ExtendibleHashTable {
+  using DirectoryPage = HashTableDirectoryPage;
+  using BucketPage = HashTableBucketPage;
+
+ public:
+  using Visitor = std::function<void(const GenericKey *key, const RowId &value)>;
+
+  ExtendibleHashTable(index_id_t index_id, BufferPoolManager *buffer_pool_manager, const KeyManager &KM,
+                      bool unique = true);
+
+  bool IsEmpty() const;
+
+  /**
+   * @return false if the key, or the pair in a non unique table, is already in the table
+   */
+  bool Insert(const GenericKey *key, const RowId &value);
+
+  /**
+   * Remove the pair of key, in a non unique table the pair of key and value.
+   * @return false if there is none
+   */
+  bool Remove(const GenericKey *key, const RowId &value);
+
+  bool GetValue(const GenericKey *key, std::vector<RowId> &result);
+
+  /**
+   * Call visit on every pair, in no order.
+   */
+  void ForEach(const Visitor &visit);
+
+  /**
+   * Delete every page of the table and its record in the index roots page.
+   */
+  void Destroy();
+
+  uint32_t GetGlobalDepth();
+
+  /** @return hash of the key bytes, the low bits pick the directory slot */
+  uint32_t Hash(const GenericKey *key) const;
+
+ private:
+  void StartNewTable();
+
+  DirectoryPage *FetchDirectory();
+
+  /** @return a new empty bucket, pinned */
+  BucketPage *NewBucket(page_id_t *page_id);
+
+  /** @return true if the pair matches key, and value in a non unique table */
+  bool Matches(const GenericKey *lhs, const RowId &lhs_value, const GenericKey *rhs, const RowId &rhs_value) const;
+
+  /** @return true if a pair of the chain starting at page_id matches key and value */
+  bool ChainContains(page_id_t page_id, const GenericKey *key, const RowId &value);
+
+  /**
+   * Append the pair to the first page of the chain with room, a full chain only grows if overflow is set.
+   * @return false if the chain is full
+   */
+  bool ChainAppend(page_id_t page_id, const GenericKey *key, const RowId &value, bool overflow);
+
+  /** @return true if every pair of the chain has the hash */
+  bool ChainSharesHash(page_id_t page_id, uint32_t hash);
+
+  /** @return true if the chain has no pair */
+  bool ChainIsEmpty(page_id_t page_id);
+
+  /** delete the pages of the chain */
+  void DeleteChain(page_id_t page_id);
+
+  /**
+   * Split the bucket of slot bucket_idx by the next bit of the hash, doubling the directory if needed.
+   */
+  void SplitBucket(DirectoryPage *directory, uint32_t bucket_idx);
+
+  /**
+   * Merge the empty bucket of slot bucket_idx with its split images while they have its local depth.
+   */
+  void MergeBucket(DirectoryPage *directory, uint32_t bucket_idx);
+
+  void UpdateDirectoryPageId(bool insert_record);
+
+  index_id_t index_id_;
+  page_id_t directory_page_id_{INVALID_PAGE_ID};
+  BufferPoolManager *buffer_pool_manager_;
+  KeyManager processor_;
+  bool unique_;
+  std::shared_mutex latch_;
+};
+
+#endif  // MINISQL_EXTENDIBLE_HASH_TABLE_H
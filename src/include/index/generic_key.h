@@ -11,64 +11,104 @@ class GenericKey {
   char data[0];
 };
 
+/**
+ * Keys are stored in a memcomparable encoding: comparing two encoded keys with memcmp gives the order of the key
+ * rows, so the index never decodes a key to compare it.
+ *
+ *  Key format, one entry per key column, every entry has a fixed width:
+ *  -----------------------------------------
+ *  | Null flag (1) | Value (column width) |
+ *  -----------------------------------------
+ *  The null flag is 0 for null (nulls sort first, the value bytes are zero) and 1 otherwise.
+ *  int: big-endian with the sign bit flipped.
+ *  float: big-endian bits, the sign bit flipped for positive values and every bit flipped for negative values.
+ *  char(n): the value padded with zero bytes to n bytes, then its length as big-endian uint16. A value and the same
+ *  value followed by zero bytes only differ in their length, which keeps the shorter one first.
+ *  The key of a non unique index ends with the row id, page id then slot number as big-endian uint32 with the sign
+ *  bit of the page id flipped. The key is then unique, and keys of equal columns are ordered by row id.
+ *  The bytes after the last entry up to the key size are zero.
+ */
 class KeyManager {
  public: /**/
   [[nodiscard]] inline GenericKey *InitKey() const {
     return (GenericKey *)malloc(key_size_);  // remember delete
   }
 
-  inline void SerializeFromKey(GenericKey *key_buf, const Row &key, Schema *schema) const {
-    // initialize to 0
-    [[maybe_unused]] uint32_t size = key.GetSerializedSize(schema);
-    ASSERT(key.GetFieldCount() == schema->GetColumnCount(), "field nums not match.");
-    ASSERT(size <= (uint32_t)key_size_, "Index key size exceed max key size.");
-    memset(key_buf->data, 0, key_size_);
-    key.SerializeTo(key_buf->data, schema);
-  }
+  void SerializeFromKey(GenericKey *key_buf, const Row &key, Schema *schema) const;
 
-  inline void DeserializeToKey(const GenericKey *key_buf, Row &key, Schema *schema) const {
-    [[maybe_unused]] uint32_t ofs = key.DeserializeFrom(const_cast<char *>(key_buf->data), schema);
-    ASSERT(ofs <= (uint32_t)key_size_, "Index key size exceed max key size.");
-  }
+  void DeserializeToKey(const GenericKey *key_buf, Row &key, Schema *schema) const;
+
+  /**
+   * Write the row id suffix of a key serialized by SerializeFromKey.
+   */
+  void SetRowIdSuffix(GenericKey *key_buf, const RowId &row_id) const;
+
+  /**
+   * Serialize the smallest or the largest key starting with prefix, the values of the first key columns. Every key of
+   * a row matching prefix, whatever its other columns and row id, orders between the two bounds.
+   *
+   * A char value longer than its key column equals no stored key. It is cut to the column length and the bound is
+   * placed after every key starting with the cut prefix, whether largest is set or not: the keys before the bound
+   * order before the value, the keys after it order after the value.
+   * @return whether a value was cut, the bound then lies between two keys and must not be taken in itself
+   */
+  bool SerializeBound(GenericKey *key_buf, const Row &prefix, Schema *schema, bool largest) const;
+
+  /**
+   * @return false if a char value of key is longer than its key column, such a key equals no stored key
+   */
+  bool FitsKey(const Row &key, Schema *schema) const;
+
+  inline bool HasRowIdSuffix() const { return row_id_suffix_; }
 
-  // compare
+  // compare, the encoded keys are ordered like the key rows
   [[nodiscard]] inline int CompareKeys(const GenericKey *lhs, const GenericKey *rhs) const {
-    //    ASSERT(malloc_usable_size((void *)&lhs) == malloc_usable_size((void *)&rhs), "key size not match.");
-    uint32_t column_count = key_schema_->GetColumnCount();
-    Row lhs_key(INVALID_ROWID);
-    Row rhs_key(INVALID_ROWID);
-    DeserializeToKey(lhs, lhs_key, key_schema_);
-    DeserializeToKey(rhs, rhs_key, key_schema_);
-
-    for (uint32_t i = 0; i < column_count; i++) {
-      Field *lhs_value = lhs_key.GetField(i);
-      Field *rhs_value = rhs_key.GetField(i);
-
-      if (lhs_value->CompareLessThan(*rhs_value) == CmpBool::kTrue) {
-        return -1;
-      }
-
-      if (lhs_value->CompareGreaterThan(*rhs_value) == CmpBool::kTrue) {
-        return 1;
-      }
-    }
-    // equals
-    return 0;
+    return memcmp(lhs->data, rhs->data, encoded_size_);
   }
 
   inline int GetKeySize() const { return key_size_; }
 
+  /**
+   * Packed keys take 8 bytes, e.g. a single int or float column, and are compared as big-endian 64 bit integers by
+   * the node search (see index/key_search.h).
+   */
+  inline bool IsPacked() const { return key_size_ == sizeof(uint64_t); }
+
+  /**
+   * @return bytes taken by the encoding of a key of key_schema
+   */
+  static uint32_t GetEncodedSize(const Schema *key_schema);
+
   KeyManager(const KeyManager &other) {
     this->key_schema_ = other.key_schema_;
     this->key_size_ = other.key_size_;
+    this->encoded_size_ = other.encoded_size_;
+    this->row_id_suffix_ = other.row_id_suffix_;
   }
 
   // constructor
-  KeyManager(Schema *key_schema, size_t key_size) : key_size_(key_size), key_schema_(key_schema) {}
+  KeyManager(Schema *key_schema, size_t key_size, bool row_id_suffix = false)
+      : key_size_(key_size),
+        key_schema_(key_schema),
+        encoded_size_(GetEncodedSize(key_schema) + (row_id_suffix ? ROW_ID_SUFFIX_SIZE : 0)),
+        row_id_suffix_(row_id_suffix) {
+    ASSERT(encoded_size_ <= static_cast<uint32_t>(key_size_), "Index key size exceed max key size.");
+  }
+
+  static constexpr uint32_t ROW_ID_SUFFIX_SIZE = 2 * sizeof(uint32_t);
 
  private:
+  /**
+   * @param cut nullptr if every char value of key fits its column. Otherwise a longer value is cut to the column,
+   *  *cut is set and the key ends after that column.
+   * @return bytes taken by the entries of the fields of key, the first columns of schema
+   */
+  uint32_t SerializeColumns(GenericKey *key_buf, const Row &key, Schema *schema, bool *cut) const;
+
   int key_size_;
   Schema *key_schema_;
+  uint32_t encoded_size_;
+  bool row_id_suffix_{false};
 };
 
 #endif  // MINISQL_GENERIC_KEY_H
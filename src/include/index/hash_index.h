@@ -0,0 +1,43 @@
+#ifndef MINISQL_HASH_INDEX_H
+#define MINISQL_HASH_INDEX_H
+
+#include "index/extendible_hash_table.h"
+#include "index/generic_key.h"
+#include "index/index.h"
+
+/**
+ * Index of an extendible hash table, created by CREATE INDEX ... USING hash. A lookup of a key reads a constant
+ * number of pages, but the keys are in no order: a range is read by visiting every bucket.
+ */
+class HashIndex : public Index {
+ public:
+  HashIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size, BufferPoolManager *buffer_pool_manager,
+            bool unique = true);
+
+  dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  /**
+   * Collect the row ids of the keys which compare to key by compare_operator, one of =, <>, <, <=, > and >=. Only =
+   * is a lookup.
+   */
+  dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn, string compare_operator = "=") override;
+
+  /**
+   * A range of a single full key is a lookup. Any other range visits every bucket, and its row ids come in row id
+   * order rather than key order.
+   */
+  std::unique_ptr<IndexScanCursor> Scan(const Row *lower, const Row *upper, bool lower_inclusive = true,
+                                        bool upper_inclusive = true, Transaction *txn = nullptr) override;
+
+  dberr_t Destroy() override;
+
+ protected:
+  // comparator for key
+  KeyManager processor_;
+  // container
+  ExtendibleHashTable container_;
+};
+
+#endif  // MINISQL_HASH_INDEX_H
@@ -1,14 +1,42 @@
 #ifndef MINISQL_INDEX_H
 #define MINISQL_INDEX_H
 
+#include <functional>
 #include <memory>
 
 #include "common/dberr.h"
 #include "record/row.h"
 #include "transaction/transaction.h"
 
+/**
+ * Cursor of an index range scan. It reads the index as it is advanced, so a caller which stops early reads no more
+ * of the index, and it keeps at most one index page pinned.
+ */
+class IndexScanCursor {
+ public:
+  virtual ~IndexScanCursor() {}
+
+  /**
+   * @return false once every row id of the range is read
+   */
+  virtual bool Next(RowId *row_id) = 0;
+
+  /**
+   * Next, also decoding the key of the row id into key, included columns too. Char fields of key refer to the
+   * cursor and are only valid until it is advanced. Only cursors of indexes keeping their keys in order read them.
+   * @return false once every row id of the range is read
+   */
+  virtual bool NextEntry([[maybe_unused]] RowId *row_id, [[maybe_unused]] Row *key) {
+    ASSERT(false, "The index scan does not read keys.");
+    return false;
+  }
+};
+
 class Index {
  public:
+  /** produces the next key and row id of an index build, false once there is none */
+  using EntrySource = std::function<bool(Row &key, RowId &row_id)>;
+
   explicit Index(index_id_t index_id, IndexSchema *key_schema) : index_id_(index_id), key_schema_(key_schema) {}
 
   virtual ~Index() {}
@@ -22,6 +50,28 @@ class Index {
 
   virtual dberr_t Destroy() = 0;
 
+  /**
+   * Open a scan of the row ids of the keys from lower to upper in key order. A null bound leaves its end of the
+   * range open, an exclusive bound leaves out the keys equal to it. A bound may hold the values of only the first
+   * key columns, it then stands for every key starting with them. The bounds are copied, they need not outlive the
+   * call.
+   */
+  virtual std::unique_ptr<IndexScanCursor> Scan(const Row *lower, const Row *upper, bool lower_inclusive = true,
+                                                bool upper_inclusive = true, Transaction *txn = nullptr) = 0;
+
+  /**
+   * Fill the index with the entries of next, e.g. the rows of a table when the index is created. The default inserts
+   * them one at a time, indexes which build faster from the whole set of entries override it.
+   */
+  virtual dberr_t BuildFrom(const EntrySource &next, Transaction *txn) {
+    Row key;
+    RowId row_id;
+    while (next(key, row_id)) {
+      InsertEntry(key, row_id, txn);
+    }
+    return DB_SUCCESS;
+  }
+
  protected:
   index_id_t index_id_;
   IndexSchema *key_schema_;
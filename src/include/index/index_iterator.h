@@ -1,6 +1,8 @@
 #ifndef MINISQL_INDEX_ITERATOR_H
 #define MINISQL_INDEX_ITERATOR_H
 
+#include <vector>
+
 #include "page/b_plus_tree_leaf_page.h"
 
 class IndexIterator {
@@ -12,9 +14,13 @@ class IndexIterator {
 
   explicit IndexIterator(page_id_t page_id, BufferPoolManager *bpm, int index = 0);
 
+  IndexIterator(const IndexIterator &other);
+
+  IndexIterator &operator=(const IndexIterator &other);
+
   ~IndexIterator();
 
-  /** Return the key/value pair this iterator is currently pointing at. */
+  /** Return the key/value pair this iterator is currently pointing at, the key is valid until the next call. */
   std::pair<GenericKey *, RowId> operator*();
 
   /** Move to the next key/value pair.*/
@@ -27,10 +33,21 @@ class IndexIterator {
   bool operator!=(const IndexIterator &itr) const;
 
  private:
+  /** move past the end of the current leaf to the next non empty leaf, or to the end */
+  void SkipToValid();
+
+  /** unpin the current leaf and become the end iterator */
+  void Release();
+
+  // the current leaf stays pinned until the iterator moves off it, so it is never freed under the iterator. The
+  // leaf is read latched only while it is read, an iterator holds no latch between calls.
   page_id_t current_page_id{INVALID_PAGE_ID};
+  Page *frame{nullptr};
   LeafPage *page{nullptr};
   int item_index{0};
   BufferPoolManager *buffer_pool_manager{nullptr};
+  // the key of the last dereference, a leaf keeps the prefix of its keys apart from the rest
+  std::vector<char> key_;
   // add your own private member variables here
 };
 
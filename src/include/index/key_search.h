@@ -0,0 +1,45 @@
+#ifndef MINISQL_KEY_SEARCH_H
+#define MINISQL_KEY_SEARCH_H
+
+#include "index/generic_key.h"
+
+/**
+ * Search of the contiguous key array of a B+ tree page, keys[i] starts at keys + i * key size.
+ *
+ * The search is picked by the key manager of the tree:
+ * - packed keys (KeyManager::IsPacked, a key of a single int or float column) are loaded as big-endian 64 bit
+ *   integers, which order like memcmp of the encoded keys. A branchless binary search narrows the range to a short
+ *   window whose keys are counted with AVX2 compares, or with a scalar loop when the cpu has no AVX2.
+ * - other keys use a branchless binary search with memcmp.
+ * A leaf page keeps the bytes its keys share once, its array then holds the rest of every key, searched with memcmp.
+ */
+class KeySearch {
+ public:
+  /**
+   * @return index of the first of the size keys which is not less than key, size if there is none
+   */
+  static int LowerBound(const char *keys, int size, const GenericKey *key, const KeyManager &KM);
+
+  /**
+   * @return index of the first of the size keys which is greater than key, size if there is none
+   */
+  static int UpperBound(const char *keys, int size, const GenericKey *key, const KeyManager &KM);
+
+  /**
+   * @return index of the first of the size keys of width bytes which is not less than key, size if there is none
+   */
+  static int LowerBound(const char *keys, int size, const char *key, int width);
+
+  static inline bool IsSimd() { return simd_; }
+
+  /**
+   * Count packed keys with the AVX2 kernel or the scalar loop, used by tests and benchmarks. Not thread safe.
+   * @return false if enabled and the cpu has no AVX2
+   */
+  static bool SetSimd(bool enabled);
+
+ private:
+  static bool simd_;
+};
+
+#endif  // MINISQL_KEY_SEARCH_H
@@ -0,0 +1,79 @@
+#ifndef MINISQL_KEY_SORTER_H
+#define MINISQL_KEY_SORTER_H
+
+#include <cstdio>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rowid.h"
+#include "index/generic_key.h"
+
+/**
+ * Sorts the (key, RowId) entries of an index build by key, then RowId.
+ *
+ * Entries are buffered in memory up to the memory budget. A full buffer is sorted and spilled as a run to a temporary
+ * file, and the runs are merged while the entries are read back. Only the first entry of equal keys, the one of the
+ * smallest RowId, is read back since the tree keeps unique keys.
+ */
+class KeySorter {
+ public:
+  explicit KeySorter(const KeyManager &KM, size_t memory_budget = INDEX_SORT_BUFFER_SIZE);
+
+  ~KeySorter();
+
+  KeySorter(const KeySorter &) = delete;
+
+  KeySorter &operator=(const KeySorter &) = delete;
+
+  void Add(const GenericKey *key, const RowId &row_id);
+
+  /**
+   * Sort the buffered entries, no entry is added afterwards.
+   */
+  void Finish();
+
+  /**
+   * Read back the next entry in order, key takes the key size of the key manager.
+   * @return false once every entry is read
+   */
+  bool Next(GenericKey *key, RowId *row_id);
+
+  /** @return number of runs spilled to disk, 0 if the entries were sorted in memory */
+  inline size_t GetRunCount() const { return runs_.size(); }
+
+ private:
+  inline const char *EntryAt(const std::vector<char> &entries, size_t index) const {
+    return entries.data() + index * entry_size_;
+  }
+
+  /** @return true if entry lhs orders before entry rhs */
+  bool Less(const char *lhs, const char *rhs) const;
+
+  /** sort order_ by the entries of buffer_ */
+  void SortBuffer();
+
+  void SpillRun();
+
+  /** read the next entry of run into its head, false at the end of the run */
+  bool ReadHead(size_t run);
+
+  /** next entry before removing duplicate keys */
+  const char *NextEntry();
+
+  const KeyManager &KM_;
+  size_t entry_size_;
+  size_t capacity_;
+  bool finished_{false};
+  // entries of the current run and their sorted order
+  std::vector<char> buffer_;
+  std::vector<uint32_t> order_;
+  size_t cursor_{0};
+  // spilled runs, the current entry of each run and the heap of the runs by their current entry
+  std::vector<FILE *> runs_;
+  std::vector<char> heads_;
+  std::vector<size_t> heap_;
+  std::vector<char> last_;
+  bool has_last_{false};
+};
+
+#endif  // MINISQL_KEY_SORTER_H
@@ -9,7 +9,6 @@
 #include "page/b_plus_tree_page.h"
 
 #define INTERNAL_PAGE_HEADER_SIZE 28
-#define INTERNAL_PAGE_SIZE ((PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(std::pair<GenericKey *, page_id_t>)) - 1)
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
@@ -18,10 +17,11 @@
  * the first key always remains invalid. That is to say, any search/lookup
  * should ignore the first key.
  *
- * Internal page format (keys are stored in increasing order):
- *  --------------------------------------------------------------------------
- * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
- *  --------------------------------------------------------------------------
+ * Internal page format (keys are stored in increasing order, in a contiguous array before the page ids, the
+ * arrays have max size + 1 slots so a page can take one more child before it is split):
+ *  ------------------------------------------------------------------------------------------------
+ * | HEADER | KEY(1) | KEY(2) | ... | KEY(max size + 1) | PAGE_ID(1) | PAGE_ID(2) | ... | PAGE_ID(max size + 1) |
+ *  ------------------------------------------------------------------------------------------------
  */
 class BPlusTreeInternalPage : public BPlusTreePage {
  public:
@@ -39,10 +39,6 @@ class BPlusTreeInternalPage : public BPlusTreePage {
 
   void SetValueAt(int index, page_id_t value);
 
-  void *PairPtrAt(int index);
-
-  void PairCopy(void *dest, void *src, int pair_num = 1);
-
   page_id_t Lookup(const GenericKey *key, const KeyManager &KP);
 
   void PopulateNewRoot(const page_id_t &old_value, GenericKey *new_key, const page_id_t &new_value);
@@ -64,12 +60,31 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, GenericKey *middle_key,
                          BufferPoolManager *buffer_pool_manager);
 
+  /**
+   * @return the largest max size of an internal page with keys of key_size bytes
+   */
+  static int GetMaxCapacity(int key_size);
+
  private:
-  void CopyNFrom(void *src, int size, BufferPoolManager *buffer_pool_manager);
+  char *KeysPtr() { return data_; }
+
+  page_id_t *ValuesPtr() { return reinterpret_cast<page_id_t *>(data_ + (GetMaxSize() + 1) * GetKeySize()); }
+
+  const page_id_t *ValuesPtr() const {
+    return reinterpret_cast<const page_id_t *>(data_ + (GetMaxSize() + 1) * GetKeySize());
+  }
+
+  /** move the pairs from index on by offset slots */
+  void ShiftPairs(int index, int offset);
+
+  /** set the parent of the child page to this page */
+  void Adopt(page_id_t child, BufferPoolManager *buffer_pool_manager);
+
+  void CopyNFrom(const char *keys, const page_id_t *values, int size, BufferPoolManager *buffer_pool_manager);
 
   void CopyLastFrom(GenericKey *key, page_id_t value, BufferPoolManager *buffer_pool_manager);
 
-  void CopyFirstFrom(page_id_t value, BufferPoolManager *buffer_pool_manager);
+  void CopyFirstFrom(GenericKey *key, page_id_t value, BufferPoolManager *buffer_pool_manager);
 
   char data_[PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE];
 };
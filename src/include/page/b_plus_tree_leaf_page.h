@@ -7,33 +7,38 @@
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
  * page. Only support unique key.
-
- * Leaf page format (keys are stored in order):
- *  ----------------------------------------------------------------------
- * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
- *  ----------------------------------------------------------------------
  *
- *  Header format (size in byte, 24 bytes in total):
+ * Leaf page format (the record ids and the keys are stored in order, each in a contiguous array, the arrays have
+ * max size + 1 slots so a page can take one more pair before it is split):
+ *  ---------------------------------------------------------------------------------------------------------
+ * | HEADER | RID(1) | ... | RID(max size + 1) | PREFIX | SUFFIX(1) | SUFFIX(2) | ... | SUFFIX(max size + 1) |
+ *  ---------------------------------------------------------------------------------------------------------
+ *
+ * Prefix compression: PREFIX holds the first bytes shared by every key of the page, each SUFFIX the rest of its key,
+ * key size - prefix size bytes. The longer the prefix, the more pairs the page takes, so the max size of a page is
+ * worked out from its prefix, up to the max size it was initialized with. The prefix is the common prefix of the
+ * first and the last key when the pairs are laid out again, which happens when a key sharing fewer bytes comes in,
+ * on splits and on merges. A removal keeps the prefix. Packed keys (see index/key_search.h) are stored whole.
+ *
+ *  Header format (size in byte, 40 bytes in total):
  *  ---------------------------------------------------------------------
- * | PageType (4) | CurrentSize (4) | MaxSize (4) | ParentPageId (4) |
+ * | PageType (4) | KeySize (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
  *  ---------------------------------------------------------------------
- *  ------------------------------
- * | PageId (4) | NextPageId (4)
- *  ------------------------------
+ *  ----------------------------------------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | NextPageId (4) | PrefixSize (4) | SizeLimit (4) |
+ *  ----------------------------------------------------------------------------------
  */
 #include <utility>
 #include <vector>
 
 #include "index/generic_key.h"
 #include "page/b_plus_tree_page.h"
-#define MappingType std::pair<GenericKey, RowId>
-#define LEAF_PAGE_HEADER_SIZE 32
-#define LEAF_PAGE_SIZE (((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType)) - 1)
+#define LEAF_PAGE_HEADER_SIZE 40
 
 class BPlusTreeLeafPage : public BPlusTreePage {
  public:
   // After creating a new leaf page from buffer pool, must call initialize
-  // method to set default values
+  // method to set default values, max size is the limit of the max size whatever the prefix
   void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int key_size = UNDEFINED_SIZE,
             int max_size = UNDEFINED_SIZE);
 
@@ -42,9 +47,10 @@ class BPlusTreeLeafPage : public BPlusTreePage {
 
   void SetNextPageId(page_id_t next_page_id);
 
-  GenericKey *KeyAt(int index);
-
-  void SetKeyAt(int index, GenericKey *key);
+  /**
+   * Put the key at index back together, its prefix then its suffix, into key.
+   */
+  void KeyAt(int index, GenericKey *key) const;
 
   RowId ValueAt(int index) const;
 
@@ -52,11 +58,17 @@ class BPlusTreeLeafPage : public BPlusTreePage {
 
   int KeyIndex(const GenericKey *key, const KeyManager &comparator);
 
-  void *PairPtrAt(int index);
+  inline int GetPrefixSize() const { return prefix_size_; }
 
-  void PairCopy(void *dest, void *src, int pair_num = 1);
+  /**
+   * @return max size of the page once key is inserted, its prefix is then cut to the bytes key shares
+   */
+  int MaxSizeWith(const GenericKey *key) const;
 
-  std::pair<GenericKey *, RowId> GetItem(int index);
+  /**
+   * @return max size of the page once the pairs of right, the page after it, are moved into it
+   */
+  int MaxSizeWith(const BPlusTreeLeafPage *right) const;
 
   // insert and delete methods
   int Insert(GenericKey *key, const RowId &value, const KeyManager &comparator);
@@ -68,20 +80,63 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   // Split and Merge utility methods
   void MoveHalfTo(BPlusTreeLeafPage *recipient);
 
+  /**
+   * Move the pairs from index on to recipient, an empty page.
+   */
+  void MoveTailTo(BPlusTreeLeafPage *recipient, int index);
+
   void MoveAllTo(BPlusTreeLeafPage *recipient);
 
   void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
 
   void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
 
+  /**
+   * @return the largest max size of a leaf page with keys of key_size bytes, reached when they share all but one byte
+   */
+  static int GetMaxCapacity(int key_size);
+
  private:
-  void CopyNFrom(void *src, int size);
+  /** @return max size of the page if its keys share prefix_size bytes */
+  int MaxSizeAt(int prefix_size) const;
+
+  /** @return number of the first bytes of the prefix key shares, up to the prefix size */
+  int CommonPrefixSize(const GenericKey *key) const;
+
+  inline bool IsPacked() const { return GetKeySize() == sizeof(uint64_t); }
+
+  inline int SuffixSize() const { return GetKeySize() - prefix_size_; }
+
+  RowId *ValuesPtr() { return reinterpret_cast<RowId *>(data_); }
+
+  const RowId *ValuesPtr() const { return reinterpret_cast<const RowId *>(data_); }
+
+  char *PrefixPtr() { return data_ + (GetMaxSize() + 1) * sizeof(RowId); }
+
+  const char *PrefixPtr() const { return data_ + (GetMaxSize() + 1) * sizeof(RowId); }
+
+  char *SuffixAt(int index) { return PrefixPtr() + prefix_size_ + index * SuffixSize(); }
+
+  const char *SuffixAt(int index) const { return PrefixPtr() + prefix_size_ + index * SuffixSize(); }
+
+  /** @return true if the key at index is key */
+  bool IsKeyAt(int index, const GenericKey *key) const;
+
+  /** move the pairs from index on by offset slots */
+  void ShiftPairs(int index, int offset);
+
+  /** insert the pair at index, laying the page out again if key does not share the whole prefix */
+  void InsertAt(int index, const GenericKey *key, const RowId &value);
 
-  void CopyLastFrom(GenericKey *key, const RowId value);
+  /** append the whole keys and the values of the pairs in [begin, end) */
+  void CopyPairsTo(int begin, int end, std::vector<char> *keys, std::vector<RowId> *values) const;
 
-  void CopyFirstFrom(GenericKey *key, const RowId value);
+  /** replace the pairs of the page by size pairs of whole keys, under the prefix of the first and the last key */
+  void Rebuild(const char *keys, const RowId *values, int size);
 
   page_id_t next_page_id_{INVALID_PAGE_ID};
+  int prefix_size_{0};
+  int size_limit_{0};
 
   char data_[PAGE_SIZE - LEAF_PAGE_HEADER_SIZE];
 };
@@ -30,6 +30,17 @@ class BitmapPage {
    */
   bool IsPageFree(uint32_t page_offset) const;
 
+  /**
+   * @return the number of allocated pages in the extent
+   */
+  uint32_t GetAllocatedPages() const { return page_allocated_; }
+
+  /**
+   * Recount the allocated pages from the bits, older files may hold a bitmap whose count was never initialized.
+   * @return true if the count or the next free page had to be corrected.
+   */
+  bool Recount();
+
  private:
   /**
    * check a bit(byte_index, bit_index) in bytes is free(value 0).
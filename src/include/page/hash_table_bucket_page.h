@@ -0,0 +1,71 @@
+#ifndef MINISQL_HASH_TABLE_BUCKET_PAGE_H
+#define MINISQL_HASH_TABLE_BUCKET_PAGE_H
+
+#include "common/rowid.h"
+#include "index/generic_key.h"
+
+#define HASH_BUCKET_PAGE_HEADER_SIZE 16
+
+/**
+ * Bucket page of an extendible hash table. The pairs are kept in no order, a removed pair is replaced by the last one.
+ * The keys a split can not tell apart, the ones of the same hash, overflow into a chain of pages linked by their next
+ * page id.
+ *
+ * Format (the arrays have capacity slots):
+ *  ---------------------------------------------------------------------------------
+ * | HEADER | RID(1) | RID(2) | ... | RID(capacity) | KEY(1) | ... | KEY(capacity) |
+ *  ---------------------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 16 bytes in total):
+ *  ------------------------------------------------------------
+ * | PageId (4) | KeySize (4) | CurrentSize (4) | NextPageId (4) |
+ *  ------------------------------------------------------------
+ */
+class HashTableBucketPage {
+ public:
+  void Init(page_id_t page_id, int key_size);
+
+  /** @return number of pairs a page of keys of key_size takes */
+  static int GetCapacity(int key_size);
+
+  inline page_id_t GetPageId() const { return page_id_; }
+
+  inline int GetSize() const { return size_; }
+
+  inline bool IsFull() const { return size_ == GetCapacity(key_size_); }
+
+  inline page_id_t GetNextPageId() const { return next_page_id_; }
+
+  inline void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  GenericKey *KeyAt(int index);
+
+  RowId ValueAt(int index) const;
+
+  /**
+   * Append a pair, the page is not full.
+   */
+  void Append(const GenericKey *key, const RowId &value);
+
+  /**
+   * Remove the pair at index, the last pair takes its place.
+   */
+  void RemoveAt(int index);
+
+  inline void Clear() { size_ = 0; }
+
+ private:
+  inline RowId *ValuesPtr() { return reinterpret_cast<RowId *>(data_); }
+
+  inline const RowId *ValuesPtr() const { return reinterpret_cast<const RowId *>(data_); }
+
+  inline char *KeysPtr() { return data_ + GetCapacity(key_size_) * sizeof(RowId); }
+
+  page_id_t page_id_;
+  int key_size_;
+  int size_;
+  page_id_t next_page_id_;
+  char data_[0];
+};
+
+#endif  // MINISQL_HASH_TABLE_BUCKET_PAGE_H
@@ -0,0 +1,69 @@
+#ifndef MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
+#define MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
+
+#include <cstdint>
+
+#include "common/config.h"
+
+/**
+ * Directory page of an extendible hash table. Slot i holds the bucket of the keys whose hash ends with the global
+ * depth low bits of i. A bucket of local depth d is held by the 2^(global depth - d) slots ending with its d bits.
+ *
+ * Format (size in byte):
+ *  ------------------------------------------------------------------------------------------
+ * | PageId (4) | LSN (4) | GlobalDepth (4) | LocalDepth (1) * 512 | BucketPageId (4) * 512 |
+ *  ------------------------------------------------------------------------------------------
+ */
+class HashTableDirectoryPage {
+ public:
+  static constexpr uint32_t MAX_DEPTH = 9;
+  static constexpr uint32_t DIRECTORY_ARRAY_SIZE = 1u << MAX_DEPTH;
+
+  void Init(page_id_t page_id);
+
+  inline page_id_t GetPageId() const { return page_id_; }
+
+  inline uint32_t GetGlobalDepth() const { return global_depth_; }
+
+  /** @return mask of the hash bits which pick a slot */
+  inline uint32_t GetGlobalDepthMask() const { return (1u << global_depth_) - 1; }
+
+  /** @return number of slots in use */
+  inline uint32_t Size() const { return 1u << global_depth_; }
+
+  /**
+   * Double the slots, the new slot i + Size() holds the bucket of slot i.
+   */
+  void IncrGlobalDepth();
+
+  /**
+   * Halve the slots, only when CanShrink().
+   */
+  void DecrGlobalDepth();
+
+  /** @return true if every bucket is held by at least two slots */
+  bool CanShrink() const;
+
+  inline page_id_t GetBucketPageId(uint32_t bucket_idx) const { return bucket_page_ids_[bucket_idx]; }
+
+  inline void SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id) {
+    bucket_page_ids_[bucket_idx] = bucket_page_id;
+  }
+
+  inline uint32_t GetLocalDepth(uint32_t bucket_idx) const { return local_depths_[bucket_idx]; }
+
+  inline void SetLocalDepth(uint32_t bucket_idx, uint32_t local_depth) {
+    local_depths_[bucket_idx] = static_cast<uint8_t>(local_depth);
+  }
+
+ private:
+  page_id_t page_id_;
+  lsn_t lsn_;
+  uint32_t global_depth_;
+  uint8_t local_depths_[DIRECTORY_ARRAY_SIZE];
+  page_id_t bucket_page_ids_[DIRECTORY_ARRAY_SIZE];
+};
+
+static_assert(sizeof(HashTableDirectoryPage) <= PAGE_SIZE, "Hash table directory exceeds the page.");
+
+#endif  // MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
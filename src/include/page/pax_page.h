@@ -0,0 +1,180 @@
+#ifndef MINISQL_PAX_PAGE_H
+#define MINISQL_PAX_PAGE_H
+/**
+ * PAX (Partition Attributes Across) page format, every column owns a minipage:
+ *  ------------------------------------------------------------------------------------------------
+ *  | HEADER | SLOT STATES | COL_0 NULLS | COL_0 LENGTHS | COL_0 VALUES | COL_1 NULLS | ... | FREE |
+ *  ------------------------------------------------------------------------------------------------
+ *
+ *  Header format (size in bytes), the first 16 bytes are the same as the ones of TablePage:
+ *  ---------------------------------------------------------------------------------------------------
+ *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| SlotCount (4)| UsedCount (4)| Reserved (8) |
+ *  ---------------------------------------------------------------------------------------------------
+ *
+ *  Slot states are one byte per slot (free, live or marked deleted). Nulls are a bitmap per column.
+ *  Int and float values are stored as arrays of 4 byte values. A char column stores a 4 byte length per slot
+ *  and reserves its declared maximum length per slot, so every value of a page sits at a fixed offset.
+ *  A dictionary-encoded char column stores 2 byte codes and has no lengths.
+ *  SlotCount is the high-water mark of used slots, UsedCount the number of slots which are not free.
+ **/
+
+#include <cstring>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/rowid.h"
+#include "page/page.h"
+#include "record/row.h"
+#include "record/schema.h"
+#include "record/tuple_view.h"
+#include "transaction/lock_manager.h"
+#include "transaction/log_manager.h"
+#include "transaction/transaction.h"
+
+/**
+ * Position of the minipages of a PAX page. It only depends on the schema, so a table computes it once.
+ */
+class PaxLayout {
+ public:
+  explicit PaxLayout(Schema *schema);
+
+  inline Schema *GetSchema() const { return schema_; }
+
+  inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(value_width_.size()); }
+
+  /**
+   * @return number of tuples a page holds, 0 if a single tuple does not fit into a page
+   */
+  inline uint32_t GetSlotCapacity() const { return slot_capacity_; }
+
+  inline uint32_t GetValueWidth(uint32_t column) const { return value_width_[column]; }
+
+  /**
+   * @return whether every value of row fits into its minipage
+   */
+  bool Fits(const Row &row) const;
+
+  inline char *GetSlotStates(char *page_data) const { return page_data + HEADER_SIZE; }
+
+  inline bool IsNull(const char *page_data, uint32_t column, uint32_t slot) const {
+    return (page_data[null_offset_[column] + slot / 8] & (1 << (slot % 8))) != 0;
+  }
+
+  inline void SetNull(char *page_data, uint32_t column, uint32_t slot, bool is_null) const {
+    if (is_null) {
+      page_data[null_offset_[column] + slot / 8] |= static_cast<char>(1 << (slot % 8));
+    } else {
+      page_data[null_offset_[column] + slot / 8] &= static_cast<char>(~(1 << (slot % 8)));
+    }
+  }
+
+  /**
+   * @return the value of column in slot, the length of a char value is read with GetCharLength
+   */
+  inline char *GetValue(char *page_data, uint32_t column, uint32_t slot) const {
+    return page_data + value_offset_[column] + slot * value_width_[column];
+  }
+
+  inline uint32_t GetCharLength(const char *page_data, uint32_t column, uint32_t slot) const {
+    return MACH_READ_UINT32(page_data + length_offset_[column] + slot * sizeof(uint32_t));
+  }
+
+  inline void SetCharLength(char *page_data, uint32_t column, uint32_t slot, uint32_t length) const {
+    MACH_WRITE_UINT32(page_data + length_offset_[column] + slot * sizeof(uint32_t), length);
+  }
+
+  static constexpr uint32_t HEADER_SIZE = 32;
+
+ private:
+  /**
+   * Lay the minipages out for capacity slots.
+   * @return bytes used by the header and all minipages
+   */
+  uint32_t Place(uint32_t capacity);
+
+  Schema *schema_;
+  uint32_t slot_capacity_{0};
+  std::vector<uint32_t> value_width_;
+  std::vector<uint32_t> null_offset_;
+  std::vector<uint32_t> length_offset_; /** only meaningful for char columns */
+  std::vector<uint32_t> value_offset_;
+};
+
+class PaxPage : public Page {
+ public:
+  void Init(page_id_t page_id, page_id_t prev_id, LogManager *log_mgr, Transaction *txn);
+
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  page_id_t GetPrevPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_PREV_PAGE_ID); }
+
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  void SetPrevPageId(page_id_t prev_page_id) {
+    memcpy(GetData() + OFFSET_PREV_PAGE_ID, &prev_page_id, sizeof(page_id_t));
+  }
+
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  bool InsertTuple(Row &row, const PaxLayout &layout, Transaction *txn, LockManager *lock_manager,
+                   LogManager *log_manager);
+
+  bool MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
+
+  /**
+   * Values are fixed width, so an update is always done in place.
+   */
+  bool UpdateTuple(const Row &new_row, Row *old_row, const PaxLayout &layout, Transaction *txn,
+                   LockManager *lock_manager, LogManager *log_manager);
+
+  void ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_manager);
+
+  void RollbackDelete(const RowId &rid, Transaction *txn, LogManager *log_manager);
+
+  bool GetTuple(Row *row, const PaxLayout &layout, Transaction *txn, LockManager *lock_manager);
+
+  bool GetTupleView(const RowId &rid, const PaxLayout &layout, TupleView *view);
+
+  uint32_t GetTupleViews(const PaxLayout &layout, std::vector<TupleView> &views);
+
+  bool GetFirstTupleRid(RowId *first_rid);
+
+  bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid);
+
+  /**
+   * Free the slots of the tuples which are marked deleted.
+   */
+  void Vacuum(Transaction *txn, LogManager *log_manager);
+
+ private:
+  uint32_t GetSlotCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_SLOT_COUNT); }
+
+  void SetSlotCount(uint32_t slot_count) { memcpy(GetData() + OFFSET_SLOT_COUNT, &slot_count, sizeof(uint32_t)); }
+
+  uint32_t GetUsedCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_USED_COUNT); }
+
+  void SetUsedCount(uint32_t used_count) { memcpy(GetData() + OFFSET_USED_COUNT, &used_count, sizeof(uint32_t)); }
+
+  uint8_t GetSlotState(uint32_t slot_num) {
+    return static_cast<uint8_t>(GetData()[PaxLayout::HEADER_SIZE + slot_num]);
+  }
+
+  void SetSlotState(uint32_t slot_num, uint8_t state) {
+    GetData()[PaxLayout::HEADER_SIZE + slot_num] = static_cast<char>(state);
+  }
+
+  void WriteSlot(uint32_t slot_num, const Row &row, const PaxLayout &layout);
+
+ private:
+  static constexpr uint8_t SLOT_FREE = 0;
+  static constexpr uint8_t SLOT_LIVE = 1;
+  static constexpr uint8_t SLOT_DELETED = 2;
+  static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
+  static constexpr size_t OFFSET_SLOT_COUNT = 16;
+  static constexpr size_t OFFSET_USED_COUNT = 20;
+};
+
+#endif  // MINISQL_PAX_PAGE_H
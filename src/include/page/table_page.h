@@ -22,6 +22,7 @@
 #include "common/rowid.h"
 #include "page/page.h"
 #include "record/row.h"
+#include "record/tuple_view.h"
 #include "transaction/lock_manager.h"
 #include "transaction/log_manager.h"
 #include "transaction/transaction.h"
@@ -59,10 +60,31 @@ class TablePage : public Page {
 
   bool GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager *lock_manager);
 
+  /**
+   * Point view at the bytes of a live tuple, nothing is copied. The view is valid while this page stays pinned.
+   */
+  bool GetTupleView(const RowId &rid, Schema *schema, TupleView *view);
+
+  /**
+   * Append a view of every live tuple on this page to views, in slot order.
+   * @return number of views appended
+   */
+  uint32_t GetTupleViews(Schema *schema, std::vector<TupleView> &views);
+
   bool GetFirstTupleRid(RowId *first_rid);
 
   bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid);
 
+  /**
+   * Physically remove the tuples which are marked deleted and drop the empty slots at the tail of the slot array.
+   * Slots of live tuples are never renumbered, so row ids stay valid.
+   */
+  void Vacuum(Transaction *txn, LogManager *log_manager);
+
+  uint32_t GetFreeSpaceRemaining() {
+    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
+  }
+
  private:
   uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
 
@@ -74,10 +96,6 @@ class TablePage : public Page {
 
   void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
 
-  uint32_t GetFreeSpaceRemaining() {
-    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
-  }
-
   uint32_t GetTupleOffsetAtSlot(uint32_t slot_num) {
     return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
   }
@@ -1,5 +1,6 @@
 %{
   #include <stdio.h>
+  #include <strings.h>
   #include "parser/parser.h"
 
   extern char *yytext;
@@ -7,6 +8,8 @@
   int yyerror(char* error);
 %}
 
+%define api.header.include {"parser/minisql_yacc.h"}
+
 %union {
 	pSyntaxNode syntax_node;
 }
@@ -17,17 +20,18 @@
 %token <syntax_node> ON FROM WHERE INTO SET VALUES PRIMARY KEY UNIQUE
 %token <syntax_node> CHAR INT FLOAT AND OR NOT IS FLAGNULL
 %token <syntax_node> IDENTIFIER STRING NUMBER EQ NE LE GE
+%token <syntax_node> VACUUM INCLUDE
 
 %type <syntax_node> start sql
 %type <syntax_node> sql_create_database sql_drop_database sql_show_databases sql_use_database
 %type <syntax_node> sql_show_tables sql_create_table sql_drop_table
 %type <syntax_node> column_definition_list column_definition column_type column_list
-%type <syntax_node> sql_create_index sql_drop_index sql_show_indexes
+%type <syntax_node> sql_create_index index_include index_using sql_drop_index sql_show_indexes
 %type <syntax_node> sql_trx_begin sql_trx_commit sql_trx_rollback
 %type <syntax_node> sql_select select_columns column_values column_value operator
 %type <syntax_node> connector where_conditions where_condition
 %type <syntax_node> sql_insert sql_delete sql_update update_values update_value
-%type <syntax_node> sql_quit sql_exec_file
+%type <syntax_node> sql_quit sql_exec_file sql_vacuum sql_set_variable
 
 %%
 
@@ -58,6 +62,8 @@ sql:
   | sql_trx_rollback { $$ = $1; }
   | sql_quit { $$ = $1; }
   | sql_exec_file { $$ = $1; }
+  | sql_vacuum { $$ = $1; }
+  | sql_set_variable { $$ = $1; }
   ;
 
 sql_create_database:
@@ -101,6 +107,16 @@ sql_create_table:
     SyntaxNodeAddChildren($$, $3);
     SyntaxNodeAddChildren($$, list_node);
   }
+  | CREATE TABLE IDENTIFIER '(' column_definition_list ')' USING IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeCreateTable, NULL);
+    pSyntaxNode list_node = CreateSyntaxNode(kNodeColumnDefinitionList, NULL);
+    SyntaxNodeAddChildren(list_node, $5);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, list_node);
+    pSyntaxNode layout_node = CreateSyntaxNode(kNodeTableLayout, "table layout");
+    SyntaxNodeAddChildren(layout_node, $8);
+    SyntaxNodeAddChildren($$, layout_node);
+  }
   ;
 
 column_list:
@@ -138,6 +154,14 @@ column_definition:
     SyntaxNodeAddChildren($$, $1);
     SyntaxNodeAddChildren($$, $2);
   }
+  | IDENTIFIER column_type IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeColumnDefinition, NULL);
+    SyntaxNodeAddChildren($$, $1);
+    SyntaxNodeAddChildren($$, $2);
+    pSyntaxNode option_node = CreateSyntaxNode(kNodeColumnOption, "column option");
+    SyntaxNodeAddChildren(option_node, $3);
+    SyntaxNodeAddChildren($$, option_node);
+  }
   ;
 
 column_type:
@@ -161,24 +185,39 @@ sql_drop_table:
   ;
 
 sql_create_index:
-  CREATE INDEX IDENTIFIER ON IDENTIFIER '(' column_list ')' {
+  CREATE INDEX IDENTIFIER ON IDENTIFIER '(' column_list ')' index_include index_using {
     $$ = CreateSyntaxNode(kNodeCreateIndex, NULL);
     SyntaxNodeAddChildren($$, $3);
     SyntaxNodeAddChildren($$, $5);
     pSyntaxNode index_keys_node = CreateSyntaxNode(kNodeColumnList, "index keys");
     SyntaxNodeAddChildren(index_keys_node, $7);
     SyntaxNodeAddChildren($$, index_keys_node);
+    if ($9 != NULL) {
+      SyntaxNodeAddChildren($$, $9);
+    }
+    if ($10 != NULL) {
+      SyntaxNodeAddChildren($$, $10);
+    }
   }
-  | CREATE INDEX IDENTIFIER ON IDENTIFIER '(' column_list ')' USING IDENTIFIER {
-      $$ = CreateSyntaxNode(kNodeCreateIndex, NULL);
-      SyntaxNodeAddChildren($$, $3);
-      SyntaxNodeAddChildren($$, $5);
-      pSyntaxNode index_keys_node = CreateSyntaxNode(kNodeColumnList, "index keys");
-      SyntaxNodeAddChildren(index_keys_node, $7);
-      SyntaxNodeAddChildren($$, index_keys_node);
-      pSyntaxNode index_type_node = CreateSyntaxNode(kNodeIndexType, "index type");
-      SyntaxNodeAddChildren(index_type_node, $10);
-      SyntaxNodeAddChildren($$, index_type_node);
+  ;
+
+index_include:
+  /* empty */ {
+    $$ = NULL;
+  }
+  | INCLUDE '(' column_list ')' {
+    $$ = CreateSyntaxNode(kNodeColumnList, "include columns");
+    SyntaxNodeAddChildren($$, $3);
+  }
+  ;
+
+index_using:
+  /* empty */ {
+    $$ = NULL;
+  }
+  | USING IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeIndexType, "index type");
+    SyntaxNodeAddChildren($$, $2);
   }
   ;
 
@@ -393,6 +432,21 @@ sql_exec_file:
   }
   ;
 
+sql_vacuum:
+  VACUUM IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeVacuum, NULL);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  ;
+
+sql_set_variable:
+  SET IDENTIFIER EQ column_value {
+    $$ = CreateSyntaxNode(kNodeSetVariable, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddChildren($$, $4);
+  }
+  ;
+
 %%
 int yyerror(char* error) {
 	MinisqlParserSetError(error);
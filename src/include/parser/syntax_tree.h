@@ -43,7 +43,11 @@ typedef enum {
   kNodeIndexType,            /** type of index */
   kNodeTrxBegin,             /** begin transaction command */
   kNodeTrxCommit,            /** commit transaction command */
-  kNodeTrxRollback           /** rollback transaction command */
+  kNodeTrxRollback,          /** rollback transaction command */
+  kNodeVacuum,               /** vacuum table command */
+  kNodeSetVariable,          /** set session variable command */
+  kNodeTableLayout,          /** page layout of a table */
+  kNodeColumnOption          /** storage option of a column, e.g. dictionary */
 } SyntaxNodeType;
 
 /**
@@ -8,6 +8,7 @@
 #include <utility>
 #include <vector>
 
+#include "record/field_compare.h"
 #include "record/row.h"
 #include "record/schema.h"
 
@@ -36,6 +37,12 @@ class AbstractExpression {
   /** @return The field obtained by evaluating the row */
   virtual Field Evaluate(const Row *row) const = 0;
 
+  /**
+   * Evaluate a boolean expression, e.g. a WHERE clause, without building a result field.
+   * @return kTrue only if the row qualifies
+   */
+  virtual CmpBool EvaluatePredicate(const Row *row) const { return FieldCompare::AsCmpBool(Evaluate(row)); }
+
   /**
    * Returns the field obtained by evaluating a JOIN.
    * @param left_row The left row
@@ -8,6 +8,9 @@
 #include <utility>
 
 #include "abstract_expression.h"
+#include "column_value_expression.h"
+#include "constant_value_expression.h"
+#include "record/field_compare.h"
 #include "record/schema.h"
 
 /**
@@ -18,13 +21,26 @@ class ComparisonExpression : public AbstractExpression {
   /** Creates a new comparison expression representing (left comp_type right). */
   ComparisonExpression(AbstractExpressionRef left, AbstractExpressionRef right, string comp_type)
       : AbstractExpression({std::move(left), std::move(right)}, TypeId::kTypeInt, ExpressionType::ComparisonExpression),
-        comp_type_{std::move(comp_type)} {}
+        comp_type_{std::move(comp_type)} {
+    Bind();
+  }
 
   /** e.g. evaluate the result of id = 1 */
   Field Evaluate(const Row *row) const override {
+    return Field(kTypeInt, static_cast<int32_t>(EvaluatePredicate(row)));
+  }
+
+  /** column op constant, the shape every WHERE clause has, runs the bound kernel on the fields in place */
+  CmpBool EvaluatePredicate(const Row *row) const override {
+    if (kernel_ != nullptr && column_idx_ >= 0) {
+      return kernel_(*row->GetField(column_idx_), constant_);
+    }
     Field lhs = GetChildAt(0)->Evaluate(row);
     Field rhs = GetChildAt(1)->Evaluate(row);
-    return Field(kTypeInt, PerformComparison(lhs, rhs));
+    if (kernel_ != nullptr) {
+      return kernel_(lhs, rhs);
+    }
+    return PerformComparison(lhs, rhs);
   }
 
   Field EvaluateJoin(const Row *left_row, const Row *right_row) const override {
@@ -36,6 +52,24 @@ class ComparisonExpression : public AbstractExpression {
   std::string GetComparisonType() { return comp_type_; }
 
  private:
+  /**
+   * Pick the kernel specialized for the type of both sides, done once when the planner builds the expression.
+   * Operands of different types or is/not null tests keep the generic path.
+   */
+  void Bind() {
+    FieldCompare::Op op;
+    auto &lhs = GetChildAt(0);
+    auto &rhs = GetChildAt(1);
+    if (!FieldCompare::ParseOp(comp_type_, &op) || lhs->GetReturnType() != rhs->GetReturnType()) {
+      return;
+    }
+    kernel_ = FieldCompare::BindKernel(lhs->GetReturnType(), op);
+    if (lhs->GetType() == ExpressionType::ColumnExpression && rhs->GetType() == ExpressionType::ConstantExpression) {
+      column_idx_ = static_cast<int32_t>(std::static_pointer_cast<ColumnValueExpression>(lhs)->GetColIdx());
+      constant_ = std::static_pointer_cast<ConstantValueExpression>(rhs)->val_;
+    }
+  }
+
   CmpBool PerformComparison(const Field &lhs, const Field &rhs) const {
     if (comp_type_ == "=")
       return lhs.CompareEquals(rhs);
@@ -58,6 +92,10 @@ class ComparisonExpression : public AbstractExpression {
   }
 
   std::string comp_type_;
+  FieldCompare::Kernel kernel_{nullptr};
+  /** set when the expression is column op constant, constant_ is a copy of the value of the right child */
+  int32_t column_idx_{-1};
+  Field constant_{kTypeInt};
 };
 
 #endif  // MINISQL_COMPARISON_EXPRESSION_H
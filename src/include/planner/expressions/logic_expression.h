@@ -26,9 +26,17 @@ class LogicExpression : public AbstractExpression {
 
   /** e.g. evaluate the result of id = 1 and name = "str"*/
   Field Evaluate(const Row *row) const override {
-    Field lhs = GetChildAt(0)->Evaluate(row);
-    Field rhs = GetChildAt(1)->Evaluate(row);
-    return Field(kTypeInt, PerformComputation(lhs, rhs));
+    return Field(kTypeInt, static_cast<int32_t>(EvaluatePredicate(row)));
+  }
+
+  CmpBool EvaluatePredicate(const Row *row) const override {
+    auto l = GetChildAt(0)->EvaluatePredicate(row);
+    // short circuit, the right side cannot change the result
+    if ((logic_type_ == LogicType::And && l == CmpBool::kFalse) ||
+        (logic_type_ == LogicType::Or && l == CmpBool::kTrue)) {
+      return l;
+    }
+    return Combine(l, GetChildAt(1)->EvaluatePredicate(row));
   }
 
   Field EvaluateJoin(const Row *left_row, const Row *right_row) const override {
@@ -49,19 +57,11 @@ class LogicExpression : public AbstractExpression {
   LogicType logic_type_;
 
  private:
-  CmpBool GetFieldAsCmpBool(const Field &val) const {
-    if (val.IsNull()) {
-      return CmpBool::kNull;
-    }
-    if (val.CompareEquals(Field(kTypeInt, 1))) {
-      return CmpBool::kTrue;
-    }
-    return CmpBool::kFalse;
+  CmpBool PerformComputation(const Field &lhs, const Field &rhs) const {
+    return Combine(FieldCompare::AsCmpBool(lhs), FieldCompare::AsCmpBool(rhs));
   }
 
-  CmpBool PerformComputation(const Field &lhs, const Field &rhs) const {
-    auto l = GetFieldAsCmpBool(lhs);
-    auto r = GetFieldAsCmpBool(rhs);
+  CmpBool Combine(CmpBool l, CmpBool r) const {
     switch (logic_type_) {
       case LogicType::And:
         if (l == CmpBool::kFalse || r == CmpBool::kFalse) {
@@ -45,6 +45,45 @@ class Planner {
 
   Schema *MakeOutputSchema(const std::vector<std::pair<std::string, AbstractExpressionRef>> &exprs);
 
+  /**
+   * @return ascending table columns read by the output schema or by the predicate, the only ones a scan decodes
+   */
+  static std::vector<uint32_t> NeededColumns(const Schema *out_schema, const AbstractExpressionRef &predicate);
+
+  /**
+   * Take the conjuncts column = constant and column <> constant on dictionary-encoded columns out of predicate, each
+   * becomes a filter comparing the stored code with the code of the constant.
+   * @return the rest of predicate, nullptr if nothing is left
+   */
+  static AbstractExpressionRef ExtractDictionaryFilters(const Schema *table_schema,
+                                                        const AbstractExpressionRef &predicate,
+                                                        std::vector<DictionaryFilter> *filters);
+
+  /**
+   * Fold the comparisons with a constant in the top-level AND chain of predicate into one key range per index, e.g.
+   * id > 100 AND id < 200 into (100, 200). The key columns are matched from the first one: equalities on a leading
+   * prefix of them and a range on the column after the prefix make one range, e.g. a = 1 AND b > 5 on an index of
+   * (a, b, c) reads ((1, 5), (1)]. Each equality counts 3 and each bounded end of the last range 1, the index of the
+   * highest count is picked. A hash index only takes equalities on every key column and counts 1 more.
+   * @param[out] complete whether the range decides the whole predicate, the rows read then need no filter
+   * @return the range, without an index if no comparison bounds one
+   */
+  static IndexScanRange PlanIndexRange(const AbstractExpressionRef &predicate, const std::vector<IndexInfo *> &indexes,
+                                       bool *complete);
+
+  /**
+   * @return whether every table column of columns is stored in the entries of index, as a key or an included column,
+   *         so that a scan of it needs not read the table. Only a bptree index returns the keys it reads
+   */
+  static bool IndexCovers(IndexInfo *index, const std::vector<uint32_t> &columns);
+
+  /**
+   * Fold the comparisons of conjuncts between table column column and a constant into single field bounds.
+   * @return number of comparisons folded
+   */
+  static size_t FoldColumnBounds(const std::vector<AbstractExpressionRef> &conjuncts, uint32_t column,
+                                 IndexScanRange *bounds);
+
   /** Catalog will be used during the planning process. SHOULD ONLY BE USED IN
    * CODE PATH OF `PlanQuery`.
    */
@@ -0,0 +1,65 @@
+#ifndef MINISQL_CHAR_OPS_H
+#define MINISQL_CHAR_OPS_H
+
+#include <cstdint>
+
+/**
+ * Comparison and hashing of char values with SSE4.2 / AVX2 kernels and a scalar fallback.
+ *
+ * The instruction set is detected once at startup and every call goes through a function pointer bound to the best
+ * kernel. All kernels return the same results: Compare orders like memcmp followed by the lengths, Hash is a CRC32C
+ * of the bytes (hardware crc32 with SSE4.2, table driven otherwise) finalized together with the length.
+ */
+class CharOps {
+ public:
+  enum class Isa { kScalar = 0, kSse42, kAvx2 };
+
+  /**
+   * @return negative, zero or positive, bytes are compared unsigned and a prefix orders before the longer value
+   */
+  static inline int Compare(const char *lhs, uint32_t lhs_len, const char *rhs, uint32_t rhs_len) {
+    return impl_.compare_(lhs, lhs_len, rhs, rhs_len);
+  }
+
+  static inline bool Equals(const char *lhs, uint32_t lhs_len, const char *rhs, uint32_t rhs_len) {
+    return lhs_len == rhs_len && impl_.equals_(lhs, rhs, lhs_len);
+  }
+
+  static inline bool StartsWith(const char *value, uint32_t len, const char *prefix, uint32_t prefix_len) {
+    return prefix_len <= len && impl_.equals_(value, prefix, prefix_len);
+  }
+
+  /**
+   * 64 bit hash for hash joins, aggregations and hash indexes, stable across instruction sets and runs.
+   */
+  static inline uint64_t Hash(const char *data, uint32_t len) { return impl_.hash_(data, len); }
+
+  static inline Isa GetIsa() { return impl_.isa_; }
+
+  static bool IsSupported(Isa isa);
+
+  /**
+   * @return the fastest instruction set supported by the cpu, the one bound at startup
+   */
+  static Isa GetBestIsa();
+
+  /**
+   * Bind the kernels of isa, used by tests and benchmarks. Not thread safe.
+   * @return false if the cpu does not support isa
+   */
+  static bool SetIsa(Isa isa);
+
+ private:
+  struct Impl {
+    Isa isa_;
+    int (*compare_)(const char *lhs, uint32_t lhs_len, const char *rhs, uint32_t rhs_len);
+    bool (*equals_)(const char *lhs, const char *rhs, uint32_t len);
+    uint64_t (*hash_)(const char *data, uint32_t len);
+  };
+
+  static Impl Select(Isa isa);
+
+  static Impl impl_;
+};
+
+#endif  // MINISQL_CHAR_OPS_H
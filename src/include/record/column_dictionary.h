@@ -0,0 +1,91 @@
+#ifndef MINISQL_COLUMN_DICTIONARY_H
+#define MINISQL_COLUMN_DICTIONARY_H
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "common/macros.h"
+#include "record/char_ops.h"
+
+/**
+ * Dictionary of a dictionary-encoded char column. Tuples store the 2 byte code of a value instead of its bytes,
+ * codes are handed out in insertion order and never change, so a code stays valid for the lifetime of the table.
+ * Codes do not follow the order of the values, only equality can be decided on them.
+ *
+ * The dictionary is part of the table metadata and has to fit into its page, it stops growing once its
+ * serialized size would exceed the byte budget given by the table metadata.
+ *
+ *  Serialized format:
+ *  -------------------------------------------------------------------------------
+ *  | Magic (4) | Count (4) | Length-0 (4) | Value-0 | ... | Length-N (4) | Value-N |
+ *  -------------------------------------------------------------------------------
+ */
+class ColumnDictionary {
+ public:
+  static constexpr uint16_t INVALID_CODE = UINT16_MAX;
+
+  explicit ColumnDictionary(uint32_t max_bytes = UINT32_MAX) : max_bytes_(max_bytes) {}
+
+  ColumnDictionary(const ColumnDictionary &) = delete;
+
+  ColumnDictionary &operator=(const ColumnDictionary &) = delete;
+
+  /**
+   * @return code of the value, INVALID_CODE if the value is not in the dictionary
+   */
+  inline uint16_t Lookup(const char *data, uint32_t len) const {
+    auto iter = codes_.find(std::string_view(data, len));
+    return iter == codes_.end() ? INVALID_CODE : iter->second;
+  }
+
+  /**
+   * Code of the value, the value is added if needed.
+   * @return INVALID_CODE if the value is missing and the dictionary is full
+   */
+  uint16_t Encode(const char *data, uint32_t len);
+
+  inline const std::string &Decode(uint16_t code) const {
+    ASSERT(code < values_.size(), "Invalid dictionary code.");
+    return values_[code];
+  }
+
+  inline uint32_t GetSize() const { return static_cast<uint32_t>(values_.size()); }
+
+  inline void SetMaxBytes(uint32_t max_bytes) { max_bytes_ = max_bytes; }
+
+  /**
+   * @return whether values were added since the dictionary was last written
+   */
+  inline bool IsDirty() const { return dirty_; }
+
+  inline void ClearDirty() { dirty_ = false; }
+
+  uint32_t SerializeTo(char *buf) const;
+
+  inline uint32_t GetSerializedSize() const { return serialized_size_; }
+
+  static uint32_t DeserializeFrom(char *buf, ColumnDictionary *&dictionary);
+
+ private:
+  struct ValueHash {
+    inline size_t operator()(std::string_view value) const {
+      return static_cast<size_t>(CharOps::Hash(value.data(), static_cast<uint32_t>(value.size())));
+    }
+  };
+
+  void Append(const char *data, uint32_t len);
+
+  static constexpr uint32_t DICTIONARY_MAGIC_NUM = 290371;
+  /** values by code, a deque never moves its elements so the keys of codes_ stay valid */
+  std::deque<std::string> values_;
+  std::unordered_map<std::string_view, uint16_t, ValueHash> codes_;
+  uint32_t serialized_size_{2 * sizeof(uint32_t)};
+  uint32_t max_bytes_;
+  bool dirty_{false};
+};
+
+#endif  // MINISQL_COLUMN_DICTIONARY_H
@@ -2,7 +2,9 @@
 #define MINISQL_FIELD_H
 
 #include <cstring>
+#include <new>
 #include <string>
+#include <utility>
 
 #include "common/config.h"
 #include "common/macros.h"
@@ -18,6 +20,8 @@ class Field {
 
   friend class TypeFloat;
 
+  friend class FieldCompare;
+
  public:
   explicit Field(const TypeId type) : type_id_(type), len_(FIELD_NULL_LEN), is_null_(true) {}
 
@@ -41,43 +45,59 @@ class Field {
     len_ = Type::GetTypeSize(type);
   }
 
-  // char
-  explicit Field(TypeId type, char *data, uint32_t len, bool manage_data) : type_id_(type), manage_data_(manage_data) {
+  // char, a managed value of at most INLINE_CHAR_SIZE bytes is kept inside the field
+  explicit Field(TypeId type, char *data, uint32_t len, bool manage_data) : type_id_(type) {
     ASSERT(type == TypeId::kTypeChar, "Invalid type.");
     if (data == nullptr) {
       is_null_ = true;
       len_ = 0;
       value_.chars_ = nullptr;
-      manage_data_ = false;
     } else {
+      len_ = len;
       if (manage_data) {
         ASSERT(len < VARCHAR_MAX_LEN, "Field length exceeds max varchar length");
-        value_.chars_ = new char[len];
-        memcpy(value_.chars_, data, len);
+        CopyChars(data);
       } else {
         value_.chars_ = data;
       }
-      len_ = len;
     }
   }
 
-  // copy constructor
-  explicit Field(const Field &other) {
-    type_id_ = other.type_id_;
-    len_ = other.len_;
-    is_null_ = other.is_null_;
-    manage_data_ = other.manage_data_;
-    if (type_id_ == TypeId::kTypeChar && !is_null_ && manage_data_) {
-      value_.chars_ = new char[len_];
-      memcpy(value_.chars_, other.value_.chars_, len_);
+  // copy constructor, a field which does not manage its data still refers to the same bytes
+  Field(const Field &other) : type_id_(other.type_id_), len_(other.len_), is_null_(other.is_null_) {
+    if (other.OwnsChars()) {
+      CopyChars(other.value_.chars_);
+    } else {
+      value_ = other.value_;
+    }
+  }
+
+  // move constructor, steals the char data of other which becomes null
+  Field(Field &&other) noexcept : type_id_(other.type_id_), len_(other.len_), is_null_(other.is_null_) {
+    if (other.inline_data_) {
+      memcpy(inline_chars_, other.inline_chars_, len_);
+      value_.chars_ = inline_chars_;
+      inline_data_ = true;
     } else {
       value_ = other.value_;
+      manage_data_ = other.manage_data_;
     }
+    other.Release();
   }
 
-  // copy
-  Field &operator=(Field &other) {
-    Swap(*this, other);
+  Field &operator=(const Field &other) {
+    if (this != &other) {
+      Field copy(other);
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  Field &operator=(Field &&other) noexcept {
+    if (this != &other) {
+      this->~Field();
+      new (this) Field(std::move(other));
+    }
     return *this;
   }
 
@@ -122,11 +142,9 @@ class Field {
   }
 
   friend void Swap(Field &first, Field &second) {
-    std::swap(first.value_, second.value_);
-    std::swap(first.type_id_, second.type_id_);
-    std::swap(first.len_, second.len_);
-    std::swap(first.is_null_, second.is_null_);
-    std::swap(first.manage_data_, second.manage_data_);
+    Field temp(std::move(first));
+    first = std::move(second);
+    second = std::move(temp);
   }
 
   std::string toString() {
@@ -144,7 +162,40 @@ class Field {
     }
   }
 
+ public:
+  /** Managed char values up to this size are copied into the field instead of a separate allocation */
+  static constexpr uint32_t INLINE_CHAR_SIZE = 16;
+
  protected:
+  inline bool OwnsChars() const { return type_id_ == TypeId::kTypeChar && !is_null_ && (manage_data_ || inline_data_); }
+
+  /**
+   * Copy len_ bytes of data into storage owned by the field.
+   */
+  void CopyChars(const char *data) {
+    if (len_ <= INLINE_CHAR_SIZE) {
+      value_.chars_ = inline_chars_;
+      inline_data_ = true;
+    } else {
+      value_.chars_ = new char[len_];
+      manage_data_ = true;
+    }
+    memcpy(value_.chars_, data, len_);
+  }
+
+  /**
+   * Forget the char data after it was moved away, the field becomes null.
+   */
+  void Release() {
+    if (type_id_ == TypeId::kTypeChar) {
+      value_.chars_ = nullptr;
+      len_ = 0;
+      is_null_ = true;
+    }
+    manage_data_ = false;
+    inline_data_ = false;
+  }
+
   union Val {
     int32_t integer_;
     float float_;
@@ -153,7 +204,9 @@ class Field {
   TypeId type_id_;
   uint32_t len_;
   bool is_null_{false};
-  bool manage_data_{false};
+  bool manage_data_{false}; /** chars_ was allocated with new[] */
+  bool inline_data_{false}; /** chars_ points to inline_chars_ */
+  char inline_chars_[INLINE_CHAR_SIZE];
 };
 
 #endif  // MINISQL_FIELD_H
@@ -0,0 +1,96 @@
+#ifndef MINISQL_FIELD_COMPARE_H
+#define MINISQL_FIELD_COMPARE_H
+
+#include <cstring>
+#include <string>
+
+#include "record/char_ops.h"
+#include "record/field.h"
+#include "record/types.h"
+
+/**
+ * Comparison kernels specialized per type at compile time. A kernel reads the values straight out of two fields or
+ * two serialized values, so calling it involves neither a Type virtual call nor a temporary Field. Kernels are bound
+ * once, when the types of an expression are known, and then called through a function pointer.
+ */
+class FieldCompare {
+ public:
+  enum class Op { kEq = 0, kNe, kLt, kLe, kGt, kGe };
+
+  /** Evaluate lhs op rhs, @return kNull if either field is null */
+  using Kernel = CmpBool (*)(const Field &lhs, const Field &rhs);
+
+  static Kernel BindKernel(TypeId type, Op op);
+
+  /**
+   * @return false if op is not one of =, <>, <, <=, >, >=
+   */
+  static bool ParseOp(const std::string &op, Op *out);
+
+  /**
+   * Truth value of the int field produced by evaluating a predicate.
+   */
+  static inline CmpBool AsCmpBool(const Field &val) {
+    if (val.IsNull() || val.value_.integer_ == CmpBool::kNull) {
+      return CmpBool::kNull;
+    }
+    return GetCmpBool(val.value_.integer_ == CmpBool::kTrue);
+  }
+
+  template <TypeId type>
+  static inline int CompareValues(const char *lhs, uint32_t lhs_len, const char *rhs, uint32_t rhs_len);
+
+ private:
+  static inline const char *RawData(const Field &field) {
+    return field.type_id_ == TypeId::kTypeChar ? field.value_.chars_ : reinterpret_cast<const char *>(&field.value_);
+  }
+
+  template <TypeId type, Op op>
+  static CmpBool Apply(const Field &lhs, const Field &rhs) {
+    if (lhs.is_null_ || rhs.is_null_) {
+      return CmpBool::kNull;
+    }
+    if constexpr (type == TypeId::kTypeChar && (op == Op::kEq || op == Op::kNe)) {
+      return GetCmpBool(CharOps::Equals(lhs.value_.chars_, lhs.len_, rhs.value_.chars_, rhs.len_) == (op == Op::kEq));
+    }
+    int cmp = CompareValues<type>(RawData(lhs), lhs.len_, RawData(rhs), rhs.len_);
+    if constexpr (op == Op::kEq) {
+      return GetCmpBool(cmp == 0);
+    } else if constexpr (op == Op::kNe) {
+      return GetCmpBool(cmp != 0);
+    } else if constexpr (op == Op::kLt) {
+      return GetCmpBool(cmp < 0);
+    } else if constexpr (op == Op::kLe) {
+      return GetCmpBool(cmp <= 0);
+    } else if constexpr (op == Op::kGt) {
+      return GetCmpBool(cmp > 0);
+    } else {
+      return GetCmpBool(cmp >= 0);
+    }
+  }
+
+  template <TypeId type>
+  static Kernel BindKernel(Op op);
+};
+
+template <>
+inline int FieldCompare::CompareValues<TypeId::kTypeInt>(const char *lhs, uint32_t, const char *rhs, uint32_t) {
+  int32_t l = MACH_READ_INT32(lhs);
+  int32_t r = MACH_READ_INT32(rhs);
+  return (l > r) - (l < r);
+}
+
+template <>
+inline int FieldCompare::CompareValues<TypeId::kTypeFloat>(const char *lhs, uint32_t, const char *rhs, uint32_t) {
+  float l = MACH_READ_FROM(float, lhs);
+  float r = MACH_READ_FROM(float, rhs);
+  return (l > r) - (l < r);
+}
+
+template <>
+inline int FieldCompare::CompareValues<TypeId::kTypeChar>(const char *lhs, uint32_t lhs_len, const char *rhs,
+                                                          uint32_t rhs_len) {
+  return CharOps::Compare(lhs, lhs_len, rhs, rhs_len);
+}
+
+#endif  // MINISQL_FIELD_COMPARE_H
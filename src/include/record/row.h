@@ -8,18 +8,27 @@
 #include "common/rowid.h"
 #include "record/field.h"
 #include "record/schema.h"
+#include "utils/mem_heap.h"
 
 /**
  *  Row format:
- * -------------------------------------------
- * | Header | Field-1 | ... | Field-N |
- * -------------------------------------------
+ * ---------------------------------------------------
+ * | Header | Fixed area | Char data-1 | ... | Char data-M |
+ * ---------------------------------------------------
  *  Header format:
- * --------------------------------------------
- * | Field Nums | Null bitmap |
- * -------------------------------------------
+ * --------------------------------
+ * | Version (1) | Null bitmap |
+ * --------------------------------
  *
+ *  The field count is taken from the schema. The fixed area holds one slot per column in schema order: int and
+ *  float values take 4 bytes, a char column takes the 2 byte end offset (from the start of the row) of its data.
+ *  Null values keep their slot, so every slot sits at a constant offset and any column is read without decoding
+ *  the others. The data of a char column starts where the data of the previous char column ends.
+ *  A dictionary-encoded char column (see Schema::SetDictionary) takes the 2 byte code of its value and has no data.
  *
+ *  Rows written before this format start with the field count and the null count (4 bytes each), followed by the
+ *  4 byte index of every null field and the values of the other fields, a char value prefixed by its 4 byte
+ *  length. DeserializeFrom still reads them, the version byte tells the two layouts apart.
  */
 class Row {
  public:
@@ -27,21 +36,14 @@ class Row {
    * Row used for insert
    * Field integrity should check by upper level
    */
-  Row(std::vector<Field> &fields) {
-    // deep copy
-    for (auto &field : fields) {
-      fields_.push_back(new Field(field));
-    }
-  }
+  Row(const std::vector<Field> &fields) : fields_(fields) {}
 
-  void destroy() {
-    if (!fields_.empty()) {
-      for (auto field : fields_) {
-        delete field;
-      }
-      fields_.clear();
-    }
-  }
+  /**
+   * Row used for insert, takes the fields over without copying them
+   */
+  Row(std::vector<Field> &&fields) : fields_(std::move(fields)) {}
+
+  void destroy() { fields_.clear(); }
 
   ~Row() {
     destroy();
@@ -58,28 +60,55 @@ class Row {
   Row(RowId rid) : rid_(rid) {}
 
   /**
-   * Row copy function, deep copy
+   * Row whose char data longer than Field::INLINE_CHAR_SIZE is allocated from heap, the heap must outlive the row
    */
-  Row(const Row &other) {
-    destroy();
-    rid_ = other.rid_;
+  explicit Row(MemHeap *heap) : heap_(heap) {}
+
+  Row(RowId rid, MemHeap *heap) : rid_(rid), heap_(heap) {}
+
+  /**
+   * Row copy function, deep copy. The copy never shares the heap of other, so it outlives a reset of that heap.
+   */
+  Row(const Row &other) : rid_(other.rid_) {
+    fields_.reserve(other.fields_.size());
     for (auto &field : other.fields_) {
-      fields_.push_back(new Field(*field));
+      AppendField(field);
     }
   }
 
   /**
-   * Assign operator, deep copy
+   * Move constructor, the fields are taken over and keep referring to the heap of other
+   */
+  Row(Row &&other) noexcept : rid_(other.rid_), fields_(std::move(other.fields_)), heap_(other.heap_) {}
+
+  /**
+   * Assign operator, deep copy into the storage of this row
    */
   Row &operator=(const Row &other) {
+    if (this == &other) {
+      return *this;
+    }
     destroy();
     rid_ = other.rid_;
+    fields_.reserve(other.fields_.size());
     for (auto &field : other.fields_) {
-      fields_.push_back(new Field(*field));
+      AppendField(field);
     }
     return *this;
   }
 
+  Row &operator=(Row &&other) noexcept {
+    rid_ = other.rid_;
+    fields_ = std::move(other.fields_);
+    heap_ = other.heap_;
+    return *this;
+  }
+
+  /**
+   * Deep copy field to the end of the row, char data is always copied into the storage of the row.
+   */
+  void AppendField(const Field &field);
+
   /**
    * Note: Make sure that bytes write to buf is equal to GetSerializedSize()
    */
@@ -87,6 +116,13 @@ class Row {
 
   uint32_t DeserializeFrom(char *buf, Schema *schema);
 
+  /**
+   * Decode only the columns listed in columns (ascending table column indexes), every other field of the row is
+   * a null placeholder. Each listed column is read at its fixed offset, the others are never touched.
+   * @return serialized size of the row, same as the full DeserializeFrom
+   */
+  uint32_t DeserializeFrom(char *buf, Schema *schema, const std::vector<uint32_t> &columns);
+
   /**
    * For empty row, return 0
    * For non-empty row with null fields, eg: |null|null|null|, return header size only
@@ -100,22 +136,57 @@ class Row {
 
   inline void SetRowId(RowId rid) { rid_ = rid; }
 
-  inline std::vector<Field *> &GetFields() { return fields_; }
+  inline std::vector<Field> &GetFields() { return fields_; }
 
   inline Field *GetField(uint32_t idx) const {
     ASSERT(idx < fields_.size(), "Failed to access field");
-    return fields_[idx];
+    return const_cast<Field *>(&fields_[idx]);
   }
 
   inline size_t GetFieldCount() const { return fields_.size(); }
 
  private:
+  /**
+   * Decode a row written in the layout which predates ROW_FORMAT_VERSION.
+   * @return serialized size of the row
+   */
+  uint32_t DeserializeLegacyFrom(char *buf, Schema *schema);
+
+  /**
+   * Append a decoded value, slot holds an int or float value, chars and len the data of a char value.
+   */
+  void AppendValue(TypeId type, const char *slot, bool is_null, char *chars, uint32_t len);
+
+  /**
+   * Append the value of a dictionary-encoded column, slot holds its code.
+   */
+  void AppendCode(const ColumnDictionary *dictionary, const char *slot, bool is_null);
+
   RowId rid_{};
-  std::vector<Field *> fields_; /** Make sure that all field ptr are destructed*/
+  std::vector<Field> fields_;
+  MemHeap *heap_{nullptr}; /** long char data is allocated from heap_ if set, otherwise owned by the field */
   /*jy added*/
   uint32_t fields_nums{0};
   uint32_t null_nums{0};
- static constexpr uint32_t ROW_MAGIC_NUM = 10117;
+ public:
+  /**
+   * First byte of every row in this format. A row in the old layout starts with ROW_MAGIC_NUM as a 4 byte
+   * integer, whose low byte differs from this value.
+   */
+  static constexpr uint8_t ROW_FORMAT_VERSION = 0xff;
+
+  /**
+   * Leading integer of a row in the old layout: magic number, field count, null bitmap of one bit per field from the
+   * high bit, then the fields which are not null, char fields prefixed by their 4 byte length.
+   */
+  static constexpr uint32_t ROW_MAGIC_NUM = 10117;
+
+  /**
+   * @return size of the version byte and the null bitmap, i.e. the offset of the fixed area
+   */
+  static inline uint32_t GetHeaderSize(const Schema *schema) {
+    return sizeof(uint8_t) + (schema->GetColumnCount() + 7) / 8;
+  }
 };
 
 #endif  // MINISQL_ROW_H
@@ -0,0 +1,142 @@
+#ifndef MINISQL_ROW_DECODER_H
+#define MINISQL_ROW_DECODER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "common/macros.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+class RowDecoder;
+
+/**
+ * Columnar buffers filled by a RowDecoder, one typed vector per column of the schema. A column that is not decoded
+ * keeps empty vectors and must not be read.
+ *
+ * Char values are not copied: they refer to the decoded tuples, so they are only valid while the pages holding the
+ * tuples stay pinned. Values of a dictionary-encoded column are kept as codes and decoded when they are read.
+ * Clear keeps the capacity of every vector, a batch reused for tuples of the same shape stops allocating.
+ */
+class ColumnBatch {
+  friend class RowDecoder;
+
+ public:
+  explicit ColumnBatch(const Schema *schema) : schema_(schema), columns_(schema->GetColumnCount()) {}
+
+  inline void Clear() {
+    for (auto &column : columns_) {
+      column.nulls_.clear();
+      column.ints_.clear();
+      column.floats_.clear();
+      column.chars_.clear();
+      column.lengths_.clear();
+      column.codes_.clear();
+    }
+    row_count_ = 0;
+  }
+
+  inline uint32_t GetRowCount() const { return row_count_; }
+
+  inline bool IsNull(uint32_t column, uint32_t row) const { return columns_[column].nulls_[row] != 0; }
+
+  inline int32_t GetInt(uint32_t column, uint32_t row) const { return columns_[column].ints_[row]; }
+
+  inline float GetFloat(uint32_t column, uint32_t row) const { return columns_[column].floats_[row]; }
+
+  inline uint16_t GetCode(uint32_t column, uint32_t row) const { return columns_[column].codes_[row]; }
+
+  const char *GetChars(uint32_t column, uint32_t row) const;
+
+  uint32_t GetCharLength(uint32_t column, uint32_t row) const;
+
+  /**
+   * Field referring to the value, char data is not owned by the returned field.
+   */
+  Field GetField(uint32_t column, uint32_t row) const;
+
+  /**
+   * Append every column of the row to out, a column that was not decoded becomes a null placeholder.
+   */
+  void Materialize(uint32_t row, Row *out) const;
+
+  /**
+   * Overwrite the fields of out with fields referring to the values of the row, nothing is copied or allocated once
+   * out has been used for a row of this batch before. The fields are only valid as long as the batch is.
+   */
+  void View(uint32_t row, Row *out) const;
+
+ private:
+  inline bool IsDecoded(uint32_t column) const { return columns_[column].nulls_.size() == row_count_; }
+
+  struct ColumnVector {
+    std::vector<uint8_t> nulls_;
+    /** only the vectors of the column type are filled */
+    std::vector<int32_t> ints_;
+    std::vector<float> floats_;
+    std::vector<const char *> chars_;
+    std::vector<uint32_t> lengths_;
+    std::vector<uint16_t> codes_;
+  };
+
+  const Schema *schema_;
+  std::vector<ColumnVector> columns_;
+  uint32_t row_count_{0};
+};
+
+/**
+ * Decoder of the row format (see row.h) compiled from a schema. Every column becomes one step of a flat program
+ * that knows where the null bit, the slot and the char data of the column are, so decoding does not look at the
+ * schema, call into the type system or allocate a field.
+ *
+ * Tuples are decoded a column at a time: each step runs one tight loop over all tuples of a call, with the type
+ * branch taken once per column instead of once per value.
+ */
+class RowDecoder {
+ public:
+  /**
+   * Decoder of every column of schema
+   */
+  explicit RowDecoder(const Schema *schema);
+
+  /**
+   * Decoder of the columns listed in columns (table column indexes), the other columns are skipped
+   */
+  RowDecoder(const Schema *schema, const std::vector<uint32_t> &columns);
+
+  inline const Schema *GetSchema() const { return schema_; }
+
+  /**
+   * @return number of columns decoded
+   */
+  inline uint32_t GetStepCount() const { return static_cast<uint32_t>(program_.size()); }
+
+  /**
+   * Append count serialized rows to batch, which has to be created for the schema of the decoder.
+   */
+  void Decode(const char *const *tuples, uint32_t count, ColumnBatch *batch) const;
+
+  inline void Decode(const char *tuple, ColumnBatch *batch) const { Decode(&tuple, 1, batch); }
+
+ private:
+  enum class StepKind : uint8_t { kInt, kFloat, kChar, kCode };
+
+  struct Step {
+    uint32_t column_;
+    StepKind kind_;
+    uint8_t null_mask_;
+    uint32_t null_byte_; /** offset of the header byte holding the null bit */
+    uint32_t slot_;      /** offset of the slot from the start of the row */
+    /** char data start: the slot of the previous char column, or the start of the char data if first_varlen_ */
+    uint32_t start_;
+    bool first_varlen_;
+  };
+
+  void Compile(const std::vector<uint32_t> &columns);
+
+  const Schema *schema_;
+  std::vector<Step> program_;
+};
+
+#endif  // MINISQL_ROW_DECODER_H
@@ -7,13 +7,17 @@
 #include "glog/logging.h"
 #include "record/column.h"
 
+class ColumnDictionary;
+
 #ifndef MINISQL_SCHEMA_H
 #define MINISQL_SCHEMA_H
 
 class Schema {
  public:
   explicit Schema(const std::vector<Column *> columns, bool is_manage_ = true)
-      : columns_(std::move(columns)), is_manage_(is_manage_) {}
+      : columns_(std::move(columns)), is_manage_(is_manage_) {
+    ComputeRowLayout();
+  }
 
   ~Schema() {
     if (is_manage_) {
@@ -39,6 +43,43 @@ class Schema {
 
   inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
 
+  /**
+   * Row format helpers, see row.h. Offsets are relative to the start of the fixed area of a serialized row.
+   * @return offset of the value of a fixed-width column, or of the end offset of a char column
+   */
+  inline uint32_t GetFixedOffset(const uint32_t column_index) const { return fixed_offsets_[column_index]; }
+
+  /**
+   * @return size of the fixed area of a serialized row
+   */
+  inline uint32_t GetFixedSize() const { return fixed_size_; }
+
+  /**
+   * @return the closest char column before column_index, -1 if column_index is the first char column
+   */
+  inline int32_t GetPrevVarlenColumn(const uint32_t column_index) const { return prev_varlen_[column_index]; }
+
+  /**
+   * @return the last char column, -1 if the schema has no char column
+   */
+  inline int32_t GetLastVarlenColumn() const { return last_varlen_; }
+
+  /**
+   * @return dictionary of a dictionary-encoded char column, nullptr for any other column
+   */
+  inline ColumnDictionary *GetDictionary(const uint32_t column_index) const { return dictionaries_[column_index]; }
+
+  /**
+   * Store char column column_index as codes of dictionary, which is owned by the table metadata.
+   * The row layout changes: the column takes a 2 byte code in the fixed area and no longer has char data.
+   * Only called while the table is set up, before any tuple is read or written with this schema.
+   */
+  void SetDictionary(const uint32_t column_index, ColumnDictionary *dictionary) {
+    ASSERT(columns_[column_index]->GetType() == TypeId::kTypeChar, "Only char columns are dictionary-encoded.");
+    dictionaries_[column_index] = dictionary;
+    ComputeRowLayout();
+  }
+
   /**
    * Shallow copy schema, only used in index
    *
@@ -81,9 +122,16 @@ class Schema {
   static uint32_t DeserializeFrom(char *buf, Schema *&schema);
 
  private:
+  void ComputeRowLayout();
+
   static constexpr uint32_t SCHEMA_MAGIC_NUM = 200715;
   std::vector<Column *> columns_;
   bool is_manage_ = false; /** if false, don't need to delete pointer to column */
+  std::vector<uint32_t> fixed_offsets_;
+  std::vector<int32_t> prev_varlen_;
+  std::vector<ColumnDictionary *> dictionaries_; /** not owned, only set in the schema of a table */
+  uint32_t fixed_size_{0};
+  int32_t last_varlen_{-1};
 };
 
 using IndexSchema = Schema;
@@ -0,0 +1,97 @@
+#ifndef MINISQL_TUPLE_VIEW_H
+#define MINISQL_TUPLE_VIEW_H
+
+#include <vector>
+
+#include "common/macros.h"
+#include "common/rowid.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+class PaxLayout;
+
+/**
+ * Read-only view over a serialized row (see row.h for the layout), or over one slot of a PAX page.
+ *
+ * The view does not copy the tuple bytes, it is only valid while the page holding them stays pinned and the
+ * tuple is not moved. Every column sits at an offset known from the schema, so a consumer that only looks at the
+ * row id or at a few columns never pays for decoding the rest of the tuple.
+ */
+class TupleView {
+ public:
+  TupleView() = default;
+
+  explicit TupleView(char *data, Schema *schema, RowId rid) : data_(data), schema_(schema), rid_(rid) {}
+
+  /**
+   * View over the slot rid.GetSlotNum() of a PAX page, every column is read straight from its minipage.
+   */
+  explicit TupleView(char *page_data, const PaxLayout *layout, RowId rid);
+
+  inline bool IsValid() const { return data_ != nullptr; }
+
+  inline RowId GetRowId() const { return rid_; }
+
+  /**
+   * @return the serialized row, or the whole page for a PAX view
+   */
+  inline const char *GetData() const { return data_; }
+
+  uint32_t GetColumnCount() const;
+
+  bool IsNull(uint32_t idx) const;
+
+  int32_t GetInt(uint32_t idx) const;
+
+  float GetFloat(uint32_t idx) const;
+
+  const char *GetChars(uint32_t idx) const;
+
+  uint32_t GetCharLength(uint32_t idx) const;
+
+  /**
+   * @return stored code of the non-null value of a dictionary-encoded column, compared without decoding the value
+   */
+  uint16_t GetCode(uint32_t idx) const;
+
+  /**
+   * Field referring to the bytes of the view, char data is not owned by the returned field.
+   */
+  Field GetField(uint32_t idx) const;
+
+  /**
+   * Deep copy the tuple into row, used when the consumer has to own the row.
+   * @return bytes read from the view, for a PAX view the bytes of the non-null values
+   */
+  uint32_t Materialize(Row *row) const;
+
+  /**
+   * Deep copy only the columns listed in columns (ascending), the other fields of row are null placeholders.
+   */
+  uint32_t Materialize(Row *row, const std::vector<uint32_t> &columns) const;
+
+ private:
+  /**
+   * @return first byte of the value of column idx, the end offset of a char column in the row format
+   */
+  const char *GetValue(uint32_t idx) const;
+
+  /**
+   * @return offset of the data of char column idx in the row format
+   */
+  uint32_t GetVarlenStart(uint32_t idx) const;
+
+  /**
+   * Copy the columns of a PAX slot, a column is only decoded when needed(idx) is true.
+   */
+  template <typename Needed>
+  uint32_t MaterializePax(Row *row, Needed needed) const;
+
+  char *data_{nullptr};
+  Schema *schema_{nullptr};
+  RowId rid_{};
+  const PaxLayout *pax_layout_{nullptr}; /** set for views over a PAX page */
+};
+
+#endif  // MINISQL_TUPLE_VIEW_H
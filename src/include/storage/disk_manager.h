@@ -16,8 +16,9 @@
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
  *
  * Disk page storage format: (Free Page BitMap Size = PAGE_SIZE * 8, we note it as N)
- * | Meta Page | Free Page BitMap 1 | Page 1 | Page 2 | ....
+ * | Free Page BitMap 1 | Page 1 | Page 2 | ....
  *      | Page N | Free Page BitMap 2 | Page N+1 | ... | Page 2N | ... |
+ * The meta page is not stored, it is rebuilt from the bitmaps when the file is opened.
  */
 class DiskManager {
  public:
@@ -70,6 +71,9 @@ class DiskManager {
 
   static constexpr size_t BITMAP_SIZE = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
 
+  /** number of extents whose used page count fits in the disk meta page */
+  static constexpr size_t MAX_EXTENT_NUMS = (PAGE_SIZE - 2 * sizeof(uint32_t)) / sizeof(uint32_t);
+
  private:
   /**
    * Helper function to get disk file size
@@ -91,6 +95,16 @@ class DiskManager {
    */
   page_id_t MapPageId(page_id_t logical_page_id);
 
+  /**
+   * Physical page holding the bitmap of extent_id, it directly precedes the pages of the extent
+   */
+  inline page_id_t GetBitmapPhysicalPageId(uint32_t extent_id) const { return extent_id * (BITMAP_SIZE + 1); }
+
+  /**
+   * Count the extents of the file and their used pages into the meta page
+   */
+  void LoadMetaData();
+
  private:
   // stream to write db file
   std::fstream db_io_;
@@ -1,28 +1,52 @@
 #ifndef MINISQL_TABLE_HEAP_H
 #define MINISQL_TABLE_HEAP_H
 
+#include <functional>
+
 #include "buffer/buffer_pool_manager.h"
 #include "page/header_page.h"
+#include "page/pax_page.h"
 #include "page/table_page.h"
 #include "storage/table_iterator.h"
 #include "transaction/lock_manager.h"
 #include "transaction/log_manager.h"
 
+/**
+ * How the tuples of a table are laid out in its pages, chosen once at CREATE TABLE.
+ */
+enum class TableLayout {
+  kRow = 0, /** whole rows stored contiguously in slotted TablePages */
+  kPax,     /** every column in its own minipage of a PaxPage */
+};
+
 class TableHeap {
   friend class TableIterator;
 
  public:
+  /**
+   * Receives the live tuples of one page. The views are only valid during the call.
+   * Return false to stop the scan.
+   */
+  using PageVisitor = std::function<bool(const std::vector<TupleView> &)>;
+
+  /**
+   * Writes the dictionaries of the table to disk, returns false if they could not be written.
+   */
+  using DictionaryWriter = std::function<bool()>;
+
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn,
-                           LogManager *log_manager, LockManager *lock_manager) {
-    return new TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager);
+                           LogManager *log_manager, LockManager *lock_manager,
+                           TableLayout layout = TableLayout::kRow) {
+    return new TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager, layout);
   }
 
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                           LogManager *log_manager, LockManager *lock_manager) {
-    return new TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager);
+                           LogManager *log_manager, LockManager *lock_manager,
+                           TableLayout layout = TableLayout::kRow) {
+    return new TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager, layout);
   }
 
-  ~TableHeap() {}
+  ~TableHeap() { delete pax_layout_; }
 
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
@@ -41,13 +65,13 @@ class TableHeap {
   bool MarkDelete(const RowId &rid, Transaction *txn);
 
   /**
-   * if the new tuple is too large to fit in the old page, return false (will delete and insert)
-   * @param[in] row Tuple of new row
+   * if the new tuple is too large to fit in the old page, the old tuple is deleted and the new one inserted elsewhere
+   * @param[in/out] row Tuple of new row, the rid of the tuple after the update is wrapped in object row
    * @param[in] rid Rid of the old tuple
    * @param[in] txn Transaction performing the update
-   * @return true is update is successful.
+   * @return true is update is successful, the old tuple is left untouched otherwise.
    */
-  bool UpdateTuple(const Row &row, const RowId &rid, Transaction *txn);
+  bool UpdateTuple(Row &row, const RowId &rid, Transaction *txn);
 
   /**
    * Called on Commit/Abort to actually delete a tuple or rollback an insert.
@@ -71,10 +95,17 @@ class TableHeap {
    */
   bool GetTuple(Row *row, Transaction *txn);
 
+  /**
+   * Read only the columns listed in columns (ascending table column indexes), the other fields of row are null
+   * placeholders.
+   */
+  bool GetTuple(Row *row, const std::vector<uint32_t> &columns, Transaction *txn);
+
   void FreeTableHeap() {
     auto next_page_id = first_page_id_;
     while (next_page_id != INVALID_PAGE_ID) {
       auto old_page_id = next_page_id;
+      // TablePage and PaxPage share the page header, the chain is walked the same way for both layouts
       auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(old_page_id));
       assert(page != nullptr);
       next_page_id = page->GetNextPageId();
@@ -83,11 +114,48 @@ class TableHeap {
     }
   }
 
+  /**
+   * Compact the table: reclaim tuples marked deleted, then move tuples from the tail of the page chain into the
+   * free space of the pages before them. Pages emptied this way are unlinked and released through DeletePage.
+   * The first page is never released, so the table meta data stays valid.
+   * @param[out] moved (old rid, new rid) of every relocated tuple, callers use it to fix index entries
+   * @param[in] txn Transaction performing the vacuum
+   * @return number of pages released
+   */
+  uint32_t Vacuum(std::vector<std::pair<RowId, RowId>> &moved, Transaction *txn);
+
+  /**
+   * Rewrite every tuple still stored in the row layout which predates Row::ROW_FORMAT_VERSION, scans and tuple
+   * views only understand the current one. Does nothing for a PAX table.
+   * @param[out] moved (old rid, new rid) of every tuple which grew out of its page, callers use it to fix indexes
+   * @param[in] txn Transaction performing the upgrade
+   * @return number of tuples rewritten
+   */
+  uint32_t UpgradeRows(std::vector<std::pair<RowId, RowId>> &moved, Transaction *txn);
+
   /**
    * Free table heap and release storage in disk file
    */
   void DeleteTable(page_id_t page_id = INVALID_PAGE_ID);
 
+  /**
+   * Scan the table page at a time, every page is pinned exactly once and all its live tuples are handed over
+   * to the visitor in one batch.
+   */
+  void ScanPages(const PageVisitor &visitor, Transaction *txn);
+
+  /**
+   * Hand the live tuples of a single page to the visitor, the building block of ScanPages.
+   * @param[out] keep_going false if the visitor asked to stop
+   * @return id of the page following page_id in the chain
+   */
+  page_id_t ScanPage(page_id_t page_id, const PageVisitor &visitor, Transaction *txn, bool *keep_going = nullptr);
+
+  /**
+   * Collect the ids of all pages in the chain, in chain order. Parallel scans split this list into morsels.
+   */
+  void GetPageIds(std::vector<page_id_t> &page_ids);
+
   /**
    * @return the begin iterator of this table
    */
@@ -103,32 +171,83 @@ class TableHeap {
    */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /**
+   * Called whenever a tuple adds a value to a dictionary, before the tuple holding its code is written, so no page
+   * on disk refers to a code the dictionaries on disk lack.
+   */
+  inline void SetDictionaryWriter(DictionaryWriter writer) { dictionary_writer_ = std::move(writer); }
+
+  inline TableLayout GetLayout() const { return pax_layout_ == nullptr ? TableLayout::kRow : TableLayout::kPax; }
+
+  /**
+   * @return minipage placement of a PAX table, nullptr for a row table
+   */
+  inline const PaxLayout *GetPaxLayout() const { return pax_layout_; }
+
 private:
   /**
    * create table heap and initialize first page
    */
   explicit TableHeap(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn,
-                     LogManager *log_manager, LockManager *lock_manager) :
+                     LogManager *log_manager, LockManager *lock_manager, TableLayout layout) :
           buffer_pool_manager_(buffer_pool_manager),
           schema_(schema),
           log_manager_(log_manager),
-          lock_manager_(lock_manager) {
+          lock_manager_(lock_manager),
+          pax_layout_(layout == TableLayout::kPax ? new PaxLayout(schema) : nullptr) {
     //ASSERT(false, "Not implemented yet.");
-    auto first_page = (TablePage *)(buffer_pool_manager_->NewPage(first_page_id_));
+    Page *first_page = buffer_pool_manager_->NewPage(first_page_id_);
     ASSERT(first_page != nullptr, "Can not initialize the first page for table heap.");
-    first_page->Init(first_page_id_, INVALID_PAGE_ID, log_manager_, txn);
+    if (pax_layout_ != nullptr) {
+      reinterpret_cast<PaxPage *>(first_page)->Init(first_page_id_, INVALID_PAGE_ID, log_manager_, txn);
+    } else {
+      reinterpret_cast<TablePage *>(first_page)->Init(first_page_id_, INVALID_PAGE_ID, log_manager_, txn);
+    }
 
     // first created, need to write to disk, so it's dirty
     buffer_pool_manager_->UnpinPage(first_page_id_, true);
   };
 
   explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                     LogManager *log_manager, LockManager *lock_manager)
+                     LogManager *log_manager, LockManager *lock_manager, TableLayout layout)
       : buffer_pool_manager_(buffer_pool_manager),
         first_page_id_(first_page_id),
         schema_(schema),
         log_manager_(log_manager),
-        lock_manager_(lock_manager) {}
+        lock_manager_(lock_manager),
+        pax_layout_(layout == TableLayout::kPax ? new PaxLayout(schema) : nullptr) {}
+
+  /**
+   * Layout independent bodies of the public operations. PageType is TablePage or PaxPage and Format is what
+   * the page needs to encode a tuple, the schema for a TablePage and the PaxLayout for a PaxPage.
+   */
+  template <typename PageType, typename Format>
+  bool InsertTupleImpl(Row &row, const Format &format, Transaction *txn);
+
+  template <typename PageType, typename Format>
+  bool UpdateTupleImpl(Row &row, const RowId &rid, const Format &format, Transaction *txn);
+
+  template <typename PageType, typename Format>
+  bool GetTupleImpl(Row *row, const Format &format, Transaction *txn);
+
+  template <typename PageType, typename Format>
+  uint32_t VacuumImpl(std::vector<std::pair<RowId, RowId>> &moved, const Format &format, Transaction *txn);
+
+  /**
+   * Add the values of the dictionary-encoded columns of row to their dictionaries, before the row is written.
+   * New values are handed to the dictionary writer.
+   * @return false if a dictionary is full or could not be written
+   */
+  bool EncodeDictionaries(const Row &row);
+
+  /**
+   * Per page helpers of TableIterator, they pick the page type from the layout of the table.
+   */
+  bool GetFirstTupleRid(Page *page, RowId *rid);
+
+  bool GetNextTupleRid(Page *page, const RowId &cur_rid, RowId *next_rid);
+
+  bool GetTupleView(Page *page, const RowId &rid, TupleView *view);
 
  private:
   BufferPoolManager *buffer_pool_manager_;
@@ -136,6 +255,8 @@ private:
   Schema *schema_;
    LogManager *log_manager_;
    LockManager *lock_manager_;
+  PaxLayout *pax_layout_{nullptr}; /** only set for PAX tables */
+  DictionaryWriter dictionary_writer_;
 };
 
 #endif  // MINISQL_TABLE_HEAP_H
@@ -42,11 +42,17 @@
 #define MINISQL_TABLE_ITERATOR_H
 
 #include "common/rowid.h"
+#include "page/table_page.h"
 #include "record/row.h"
+#include "record/tuple_view.h"
 #include "transaction/transaction.h"
 
 class TableHeap;
 
+/**
+ * The iterator keeps the page of the current tuple pinned and only hands out views into it.
+ * A Row is deserialized on operator* / operator-> only, and it is reused while the iterator moves.
+ */
 class TableIterator {
  public:
   // you may define your own constructor based on your member variables
@@ -66,18 +72,32 @@ class TableIterator {
 
   Row *operator->();
 
+  /**
+   * @return view over the current tuple, valid until the iterator moves
+   */
+  TupleView GetTupleView() const;
+
+  inline RowId GetRowId() const { return row_id_; }
+
   TableIterator &operator=(const TableIterator &itr) noexcept;
 
   TableIterator &operator++();
 
   TableIterator operator++(int);
 
+ private:
+  void PinPage();
+
+  void UnpinPage();
+
  private:
   // add your own private member variables here
-  Transaction *txn_;
-  [[maybe_unused]] TableHeap *table_heap_;
+  Transaction *txn_{nullptr};
+  TableHeap *table_heap_{nullptr};
   RowId row_id_;
-  Row * row_{nullptr};
+  Page *page_{nullptr}; /** page of row_id_, pinned while the iterator stays on it */
+  Row *row_{nullptr};
+  bool row_materialized_{false};
 };
 
 #endif  // MINISQL_TABLE_ITERATOR_H
@@ -0,0 +1,95 @@
+#ifndef MINISQL_MEM_HEAP_H
+#define MINISQL_MEM_HEAP_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
+#include "common/macros.h"
+
+/**
+ * Allocator interface for objects created with ALLOC/ALLOC_P. Objects placed in a heap are destructed by their
+ * owner, the memory is returned with Free.
+ */
+class MemHeap {
+ public:
+  virtual ~MemHeap() = default;
+
+  virtual void *Allocate(size_t size) = 0;
+
+  virtual void Free(void *ptr) = 0;
+};
+
+/**
+ * Bump allocator, memory is carved out of large chunks and only released in bulk by Reset or by the destructor.
+ * Free is a no-op. Meant for short-lived data such as the rows of a scan batch, one heap must not be shared by
+ * several threads.
+ */
+class ArenaHeap : public MemHeap {
+ public:
+  explicit ArenaHeap(size_t chunk_size = DEFAULT_CHUNK_SIZE) : chunk_size_(chunk_size) {}
+
+  ~ArenaHeap() override {
+    for (auto &chunk : chunks_) {
+      free(chunk.data_);
+    }
+  }
+
+  ArenaHeap(const ArenaHeap &) = delete;
+
+  ArenaHeap &operator=(const ArenaHeap &) = delete;
+
+  void *Allocate(size_t size) override {
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    while (current_ < chunks_.size() && chunks_[current_].used_ + size > chunks_[current_].size_) {
+      current_++;
+    }
+    if (current_ == chunks_.size()) {
+      size_t chunk_size = size > chunk_size_ ? size : chunk_size_;
+      chunks_.push_back({static_cast<char *>(malloc(chunk_size)), chunk_size, 0});
+      ASSERT(chunks_.back().data_ != nullptr, "Out of memory.");
+    }
+    Chunk &chunk = chunks_[current_];
+    void *ptr = chunk.data_ + chunk.used_;
+    chunk.used_ += size;
+    allocated_bytes_ += size;
+    return ptr;
+  }
+
+  void Free([[maybe_unused]] void *ptr) override {}
+
+  /**
+   * Release everything allocated so far, the chunks are kept for the next allocations.
+   * Every object placed in the heap must have been destructed before.
+   */
+  void Reset() {
+    for (auto &chunk : chunks_) {
+      chunk.used_ = 0;
+    }
+    current_ = 0;
+    allocated_bytes_ = 0;
+  }
+
+  /**
+   * @return bytes handed out since the last Reset
+   */
+  inline size_t GetAllocatedBytes() const { return allocated_bytes_; }
+
+  static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+ private:
+  struct Chunk {
+    char *data_;
+    size_t size_;
+    size_t used_;
+  };
+
+  static constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+
+  size_t chunk_size_;
+  std::vector<Chunk> chunks_;
+  size_t current_{0};
+  size_t allocated_bytes_{0};
+};
+
+#endif  // MINISQL_MEM_HEAP_H
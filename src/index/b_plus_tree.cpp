@@ -1,5 +1,6 @@
 #include "index/b_plus_tree.h"
 
+#include <algorithm>
 #include <string>
 
 #include "glog/logging.h"
@@ -7,9 +8,6 @@
 #include "index/generic_key.h"
 #include "page/index_roots_page.h"
 
-/**
- * TODO: Student Implement
- */
 BPlusTree::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager, const KeyManager &KM,
                      int leaf_max_size, int internal_max_size)
     : index_id_(index_id),
@@ -17,34 +15,59 @@ BPlusTree::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager
       processor_(KM),
       leaf_max_size_(leaf_max_size),
       internal_max_size_(internal_max_size) {
-//  Page *page = buffer_pool_manager->FetchPage(INDEX_ROOTS_PAGE_ID);
-//  IndexRootsPage *index_root_page = reinterpret_cast<IndexRootsPage *>(page->GetData());
-//  root_page_id_ = INVALID_PAGE_ID;
-//  index_root_page->GetRootId(index_id, &root_page_id_);
-//  buffer_pool_manager->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+  // by default the pages are filled with as many keys of the key size as they take
+  int leaf_capacity = LeafPage::GetMaxCapacity(processor_.GetKeySize());
+  if (leaf_max_size_ == UNDEFINED_SIZE || leaf_max_size_ > leaf_capacity) {
+    leaf_max_size_ = leaf_capacity;
+  }
+  int internal_capacity = InternalPage::GetMaxCapacity(processor_.GetKeySize());
+  if (internal_max_size_ == UNDEFINED_SIZE || internal_max_size_ > internal_capacity) {
+    internal_max_size_ = internal_capacity;
+  }
 }
 
 void BPlusTree::Destroy(page_id_t current_page_id) {
-  if (IsEmpty()) return;
-  GenericKey *key;
-  Page *page = FindLeafPage(key, true);
-  LeafPage *leaf = reinterpret_cast<LeafPage *>(page->GetData());
-  while (leaf->GetNextPageId() != INVALID_PAGE_ID) {
-    page_id_t next_id = leaf->GetNextPageId();
-    Page *next = buffer_pool_manager_->FetchPage(next_id);
-    Remove(leaf->KeyAt(0));
-    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), true);
-    leaf = reinterpret_cast<LeafPage *>(next);
+  std::unique_lock<std::shared_mutex> root_guard(root_latch_);
+  bool whole_tree = current_page_id == INVALID_PAGE_ID;
+  if (whole_tree) {
+    if (IsEmpty()) {
+      return;
+    }
+    current_page_id = root_page_id_;
+  }
+  // level by level from the top, the pages of a level are listed by their parents. Only the first page of a level is
+  // read to tell whether the level is made of leaves, the other leaves are deleted without being read
+  std::vector<page_id_t> level{current_page_id};
+  while (!level.empty()) {
+    Page *first = buffer_pool_manager_->FetchPage(level[0]);
+    bool leaves = reinterpret_cast<BPlusTreePage *>(first->GetData())->IsLeafPage();
+    buffer_pool_manager_->UnpinPage(level[0], false);
+    std::vector<page_id_t> children;
+    for (page_id_t page_id : level) {
+      if (!leaves) {
+        Page *page = buffer_pool_manager_->FetchPage(page_id);
+        auto *internal = reinterpret_cast<InternalPage *>(page->GetData());
+        for (int i = 0; i < internal->GetSize(); i++) {
+          children.push_back(internal->ValueAt(i));
+        }
+        buffer_pool_manager_->UnpinPage(page_id, false);
+      }
+      buffer_pool_manager_->DeletePage(page_id);
+    }
+    level = std::move(children);
+  }
+  if (whole_tree) {
+    root_page_id_ = INVALID_PAGE_ID;
+    Page *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+    reinterpret_cast<IndexRootsPage *>(page->GetData())->Delete(index_id_);
+    buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
   }
-  Remove(leaf->KeyAt(0));
-  buffer_pool_manager_->UnpinPage(leaf->GetPageId(), true);
 }
 
 /*
  * Helper function to decide whether current b+tree is empty
  */
 bool BPlusTree::IsEmpty() const {
-//  LOG(INFO) << "IsEmpty:" << (root_page_id_ == INVALID_PAGE_ID);
   return (root_page_id_ == INVALID_PAGE_ID);
 }
 
@@ -57,20 +80,18 @@ bool BPlusTree::IsEmpty() const {
  * @return : true means key exists
  */
 bool BPlusTree::GetValue(const GenericKey *key, std::vector<RowId> &result, Transaction *transaction) {
-//  LOG(INFO) << "GetValue called.";
-  if (IsEmpty())
-    return false;
-  Page *page = FindLeafPage(key, false);
-  LeafPage *node = reinterpret_cast<LeafPage *>(page->GetData());
-  RowId v;
-  if (node == nullptr)
+  Page *page = LatchLeafPage(key, Operation::kRead);
+  if (page == nullptr) {
     return false;
-  bool found = node->Lookup(key, v, processor_);
-  if (node->Lookup(key, v, processor_)) {
-    result.push_back(v);
-//    buffer_pool_manager_->UnpinPage(node->GetPageId(), false);
   }
-  buffer_pool_manager_->UnpinPage(node->GetPageId(), false);
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  RowId value;
+  bool found = leaf->Lookup(key, value, processor_);
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  if (found) {
+    result.push_back(value);
+  }
   return found;
 }
 
@@ -85,13 +106,37 @@ bool BPlusTree::GetValue(const GenericKey *key, std::vector<RowId> &result, Tran
  * keys return false, otherwise return true.
  */
 bool BPlusTree::Insert(GenericKey *key, const RowId &value, Transaction *transaction) {
-//  LOG(INFO) << "Insert called.";
-  if (IsEmpty()) { // empty, create a new tree
-    StartNewTree(key, value); // update root_page_id in StartNewTree
+  // optimistic pass, it gives up when the leaf would split
+  Page *page = LatchLeafPage(key, Operation::kInsert);
+  if (page != nullptr) {
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    RowId existing;
+    bool duplicate = leaf->Lookup(key, existing, processor_);
+    bool safe = !duplicate && IsSafe(leaf, Operation::kInsert, key);
+    if (safe) {
+      leaf->Insert(key, value, processor_);
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), safe);
+    if (duplicate || safe) {
+      return safe;
+    }
+  }
+  // pessimistic pass
+  WriteContext context;
+  root_latch_.lock();
+  context.root_latched_ = true;
+  if (IsEmpty()) {
+    StartNewTree(key, value);
+    ReleaseWriteContext(&context);
     return true;
   }
-  return InsertIntoLeaf(key, value, transaction);
+  Page *leaf_page = LatchPathToLeaf(key, Operation::kInsert, &context);
+  bool inserted = InsertIntoLeaf(reinterpret_cast<LeafPage *>(leaf_page->GetData()), key, value, transaction);
+  ReleaseWriteContext(&context);
+  return inserted;
 }
+
 /*
  * Insert constant key & value pair into an empty tree
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
@@ -99,53 +144,50 @@ bool BPlusTree::Insert(GenericKey *key, const RowId &value, Transaction *transac
  * tree's root page id and insert entry directly into leaf page.
  */
 void BPlusTree::StartNewTree(GenericKey *key, const RowId &value) {
-//  LOG(INFO) << "StartNewTree called.";
   page_id_t new_page_id;
   Page *page = buffer_pool_manager_->NewPage(new_page_id);
-  if(page == nullptr) {
+  if (page == nullptr) {
     throw runtime_error("out of memory");
   }
-  BPlusTreeLeafPage *leaf_page = reinterpret_cast<BPlusTreeLeafPage*>(page->GetData());
-  leaf_page->Init(new_page_id, INVALID_PAGE_ID, /*sizeof(GenericKey)*/processor_.GetKeySize(), LEAF_PAGE_SIZE);
-//  LOG(INFO) << "SN leaf_page is root ?:" << leaf_page->IsRootPage();
-//  LOG(INFO) << "SN leaf_page is leaf ?:" << leaf_page->IsLeafPage();
-//  root_page_id_ = new_page_id;
-//  UpdateRootPageId(1);
+  auto *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+  leaf_page->Init(new_page_id, INVALID_PAGE_ID, processor_.GetKeySize(), leaf_max_size_);
   leaf_page->Insert(key, value, processor_);
   root_page_id_ = new_page_id;
   UpdateRootPageId(1);
-  buffer_pool_manager_->UnpinPage(page->GetPageId(), true); //unpin, dirty
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
 }
 
 /*
  * Insert constant key & value pair into leaf page
- * User needs to first find the right leaf page as insertion target, then look
- * through leaf page to see whether insert key exist or not. If exist, return
+ * The leaf is the target leaf page, pinned and latched by the caller with the
+ * unsafe pages above it. Look through leaf page to see whether insert key exist or not. If exist, return
  * immediately, otherwise insert entry. Remember to deal with split if necessary.
  * @return: since we only support unique key, if user try to insert duplicate
  * keys return false, otherwise return true.
  */
-bool BPlusTree::InsertIntoLeaf(GenericKey *key, const RowId &value, Transaction *transaction) {
-  Page *page = FindLeafPage(key, false);
-  RowId v;
-  BPlusTreeLeafPage *leafPage = reinterpret_cast<BPlusTreeLeafPage *>(page->GetData());
-//  LOG(INFO) << "leaf_page is root ?, Insert into leaf:" << leafPage->IsRootPage();
-//  LOG(INFO) << "leaf_page is leaf ?, Insert into leaf:" << leafPage->IsLeafPage();
-  if (leafPage->Lookup(key, v, processor_)) {
-    buffer_pool_manager_->UnpinPage(leafPage->GetPageId(), false);
-//    LOG(INFO) << "failed";
+bool BPlusTree::InsertIntoLeaf(LeafPage *leaf, GenericKey *key, const RowId &value, Transaction *transaction) {
+  RowId existing;
+  if (leaf->Lookup(key, existing, processor_)) {
     return false;
-  } else {
-//    LOG(INFO) << "success.";
-    leafPage->Insert(key, value, processor_);
-    if (leafPage->GetSize() > leafPage->GetMaxSize()) {
-      BPlusTreeLeafPage *newleafpage = Split(leafPage, transaction);
-      buffer_pool_manager_->UnpinPage(newleafpage->GetPageId(), true);
-      InsertIntoParent(leafPage, newleafpage->KeyAt(0), newleafpage, transaction);
-    }
-    buffer_pool_manager_->UnpinPage(leafPage->GetPageId(), true);
-    return true;
   }
+  LeafPage *new_leaf = nullptr;
+  if (leaf->GetSize() > leaf->MaxSizeWith(key)) {
+    // the key shares too little of the prefix for the pairs to fit around it, it is before or after every key of the
+    // leaf and takes a page of its own on that side
+    int index = leaf->KeyIndex(key, processor_);
+    new_leaf = Split(leaf, index, transaction);
+    (index == 0 ? leaf : new_leaf)->Insert(key, value, processor_);
+  } else if (leaf->Insert(key, value, processor_) > leaf->GetMaxSize()) {
+    new_leaf = Split(leaf, leaf->GetSize() / 2, transaction);
+  }
+  if (new_leaf != nullptr) {
+    GenericKey *separator = processor_.InitKey();
+    new_leaf->KeyAt(0, separator);
+    InsertIntoParent(leaf, separator, new_leaf, transaction);
+    free(separator);
+    buffer_pool_manager_->UnpinPage(new_leaf->GetPageId(), true);
+  }
+  return true;
 }
 
 /*
@@ -154,39 +196,32 @@ bool BPlusTree::InsertIntoLeaf(GenericKey *key, const RowId &value, Transaction
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
  * an "out of memory" exception if returned value is nullptr), then move half
  * of key & value pairs from input page to newly created page
+ * Note: the new page is pinned, you need to unpin it after use.
  */
 BPlusTreeInternalPage *BPlusTree::Split(InternalPage *node, Transaction *transaction) {
-  LOG(INFO) << "Split_internal called.";
   page_id_t new_page_id;
-  Page *new_page = buffer_pool_manager_->NewPage(new_page_id);
-  if (new_page == nullptr) {
-    throw std::runtime_error("Out of memory");
-  }
-  BPlusTreeInternalPage *new_internal_page = reinterpret_cast<BPlusTreeInternalPage*>(new_page->GetData());
-  // Move half of the key-childId pairs from the original internal page to the new internal page
-  new_internal_page->Init(new_page_id, node->GetParentPageId(), node->GetKeySize(), node->GetMaxSize());
-  node->MoveHalfTo(new_internal_page, buffer_pool_manager_);
-  // Unpin the pages
-  buffer_pool_manager_->UnpinPage(new_page_id, true);
-  buffer_pool_manager_->UnpinPage(node->GetPageId(), true);
-  return new_internal_page;
+  Page *page = buffer_pool_manager_->NewPage(new_page_id);
+  if (page == nullptr) {
+    throw runtime_error("out of memory");
+  }
+  auto *new_node = reinterpret_cast<InternalPage *>(page->GetData());
+  new_node->Init(new_page_id, node->GetParentPageId(), processor_.GetKeySize(), internal_max_size_);
+  node->MoveHalfTo(new_node, buffer_pool_manager_);
+  return new_node;
 }
 
-BPlusTreeLeafPage *BPlusTree::Split(LeafPage *node, Transaction *transaction) {
-  LOG(INFO) << "Split_leaf called.";
+BPlusTreeLeafPage *BPlusTree::Split(LeafPage *node, int index, Transaction *transaction) {
   page_id_t new_page_id;
-  Page *new_page = buffer_pool_manager_->NewPage(new_page_id);
-
-  if(new_page == nullptr) {
+  Page *page = buffer_pool_manager_->NewPage(new_page_id);
+  if (page == nullptr) {
     throw runtime_error("out of memory");
   }
-  BPlusTreeLeafPage *new_leaf_page = reinterpret_cast<BPlusTreeLeafPage*>(new_page->GetData());
-  new_leaf_page->Init(new_page_id, node->GetParentPageId());
-  node->MoveHalfTo(new_leaf_page);
-  new_leaf_page->SetNextPageId(node->GetPageId());
-  buffer_pool_manager_->UnpinPage(new_page_id, true);
-  buffer_pool_manager_->UnpinPage(node->GetPageId(), true);
-  return new_leaf_page;
+  auto *new_node = reinterpret_cast<LeafPage *>(page->GetData());
+  new_node->Init(new_page_id, node->GetParentPageId(), processor_.GetKeySize(), leaf_max_size_);
+  node->MoveTailTo(new_node, index);
+  new_node->SetNextPageId(node->GetNextPageId());
+  node->SetNextPageId(new_page_id);
+  return new_node;
 }
 
 /*
@@ -200,63 +235,166 @@ BPlusTreeLeafPage *BPlusTree::Split(LeafPage *node, Transaction *transaction) {
  */
 void BPlusTree::InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlusTreePage *new_node,
                                  Transaction *transaction) {
-//  LOG(INFO) << "InsertIntoParent called.";
-//  if(old_node->IsRootPage()) {
-////    page_id_t new_page_id;
-////    Page *new_root_page = buffer_pool_manager_->NewPage(new_page_id);
-//    Page *new_root_page = buffer_pool_manager_->NewPage(root_page_id_);
-//    if(new_root_page == nullptr) {
-//      throw runtime_error("out of memory!");
-//    }
-//    BPlusTreeInternalPage *new_root = reinterpret_cast<BPlusTreeInternalPage*>(new_root_page->GetData());
-//    new_root->Init(root_page_id_, INVALID_PAGE_ID, internal_max_size_, internal_max_size_);
-////    root_page_id_ = new_root_page->GetPageId();
-//    UpdateRootPageId(0);
-//    new_root->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId()); //insert the key and pointer to the new root
-//    //update the parent id of old node and new node
-//    old_node->SetParentPageId(new_root_page->GetPageId());
-//    new_node->SetParentPageId(new_root_page->GetPageId());
-//    buffer_pool_manager_->UnpinPage(new_root_page->GetPageId(), true);
-//  } else {
-//    Page *parent_page = buffer_pool_manager_->FetchPage(old_node->GetParentPageId());
-//    if(parent_page == nullptr) {
-//      throw runtime_error("Fail to fetch parent page");
-//    }
-//    BPlusTreeInternalPage *parent = reinterpret_cast<BPlusTreeInternalPage*>(parent_page->GetData());
-//    parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
-//    new_node->SetParentPageId(parent_page->GetPageId());
-//    if(parent->GetSize() > parent->GetMaxSize()){
-//      BPlusTreeInternalPage *new_internal_page = Split(parent, transaction);
-//      buffer_pool_manager_->UnpinPage(new_internal_page->GetPageId(), true);
-//      InsertIntoParent(parent, new_internal_page->KeyAt(0), new_internal_page, transaction);
-//    }
-//    buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
-//  }
   if (old_node->IsRootPage()) {
-    Page *page = buffer_pool_manager_->NewPage(root_page_id_);
+    page_id_t new_root_id;
+    Page *page = buffer_pool_manager_->NewPage(new_root_id);
     if (page == nullptr) {
-      throw std::string("out of memory");
+      throw runtime_error("out of memory");
     }
-    InternalPage *newrootpage = reinterpret_cast<InternalPage *>(page->GetData());
-    newrootpage->Init(root_page_id_, INVALID_PAGE_ID, sizeof(GenericKey),INTERNAL_PAGE_SIZE);
-    newrootpage->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
-    old_node->SetParentPageId(root_page_id_);
-    new_node->SetParentPageId(root_page_id_);
-    UpdateRootPageId(0);
-    buffer_pool_manager_->UnpinPage(root_page_id_, true);
-  } else {
-    page_id_t old = old_node->GetParentPageId();
-    Page *page = buffer_pool_manager_->FetchPage(old_node->GetParentPageId());
-    InternalPage *newpre_page = reinterpret_cast<InternalPage *>(page->GetData());
-    new_node->SetParentPageId(old_node->GetParentPageId());
-    newpre_page->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
-    if (newpre_page->GetSize() > newpre_page->GetMaxSize()) {
-      InternalPage *pre_page = Split(newpre_page, transaction);
-      buffer_pool_manager_->UnpinPage(pre_page->GetPageId(), true);
-      InsertIntoParent(newpre_page, pre_page->KeyAt(0), pre_page, transaction);
+    auto *new_root = reinterpret_cast<InternalPage *>(page->GetData());
+    new_root->Init(new_root_id, INVALID_PAGE_ID, processor_.GetKeySize(), internal_max_size_);
+    new_root->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
+    old_node->SetParentPageId(new_root_id);
+    new_node->SetParentPageId(new_root_id);
+    root_page_id_ = new_root_id;
+    UpdateRootPageId();
+    buffer_pool_manager_->UnpinPage(new_root_id, true);
+    return;
+  }
+  page_id_t parent_id = old_node->GetParentPageId();
+  auto *parent = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(parent_id)->GetData());
+  if (parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId()) > parent->GetMaxSize()) {
+    InternalPage *new_parent = Split(parent, transaction);
+    InsertIntoParent(parent, new_parent->KeyAt(0), new_parent, transaction);
+    buffer_pool_manager_->UnpinPage(new_parent->GetPageId(), true);
+  }
+  buffer_pool_manager_->UnpinPage(parent_id, true);
+}
+
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+/*
+ * Write the sorted entries into leaves left to right, then build the internal
+ * levels until a single page, the root, is left. The last page of a level may
+ * be short of its min size, it is then merged into the page before it or takes
+ * half of the entries of the page before it.
+ */
+void BPlusTree::BulkLoad(KeySorter *sorter, double fill_factor, Transaction *transaction) {
+  GenericKey *key = processor_.InitKey();
+  RowId value;
+  std::unique_lock<std::shared_mutex> root_guard(root_latch_);
+  if (!IsEmpty()) {
+    root_guard.unlock();
+    while (sorter->Next(key, &value)) {
+      Insert(key, value, transaction);
+    }
+    free(key);
+    return;
+  }
+  int key_size = processor_.GetKeySize();
+  // first keys and page ids of the pages of the level being built
+  std::vector<char> keys;
+  std::vector<page_id_t> nodes;
+  LeafPage *prev = nullptr;
+  LeafPage *leaf = nullptr;
+  while (sorter->Next(key, &value)) {
+    // a key sharing less of the prefix leaves room for fewer pairs
+    if (leaf == nullptr || leaf->GetSize() >= FillSize(leaf->MaxSizeWith(key), true, fill_factor)) {
+      page_id_t page_id;
+      Page *page = buffer_pool_manager_->NewPage(page_id);
+      if (page == nullptr) {
+        throw runtime_error("out of memory");
+      }
+      if (prev != nullptr) {
+        buffer_pool_manager_->UnpinPage(prev->GetPageId(), true);
+      }
+      prev = leaf;
+      leaf = reinterpret_cast<LeafPage *>(page->GetData());
+      leaf->Init(page_id, INVALID_PAGE_ID, key_size, leaf_max_size_);
+      if (prev != nullptr) {
+        prev->SetNextPageId(page_id);
+      }
+      keys.insert(keys.end(), reinterpret_cast<char *>(key), reinterpret_cast<char *>(key) + key_size);
+      nodes.push_back(page_id);
+    }
+    leaf->Insert(key, value, processor_);
+  }
+  free(key);
+  if (prev != nullptr && leaf->GetSize() < leaf->GetMinSize()) {
+    if (CanCoalesce(prev, leaf)) {
+      leaf->MoveAllTo(prev);
+      buffer_pool_manager_->UnpinPage(leaf->GetPageId(), true);
+      buffer_pool_manager_->DeletePage(nodes.back());
+      leaf = nullptr;
+      keys.resize(keys.size() - key_size);
+      nodes.pop_back();
+    } else {
+      while (leaf->GetSize() < prev->GetSize() - 1 && CanRedistribute(prev, leaf, 1)) {
+        prev->MoveLastToFrontOf(leaf);
+      }
+      leaf->KeyAt(0, reinterpret_cast<GenericKey *>(keys.data() + keys.size() - key_size));
+    }
+  }
+  if (prev != nullptr) {
+    buffer_pool_manager_->UnpinPage(prev->GetPageId(), true);
+  }
+  if (leaf != nullptr) {
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), true);
+  }
+  if (nodes.empty()) {
+    return;
+  }
+  while (nodes.size() > 1) {
+    BuildInternalLevel(&keys, &nodes, fill_factor);
+  }
+  root_page_id_ = nodes[0];
+  UpdateRootPageId(1);
+}
+
+int BPlusTree::FillSize(int max_size, bool leaf, double fill_factor) {
+  int size = std::min(max_size, static_cast<int>(max_size * fill_factor));
+  // the min size of the page, an internal page of a single child would not make the level above smaller
+  return std::max({size, leaf ? max_size / 2 : (max_size + 1) / 2, leaf ? 1 : 2});
+}
+
+void BPlusTree::BuildInternalLevel(std::vector<char> *keys, std::vector<page_id_t> *children, double fill_factor) {
+  int key_size = processor_.GetKeySize();
+  int count = static_cast<int>(children->size());
+  std::vector<char> level_keys;
+  std::vector<page_id_t> level_nodes;
+  std::vector<int> sizes;
+  for (int begin = 0; begin < count; begin += sizes[level_nodes.size() - 1]) {
+    page_id_t page_id;
+    Page *page = buffer_pool_manager_->NewPage(page_id);
+    if (page == nullptr) {
+      throw runtime_error("out of memory");
+    }
+    auto *node = reinterpret_cast<InternalPage *>(page->GetData());
+    node->Init(page_id, INVALID_PAGE_ID, key_size, internal_max_size_);
+    if (sizes.empty()) {
+      // full pages, the last one evened out with the page before it when it is short of the min size
+      int fill_size = FillSize(node->GetMaxSize(), false, fill_factor);
+      for (int left = count; left > 0; left -= sizes.back()) {
+        sizes.push_back(std::min(fill_size, left));
+      }
+      int last = static_cast<int>(sizes.size()) - 1;
+      if (last > 0 && sizes[last] < node->GetMinSize()) {
+        int total = sizes[last - 1] + sizes[last];
+        if (total <= node->GetMaxSize()) {
+          sizes.pop_back();
+          sizes.back() = total;
+        } else {
+          sizes[last - 1] = total - total / 2;
+          sizes[last] = total / 2;
+        }
+      }
     }
-    buffer_pool_manager_->UnpinPage(old, true);
+    int size = sizes[level_nodes.size()];
+    for (int i = 0; i < size; i++) {
+      node->SetKeyAt(i, reinterpret_cast<GenericKey *>(keys->data() + (begin + i) * key_size));
+      node->SetValueAt(i, (*children)[begin + i]);
+      Page *child_page = buffer_pool_manager_->FetchPage((*children)[begin + i]);
+      reinterpret_cast<BPlusTreePage *>(child_page->GetData())->SetParentPageId(page_id);
+      buffer_pool_manager_->UnpinPage(child_page->GetPageId(), true);
+    }
+    node->SetSize(size);
+    level_keys.insert(level_keys.end(), keys->data() + begin * key_size, keys->data() + (begin + 1) * key_size);
+    level_nodes.push_back(page_id);
+    buffer_pool_manager_->UnpinPage(page_id, true);
   }
+  keys->swap(level_keys);
+  children->swap(level_nodes);
 }
 
 /*****************************************************************************
@@ -270,147 +408,87 @@ void BPlusTree::InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlus
  * necessary.
  */
 void BPlusTree::Remove(const GenericKey *key, Transaction *transaction) {
-//  LOG(INFO) << "Remove called.";
-  if (IsEmpty()) return;
-  Page *page = FindLeafPage(key, false);
-  LeafPage *leaf = reinterpret_cast<LeafPage *>(page->GetData());
-  leaf->RemoveAndDeleteRecord(key, processor_);
-  CoalesceOrRedistribute(leaf, transaction);
+  // optimistic pass, it gives up when the leaf would underflow
+  Page *page = LatchLeafPage(key, Operation::kRemove);
+  if (page == nullptr) {
+    return;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  RowId existing;
+  bool found = leaf->Lookup(key, existing, processor_);
+  bool safe = found && IsSafe(leaf, Operation::kRemove, key);
+  if (safe) {
+    leaf->RemoveAndDeleteRecord(key, processor_);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), safe);
+  if (!found || safe) {
+    return;
+  }
+  // pessimistic pass
+  WriteContext context;
+  root_latch_.lock();
+  context.root_latched_ = true;
+  if (IsEmpty()) {
+    ReleaseWriteContext(&context);
+    return;
+  }
+  page = LatchPathToLeaf(key, Operation::kRemove, &context);
+  leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int size = leaf->GetSize();
+  if (leaf->RemoveAndDeleteRecord(key, processor_) != size && CoalesceOrRedistribute(leaf, &context)) {
+    context.deleted_.push_back(leaf->GetPageId());
+  }
+  ReleaseWriteContext(&context);
 }
 
-/* todo
+/*
  * User needs to first find the sibling of input page. If sibling's size + input
  * page's size > page's max size, then redistribute. Otherwise, merge.
  * Using template N to represent either internal page or leaf page.
+ * Note: the input page and its parent are latched in context, the caller deletes the input page if asked to.
+ * The neighbor is write latched while it is used and freed pages are deleted when context is released.
  * @return: true means target leaf page should be deleted, false means no
  * deletion happens
  */
 template <typename N>
-bool BPlusTree::CoalesceOrRedistribute(N *&node, Transaction *transaction) {
-//  if (node->IsRootPage()) {
-//    bool f = AdjustRoot(node);
-//    if(!f)
-//      return false;
-//  }
-//
-//  Page *current_page = buffer_pool_manager_->FetchPage(node->GetPageId());
-//  Page *parent_page = buffer_pool_manager_->FetchPage(node->GetParentPageId());
-//
-//  InternalPage *parent = nullptr;
-//  int index = -1;
-//
-//  // Find the parent node and index of the current node in the parent
-//  if (current_page != nullptr && parent_page != nullptr) {
-//    parent = reinterpret_cast<InternalPage*>(parent_page->GetData());
-//    for (int i = 0; i < parent->GetSize(); i++) {
-//      if (parent->ValueAt(i) == node->GetPageId()) {
-//        index = i;
-//        break;
-//      }
-//    }
-//  }
-//
-//  // Find the sibling node
-//  N *sibling = nullptr;
-//  if (parent != nullptr && index != -1) {
-//    if (index == 0) {
-//      // Left sibling
-//      sibling = reinterpret_cast<N*>(buffer_pool_manager_->FetchPage(parent->ValueAt(1)));
-//    } else {
-//      // Right sibling
-//      sibling = reinterpret_cast<N*>(buffer_pool_manager_->FetchPage(parent->ValueAt(index - 1)));
-//    }
-//  }
-//
-//  // Perform redistribution or coalescing
-//  bool success = false;
-//  if (sibling != nullptr) {
-//    if (sibling->GetSize() + node->GetSize() > node->GetMaxSize()) {
-//      // Redistribute
-//      Redistribute(sibling, node, index);
-//      success = true;
-//    } else {
-//      // Coalesce
-//      if (std::is_same<N, InternalPage>::value) {
-//        success = Coalesce(sibling, node, parent, index + 1, transaction);
-//      } else if (std::is_same<N, LeafPage>::value) {
-//        success = Coalesce(sibling, node, parent, index, transaction);
-//      }
-//    }
-//  }
-//
-//  // Unpin sibling and parent pages
-//  buffer_pool_manager_->UnpinPage(sibling->GetPageId(), false);
-//  buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
-//  buffer_pool_manager_->UnpinPage(node->GetPageId(), true);
-//
-//  return success;
-  bool Deletion = false;
+bool BPlusTree::CoalesceOrRedistribute(N *&node, WriteContext *context) {
   if (node->IsRootPage()) {
-    Deletion = AdjustRoot(node);
-  } else {
-    Page *parent = buffer_pool_manager_->FetchPage(node->GetParentPageId());
-    InternalPage *p = reinterpret_cast<InternalPage *>(parent);
-    int x = p->ValueIndex(node->GetPageId());
-    p->SetKeyAt(x, node->KeyAt(0));
-    buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
-
-    // find parent key
-    if (node->GetSize() < node->GetMinSize()) { // if underflow
-      page_id_t parent_id = node->GetParentPageId();
-      Page *parent = buffer_pool_manager_->FetchPage(parent_id);
-      InternalPage *parent_page = reinterpret_cast<InternalPage *>(parent);
-      int index = parent_page->ValueIndex(node->GetPageId());
-      if (index == 0) { // first node
-        page_id_t neighbor_id = parent_page->ValueAt(1);
-        Page *neighbor = buffer_pool_manager_->FetchPage(neighbor_id);
-        BPlusTree::LeafPage *neighbor_page = reinterpret_cast<BPlusTree::LeafPage *>(neighbor->GetData());
-        BPlusTree::LeafPage *l_node = reinterpret_cast<BPlusTree::LeafPage *>(node);
-        if (node->GetSize() + neighbor_page->GetSize() > node->GetMaxSize()) {
-          Redistribute(neighbor_page, l_node, 0);
-        } else {
-          Deletion = Coalesce(neighbor_page, l_node, parent_page, index, transaction);
-          buffer_pool_manager_->DeletePage(neighbor->GetPageId());
-        }
-
-        buffer_pool_manager_->UnpinPage(neighbor->GetPageId(), true);
-      } else if (index == parent_page->GetSize() - 1) { // last node
-        page_id_t neighbor_id = parent_page->ValueAt(index - 1);
-        Page *neighbor = buffer_pool_manager_->FetchPage(neighbor_id);
-        BPlusTree::LeafPage *neighbor_page = reinterpret_cast<BPlusTree::LeafPage *>(neighbor->GetData());
-        BPlusTree::LeafPage *l_node = reinterpret_cast<BPlusTree::LeafPage *>(node);
-        if (node->GetSize() + neighbor_page->GetSize() > node->GetMaxSize()) {
-          Redistribute(neighbor_page, l_node, 1);
-        } else {
-          Deletion = Coalesce(neighbor_page, l_node, parent_page, index, transaction);
-          buffer_pool_manager_->DeletePage(node->GetPageId());
-        }
-        buffer_pool_manager_->UnpinPage(neighbor->GetPageId(), true);
-
-      } else {  // internal
-        page_id_t neighbor_id_l = parent_page->ValueAt(index - 1);
-        Page *neighbor_l = buffer_pool_manager_->FetchPage(neighbor_id_l);
-        BPlusTree::InternalPage *neighbor_page_l = reinterpret_cast<BPlusTree::InternalPage *>(neighbor_l->GetData());
-        page_id_t neighbor_id_r = parent_page->ValueAt(index + 1);
-        Page *neighbor_r = buffer_pool_manager_->FetchPage(neighbor_id_r);
-        BPlusTree::InternalPage *neighbor_page_r = reinterpret_cast<BPlusTree::InternalPage *>(neighbor_r->GetData());
-        BPlusTree::InternalPage *node_i = reinterpret_cast<BPlusTree::InternalPage *>(node);
-        if (node->GetSize() + neighbor_page_l->GetSize() > node->GetMaxSize()) {
-          Redistribute(neighbor_page_l, node_i, 1);
-        } else if (node->GetSize() + neighbor_page_r->GetSize() > node->GetMaxSize()) {
-          Redistribute(neighbor_page_r, node_i, 0);
-        } else {
-          Deletion = Coalesce(neighbor_page_l, node_i, parent_page, index, transaction);
-          buffer_pool_manager_->DeletePage(node->GetPageId());
-        }
-        buffer_pool_manager_->UnpinPage(neighbor_l->GetPageId(), true);
-        buffer_pool_manager_->UnpinPage(neighbor_r->GetPageId(), true);
-      }
-      buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
+    return AdjustRoot(node);
+  }
+  if (node->GetSize() >= node->GetMinSize()) {
+    return false;
+  }
+  page_id_t parent_id = node->GetParentPageId();
+  auto *parent = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(parent_id)->GetData());
+  // the left sibling, or the right one for the first child
+  int index = parent->ValueIndex(node->GetPageId());
+  page_id_t neighbor_id = parent->ValueAt(index == 0 ? 1 : index - 1);
+  Page *neighbor_page = buffer_pool_manager_->FetchPage(neighbor_id);
+  neighbor_page->WLatch();
+  auto *neighbor = reinterpret_cast<N *>(neighbor_page->GetData());
+  if (!(index == 0 ? CanCoalesce(node, neighbor) : CanCoalesce(neighbor, node))) {
+    // leaves of keys sharing short prefixes may take neither all the pairs of the other nor one more, the node then
+    // stays below its min size
+    if (CanRedistribute(neighbor, node, index)) {
+      Redistribute(neighbor, node, parent, index);
     }
+    neighbor_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(neighbor_id, true);
+    buffer_pool_manager_->UnpinPage(parent_id, true);
+    return false;
   }
-
-  return Deletion;
+  // the right page of the two is merged into the left one and deleted
+  if (Coalesce(neighbor, node, parent, index, context)) {
+    context->deleted_.push_back(parent_id);
+  }
+  neighbor_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(neighbor_id, true);
+  if (index == 0) {
+    context->deleted_.push_back(neighbor_id);
+  }
+  buffer_pool_manager_->UnpinPage(parent_id, true);
+  return index != 0;
 }
 
 /*
@@ -425,30 +503,27 @@ bool BPlusTree::CoalesceOrRedistribute(N *&node, Transaction *transaction) {
  * @return  true means parent node should be deleted, false means no deletion happened
  */
 bool BPlusTree::Coalesce(LeafPage *&neighbor_node, LeafPage *&node, InternalPage *&parent, int index,
-                         Transaction *transaction) {
-  LOG(INFO) << "Coalesce_leaf called.";
-  if(neighbor_node->GetSize() + node->GetSize() > node->GetMaxSize()) {
-    return false;
+                         WriteContext *context) {
+  if (index == 0) {
+    neighbor_node->MoveAllTo(node);
+    parent->Remove(1);
+  } else {
+    node->MoveAllTo(neighbor_node);
+    parent->Remove(index);
   }
-  //move all key-value pair from node to neighbour node
-  node->MoveAllTo(neighbor_node);
-  parent->Remove(index + 1);
-  buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
-  buffer_pool_manager_->DeletePage(node->GetPageId());
-  return true;
+  return CoalesceOrRedistribute(parent, context);
 }
 
 bool BPlusTree::Coalesce(InternalPage *&neighbor_node, InternalPage *&node, InternalPage *&parent, int index,
-                         Transaction *transaction) {
-  LOG(INFO) << "Coalesce_internal called.";
-  if(neighbor_node->GetSize() + node->GetSize() > node->GetMaxSize()) {
-    return false;
+                         WriteContext *context) {
+  if (index == 0) {
+    neighbor_node->MoveAllTo(node, parent->KeyAt(1), buffer_pool_manager_);
+    parent->Remove(1);
+  } else {
+    node->MoveAllTo(neighbor_node, parent->KeyAt(index), buffer_pool_manager_);
+    parent->Remove(index);
   }
-  node->MoveAllTo(neighbor_node, parent->KeyAt(index), buffer_pool_manager_);
-  parent->Remove(index + 1);
-  buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
-  buffer_pool_manager_->DeletePage(node->GetPageId());
-  return true;
+  return CoalesceOrRedistribute(parent, context);
 }
 
 /*
@@ -459,25 +534,56 @@ bool BPlusTree::Coalesce(InternalPage *&neighbor_node, InternalPage *&node, Inte
  * Using template N to represent either internal page or leaf page.
  * @param   neighbor_node      sibling page of input "node"
  * @param   node               input from method coalesceOrRedistribute()
+ * @param   parent             parent page of input "node", its separation key is updated
  */
-void BPlusTree::Redistribute(LeafPage *neighbor_node, LeafPage *node, int index) {
-  LOG(INFO) << "Redistribute_leaf called.";
-  if(index == 0) {
-    node->MoveFirstToEndOf(neighbor_node);
+bool BPlusTree::CanCoalesce(LeafPage *left, LeafPage *right) {
+  return left->GetSize() + right->GetSize() <= left->MaxSizeWith(right);
+}
+
+bool BPlusTree::CanCoalesce(InternalPage *left, InternalPage *right) {
+  return left->GetSize() + right->GetSize() <= left->GetMaxSize();
+}
+
+bool BPlusTree::CanRedistribute(LeafPage *neighbor_node, LeafPage *node, int index) {
+  if (neighbor_node->GetSize() <= neighbor_node->GetMinSize()) {
+    return false;
+  }
+  GenericKey *key = processor_.InitKey();
+  neighbor_node->KeyAt(index == 0 ? 0 : neighbor_node->GetSize() - 1, key);
+  bool fits = node->GetSize() < node->MaxSizeWith(key);
+  free(key);
+  return fits;
+}
+
+bool BPlusTree::CanRedistribute([[maybe_unused]] InternalPage *neighbor_node, [[maybe_unused]] InternalPage *node,
+                                [[maybe_unused]] int index) {
+  return true;
+}
+
+void BPlusTree::Redistribute(LeafPage *neighbor_node, LeafPage *node, InternalPage *parent, int index) {
+  GenericKey *key = processor_.InitKey();
+  if (index == 0) {
+    neighbor_node->MoveFirstToEndOf(node);
+    neighbor_node->KeyAt(0, key);
+    parent->SetKeyAt(1, key);
   } else {
-    node->MoveLastToFrontOf(neighbor_node);
+    neighbor_node->MoveLastToFrontOf(node);
+    node->KeyAt(0, key);
+    parent->SetKeyAt(index, key);
   }
+  free(key);
 }
-void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, int index) {
-  LOG(INFO) << "Redistribute_internal called.";
+
+void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, InternalPage *parent, int index) {
   if (index == 0) {
-    // Move the first key-value pair from neighbor_node to the end of node
-    node->MoveFirstToEndOf(neighbor_node, node->KeyAt(0), buffer_pool_manager_);
+    neighbor_node->MoveFirstToEndOf(node, parent->KeyAt(1), buffer_pool_manager_);
+    parent->SetKeyAt(1, neighbor_node->KeyAt(0));
   } else {
-    // Move the last key-value pair from neighbor_node to the head of node
-    node->MoveLastToFrontOf(neighbor_node, neighbor_node->KeyAt(neighbor_node->GetSize() - 2), buffer_pool_manager_);
+    neighbor_node->MoveLastToFrontOf(node, parent->KeyAt(index), buffer_pool_manager_);
+    parent->SetKeyAt(index, node->KeyAt(0));
   }
 }
+
 /*
  * Update root page if necessary
  * NOTE: size of root page can be less than min size and this method is only
@@ -489,35 +595,20 @@ void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, in
  * happened
  */
 bool BPlusTree::AdjustRoot(BPlusTreePage *old_root_node) {
+  if (!old_root_node->IsLeafPage() && old_root_node->GetSize() == 1) {
+    auto *old_root = reinterpret_cast<InternalPage *>(old_root_node);
+    root_page_id_ = old_root->RemoveAndReturnOnlyChild();
+    Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+    reinterpret_cast<BPlusTreePage *>(page->GetData())->SetParentPageId(INVALID_PAGE_ID);
+    buffer_pool_manager_->UnpinPage(root_page_id_, true);
+    UpdateRootPageId();
+    return true;
+  }
   if (old_root_node->IsLeafPage() && old_root_node->GetSize() == 0) {
     root_page_id_ = INVALID_PAGE_ID;
-    UpdateRootPageId(0);
-    return true;
-  } else if(old_root_node->GetSize() == 1) {
-    InternalPage *root_node = reinterpret_cast<InternalPage *>(old_root_node);
-    page_id_t new_root_id = root_node->RemoveAndReturnOnlyChild();
-    root_page_id_ = new_root_id;
-    UpdateRootPageId(0);
-    Page *page = buffer_pool_manager_->FetchPage(new_root_id);
-    BPlusTreePage *new_root = reinterpret_cast<BPlusTreePage *>(page->GetData());
-    new_root->SetParentPageId(INVALID_PAGE_ID);
-    buffer_pool_manager_->UnpinPage(new_root_id, true);
+    UpdateRootPageId();
     return true;
   }
-
-
-//  if (root_node->GetSize() == 0) {
-//    // Case 2: The root node is empty, indicating the whole B+ tree is empty
-//    // Set the root page ID to INVALID_PAGE_ID
-//    root_page_id_ = INVALID_PAGE_ID;
-//    // Delete the old root page
-//    buffer_pool_manager_->DeletePage(root_node->GetPageId());
-//    // Update the root page ID in the header page
-//    UpdateRootPageId();
-//    // Return true to indicate that the root page should be deleted
-//    return true;
-//  }
-
   return false;
 }
 
@@ -530,13 +621,15 @@ bool BPlusTree::AdjustRoot(BPlusTreePage *old_root_node) {
  * @return : index iterator
  */
 IndexIterator BPlusTree::Begin() {
-//  LOG(INFO) << "Begin called.";
-  Page *leaf_page = FindLeafPage(nullptr, root_page_id_, true);
-  if(leaf_page == nullptr) {
+  Page *page = LatchLeafPage(nullptr, Operation::kRead, true);
+  if (page == nullptr) {
     return End();
   }
-  BPlusTreeLeafPage *leaf = reinterpret_cast<BPlusTreeLeafPage *>(leaf_page->GetData());
-  return IndexIterator(leaf->GetPageId(), buffer_pool_manager_, 0);
+  // the iterator latches the leaf whenever it reads it, the pin keeps the leaf until it is pinned again
+  page->RUnlatch();
+  IndexIterator iterator(page->GetPageId(), buffer_pool_manager_);
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  return iterator;
 }
 
 /*
@@ -545,14 +638,15 @@ IndexIterator BPlusTree::Begin() {
  * @return : index iterator
  */
 IndexIterator BPlusTree::Begin(const GenericKey *key) {
-  LOG(INFO) << "Begin_internal called.";
-  Page *leaf_page = FindLeafPage(key, root_page_id_, false);
-  if(leaf_page == nullptr) {
+  Page *page = LatchLeafPage(key, Operation::kRead);
+  if (page == nullptr) {
     return End();
   }
-  BPlusTreeLeafPage *leaf = reinterpret_cast<BPlusTreeLeafPage *>(leaf_page->GetData());
-  int index = leaf->KeyIndex(key, processor_);
-  return IndexIterator(leaf->GetPageId(), buffer_pool_manager_, index);
+  int index = reinterpret_cast<LeafPage *>(page->GetData())->KeyIndex(key, processor_);
+  page->RUnlatch();
+  IndexIterator iterator(page->GetPageId(), buffer_pool_manager_, index);
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  return iterator;
 }
 
 /*
@@ -561,34 +655,142 @@ IndexIterator BPlusTree::Begin(const GenericKey *key) {
  * @return : index iterator
  */
 IndexIterator BPlusTree::End() {
-//  LOG(INFO) << "End called.";
   return IndexIterator();
 }
 
 /*****************************************************************************
  * UTILITIES AND DEBUG
  *****************************************************************************/
+Page *BPlusTree::LatchLeafPage(const GenericKey *key, Operation op, bool leftMost) {
+  root_latch_.lock_shared();
+  if (IsEmpty()) {
+    root_latch_.unlock_shared();
+    return nullptr;
+  }
+  // a page never changes its type while it is pinned, so it is read before the page is latched
+  auto latch = [op](Page *page) {
+    if (op != Operation::kRead && reinterpret_cast<BPlusTreePage *>(page->GetData())->IsLeafPage()) {
+      page->WLatch();
+    } else {
+      page->RLatch();
+    }
+  };
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  latch(page);
+  root_latch_.unlock_shared();
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (!node->IsLeafPage()) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    page_id_t child_id = leftMost ? internal->ValueAt(0) : internal->Lookup(key, processor_);
+    Page *child = buffer_pool_manager_->FetchPage(child_id);
+    latch(child);
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = child;
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  }
+  return page;
+}
+
+Page *BPlusTree::LatchPathToLeaf(const GenericKey *key, Operation op, WriteContext *context) {
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  page->WLatch();
+  context->latched_.push_back(page);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if (IsSafe(node, op, key)) {
+    ReleaseAncestors(context);
+  }
+  while (!node->IsLeafPage()) {
+    page_id_t child_id = reinterpret_cast<InternalPage *>(node)->Lookup(key, processor_);
+    page = buffer_pool_manager_->FetchPage(child_id);
+    page->WLatch();
+    context->latched_.push_back(page);
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (IsSafe(node, op, key)) {
+      ReleaseAncestors(context);
+    }
+  }
+  return page;
+}
+
+bool BPlusTree::IsSafe(BPlusTreePage *node, Operation op, const GenericKey *key) {
+  switch (op) {
+    case Operation::kRead:
+      return true;
+    case Operation::kInsert:
+      if (node->IsLeafPage()) {
+        return node->GetSize() < reinterpret_cast<LeafPage *>(node)->MaxSizeWith(key);
+      }
+      return node->GetSize() < node->GetMaxSize();
+    case Operation::kRemove:
+      if (node->IsRootPage()) {
+        return node->GetSize() > (node->IsLeafPage() ? 1 : 2);
+      }
+      return node->GetSize() > node->GetMinSize();
+  }
+  return false;
+}
+
+void BPlusTree::ReleaseAncestors(WriteContext *context) {
+  Page *last = context->latched_.back();
+  context->latched_.pop_back();
+  for (auto page : context->latched_) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  }
+  context->latched_.assign(1, last);
+  if (context->root_latched_) {
+    root_latch_.unlock();
+    context->root_latched_ = false;
+  }
+}
+
+void BPlusTree::ReleaseWriteContext(WriteContext *context) {
+  for (auto page : context->latched_) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+  }
+  context->latched_.clear();
+  if (context->root_latched_) {
+    root_latch_.unlock();
+    context->root_latched_ = false;
+  }
+  DeleteFreedPages(&context->deleted_);
+}
+
+size_t BPlusTree::DeleteFreedPages(std::vector<page_id_t> *freed) {
+  std::scoped_lock<std::mutex> lock(pending_latch_);
+  if (freed != nullptr) {
+    pending_deletes_.insert(pending_deletes_.end(), freed->begin(), freed->end());
+    freed->clear();
+  }
+  auto kept = std::remove_if(pending_deletes_.begin(), pending_deletes_.end(),
+                             [this](page_id_t page_id) { return buffer_pool_manager_->DeletePage(page_id); });
+  pending_deletes_.erase(kept, pending_deletes_.end());
+  return pending_deletes_.size();
+}
+
 /*
  * Find leaf page containing particular key, if leftMost flag == true, find
  * the left most leaf page
- * Note: the leaf page is pinned, you need to unpin it after use.
+ * Note: the leaf page is pinned, you need to unpin it after use. No page is latched, it is only used by tests and
+ * single threaded callers.
  */
 Page *BPlusTree::FindLeafPage(const GenericKey *key, page_id_t page_id, bool leftMost) {
-//  LOG(INFO) << "FindLeafPage called.";
-//  LOG(INFO) << "root_page_id:" << root_page_id_;
-  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);  // now root page is pin
-  BPlusTreePage *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
-//  LOG(INFO) << "node is leaf ?:" << node->IsLeafPage();
-//  LOG(INFO) << "node is leaf ?:" << node->IsLeafPage();
-//  LOG(INFO) << "node is leaf ?:" ;
+  if (IsEmpty()) {
+    return nullptr;
+  }
+  page_id_t current_id = page_id == INVALID_PAGE_ID ? root_page_id_ : page_id;
+  Page *page = buffer_pool_manager_->FetchPage(current_id);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
   while (!node->IsLeafPage()) {
-    InternalPage *internal_node = reinterpret_cast<InternalPage *>(node);
-    page_id_t next_page_id = leftMost ? internal_node->ValueAt(0) : internal_node->Lookup(key, processor_);
-    Page *next_page = buffer_pool_manager_->FetchPage(next_page_id);  // next_level_page pinned
-    BPlusTreePage *next_node = reinterpret_cast<BPlusTreePage *>(next_page);
-    buffer_pool_manager_->UnpinPage(node->GetPageId(), false);  // curr_node unpinned
-    page = next_page;
-    node = next_node;
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    page_id_t child_id = leftMost ? internal->ValueAt(0) : internal->Lookup(key, processor_);
+    Page *child = buffer_pool_manager_->FetchPage(child_id);
+    buffer_pool_manager_->UnpinPage(current_id, false);
+    current_id = child_id;
+    page = child;
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
   }
   return page;
 }
@@ -602,24 +804,12 @@ Page *BPlusTree::FindLeafPage(const GenericKey *key, page_id_t page_id, bool lef
  * updating it.
  */
 void BPlusTree::UpdateRootPageId(int insert_record) {
-//  LOG(INFO) << "UpdateRootPageId called.";
-//  LOG(INFO) << "index_id_: " << index_id_;
-//  LOG(INFO) << "root_page_id_: " << root_page_id_;
-//  LOG(INFO) << "INDEX_ROOTS_PAGE_ID: " << INDEX_ROOTS_PAGE_ID;
-  Page *index_roots_page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
-  IndexRootsPage *roots_page = reinterpret_cast<IndexRootsPage *>(index_roots_page);
-
-  if (insert_record) {
-    // Insert a new record into the index roots page
-    roots_page->Insert(index_id_, root_page_id_);
-//    LOG(INFO) << index_id_;
-  } else {
-    // Update the root page ID directly
-    roots_page->Update(index_id_, root_page_id_);
-    LOG(INFO) << index_id_;
+  Page *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  auto *index_roots_page = reinterpret_cast<IndexRootsPage *>(page->GetData());
+  // an index emptied or reopened before keeps its record
+  if (!insert_record || !index_roots_page->Insert(index_id_, root_page_id_)) {
+    index_roots_page->Update(index_id_, root_page_id_);
   }
-
-  // used
   buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
 }
 
@@ -645,7 +835,7 @@ void BPlusTree::ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstre
         << "</TD></TR>\n";
     out << "<TR>";
     for (int i = 0; i < leaf->GetSize(); i++) {
-      out << "<TD>" << leaf->KeyAt(i) << "</TD>\n";
+      out << "<TD>" << leaf->ValueAt(i).Get() << "</TD>\n";
     }
     out << "</TR>";
     // Print table end
@@ -719,7 +909,7 @@ void BPlusTree::ToString(BPlusTreePage *page, BufferPoolManager *bpm) const {
     std::cout << "Leaf Page: " << leaf->GetPageId() << " parent: " << leaf->GetParentPageId()
               << " next: " << leaf->GetNextPageId() << std::endl;
     for (int i = 0; i < leaf->GetSize(); i++) {
-      std::cout << leaf->KeyAt(i) << ",";
+      std::cout << leaf->ValueAt(i).Get() << ",";
     }
     std::cout << std::endl;
     std::cout << std::endl;
@@ -743,5 +933,9 @@ bool BPlusTree::Check() {
   if (!all_unpinned) {
     LOG(ERROR) << "problem in page unpin" << endl;
   }
-  return all_unpinned;
+  size_t pending = DeleteFreedPages(nullptr);
+  if (pending != 0) {
+    LOG(ERROR) << pending << " freed pages can not be deleted" << endl;
+  }
+  return all_unpinned && pending == 0;
 }
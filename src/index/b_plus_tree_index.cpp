@@ -4,15 +4,23 @@
 #include "index/generic_key.h"
 #include "utils/tree_file_mgr.h"
 BPlusTreeIndex::BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size,
-                               BufferPoolManager *buffer_pool_manager)
+                               BufferPoolManager *buffer_pool_manager, bool unique)
     : Index(index_id, key_schema),
-      processor_(key_schema_, key_size),
+      processor_(key_schema_, key_size, !unique),
       container_(index_id, buffer_pool_manager, processor_) {}
 
+void BPlusTreeIndex::SerializeKey(GenericKey *index_key, const Row &key, const RowId &row_id) const {
+  processor_.SerializeFromKey(index_key, key, key_schema_);
+  if (processor_.HasRowIdSuffix()) {
+    processor_.SetRowIdSuffix(index_key, row_id);
+  }
+}
+
+
 dberr_t BPlusTreeIndex::InsertEntry(const Row &key, RowId row_id, Transaction *txn) {
   // ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
   GenericKey *index_key = processor_.InitKey();
-  processor_.SerializeFromKey(index_key, key, key_schema_);
+  SerializeKey(index_key, key, row_id);
 
   bool status = container_.Insert(index_key, row_id, txn);
   delete index_key;
@@ -30,55 +38,127 @@ dberr_t BPlusTreeIndex::InsertEntry(const Row &key, RowId row_id, Transaction *t
 
 dberr_t BPlusTreeIndex::RemoveEntry(const Row &key, RowId row_id, Transaction *txn) {
   GenericKey *index_key = processor_.InitKey();
-  processor_.SerializeFromKey(index_key, key, key_schema_);
+  SerializeKey(index_key, key, row_id);
 
   container_.Remove(index_key, txn);
   delete index_key;
   return DB_SUCCESS;
 }
 
+namespace {
+
+/**
+ * Walks the leaves from the first key of the range and stops at the first key past the upper bound.
+ */
+class BPlusTreeScanCursor : public IndexScanCursor {
+ public:
+  BPlusTreeScanCursor(IndexIterator iter, const KeyManager &KM, IndexSchema *key_schema, GenericKey *lower,
+                      bool lower_inclusive, GenericKey *upper, bool upper_inclusive)
+      : iter_(std::move(iter)),
+        KM_(KM),
+        key_schema_(key_schema),
+        lower_(lower),
+        upper_(upper),
+        lower_inclusive_(lower_inclusive),
+        upper_inclusive_(upper_inclusive) {}
+
+  ~BPlusTreeScanCursor() override {
+    free(lower_);
+    free(upper_);
+  }
+
+  bool Next(RowId *row_id) override { return NextEntry(row_id, nullptr); }
+
+  bool NextEntry(RowId *row_id, Row *key) override {
+    for (; iter_ != end_; ++iter_) {
+      auto item = *iter_;
+      if (upper_ != nullptr && KM_.CompareKeys(item.first, upper_) >= (upper_inclusive_ ? 1 : 0)) {
+        // unpin the leaf as soon as the range ends
+        iter_ = end_;
+        return false;
+      }
+      if (lower_ != nullptr && !lower_inclusive_ && KM_.CompareKeys(item.first, lower_) == 0) {
+        continue;
+      }
+      *row_id = item.second;
+      if (key != nullptr) {
+        // the iterator keeps the decoded key until it is dereferenced again
+        key->destroy();
+        KM_.DeserializeToKey(item.first, *key, key_schema_);
+      }
+      ++iter_;
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  IndexIterator iter_;
+  IndexIterator end_;
+  const KeyManager &KM_;
+  IndexSchema *key_schema_;
+  GenericKey *lower_;
+  GenericKey *upper_;
+  bool lower_inclusive_;
+  bool upper_inclusive_;
+};
+
+void Drain(IndexScanCursor *cursor, vector<RowId> &result) {
+  RowId row_id;
+  while (cursor->Next(&row_id)) {
+    result.emplace_back(row_id);
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<IndexScanCursor> BPlusTreeIndex::Scan(const Row *lower, const Row *upper, bool lower_inclusive,
+                                                      bool upper_inclusive, [[maybe_unused]] Transaction *txn) {
+  GenericKey *lower_key = nullptr;
+  GenericKey *upper_key = nullptr;
+  // the smallest or the largest key starting with a bound takes in or leaves out every key of the bound
+  if (lower != nullptr) {
+    lower_key = processor_.InitKey();
+    // a cut bound stands between keys: everything up to it is smaller, everything after it larger than the bound
+    if (processor_.SerializeBound(lower_key, *lower, key_schema_, !lower_inclusive)) {
+      lower_inclusive = false;
+    }
+  }
+  if (upper != nullptr) {
+    upper_key = processor_.InitKey();
+    if (processor_.SerializeBound(upper_key, *upper, key_schema_, upper_inclusive)) {
+      upper_inclusive = true;
+    }
+  }
+  IndexIterator iter = lower_key == nullptr ? container_.Begin() : container_.Begin(lower_key);
+  return std::make_unique<BPlusTreeScanCursor>(std::move(iter), processor_, key_schema_, lower_key, lower_inclusive,
+                                               upper_key, upper_inclusive);
+}
+
 dberr_t BPlusTreeIndex::ScanKey(const Row &key, vector<RowId> &result, Transaction *txn, string compare_operator) {
-//  LOG(INFO) << "ScanKey called.";
-  GenericKey *index_key = processor_.InitKey();
-  processor_.SerializeFromKey(index_key, key, key_schema_);
-  if (compare_operator == "=") {
-//    LOG(INFO) << "=test";
+  // a key without its last columns, e.g. without the included columns, stands for every key starting with it
+  if (compare_operator == "=" && !processor_.FitsKey(key, key_schema_)) {
+    // no stored key is that long
+  } else if (compare_operator == "=" &&
+             (processor_.HasRowIdSuffix() || key.GetFieldCount() < key_schema_->GetColumnCount())) {
+    Drain(Scan(&key, &key, true, true, txn).get(), result);
+  } else if (compare_operator == "=") {
+    GenericKey *index_key = processor_.InitKey();
+    processor_.SerializeFromKey(index_key, key, key_schema_);
     container_.GetValue(index_key, result, txn);
+    free(index_key);
   } else if (compare_operator == ">") {
-//    LOG(INFO) << ">test";
-    auto iter = GetBeginIterator(index_key);
-    if (container_.GetValue(index_key, result, txn))
-      ++iter;
-    result.clear();
-    for (; iter != GetEndIterator(); ++iter) {
-      result.emplace_back((*iter).second);
-    }
+    Drain(Scan(&key, nullptr, false, true, txn).get(), result);
   } else if (compare_operator == ">=") {
-//    LOG(INFO) << ">=test";
-    for (auto iter = GetBeginIterator(index_key); iter != GetEndIterator(); ++iter) {
-      result.emplace_back((*iter).second);
-    }
+    Drain(Scan(&key, nullptr, true, true, txn).get(), result);
   } else if (compare_operator == "<") {
-//    LOG(INFO) << "<test";
-    for (auto iter = GetBeginIterator(); iter != GetBeginIterator(index_key); ++iter) {
-      result.emplace_back((*iter).second);
-    }
+    Drain(Scan(nullptr, &key, true, false, txn).get(), result);
   } else if (compare_operator == "<=") {
-//    LOG(INFO) << "<=test";
-    for (auto iter = GetBeginIterator(); iter != GetBeginIterator(index_key); ++iter) {
-      result.emplace_back((*iter).second);
-    }
-    container_.GetValue(index_key, result, txn);
+    Drain(Scan(nullptr, &key, true, true, txn).get(), result);
   } else if (compare_operator == "<>") {
-//    LOG(INFO) << "<>test";
-    for (auto iter = GetBeginIterator(); iter != GetEndIterator(); ++iter) {
-      result.emplace_back((*iter).second);
-    }
-    vector<RowId> temp;
-    if (container_.GetValue(index_key, temp, txn))
-      result.erase(find(result.begin(), result.end(), temp[0]));
+    Drain(Scan(nullptr, &key, true, false, txn).get(), result);
+    Drain(Scan(&key, nullptr, false, true, txn).get(), result);
   }
-  delete index_key;
   if (!result.empty())
     return DB_SUCCESS;
   else
@@ -90,6 +170,21 @@ dberr_t BPlusTreeIndex::Destroy() {
   return DB_SUCCESS;
 }
 
+dberr_t BPlusTreeIndex::BuildFrom(const EntrySource &next, Transaction *txn) {
+  KeySorter sorter(processor_);
+  GenericKey *index_key = processor_.InitKey();
+  Row key;
+  RowId row_id;
+  while (next(key, row_id)) {
+    SerializeKey(index_key, key, row_id);
+    sorter.Add(index_key, row_id);
+  }
+  free(index_key);
+  sorter.Finish();
+  container_.BulkLoad(&sorter, INDEX_FILL_FACTOR, txn);
+  return DB_SUCCESS;
+}
+
 IndexIterator BPlusTreeIndex::GetBeginIterator() {
   return container_.Begin();
 }
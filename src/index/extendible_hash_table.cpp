@@ -0,0 +1,382 @@
+#include "index/extendible_hash_table.h"
+
+#include <mutex>
+#include <stdexcept>
+
+#include "page/index_roots_page.h"
+
+ExtendibleHashTable::ExtendibleHashTable(index_id_t index_id, BufferPoolManager *buffer_pool_manager,
+                                         const KeyManager &KM, bool unique)
+    : index_id_(index_id), buffer_pool_manager_(buffer_pool_manager), processor_(KM), unique_(unique) {}
+
+bool ExtendibleHashTable::IsEmpty() const {
+  return directory_page_id_ == INVALID_PAGE_ID;
+}
+
+uint32_t ExtendibleHashTable::Hash(const GenericKey *key) const {
+  // FNV-1a over the key bytes, then the murmur3 finalizer mixes every byte into the low bits the directory reads
+  const auto *bytes = reinterpret_cast<const uint8_t *>(key);
+  uint64_t hash = 14695981039346656037ULL;
+  for (int i = 0; i < processor_.GetKeySize(); i++) {
+    hash = (hash ^ bytes[i]) * 1099511628211ULL;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return static_cast<uint32_t>(hash);
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+void ExtendibleHashTable::StartNewTable() {
+  Page *page = buffer_pool_manager_->NewPage(directory_page_id_);
+  if (page == nullptr) {
+    throw std::runtime_error("out of memory");
+  }
+  auto *directory = reinterpret_cast<DirectoryPage *>(page->GetData());
+  directory->Init(directory_page_id_);
+  page_id_t bucket_page_id;
+  NewBucket(&bucket_page_id);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  directory->SetBucketPageId(0, bucket_page_id);
+  directory->SetLocalDepth(0, 0);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+  UpdateDirectoryPageId(true);
+}
+
+ExtendibleHashTable::DirectoryPage *ExtendibleHashTable::FetchDirectory() {
+  return reinterpret_cast<DirectoryPage *>(buffer_pool_manager_->FetchPage(directory_page_id_)->GetData());
+}
+
+ExtendibleHashTable::BucketPage *ExtendibleHashTable::NewBucket(page_id_t *page_id) {
+  Page *page = buffer_pool_manager_->NewPage(*page_id);
+  if (page == nullptr) {
+    throw std::runtime_error("out of memory");
+  }
+  auto *bucket = reinterpret_cast<BucketPage *>(page->GetData());
+  bucket->Init(*page_id, processor_.GetKeySize());
+  return bucket;
+}
+
+bool ExtendibleHashTable::Matches(const GenericKey *lhs, const RowId &lhs_value, const GenericKey *rhs,
+                                  const RowId &rhs_value) const {
+  return processor_.CompareKeys(lhs, rhs) == 0 && (unique_ || lhs_value == rhs_value);
+}
+
+bool ExtendibleHashTable::ChainContains(page_id_t page_id, const GenericKey *key, const RowId &value) {
+  bool found = false;
+  while (page_id != INVALID_PAGE_ID && !found) {
+    auto *bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    for (int i = 0; i < bucket->GetSize() && !found; i++) {
+      found = Matches(bucket->KeyAt(i), bucket->ValueAt(i), key, value);
+    }
+    page_id_t next_page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  return found;
+}
+
+bool ExtendibleHashTable::ChainAppend(page_id_t page_id, const GenericKey *key, const RowId &value, bool overflow) {
+  while (true) {
+    auto *bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    if (!bucket->IsFull()) {
+      bucket->Append(key, value);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      return true;
+    }
+    page_id_t next_page_id = bucket->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      if (!overflow) {
+        buffer_pool_manager_->UnpinPage(page_id, false);
+        return false;
+      }
+      BucketPage *overflow_bucket = NewBucket(&next_page_id);
+      overflow_bucket->Append(key, value);
+      buffer_pool_manager_->UnpinPage(next_page_id, true);
+      bucket->SetNextPageId(next_page_id);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      return true;
+    }
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+bool ExtendibleHashTable::ChainSharesHash(page_id_t page_id, uint32_t hash) {
+  bool shared = true;
+  while (page_id != INVALID_PAGE_ID && shared) {
+    auto *bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    for (int i = 0; i < bucket->GetSize() && shared; i++) {
+      shared = Hash(bucket->KeyAt(i)) == hash;
+    }
+    page_id_t next_page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  return shared;
+}
+
+bool ExtendibleHashTable::ChainIsEmpty(page_id_t page_id) {
+  bool empty = true;
+  while (page_id != INVALID_PAGE_ID && empty) {
+    auto *bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    empty = bucket->GetSize() == 0;
+    page_id_t next_page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  return empty;
+}
+
+void ExtendibleHashTable::DeleteChain(page_id_t page_id) {
+  while (page_id != INVALID_PAGE_ID) {
+    auto *bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    page_id_t next_page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    buffer_pool_manager_->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+bool ExtendibleHashTable::GetValue(const GenericKey *key, std::vector<RowId> &result) {
+  std::shared_lock<std::shared_mutex> guard(latch_);
+  if (IsEmpty()) {
+    return false;
+  }
+  DirectoryPage *directory = FetchDirectory();
+  page_id_t page_id = directory->GetBucketPageId(Hash(key) & directory->GetGlobalDepthMask());
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  bool found = false;
+  while (page_id != INVALID_PAGE_ID) {
+    auto *bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    for (int i = 0; i < bucket->GetSize(); i++) {
+      if (processor_.CompareKeys(bucket->KeyAt(i), key) == 0) {
+        result.emplace_back(bucket->ValueAt(i));
+        found = true;
+      }
+    }
+    page_id_t next_page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  return found;
+}
+
+void ExtendibleHashTable::ForEach(const Visitor &visit) {
+  std::shared_lock<std::shared_mutex> guard(latch_);
+  if (IsEmpty()) {
+    return;
+  }
+  DirectoryPage *directory = FetchDirectory();
+  for (uint32_t i = 0; i < directory->Size(); i++) {
+    // a bucket is visited from its first slot, the one without bits above its local depth
+    if (i >= (1u << directory->GetLocalDepth(i))) {
+      continue;
+    }
+    page_id_t page_id = directory->GetBucketPageId(i);
+    while (page_id != INVALID_PAGE_ID) {
+      auto *bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+      for (int j = 0; j < bucket->GetSize(); j++) {
+        visit(bucket->KeyAt(j), bucket->ValueAt(j));
+      }
+      page_id_t next_page_id = bucket->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+}
+
+uint32_t ExtendibleHashTable::GetGlobalDepth() {
+  std::shared_lock<std::shared_mutex> guard(latch_);
+  if (IsEmpty()) {
+    return 0;
+  }
+  uint32_t global_depth = FetchDirectory()->GetGlobalDepth();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  return global_depth;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+bool ExtendibleHashTable::Insert(const GenericKey *key, const RowId &value) {
+  std::unique_lock<std::shared_mutex> guard(latch_);
+  if (IsEmpty()) {
+    StartNewTable();
+  }
+  uint32_t hash = Hash(key);
+  DirectoryPage *directory = FetchDirectory();
+  uint32_t bucket_idx = hash & directory->GetGlobalDepthMask();
+  if (ChainContains(directory->GetBucketPageId(bucket_idx), key, value)) {
+    buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+    return false;
+  }
+  bool dirty = false;
+  while (!ChainAppend(directory->GetBucketPageId(bucket_idx), key, value, false)) {
+    // a split can not tell apart the pairs of one hash, nor go past the largest directory
+    if (directory->GetLocalDepth(bucket_idx) == DirectoryPage::MAX_DEPTH ||
+        ChainSharesHash(directory->GetBucketPageId(bucket_idx), hash)) {
+      ChainAppend(directory->GetBucketPageId(bucket_idx), key, value, true);
+      break;
+    }
+    SplitBucket(directory, bucket_idx);
+    bucket_idx = hash & directory->GetGlobalDepthMask();
+    dirty = true;
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, dirty);
+  return true;
+}
+
+void ExtendibleHashTable::SplitBucket(DirectoryPage *directory, uint32_t bucket_idx) {
+  uint32_t local_depth = directory->GetLocalDepth(bucket_idx);
+  if (local_depth == directory->GetGlobalDepth()) {
+    directory->IncrGlobalDepth();
+  }
+  page_id_t bucket_page_id = directory->GetBucketPageId(bucket_idx);
+  page_id_t image_page_id;
+  NewBucket(&image_page_id);
+  buffer_pool_manager_->UnpinPage(image_page_id, true);
+  uint32_t split_bit = 1u << local_depth;
+  for (uint32_t i = 0; i < directory->Size(); i++) {
+    if (directory->GetBucketPageId(i) == bucket_page_id) {
+      directory->SetLocalDepth(i, local_depth + 1);
+      if ((i & split_bit) != 0) {
+        directory->SetBucketPageId(i, image_page_id);
+      }
+    }
+  }
+  // take every pair out of the chain, the overflow pages are dropped, then append each by its split bit
+  std::vector<char> keys;
+  std::vector<RowId> values;
+  auto *bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(bucket_page_id)->GetData());
+  page_id_t overflow_page_id = bucket->GetNextPageId();
+  for (page_id_t page_id = bucket_page_id; page_id != INVALID_PAGE_ID;) {
+    auto *page = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    for (int i = 0; i < page->GetSize(); i++) {
+      keys.insert(keys.end(), reinterpret_cast<char *>(page->KeyAt(i)),
+                  reinterpret_cast<char *>(page->KeyAt(i)) + processor_.GetKeySize());
+      values.emplace_back(page->ValueAt(i));
+    }
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  bucket->Clear();
+  bucket->SetNextPageId(INVALID_PAGE_ID);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  DeleteChain(overflow_page_id);
+  for (size_t i = 0; i < values.size(); i++) {
+    auto *key = reinterpret_cast<const GenericKey *>(keys.data() + i * processor_.GetKeySize());
+    ChainAppend((Hash(key) & split_bit) != 0 ? image_page_id : bucket_page_id, key, values[i], true);
+  }
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+bool ExtendibleHashTable::Remove(const GenericKey *key, const RowId &value) {
+  std::unique_lock<std::shared_mutex> guard(latch_);
+  if (IsEmpty()) {
+    return false;
+  }
+  DirectoryPage *directory = FetchDirectory();
+  uint32_t bucket_idx = Hash(key) & directory->GetGlobalDepthMask();
+  page_id_t bucket_page_id = directory->GetBucketPageId(bucket_idx);
+  bool removed = false;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  for (page_id_t page_id = bucket_page_id; page_id != INVALID_PAGE_ID && !removed;) {
+    auto *bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    for (int i = 0; i < bucket->GetSize() && !removed; i++) {
+      if (Matches(bucket->KeyAt(i), bucket->ValueAt(i), key, value)) {
+        bucket->RemoveAt(i);
+        removed = true;
+      }
+    }
+    page_id_t next_page_id = bucket->GetNextPageId();
+    if (removed && bucket->GetSize() == 0 && prev_page_id != INVALID_PAGE_ID) {
+      // unlink the emptied overflow page
+      auto *prev = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(prev_page_id)->GetData());
+      prev->SetNextPageId(next_page_id);
+      buffer_pool_manager_->UnpinPage(prev_page_id, true);
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+    } else {
+      buffer_pool_manager_->UnpinPage(page_id, removed);
+    }
+    prev_page_id = page_id;
+    page_id = next_page_id;
+  }
+  bool merged = removed && ChainIsEmpty(bucket_page_id);
+  if (merged) {
+    MergeBucket(directory, bucket_idx);
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, merged);
+  return removed;
+}
+
+void ExtendibleHashTable::MergeBucket(DirectoryPage *directory, uint32_t bucket_idx) {
+  while (directory->GetLocalDepth(bucket_idx) > 0) {
+    uint32_t local_depth = directory->GetLocalDepth(bucket_idx);
+    uint32_t image_idx = bucket_idx ^ (1u << (local_depth - 1));
+    if (directory->GetLocalDepth(image_idx) != local_depth) {
+      return;
+    }
+    page_id_t bucket_page_id = directory->GetBucketPageId(bucket_idx);
+    page_id_t image_page_id = directory->GetBucketPageId(image_idx);
+    for (uint32_t i = 0; i < directory->Size(); i++) {
+      page_id_t page_id = directory->GetBucketPageId(i);
+      if (page_id == bucket_page_id || page_id == image_page_id) {
+        directory->SetBucketPageId(i, image_page_id);
+        directory->SetLocalDepth(i, local_depth - 1);
+      }
+    }
+    DeleteChain(bucket_page_id);
+    while (directory->CanShrink()) {
+      directory->DecrGlobalDepth();
+    }
+    // the image merges further if it is empty as well
+    if (!ChainIsEmpty(image_page_id)) {
+      return;
+    }
+    bucket_idx = image_idx & directory->GetGlobalDepthMask();
+  }
+}
+
+void ExtendibleHashTable::Destroy() {
+  std::unique_lock<std::shared_mutex> guard(latch_);
+  if (IsEmpty()) {
+    return;
+  }
+  DirectoryPage *directory = FetchDirectory();
+  for (uint32_t i = 0; i < directory->Size(); i++) {
+    if (i < (1u << directory->GetLocalDepth(i))) {
+      DeleteChain(directory->GetBucketPageId(i));
+    }
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  buffer_pool_manager_->DeletePage(directory_page_id_);
+  Page *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  reinterpret_cast<IndexRootsPage *>(page->GetData())->Delete(index_id_);
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+  directory_page_id_ = INVALID_PAGE_ID;
+}
+
+/*
+ * Update/Insert the directory page id in the index roots page, like the root page id of a B+ tree.
+ */
+void ExtendibleHashTable::UpdateDirectoryPageId(bool insert_record) {
+  Page *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  auto *index_roots_page = reinterpret_cast<IndexRootsPage *>(page->GetData());
+  if (!insert_record || !index_roots_page->Insert(index_id_, directory_page_id_)) {
+    index_roots_page->Update(index_id_, directory_page_id_);
+  }
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+}
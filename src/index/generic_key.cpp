@@ -0,0 +1,152 @@
+#include "index/generic_key.h"
+
+namespace {
+
+inline void WriteBigEndian32(char *buf, uint32_t value) { MACH_WRITE_TO(uint32_t, buf, __builtin_bswap32(value)); }
+
+inline uint32_t ReadBigEndian32(const char *buf) { return __builtin_bswap32(MACH_READ_FROM(uint32_t, buf)); }
+
+constexpr uint32_t SIGN_BIT = 0x80000000u;
+
+/** width of the value of a key column after its null flag */
+inline uint32_t EncodedWidth(const Column *column) {
+  if (column->GetType() == TypeId::kTypeChar) {
+    return column->GetLength() + sizeof(uint16_t);
+  }
+  return Type::GetTypeSize(column->GetType());
+}
+
+}  // namespace
+
+uint32_t KeyManager::GetEncodedSize(const Schema *key_schema) {
+  uint32_t size = 0;
+  for (auto column : key_schema->GetColumns()) {
+    size += sizeof(uint8_t) + EncodedWidth(column);
+  }
+  return size;
+}
+
+void KeyManager::SerializeFromKey(GenericKey *key_buf, const Row &key, Schema *schema) const {
+  ASSERT(key.GetFieldCount() == schema->GetColumnCount(), "field nums not match.");
+  SerializeColumns(key_buf, key, schema, nullptr);
+}
+
+bool KeyManager::SerializeBound(GenericKey *key_buf, const Row &prefix, Schema *schema, bool largest) const {
+  ASSERT(prefix.GetFieldCount() <= schema->GetColumnCount(), "Bound has more fields than the key.");
+  bool cut = false;
+  uint32_t size = SerializeColumns(key_buf, prefix, schema, &cut);
+  // no encoded entry starts with 0xff, a null flag is 0 or 1
+  memset(key_buf->data + size, largest || cut ? 0xff : 0, encoded_size_ - size);
+  return cut;
+}
+
+bool KeyManager::FitsKey(const Row &key, Schema *schema) const {
+  for (uint32_t i = 0; i < key.GetFieldCount(); i++) {
+    const Column *column = schema->GetColumn(i);
+    const Field *field = key.GetField(i);
+    if (column->GetType() == TypeId::kTypeChar && !field->IsNull() && field->GetLength() > column->GetLength()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint32_t KeyManager::SerializeColumns(GenericKey *key_buf, const Row &key, Schema *schema, bool *cut) const {
+  // initialize to 0, null values and padding stay zero
+  memset(key_buf->data, 0, key_size_);
+  char *buf = key_buf->data;
+  for (uint32_t i = 0; i < key.GetFieldCount(); i++) {
+    const Column *column = schema->GetColumn(i);
+    const Field *field = key.GetField(i);
+    uint32_t width = EncodedWidth(column);
+    if (field->IsNull()) {
+      buf += sizeof(uint8_t) + width;
+      continue;
+    }
+    *buf++ = 1;
+    switch (column->GetType()) {
+      case TypeId::kTypeInt: {
+        char raw[sizeof(int32_t)];
+        field->SerializeTo(raw);
+        WriteBigEndian32(buf, MACH_READ_FROM(uint32_t, raw) ^ SIGN_BIT);
+        break;
+      }
+      case TypeId::kTypeFloat: {
+        char raw[sizeof(float)];
+        field->SerializeTo(raw);
+        // -0.0 compares equal to 0.0, so both take the same key
+        uint32_t bits = MACH_READ_FROM(float, raw) == 0.0f ? 0 : MACH_READ_FROM(uint32_t, raw);
+        WriteBigEndian32(buf, (bits & SIGN_BIT) != 0 ? ~bits : bits ^ SIGN_BIT);
+        break;
+      }
+      case TypeId::kTypeChar: {
+        uint32_t len = field->GetLength();
+        if (len > column->GetLength()) {
+          ASSERT(cut != nullptr, "Char value is longer than its key column.");
+          // the stored values order before the value iff they order before or equal to its cut prefix
+          len = column->GetLength();
+          *cut = true;
+        }
+        memcpy(buf, field->GetData(), len);
+        buf[column->GetLength()] = static_cast<char>(len >> 8);
+        buf[column->GetLength() + 1] = static_cast<char>(len);
+        break;
+      }
+      default:
+        ASSERT(false, "Unsupported key column type.");
+    }
+    buf += width;
+    if (cut != nullptr && *cut) {
+      // the columns after a cut value cannot narrow the bound any further
+      break;
+    }
+  }
+  return static_cast<uint32_t>(buf - key_buf->data);
+}
+
+void KeyManager::DeserializeToKey(const GenericKey *key_buf, Row &key, Schema *schema) const {
+  ASSERT(key.GetFieldCount() == 0, "Non empty field in key.");
+  const char *buf = key_buf->data;
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+    const Column *column = schema->GetColumn(i);
+    uint32_t width = EncodedWidth(column);
+    bool is_null = *buf++ == 0;
+    if (is_null) {
+      key.AppendField(Field(column->GetType()));
+      buf += width;
+      continue;
+    }
+    switch (column->GetType()) {
+      case TypeId::kTypeInt: {
+        uint32_t bits = ReadBigEndian32(buf) ^ SIGN_BIT;
+        key.AppendField(Field(TypeId::kTypeInt, static_cast<int32_t>(bits)));
+        break;
+      }
+      case TypeId::kTypeFloat: {
+        uint32_t bits = ReadBigEndian32(buf);
+        bits = (bits & SIGN_BIT) != 0 ? bits ^ SIGN_BIT : ~bits;
+        float value;
+        memcpy(&value, &bits, sizeof(float));
+        key.AppendField(Field(TypeId::kTypeFloat, value));
+        break;
+      }
+      case TypeId::kTypeChar: {
+        auto len_hi = static_cast<uint8_t>(buf[column->GetLength()]);
+        auto len_lo = static_cast<uint8_t>(buf[column->GetLength() + 1]);
+        uint32_t len = (static_cast<uint32_t>(len_hi) << 8) | len_lo;
+        key.AppendField(Field(TypeId::kTypeChar, const_cast<char *>(buf), len, false));
+        break;
+      }
+      default:
+        ASSERT(false, "Unsupported key column type.");
+    }
+    buf += width;
+  }
+}
+
+void KeyManager::SetRowIdSuffix(GenericKey *key_buf, const RowId &row_id) const {
+  ASSERT(row_id_suffix_, "Key has no row id suffix.");
+  char *buf = key_buf->data + encoded_size_ - ROW_ID_SUFFIX_SIZE;
+  WriteBigEndian32(buf, static_cast<uint32_t>(row_id.GetPageId()) ^ SIGN_BIT);
+  WriteBigEndian32(buf + sizeof(uint32_t), row_id.GetSlotNum());
+}
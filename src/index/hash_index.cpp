@@ -0,0 +1,130 @@
+#include "index/hash_index.h"
+
+#include <algorithm>
+
+HashIndex::HashIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size,
+                     BufferPoolManager *buffer_pool_manager, bool unique)
+    : Index(index_id, key_schema),
+      processor_(key_schema_, key_size),
+      container_(index_id, buffer_pool_manager, processor_, unique) {}
+
+dberr_t HashIndex::InsertEntry(const Row &key, RowId row_id, [[maybe_unused]] Transaction *txn) {
+  GenericKey *index_key = processor_.InitKey();
+  processor_.SerializeFromKey(index_key, key, key_schema_);
+  bool status = container_.Insert(index_key, row_id);
+  free(index_key);
+  return status ? DB_SUCCESS : DB_FAILED;
+}
+
+dberr_t HashIndex::RemoveEntry(const Row &key, RowId row_id, [[maybe_unused]] Transaction *txn) {
+  GenericKey *index_key = processor_.InitKey();
+  processor_.SerializeFromKey(index_key, key, key_schema_);
+  container_.Remove(index_key, row_id);
+  free(index_key);
+  return DB_SUCCESS;
+}
+
+namespace {
+
+/**
+ * Hands out the row ids collected when the scan was opened, it keeps no page pinned.
+ */
+class HashScanCursor : public IndexScanCursor {
+ public:
+  explicit HashScanCursor(std::vector<RowId> row_ids) : row_ids_(std::move(row_ids)) {}
+
+  bool Next(RowId *row_id) override {
+    if (cursor_ == row_ids_.size()) {
+      return false;
+    }
+    *row_id = row_ids_[cursor_++];
+    return true;
+  }
+
+ private:
+  std::vector<RowId> row_ids_;
+  size_t cursor_{0};
+};
+
+}  // namespace
+
+std::unique_ptr<IndexScanCursor> HashIndex::Scan(const Row *lower, const Row *upper, bool lower_inclusive,
+                                                 bool upper_inclusive, [[maybe_unused]] Transaction *txn) {
+  GenericKey *lower_key = nullptr;
+  GenericKey *upper_key = nullptr;
+  if (lower != nullptr) {
+    lower_key = processor_.InitKey();
+    // a cut bound stands between keys: everything up to it is smaller, everything after it larger than the bound
+    if (processor_.SerializeBound(lower_key, *lower, key_schema_, !lower_inclusive)) {
+      lower_inclusive = false;
+    }
+  }
+  if (upper != nullptr) {
+    upper_key = processor_.InitKey();
+    if (processor_.SerializeBound(upper_key, *upper, key_schema_, upper_inclusive)) {
+      upper_inclusive = true;
+    }
+  }
+  std::vector<RowId> row_ids;
+  uint32_t key_columns = key_schema_->GetColumnCount();
+  if (lower_key != nullptr && upper_key != nullptr && lower_inclusive && upper_inclusive &&
+      lower->GetFieldCount() == key_columns && upper->GetFieldCount() == key_columns &&
+      processor_.CompareKeys(lower_key, upper_key) == 0) {
+    container_.GetValue(lower_key, row_ids);
+  } else {
+    container_.ForEach([&](const GenericKey *key, const RowId &row_id) {
+      if (lower_key != nullptr) {
+        int cmp = processor_.CompareKeys(key, lower_key);
+        if (cmp < 0 || (cmp == 0 && !lower_inclusive)) {
+          return;
+        }
+      }
+      if (upper_key != nullptr) {
+        int cmp = processor_.CompareKeys(key, upper_key);
+        if (cmp > 0 || (cmp == 0 && !upper_inclusive)) {
+          return;
+        }
+      }
+      row_ids.emplace_back(row_id);
+    });
+    std::sort(row_ids.begin(), row_ids.end());
+  }
+  free(lower_key);
+  free(upper_key);
+  return std::make_unique<HashScanCursor>(std::move(row_ids));
+}
+
+dberr_t HashIndex::ScanKey(const Row &key, vector<RowId> &result, Transaction *txn, string compare_operator) {
+  std::vector<std::unique_ptr<IndexScanCursor>> scans;
+  if (compare_operator == "=" && !processor_.FitsKey(key, key_schema_)) {
+    // no stored key is that long
+  } else if (compare_operator == "=") {
+    GenericKey *index_key = processor_.InitKey();
+    processor_.SerializeFromKey(index_key, key, key_schema_);
+    container_.GetValue(index_key, result);
+    free(index_key);
+  } else if (compare_operator == ">") {
+    scans.emplace_back(Scan(&key, nullptr, false, true, txn));
+  } else if (compare_operator == ">=") {
+    scans.emplace_back(Scan(&key, nullptr, true, true, txn));
+  } else if (compare_operator == "<") {
+    scans.emplace_back(Scan(nullptr, &key, true, false, txn));
+  } else if (compare_operator == "<=") {
+    scans.emplace_back(Scan(nullptr, &key, true, true, txn));
+  } else if (compare_operator == "<>") {
+    scans.emplace_back(Scan(nullptr, &key, true, false, txn));
+    scans.emplace_back(Scan(&key, nullptr, false, true, txn));
+  }
+  RowId row_id;
+  for (auto &scan : scans) {
+    while (scan->Next(&row_id)) {
+      result.emplace_back(row_id);
+    }
+  }
+  return result.empty() ? DB_KEY_NOT_FOUND : DB_SUCCESS;
+}
+
+dberr_t HashIndex::Destroy() {
+  container_.Destroy();
+  return DB_SUCCESS;
+}
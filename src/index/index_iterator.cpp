@@ -7,36 +7,88 @@ IndexIterator::IndexIterator() = default;
 
 IndexIterator::IndexIterator(page_id_t page_id, BufferPoolManager *bpm, int index)
     : current_page_id(page_id), item_index(index), buffer_pool_manager(bpm) {
-  page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id)->GetData());
+  frame = buffer_pool_manager->FetchPage(current_page_id);
+  page = reinterpret_cast<LeafPage *>(frame->GetData());
+  SkipToValid();
+}
+
+IndexIterator::IndexIterator(const IndexIterator &other)
+    : current_page_id(other.current_page_id),
+      frame(other.frame),
+      page(other.page),
+      item_index(other.item_index),
+      buffer_pool_manager(other.buffer_pool_manager) {
+  if (current_page_id != INVALID_PAGE_ID) {
+    buffer_pool_manager->FetchPage(current_page_id);
+  }
+}
+
+IndexIterator &IndexIterator::operator=(const IndexIterator &other) {
+  if (this != &other) {
+    Release();
+    current_page_id = other.current_page_id;
+    frame = other.frame;
+    page = other.page;
+    item_index = other.item_index;
+    buffer_pool_manager = other.buffer_pool_manager;
+    if (current_page_id != INVALID_PAGE_ID) {
+      buffer_pool_manager->FetchPage(current_page_id);
+    }
+  }
+  return *this;
 }
 
 IndexIterator::~IndexIterator() {
-  if (current_page_id != INVALID_PAGE_ID)
+  Release();
+}
+
+void IndexIterator::Release() {
+  if (current_page_id != INVALID_PAGE_ID) {
     buffer_pool_manager->UnpinPage(current_page_id, false);
+  }
+  current_page_id = INVALID_PAGE_ID;
+  frame = nullptr;
+  page = nullptr;
+  item_index = 0;
+}
+
+void IndexIterator::SkipToValid() {
+  while (current_page_id != INVALID_PAGE_ID) {
+    frame->RLatch();
+    if (item_index < page->GetSize()) {
+      frame->RUnlatch();
+      return;
+    }
+    // pin the next leaf while this one is latched, a leaf is only freed by a writer holding its left neighbor
+    page_id_t next_page_id = page->GetNextPageId();
+    Page *next = nullptr;
+    if (next_page_id != INVALID_PAGE_ID) {
+      next = buffer_pool_manager->FetchPage(next_page_id);
+    }
+    frame->RUnlatch();
+    Release();
+    if (next != nullptr) {
+      current_page_id = next_page_id;
+      frame = next;
+      page = reinterpret_cast<LeafPage *>(frame->GetData());
+    }
+  }
 }
 
 std::pair<GenericKey *, RowId> IndexIterator::operator*() {
-//  ASSERT(false, "Not implemented yet.");
-  LeafPage *leaf_page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id)->GetData());
-  return std::make_pair(leaf_page->KeyAt(item_index), leaf_page->ValueAt(item_index));
+  ASSERT(current_page_id != INVALID_PAGE_ID, "Dereference of the end iterator.");
+  key_.resize(page->GetKeySize());
+  auto key = reinterpret_cast<GenericKey *>(key_.data());
+  frame->RLatch();
+  page->KeyAt(item_index, key);
+  RowId value = page->ValueAt(item_index);
+  frame->RUnlatch();
+  return std::make_pair(key, value);
 }
 
 IndexIterator &IndexIterator::operator++() {
-//  ASSERT(false, "Not implemented yet.");
-  LeafPage *leaf_page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id)->GetData());
-  if (item_index + 1 < leaf_page->GetSize()) {
-    item_index++;
-  } else {
-    current_page_id = leaf_page->GetNextPageId();
-    item_index = 0;
-    buffer_pool_manager->UnpinPage(leaf_page->GetPageId(), false);
-    if (current_page_id != INVALID_PAGE_ID) {
-      leaf_page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id)->GetData());
-    } else {
-      leaf_page = nullptr;
-    }
-  }
-  page = leaf_page;
+  item_index++;
+  SkipToValid();
   return *this;
 }
 
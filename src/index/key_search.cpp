@@ -0,0 +1,134 @@
+#include "index/key_search.h"
+
+#include "record/char_ops.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define KEY_SEARCH_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/** keys left to the final count of a packed search, two cache lines of keys */
+constexpr int PACKED_WINDOW = 16;
+
+inline uint64_t LoadPacked(const char *key) { return __builtin_bswap64(MACH_READ_FROM(uint64_t, key)); }
+
+/**
+ * Number of the size keys which are less than key, or not greater than key for an upper bound.
+ */
+template <bool kUpper>
+int CountPackedScalar(const char *keys, int size, uint64_t key) {
+  int count = 0;
+  for (int i = 0; i < size; i++) {
+    uint64_t k = LoadPacked(keys + i * sizeof(uint64_t));
+    count += kUpper ? k <= key : k < key;
+  }
+  return count;
+}
+
+#ifdef KEY_SEARCH_X86
+template <bool kUpper>
+__attribute__((target("avx2"))) int CountPackedAvx2(const char *keys, int size, uint64_t key) {
+  // byte swap every 64 bit lane, then flip the sign bits so the signed compare orders unsigned values
+  const __m256i bswap = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                         15, 14, 13, 12, 11, 10, 9, 8);
+  const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+  const __m256i needle = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<int64_t>(key)), sign);
+  int count = 0;
+  int i = 0;
+  for (; i + 4 <= size; i += 4) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i * sizeof(uint64_t)));
+    v = _mm256_xor_si256(_mm256_shuffle_epi8(v, bswap), sign);
+    __m256i mask = kUpper ? _mm256_cmpgt_epi64(v, needle) : _mm256_cmpgt_epi64(needle, v);
+    int bits = __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(mask)));
+    count += kUpper ? 4 - bits : bits;
+  }
+  return count + CountPackedScalar<kUpper>(keys + i * sizeof(uint64_t), size - i, key);
+}
+#endif  // KEY_SEARCH_X86
+
+template <bool kUpper>
+int SearchPacked(const char *keys, int size, const GenericKey *key, bool simd) {
+  uint64_t needle = LoadPacked(reinterpret_cast<const char *>(key));
+  // the answer stays in [first, first + len], the probe only picks the half, not a branch
+  int first = 0;
+  int len = size;
+  while (len > PACKED_WINDOW) {
+    int half = len / 2;
+    uint64_t probe = LoadPacked(keys + (first + half - 1) * sizeof(uint64_t));
+    first += (kUpper ? probe <= needle : probe < needle) ? half : 0;
+    len -= half;
+  }
+  const char *window = keys + first * sizeof(uint64_t);
+#ifdef KEY_SEARCH_X86
+  if (simd) {
+    return first + CountPackedAvx2<kUpper>(window, len, needle);
+  }
+#endif
+  return first + CountPackedScalar<kUpper>(window, len, needle);
+}
+
+/**
+ * Binary search of size keys, compare(i) is the order of the i-th key against the searched key.
+ */
+template <bool kUpper, typename Compare>
+int SearchBytes(int size, Compare compare) {
+  if (size == 0) {
+    return 0;
+  }
+  int first = 0;
+  int len = size;
+  while (len > 1) {
+    int half = len / 2;
+    int cmp = compare(first + half - 1);
+    first += (kUpper ? cmp <= 0 : cmp < 0) ? half : 0;
+    len -= half;
+  }
+  int cmp = compare(first);
+  return first + (kUpper ? cmp <= 0 : cmp < 0);
+}
+
+template <bool kUpper>
+int SearchBytes(const char *keys, int size, const GenericKey *key, const KeyManager &KM) {
+  return SearchBytes<kUpper>(size, [&](int i) {
+    return KM.CompareKeys(reinterpret_cast<const GenericKey *>(keys + i * KM.GetKeySize()), key);
+  });
+}
+
+}  // namespace
+
+bool KeySearch::simd_ = false;
+
+int KeySearch::LowerBound(const char *keys, int size, const GenericKey *key, const KeyManager &KM) {
+  if (KM.IsPacked()) {
+    return SearchPacked<false>(keys, size, key, simd_);
+  }
+  return SearchBytes<false>(keys, size, key, KM);
+}
+
+int KeySearch::UpperBound(const char *keys, int size, const GenericKey *key, const KeyManager &KM) {
+  if (KM.IsPacked()) {
+    return SearchPacked<true>(keys, size, key, simd_);
+  }
+  return SearchBytes<true>(keys, size, key, KM);
+}
+
+int KeySearch::LowerBound(const char *keys, int size, const char *key, int width) {
+  return SearchBytes<false>(size, [&](int i) { return memcmp(keys + i * width, key, width); });
+}
+
+bool KeySearch::SetSimd(bool enabled) {
+  if (enabled && !CharOps::IsSupported(CharOps::Isa::kAvx2)) {
+    return false;
+  }
+  simd_ = enabled;
+  return true;
+}
+
+namespace {
+
+/** use the AVX2 kernel when the cpu has it, searches running before main count with the scalar loop */
+const bool kKeySearchBound = KeySearch::SetSimd(true);
+
+}  // namespace
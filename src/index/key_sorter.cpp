@@ -0,0 +1,126 @@
+#include "index/key_sorter.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+KeySorter::KeySorter(const KeyManager &KM, size_t memory_budget)
+    : KM_(KM), entry_size_(KM.GetKeySize() + sizeof(RowId)) {
+  capacity_ = std::max<size_t>(1, memory_budget / (entry_size_ + sizeof(uint32_t)));
+  last_.resize(KM.GetKeySize());
+}
+
+KeySorter::~KeySorter() {
+  for (FILE *run : runs_) {
+    fclose(run);
+  }
+}
+
+bool KeySorter::Less(const char *lhs, const char *rhs) const {
+  int cmp = KM_.CompareKeys(reinterpret_cast<const GenericKey *>(lhs), reinterpret_cast<const GenericKey *>(rhs));
+  if (cmp != 0) {
+    return cmp < 0;
+  }
+  return MACH_READ_FROM(RowId, lhs + KM_.GetKeySize()) < MACH_READ_FROM(RowId, rhs + KM_.GetKeySize());
+}
+
+void KeySorter::Add(const GenericKey *key, const RowId &row_id) {
+  ASSERT(!finished_, "Entry added after the sort.");
+  if (order_.size() == capacity_) {
+    SpillRun();
+  }
+  size_t offset = buffer_.size();
+  buffer_.resize(offset + entry_size_);
+  memcpy(buffer_.data() + offset, key, KM_.GetKeySize());
+  MACH_WRITE_TO(RowId, buffer_.data() + offset + KM_.GetKeySize(), row_id);
+  order_.push_back(order_.size());
+}
+
+void KeySorter::SortBuffer() {
+  std::sort(order_.begin(), order_.end(),
+            [this](uint32_t lhs, uint32_t rhs) { return Less(EntryAt(buffer_, lhs), EntryAt(buffer_, rhs)); });
+}
+
+void KeySorter::SpillRun() {
+  SortBuffer();
+  FILE *run = tmpfile();
+  if (run == nullptr) {
+    throw std::runtime_error("can not create a sort run");
+  }
+  for (uint32_t index : order_) {
+    if (fwrite(EntryAt(buffer_, index), entry_size_, 1, run) != 1) {
+      fclose(run);
+      throw std::runtime_error("can not write a sort run");
+    }
+  }
+  rewind(run);
+  runs_.push_back(run);
+  buffer_.clear();
+  order_.clear();
+}
+
+bool KeySorter::ReadHead(size_t run) {
+  return fread(heads_.data() + run * entry_size_, entry_size_, 1, runs_[run]) == 1;
+}
+
+void KeySorter::Finish() {
+  if (finished_) {
+    return;
+  }
+  finished_ = true;
+  if (runs_.empty()) {
+    SortBuffer();
+    return;
+  }
+  if (!order_.empty()) {
+    SpillRun();
+  }
+  // buffer_ keeps a copy of the entry read last
+  buffer_.assign(entry_size_, 0);
+  buffer_.shrink_to_fit();
+  // a min heap of the runs by their current entry
+  heads_.resize(runs_.size() * entry_size_);
+  for (size_t run = 0; run < runs_.size(); run++) {
+    if (ReadHead(run)) {
+      heap_.push_back(run);
+    }
+  }
+  auto greater = [this](size_t lhs, size_t rhs) { return Less(EntryAt(heads_, rhs), EntryAt(heads_, lhs)); };
+  std::make_heap(heap_.begin(), heap_.end(), greater);
+}
+
+const char *KeySorter::NextEntry() {
+  if (runs_.empty()) {
+    return cursor_ < order_.size() ? EntryAt(buffer_, order_[cursor_++]) : nullptr;
+  }
+  if (heap_.empty()) {
+    return nullptr;
+  }
+  auto greater = [this](size_t lhs, size_t rhs) { return Less(EntryAt(heads_, rhs), EntryAt(heads_, lhs)); };
+  std::pop_heap(heap_.begin(), heap_.end(), greater);
+  size_t run = heap_.back();
+  // the head is overwritten by the next entry of its run
+  memcpy(buffer_.data(), EntryAt(heads_, run), entry_size_);
+  if (ReadHead(run)) {
+    std::push_heap(heap_.begin(), heap_.end(), greater);
+  } else {
+    heap_.pop_back();
+  }
+  return buffer_.data();
+}
+
+bool KeySorter::Next(GenericKey *key, RowId *row_id) {
+  ASSERT(finished_, "Entries read before the sort.");
+  const char *entry;
+  do {
+    entry = NextEntry();
+    if (entry == nullptr) {
+      return false;
+    }
+  } while (has_last_ && KM_.CompareKeys(reinterpret_cast<const GenericKey *>(entry),
+                                        reinterpret_cast<const GenericKey *>(last_.data())) == 0);
+  memcpy(last_.data(), entry, KM_.GetKeySize());
+  has_last_ = true;
+  memcpy(key, entry, KM_.GetKeySize());
+  *row_id = MACH_READ_FROM(RowId, entry + KM_.GetKeySize());
+  return true;
+}
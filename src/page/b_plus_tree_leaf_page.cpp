@@ -3,34 +3,79 @@
 #include <algorithm>
 
 #include "index/generic_key.h"
+#include "index/key_search.h"
 
-#define pairs_off (data_)
-#define pair_size (GetKeySize() + sizeof(RowId))
-#define key_off 0
-#define val_off GetKeySize()
 /*****************************************************************************
  * HELPER METHODS AND UTILITIES
  *****************************************************************************/
 
-/**
- * TODO: Student Implement
- */
 /**
  * Init method after creating a new leaf page
  * Including set page type, set current size to zero, set page id/parent id, set
  * next page id and set max size
- * 未初始化next_page_id
  */
 void LeafPage::Init(page_id_t page_id, page_id_t parent_id, int key_size, int max_size) {
+  ASSERT(max_size <= GetMaxCapacity(key_size), "Leaf page max size exceeds the page.");
   SetPageType(IndexPageType::LEAF_PAGE);
   SetKeySize(key_size);
   SetSize(0);
-  SetMaxSize(max_size);
+  size_limit_ = max_size;
+  prefix_size_ = 0;
+  SetMaxSize(MaxSizeAt(0));
   SetParentPageId(parent_id);
   SetPageId(page_id);
   SetNextPageId(INVALID_PAGE_ID);
 }
 
+int LeafPage::GetMaxCapacity(int key_size) {
+  // one slot is kept for the pair which overflows the page before it is split
+  int prefix_size = key_size == sizeof(uint64_t) ? 0 : key_size - 1;
+  return static_cast<int>((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE - prefix_size) /
+                          (key_size - prefix_size + sizeof(RowId))) - 1;
+}
+
+int LeafPage::MaxSizeAt(int prefix_size) const {
+  int capacity = static_cast<int>((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE - prefix_size) /
+                                  (GetKeySize() - prefix_size + sizeof(RowId))) - 1;
+  return std::min(size_limit_, capacity);
+}
+
+int LeafPage::CommonPrefixSize(const GenericKey *key) const {
+  const char *prefix = PrefixPtr();
+  const char *bytes = reinterpret_cast<const char *>(key);
+  int size = 0;
+  while (size < prefix_size_ && prefix[size] == bytes[size]) {
+    size++;
+  }
+  return size;
+}
+
+int LeafPage::MaxSizeWith(const GenericKey *key) const {
+  if (IsPacked()) {
+    return GetMaxSize();
+  }
+  // a key alone is its own prefix
+  return MaxSizeAt(GetSize() == 0 ? GetKeySize() : CommonPrefixSize(key));
+}
+
+int LeafPage::MaxSizeWith(const LeafPage *right) const {
+  if (IsPacked() || right->GetSize() == 0) {
+    return GetMaxSize();
+  }
+  if (GetSize() == 0) {
+    return MaxSizeAt(right->prefix_size_);
+  }
+  // the keys of both pages share the bytes both prefixes share
+  int prefix_size = std::min(prefix_size_, right->prefix_size_);
+  const char *prefix = PrefixPtr();
+  const char *right_prefix = right->PrefixPtr();
+  int size = 0;
+  while (size < prefix_size && prefix[size] == right_prefix[size]) {
+    size++;
+  }
+  return MaxSizeAt(size);
+}
+
 /**
  * Helper methods to set/get next page id
  */
@@ -40,73 +85,105 @@ page_id_t LeafPage::GetNextPageId() const {
 
 void LeafPage::SetNextPageId(page_id_t next_page_id) {
   next_page_id_ = next_page_id;
-  if (next_page_id == 0) {
-    LOG(INFO) << "Fatal error";
-  }
 }
 
-/**
- * TODO: Student Implement
- */
 /**
  * Helper method to find the first index i so that pairs_[i].first >= key
  * NOTE: This method is only used when generating index iterator
- * 二分查找
  */
 int LeafPage::KeyIndex(const GenericKey *key, const KeyManager &KM) {
-  int l = 0, r = GetSize() - 1;
-  int m = (l + r) / 2;
-  while (l <= r) {
-    m = (l + r) / 2;
-    GenericKey *keyNow = KeyAt(m);
-    if(KM.CompareKeys(keyNow, key) >= 0) {
-      r = m - 1;
-    } else {
-      l = m + 1;
-    }
+  if (prefix_size_ == 0) {
+    return KeySearch::LowerBound(SuffixAt(0), GetSize(), key, KM);
   }
-  return (r + 1);
+  // a key which does not start with the prefix is before or after every key of the page
+  int cmp = memcmp(key, PrefixPtr(), prefix_size_);
+  if (cmp != 0) {
+    return cmp < 0 ? 0 : GetSize();
+  }
+  return KeySearch::LowerBound(SuffixAt(0), GetSize(), reinterpret_cast<const char *>(key) + prefix_size_,
+                               SuffixSize());
+}
+
+bool LeafPage::IsKeyAt(int index, const GenericKey *key) const {
+  auto bytes = reinterpret_cast<const char *>(key);
+  return memcmp(bytes, PrefixPtr(), prefix_size_) == 0 &&
+         memcmp(bytes + prefix_size_, SuffixAt(index), SuffixSize()) == 0;
 }
 
 /*
  * Helper method to find and return the key associated with input "index"(a.k.a
  * array offset)
  */
-GenericKey *LeafPage::KeyAt(int index) {
-//  LOG(INFO) << "pairs_off:" << data_;
-//  LOG(INFO) << "index * pair_size:" << index * pair_size;
-//  LOG(INFO) << "key_off:" << key_off;
-  return reinterpret_cast<GenericKey *>(pairs_off + index * pair_size + key_off);
-}
-
-void LeafPage::SetKeyAt(int index, GenericKey *key) {
-//  LOG(INFO) << "set key" << key;
-  memcpy(pairs_off + index * pair_size + key_off, key, GetKeySize());
+void LeafPage::KeyAt(int index, GenericKey *key) const {
+  auto bytes = reinterpret_cast<char *>(key);
+  memcpy(bytes, PrefixPtr(), prefix_size_);
+  memcpy(bytes + prefix_size_, SuffixAt(index), SuffixSize());
 }
 
 RowId LeafPage::ValueAt(int index) const {
-  return *reinterpret_cast<const RowId *>(pairs_off + index * pair_size + val_off);
+  return ValuesPtr()[index];
 }
 
 void LeafPage::SetValueAt(int index, RowId value) {
-  *reinterpret_cast<RowId *>(pairs_off + index * pair_size + val_off) = value;
+  ValuesPtr()[index] = value;
+}
+
+void LeafPage::ShiftPairs(int index, int offset) {
+  int count = GetSize() - index;
+  memmove(SuffixAt(index + offset), SuffixAt(index), count * SuffixSize());
+  memmove(ValuesPtr() + index + offset, ValuesPtr() + index, count * sizeof(RowId));
 }
 
-void *LeafPage::PairPtrAt(int index) {
-  return KeyAt(index);
+void LeafPage::CopyPairsTo(int begin, int end, std::vector<char> *keys, std::vector<RowId> *values) const {
+  int key_size = GetKeySize();
+  size_t offset = keys->size();
+  keys->resize(offset + (end - begin) * key_size);
+  for (int i = begin; i < end; i++, offset += key_size) {
+    KeyAt(i, reinterpret_cast<GenericKey *>(keys->data() + offset));
+  }
+  values->insert(values->end(), ValuesPtr() + begin, ValuesPtr() + end);
 }
 
-void LeafPage::PairCopy(void *dest, void *src, int pair_num) {
-  memcpy(dest, src, pair_num * (GetKeySize() + sizeof(std::pair<GenericKey *, RowId>)));
+void LeafPage::Rebuild(const char *keys, const RowId *values, int size) {
+  int key_size = GetKeySize();
+  int prefix_size = 0;
+  if (size > 0 && !IsPacked()) {
+    // sorted keys all share the prefix of the first and the last one
+    const char *last = keys + (size - 1) * key_size;
+    while (prefix_size < key_size && keys[prefix_size] == last[prefix_size]) {
+      prefix_size++;
+    }
+  }
+  prefix_size_ = prefix_size;
+  SetMaxSize(MaxSizeAt(prefix_size));
+  ASSERT(size <= GetMaxSize() + 1, "Leaf page pairs exceed the page.");
+  SetSize(size);
+  if (size > 0) {
+    memcpy(PrefixPtr(), keys, prefix_size);
+  }
+  for (int i = 0; i < size; i++) {
+    memcpy(SuffixAt(i), keys + i * key_size + prefix_size, SuffixSize());
+  }
+  memcpy(ValuesPtr(), values, size * sizeof(RowId));
 }
 
-/*
- * Helper method to find and return the key & value pair associated with input
- * "index"(a.k.a. array offset)
- */
-std::pair<GenericKey *, RowId> LeafPage::GetItem(int index) {
-    // replace with your own code
-    return make_pair(KeyAt(index), ValueAt(index));
+void LeafPage::InsertAt(int index, const GenericKey *key, const RowId &value) {
+  if (GetSize() == 0 || (!IsPacked() && CommonPrefixSize(key) < prefix_size_)) {
+    // the key shares less than the prefix, the pairs are laid out again under a shorter one
+    std::vector<char> keys;
+    std::vector<RowId> values;
+    CopyPairsTo(0, index, &keys, &values);
+    auto bytes = reinterpret_cast<const char *>(key);
+    keys.insert(keys.end(), bytes, bytes + GetKeySize());
+    values.push_back(value);
+    CopyPairsTo(index, GetSize(), &keys, &values);
+    Rebuild(keys.data(), values.data(), GetSize() + 1);
+    return;
+  }
+  ShiftPairs(index, 1);
+  memcpy(SuffixAt(index), reinterpret_cast<const char *>(key) + prefix_size_, SuffixSize());
+  SetValueAt(index, value);
+  IncreaseSize(1);
 }
 
 /*****************************************************************************
@@ -117,21 +194,8 @@ std::pair<GenericKey *, RowId> LeafPage::GetItem(int index) {
  * @return page size after insertion
  */
 int LeafPage::Insert(GenericKey *key, const RowId &value, const KeyManager &KM) {
-  int index = KeyIndex(key, KM);
-//  if (index >= 0 && KM.CompareKeys(key, KeyAt(index)) == 0) {
-//    return GetSize();
-//  }
-//  if(GetSize() >= GetMaxSize()) {
-//    return GetSize();
-//  }
-//  for(int i = GetSize(); i > index; i--) {
-//    SetKeyAt(i, KeyAt(i - 1));
-//    SetValueAt(i, ValueAt(i - 1));
-//  }
-  PairCopy(PairPtrAt(index + 1), PairPtrAt(index), GetSize() - index);
-  SetKeyAt(index, key);
-  SetValueAt(index, value);
-  IncreaseSize(1);
+  ASSERT(GetSize() <= MaxSizeWith(key), "Leaf page is not split.");
+  InsertAt(KeyIndex(key, KM), key, value);
   return GetSize();
 }
 
@@ -142,21 +206,17 @@ int LeafPage::Insert(GenericKey *key, const RowId &value, const KeyManager &KM)
  * Remove half of key & value pairs from this page to "recipient" page
  */
 void LeafPage::MoveHalfTo(LeafPage *recipient) {
-  int size = GetSize();
-  int half = GetMaxSize() / 2;
-  recipient->CopyNFrom(PairPtrAt(half), size - half);
-//  recipient->SetSize(size - half); // right half
-//  recipient->SetNextPageId(GetNextPageId());
-//  SetNextPageId(recipient->GetPageId());
-  SetSize(half); // split
+  MoveTailTo(recipient, GetSize() / 2);
 }
 
-/*
- * Copy starting from items, and copy {size} number of elements into me.
- */
-void LeafPage::CopyNFrom(void *src, int size) {
-  PairCopy(PairPtrAt(GetSize()), src, size);
-  IncreaseSize(size);
+void LeafPage::MoveTailTo(LeafPage *recipient, int index) {
+  ASSERT(recipient->GetSize() == 0, "Recipient of the split is not empty.");
+  // both halves are laid out again, their keys may share longer prefixes
+  std::vector<char> keys;
+  std::vector<RowId> values;
+  CopyPairsTo(0, GetSize(), &keys, &values);
+  recipient->Rebuild(keys.data() + index * GetKeySize(), values.data() + index, GetSize() - index);
+  Rebuild(keys.data(), values.data(), index);
 }
 
 /*****************************************************************************
@@ -169,7 +229,7 @@ void LeafPage::CopyNFrom(void *src, int size) {
  */
 bool LeafPage::Lookup(const GenericKey *key, RowId &value, const KeyManager &KM) {
   int key_index = KeyIndex(key, KM);
-  if(key_index < GetSize() && KM.CompareKeys(key, KeyAt(key_index)) == 0) {
+  if (key_index < GetSize() && IsKeyAt(key_index, key)) {
     value = ValueAt(key_index);
     return true;
   }
@@ -187,11 +247,9 @@ bool LeafPage::Lookup(const GenericKey *key, RowId &value, const KeyManager &KM)
  */
 int LeafPage::RemoveAndDeleteRecord(const GenericKey *key, const KeyManager &KM) {
   int key_index = KeyIndex(key, KM);
-  if(key_index < GetSize() && KM.CompareKeys(key, KeyAt(key_index)) == 0) {
-    int num_pairs = GetSize() - key_index - 1;
-    PairCopy(PairPtrAt(key_index), PairPtrAt(key_index + 1), num_pairs);
+  if (key_index < GetSize() && IsKeyAt(key_index, key)) {
+    ShiftPairs(key_index + 1, -1);
     IncreaseSize(-1);
-    return GetSize();
   }
   return GetSize();
 }
@@ -204,12 +262,13 @@ int LeafPage::RemoveAndDeleteRecord(const GenericKey *key, const KeyManager &KM)
  * to update the next_page id in the sibling page
  */
 void LeafPage::MoveAllTo(LeafPage *recipient) {
-  int num_pairs = GetSize();
-  recipient->PairCopy(recipient->PairPtrAt(0), PairPtrAt(0), num_pairs);
-//  recipient->SetSize(recipient->GetSize() + num_pairs);
-//  recipient->SetNextPageId(GetNextPageId());
+  std::vector<char> keys;
+  std::vector<RowId> values;
+  recipient->CopyPairsTo(0, recipient->GetSize(), &keys, &values);
+  CopyPairsTo(0, GetSize(), &keys, &values);
+  recipient->Rebuild(keys.data(), values.data(), recipient->GetSize() + GetSize());
+  recipient->SetNextPageId(GetNextPageId());
   SetSize(0);
-//  SetNextPageId(INVALID_PAGE_ID);
 }
 
 /*****************************************************************************
@@ -220,45 +279,20 @@ void LeafPage::MoveAllTo(LeafPage *recipient) {
  *
  */
 void LeafPage::MoveFirstToEndOf(LeafPage *recipient) {
-  GenericKey *key = KeyAt(0);
-  RowId value = ValueAt(0);
-  recipient->CopyLastFrom(key, value);
-//  int num_pairs = GetSize() - 1;
-//  PairCopy(PairPtrAt(0), PairPtrAt(1), num_pairs);
-  PairCopy(PairPtrAt(0), PairPtrAt(1), GetSize() - 1);
+  std::vector<char> key(GetKeySize());
+  KeyAt(0, reinterpret_cast<GenericKey *>(key.data()));
+  recipient->InsertAt(recipient->GetSize(), reinterpret_cast<GenericKey *>(key.data()), ValueAt(0));
+  ShiftPairs(1, -1);
   IncreaseSize(-1);
 }
 
-/*
- * Copy the item into the end of my item list. (Append item to my array)
- */
-void LeafPage::CopyLastFrom(GenericKey *key, const RowId value) {
-  int index = GetSize();
-  SetKeyAt(index, key);
-  SetValueAt(index, value);
-  IncreaseSize(1);
-}
-
 /*
  * Remove the last key & value pair from this page to "recipient" page.
  */
 void LeafPage::MoveLastToFrontOf(LeafPage *recipient) {
   int index = GetSize() - 1;
-  GenericKey *key = KeyAt(index);
-  RowId value = ValueAt(index);
-  recipient->CopyFirstFrom(key, value);
+  std::vector<char> key(GetKeySize());
+  KeyAt(index, reinterpret_cast<GenericKey *>(key.data()));
+  recipient->InsertAt(0, reinterpret_cast<GenericKey *>(key.data()), ValueAt(index));
   IncreaseSize(-1);
 }
-
-/*
- * Insert item at the front of my items. Move items accordingly.
- *
- */
-void LeafPage::CopyFirstFrom(GenericKey *key, const RowId value) {
-  int num_pairs = GetSize();
-  PairCopy(PairPtrAt(1), PairPtrAt(0), num_pairs);
-  // insert new key value page
-  SetKeyAt(0, key);
-  SetValueAt(0, value);
-  IncreaseSize(1);
-}
@@ -69,13 +69,11 @@ void BPlusTreePage::SetMaxSize(int size) {
 
 /*
  * Helper method to get min page size
- * Generally, min page size == max page size / 2
- */
-/**
- * TODO: Student Implement
+ * Generally, min page size == max page size / 2, rounded up for internal pages
+ * so that every internal page but the root has a sibling to merge with.
  */
 int BPlusTreePage::GetMinSize() const {
-  return max_size_ / 2;
+  return page_type_ == IndexPageType::LEAF_PAGE ? max_size_ / 2 : (max_size_ + 1) / 2;
 }
 
 /*
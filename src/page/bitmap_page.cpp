@@ -28,6 +28,20 @@ bool BitmapPage<PageSize>::IsPageFree(uint32_t page_offset) const {
   return IsPageFreeLow(page_offset / 8, page_offset % 8);
 }
 
+template<size_t PageSize>
+bool BitmapPage<PageSize>::Recount() {
+  uint32_t allocated = 0;
+  for (size_t i = 0; i < MAX_CHARS; i++) {
+    allocated += __builtin_popcount(bytes[i]);
+  }
+  if (allocated == page_allocated_ && next_free_page_ <= GetMaxSupportedSize()) {
+    return false;
+  }
+  page_allocated_ = allocated;
+  next_free_page_ = 0;
+  return true;
+}
+
 template<size_t PageSize>
 bool BitmapPage<PageSize>::IsPageFreeLow(uint32_t byte_index, uint8_t bit_index) const {
   return (bytes[byte_index] & (1u << bit_index)) == 0;
@@ -0,0 +1,37 @@
+#include "page/hash_table_bucket_page.h"
+
+void HashTableBucketPage::Init(page_id_t page_id, int key_size) {
+  ASSERT(GetCapacity(key_size) > 0, "Hash bucket page takes no key of the key size.");
+  page_id_ = page_id;
+  key_size_ = key_size;
+  size_ = 0;
+  next_page_id_ = INVALID_PAGE_ID;
+}
+
+int HashTableBucketPage::GetCapacity(int key_size) {
+  return static_cast<int>((PAGE_SIZE - HASH_BUCKET_PAGE_HEADER_SIZE) / (key_size + sizeof(RowId)));
+}
+
+GenericKey *HashTableBucketPage::KeyAt(int index) {
+  return reinterpret_cast<GenericKey *>(KeysPtr() + index * key_size_);
+}
+
+RowId HashTableBucketPage::ValueAt(int index) const {
+  return ValuesPtr()[index];
+}
+
+void HashTableBucketPage::Append(const GenericKey *key, const RowId &value) {
+  ASSERT(!IsFull(), "Hash bucket page is full.");
+  memcpy(KeysPtr() + size_ * key_size_, key, key_size_);
+  ValuesPtr()[size_] = value;
+  size_++;
+}
+
+void HashTableBucketPage::RemoveAt(int index) {
+  int last = size_ - 1;
+  if (index != last) {
+    memcpy(KeysPtr() + index * key_size_, KeysPtr() + last * key_size_, key_size_);
+    ValuesPtr()[index] = ValuesPtr()[last];
+  }
+  size_--;
+}
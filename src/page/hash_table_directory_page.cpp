@@ -0,0 +1,40 @@
+#include "page/hash_table_directory_page.h"
+
+#include <cstring>
+
+#include "common/macros.h"
+
+void HashTableDirectoryPage::Init(page_id_t page_id) {
+  page_id_ = page_id;
+  lsn_ = INVALID_LSN;
+  global_depth_ = 0;
+  memset(local_depths_, 0, sizeof(local_depths_));
+  for (uint32_t i = 0; i < DIRECTORY_ARRAY_SIZE; i++) {
+    bucket_page_ids_[i] = INVALID_PAGE_ID;
+  }
+}
+
+void HashTableDirectoryPage::IncrGlobalDepth() {
+  ASSERT(global_depth_ < MAX_DEPTH, "Hash table directory is full.");
+  uint32_t size = Size();
+  memcpy(local_depths_ + size, local_depths_, size * sizeof(uint8_t));
+  memcpy(bucket_page_ids_ + size, bucket_page_ids_, size * sizeof(page_id_t));
+  global_depth_++;
+}
+
+void HashTableDirectoryPage::DecrGlobalDepth() {
+  ASSERT(CanShrink(), "Hash table directory can not shrink.");
+  global_depth_--;
+}
+
+bool HashTableDirectoryPage::CanShrink() const {
+  if (global_depth_ == 0) {
+    return false;
+  }
+  for (uint32_t i = 0; i < Size(); i++) {
+    if (local_depths_[i] == global_depth_) {
+      return false;
+    }
+  }
+  return true;
+}
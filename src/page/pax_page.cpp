@@ -0,0 +1,235 @@
+#include "page/pax_page.h"
+
+#include "record/column_dictionary.h"
+
+namespace {
+inline uint32_t AlignMinipage(uint32_t offset) { return (offset + 7) & ~7u; }
+}  // namespace
+
+PaxLayout::PaxLayout(Schema *schema) : schema_(schema) {
+  uint32_t column_count = schema->GetColumnCount();
+  value_width_.resize(column_count);
+  null_offset_.resize(column_count);
+  length_offset_.resize(column_count);
+  value_offset_.resize(column_count);
+  uint32_t slot_size = 1;
+  for (uint32_t i = 0; i < column_count; i++) {
+    const Column *column = schema->GetColumn(i);
+    if (schema->GetDictionary(i) != nullptr) {
+      value_width_[i] = sizeof(uint16_t);
+    } else if (column->GetType() == TypeId::kTypeChar) {
+      value_width_[i] = column->GetLength();
+      slot_size += sizeof(uint32_t);
+    } else {
+      value_width_[i] = Type::GetTypeSize(column->GetType());
+    }
+    slot_size += value_width_[i];
+  }
+  // start from the capacity without bitmaps and padding, then shrink until everything fits
+  uint32_t capacity = (PAGE_SIZE - HEADER_SIZE) / slot_size;
+  while (capacity > 0 && Place(capacity) > PAGE_SIZE) {
+    capacity--;
+  }
+  slot_capacity_ = capacity;
+  Place(slot_capacity_);
+}
+
+bool PaxLayout::Fits(const Row &row) const {
+  if (row.GetFieldCount() != GetColumnCount()) {
+    return false;
+  }
+  for (uint32_t i = 0; i < GetColumnCount(); i++) {
+    const Field *field = row.GetField(i);
+    if (!field->IsNull() && field->GetTypeId() == TypeId::kTypeChar && schema_->GetDictionary(i) == nullptr &&
+        field->GetLength() > value_width_[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint32_t PaxLayout::Place(uint32_t capacity) {
+  uint32_t ofs = HEADER_SIZE + capacity;
+  for (uint32_t i = 0; i < GetColumnCount(); i++) {
+    ofs = AlignMinipage(ofs);
+    null_offset_[i] = ofs;
+    ofs += (capacity + 7) / 8;
+    if (schema_->GetColumn(i)->GetType() == TypeId::kTypeChar && schema_->GetDictionary(i) == nullptr) {
+      ofs = AlignMinipage(ofs);
+      length_offset_[i] = ofs;
+      ofs += capacity * sizeof(uint32_t);
+    }
+    ofs = AlignMinipage(ofs);
+    value_offset_[i] = ofs;
+    ofs += capacity * value_width_[i];
+  }
+  return ofs;
+}
+
+void PaxPage::Init(page_id_t page_id, page_id_t prev_id, [[maybe_unused]] LogManager *log_mgr,
+                   [[maybe_unused]] Transaction *txn) {
+  memset(GetData(), 0, PAGE_SIZE);
+  memcpy(GetData(), &page_id, sizeof(page_id));
+  SetPrevPageId(prev_id);
+  SetNextPageId(INVALID_PAGE_ID);
+  SetSlotCount(0);
+  SetUsedCount(0);
+}
+
+bool PaxPage::InsertTuple(Row &row, const PaxLayout &layout, [[maybe_unused]] Transaction *txn,
+                          [[maybe_unused]] LockManager *lock_manager, [[maybe_unused]] LogManager *log_manager) {
+  ASSERT(layout.Fits(row), "Row does not fit into the pax layout.");
+  if (GetUsedCount() >= layout.GetSlotCapacity()) {
+    return false;
+  }
+  // reuse a free slot below the high-water mark first
+  uint32_t i;
+  for (i = 0; i < GetSlotCount(); i++) {
+    if (GetSlotState(i) == SLOT_FREE) {
+      break;
+    }
+  }
+  WriteSlot(i, row, layout);
+  SetSlotState(i, SLOT_LIVE);
+  SetUsedCount(GetUsedCount() + 1);
+  if (i == GetSlotCount()) {
+    SetSlotCount(GetSlotCount() + 1);
+  }
+  row.SetRowId(RowId(GetTablePageId(), i));
+  return true;
+}
+
+bool PaxPage::MarkDelete(const RowId &rid, [[maybe_unused]] Transaction *txn,
+                         [[maybe_unused]] LockManager *lock_manager, [[maybe_unused]] LogManager *log_manager) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetSlotCount() || GetSlotState(slot_num) != SLOT_LIVE) {
+    return false;
+  }
+  SetSlotState(slot_num, SLOT_DELETED);
+  return true;
+}
+
+bool PaxPage::UpdateTuple(const Row &new_row, Row *old_row, const PaxLayout &layout,
+                          [[maybe_unused]] Transaction *txn, [[maybe_unused]] LockManager *lock_manager,
+                          [[maybe_unused]] LogManager *log_manager) {
+  ASSERT(old_row != nullptr && old_row->GetRowId().Get() != INVALID_ROWID.Get(), "Invalid row.");
+  uint32_t slot_num = old_row->GetRowId().GetSlotNum();
+  if (slot_num >= GetSlotCount() || GetSlotState(slot_num) != SLOT_LIVE || !layout.Fits(new_row)) {
+    return false;
+  }
+  TupleView(GetData(), &layout, old_row->GetRowId()).Materialize(old_row);
+  WriteSlot(slot_num, new_row, layout);
+  return true;
+}
+
+void PaxPage::ApplyDelete(const RowId &rid, [[maybe_unused]] Transaction *txn,
+                          [[maybe_unused]] LogManager *log_manager) {
+  uint32_t slot_num = rid.GetSlotNum();
+  ASSERT(slot_num < GetSlotCount(), "Cannot have more slots than tuples.");
+  if (GetSlotState(slot_num) == SLOT_FREE) {
+    return;
+  }
+  SetSlotState(slot_num, SLOT_FREE);
+  SetUsedCount(GetUsedCount() - 1);
+  uint32_t slot_count = GetSlotCount();
+  while (slot_count > 0 && GetSlotState(slot_count - 1) == SLOT_FREE) {
+    slot_count--;
+  }
+  SetSlotCount(slot_count);
+}
+
+void PaxPage::RollbackDelete(const RowId &rid, [[maybe_unused]] Transaction *txn,
+                             [[maybe_unused]] LogManager *log_manager) {
+  uint32_t slot_num = rid.GetSlotNum();
+  ASSERT(slot_num < GetSlotCount(), "We can't have more slots than tuples.");
+  if (GetSlotState(slot_num) == SLOT_DELETED) {
+    SetSlotState(slot_num, SLOT_LIVE);
+  }
+}
+
+void PaxPage::Vacuum(Transaction *txn, LogManager *log_manager) {
+  for (uint32_t i = GetSlotCount(); i > 0; i--) {
+    if (GetSlotState(i - 1) == SLOT_DELETED) {
+      ApplyDelete(RowId(GetTablePageId(), i - 1), txn, log_manager);
+    }
+  }
+}
+
+bool PaxPage::GetTuple(Row *row, const PaxLayout &layout, [[maybe_unused]] Transaction *txn,
+                       [[maybe_unused]] LockManager *lock_manager) {
+  ASSERT(row != nullptr && row->GetRowId().Get() != INVALID_ROWID.Get(), "Invalid row.");
+  TupleView view;
+  if (!GetTupleView(row->GetRowId(), layout, &view)) {
+    return false;
+  }
+  view.Materialize(row);
+  return true;
+}
+
+bool PaxPage::GetTupleView(const RowId &rid, const PaxLayout &layout, TupleView *view) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetSlotCount() || GetSlotState(slot_num) != SLOT_LIVE) {
+    return false;
+  }
+  *view = TupleView(GetData(), &layout, rid);
+  return true;
+}
+
+uint32_t PaxPage::GetTupleViews(const PaxLayout &layout, std::vector<TupleView> &views) {
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < GetSlotCount(); i++) {
+    if (GetSlotState(i) == SLOT_LIVE) {
+      views.emplace_back(GetData(), &layout, RowId(GetTablePageId(), i));
+      count++;
+    }
+  }
+  return count;
+}
+
+bool PaxPage::GetFirstTupleRid(RowId *first_rid) {
+  for (uint32_t i = 0; i < GetSlotCount(); i++) {
+    if (GetSlotState(i) == SLOT_LIVE) {
+      first_rid->Set(GetTablePageId(), i);
+      return true;
+    }
+  }
+  first_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+bool PaxPage::GetNextTupleRid(const RowId &cur_rid, RowId *next_rid) {
+  ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
+  for (auto i = cur_rid.GetSlotNum() + 1; i < GetSlotCount(); i++) {
+    if (GetSlotState(i) == SLOT_LIVE) {
+      next_rid->Set(GetTablePageId(), i);
+      return true;
+    }
+  }
+  next_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+void PaxPage::WriteSlot(uint32_t slot_num, const Row &row, const PaxLayout &layout) {
+  for (uint32_t i = 0; i < layout.GetColumnCount(); i++) {
+    const Field *field = row.GetField(i);
+    layout.SetNull(GetData(), i, slot_num, field->IsNull());
+    char *value = layout.GetValue(GetData(), i, slot_num);
+    ColumnDictionary *dictionary = layout.GetSchema()->GetDictionary(i);
+    if (dictionary != nullptr) {
+      uint16_t code = 0;
+      if (!field->IsNull()) {
+        code = dictionary->Lookup(field->GetData(), field->GetLength());
+        ASSERT(code != ColumnDictionary::INVALID_CODE, "Value is not in the column dictionary.");
+      }
+      MACH_WRITE_TO(uint16_t, value, code);
+    } else if (field->GetTypeId() == TypeId::kTypeChar) {
+      uint32_t length = field->IsNull() ? 0 : field->GetLength();
+      layout.SetCharLength(GetData(), i, slot_num, length);
+      if (length > 0) {
+        memcpy(value, field->GetData(), length);
+      }
+    } else if (!field->IsNull()) {
+      field->SerializeTo(value);
+    }
+  }
+}
@@ -146,6 +146,21 @@ void TablePage::RollbackDelete(const RowId &rid, Transaction *txn, LogManager *l
   }
 }
 
+void TablePage::Vacuum(Transaction *txn, LogManager *log_manager) {
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    uint32_t tuple_size = GetTupleSize(i);
+    // Only tuples carrying the delete flag still hold bytes, empty slots have nothing to reclaim.
+    if (tuple_size != 0 && IsDeleted(tuple_size)) {
+      ApplyDelete(RowId(GetTablePageId(), i), txn, log_manager);
+    }
+  }
+  uint32_t tuple_count = GetTupleCount();
+  while (tuple_count > 0 && GetTupleSize(tuple_count - 1) == 0) {
+    tuple_count--;
+  }
+  SetTupleCount(tuple_count);
+}
+
 bool TablePage::GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager *lock_manager) {
   ASSERT(row != nullptr && row->GetRowId().Get() != INVALID_ROWID.Get(), "Invalid row.");
   // Get the current slot number.
@@ -167,6 +182,26 @@ bool TablePage::GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager
   return true;
 }
 
+bool TablePage::GetTupleView(const RowId &rid, Schema *schema, TupleView *view) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount() || IsDeleted(GetTupleSize(slot_num))) {
+    return false;
+  }
+  *view = TupleView(GetData() + GetTupleOffsetAtSlot(slot_num), schema, rid);
+  return true;
+}
+
+uint32_t TablePage::GetTupleViews(Schema *schema, std::vector<TupleView> &views) {
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    if (!IsDeleted(GetTupleSize(i))) {
+      views.emplace_back(GetData() + GetTupleOffsetAtSlot(i), schema, RowId(GetTablePageId(), i));
+      count++;
+    }
+  }
+  return count;
+}
+
 bool TablePage::GetFirstTupleRid(RowId *first_rid) {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); i++) {
@@ -374,8 +374,8 @@ static void yy_fatal_error (yyconst char msg[]  );
 	*yy_cp = '\0'; \
 	(yy_c_buf_p) = yy_cp;
 
-#define YY_NUM_RULES 56
-#define YY_END_OF_BUFFER 57
+#define YY_NUM_RULES 58
+#define YY_END_OF_BUFFER 59
 /* This struct is not used in this scanner,
    but its presence is necessary. */
 struct yy_trans_info
@@ -383,27 +383,28 @@ struct yy_trans_info
 	flex_int32_t yy_verify;
 	flex_int32_t yy_nxt;
 	};
-static yyconst flex_int16_t yy_accept[175] =
+static yyconst flex_int16_t yy_accept[183] =
     {   0,
-       41,   41,   57,   55,   54,   54,   55,   49,   52,   53,
-       47,   46,   41,   55,   41,   48,   50,   42,   51,   39,
-       39,   39,   39,   39,   39,   39,   39,   39,   39,   39,
-       39,   39,   39,   39,   39,   39,   39,   39,    0,    1,
-        0,    0,   41,   40,   44,   43,   45,   39,   39,   39,
-       39,   39,   39,   39,   39,   39,   39,   39,   39,   39,
-       37,   39,   39,   39,   22,   35,   39,   39,   39,   39,
-       39,   39,   39,   39,   39,   39,   39,   34,   39,   39,
-       39,   39,   39,   39,   39,   39,   39,   39,   39,   39,
-       32,   29,   36,   39,   39,   39,   39,   39,   26,   39,
-
-       39,   39,   39,   14,   39,   39,   39,   39,   31,   39,
-       39,   39,   39,    3,   39,   39,   23,   39,   39,   25,
-       38,   39,   11,   39,   39,   13,   39,   39,   39,   39,
-       39,   39,    8,   39,   39,   39,   39,   39,   33,   20,
-       39,   39,   39,   39,   18,   39,   39,   15,   39,   24,
-        9,    2,   39,    6,   39,   39,    5,   39,   39,    4,
-       19,   30,    7,   27,   39,   39,   21,   28,   39,   16,
-       12,   10,   17,    0
+       43,   43,   59,   57,   56,   56,   57,   51,   54,   55,
+       49,   48,   43,   57,   50,   52,   44,   53,   41,   41,
+       41,   41,   41,   41,   41,   41,   41,   41,   41,   41,
+       41,   41,   41,   41,   41,   41,   41,    0,    1,    0,
+        0,   43,   42,   46,   45,   47,   41,   41,   41,   41,
+       41,   41,   41,   41,   41,   41,   41,   41,   41,   39,
+       41,   41,   41,   23,   37,   41,   41,   41,   41,   41,
+       41,   41,   41,   41,   41,   41,   36,   41,   41,   41,
+       41,   41,   41,   41,   41,   41,   41,   41,   41,   41,
+       34,   30,   38,   41,   41,   41,   41,   41,   27,   41,
+
+       41,   41,   41,   15,   41,   41,   41,   41,   41,   33,
+       41,   41,   41,   41,    3,   41,   41,   24,   41,   41,
+       41,   26,   40,   41,   11,   41,   41,   14,   41,   41,
+       41,   41,   41,   41,   41,    8,   41,   41,   41,   41,
+       41,   35,   41,   21,   41,   41,   41,   41,   19,   41,
+       41,   16,   41,   41,   25,    9,    2,   41,    6,   41,
+       41,   41,    5,   41,   41,    4,   20,   31,    7,   13,
+       28,   41,   41,   32,   22,   29,   41,   17,   12,   10,
+       18,    0
     } ;
 
 static yyconst flex_int32_t yy_ec[256] =
@@ -441,124 +442,138 @@ static yyconst flex_int32_t yy_ec[256] =
 static yyconst flex_int32_t yy_meta[43] =
     {   0,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    2,    1,    1,    1,    1,    2,    1,    2,    2,
-        2,    2,    2,    2,    2,    2,    2,    2,    2,    2,
-        2,    2,    2,    2,    2,    2,    2,    2,    2,    2,
-        2,    2
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1
     } ;
 
-static yyconst flex_int16_t yy_base[177] =
+static yyconst flex_int16_t yy_base[183] =
     {   0,
-        0,    0,  188,  189,  189,  189,   39,  189,  189,  189,
-      189,  189,   33,  175,   35,  189,   33,  189,  171,    0,
-      154,  161,   24,   32,  142,   23,   29,  159,   30,   35,
-      146,  142,  147,   38,  159,   38,  158,  150,   59,  189,
-      172,  162,   42,  161,  189,  189,  189,    0,  150,  146,
-      151,  139,  145,  130,  137,  133,  141,  131,  130,   50,
-        0,  119,  123,  130,    0,    0,  131,  130,  127,   44,
-      123,  134,  126,  130,   52,  122,  127,    0,  122,  113,
-      117,  127,  126,  121,  110,  121,  122,  110,  116,  115,
-      105,    0,    0,  107,  105,   97,  104,  109,    0,   91,
-
-      101,   95,  109,    0,   96,   88,   90,   93,    0,   96,
-       85,  101,   83,    0,   95,   81,    0,   76,   81,    0,
-        0,   96,    0,   94,   92,    0,   89,   73,   73,   84,
-       85,   84,    0,   69,   82,   85,   80,   75,    0,   78,
-       63,   64,   79,   60,   60,   72,   71,    0,   57,    0,
-        0,    0,   56,    0,   62,   54,    0,   43,   63,    0,
-        0,    0,    0,    0,   60,   59,    0,    0,   52,   42,
-        0,    0,    0,  189,   87,   74
+        0,    0,   43,  255,  255,  255,   43,  255,  255,  255,
+      255,  255,   75,   76,  255,   74,  255,   76,   80,   62,
+       71,   97,  105,   54,   96,   99,   73,   95,  103,   63,
+       88,  104,  116,  118,  110,  125,  119,    0,  255,  144,
+        0,    0,    0,  255,  255,  255,    0,  127,  125,  132,
+      122,  130,  117,  126,  124,  134,  126,  127,  139,    0,
+      121,  127,  136,    0,    0,  139,  140,  139,  140,  138,
+      151,  145,  151,  151,  158,  157,    0,  154,  147,  153,
+      165,  166,  163,  155,  168,  171,  161,  163,  170,  171,
+      163,    0,    0,  167,  167,  161,  170,  177,    0,  161,
+
+      173,  169,  185,    0,  174,  168,  169,  173,  178,    0,
+      183,  174,  192,  176,    0,  190,  178,    0,  178,  176,
+      183,    0,    0,  200,    0,  200,  200,    0,  199,  185,
+      187,  200,  188,  204,  205,    0,  192,  207,  212,  209,
+      206,    0,  212,  212,  199,  202,  219,  202,  204,  218,
+      219,    0,  213,  208,    0,    0,    0,  209,    0,  217,
+      224,  212,    0,  207,  229,    0,    0,    0,    0,    0,
+        0,  228,  229,    0,    0,    0,  225,  218,    0,    0,
+        0,  255
     } ;
 
-static yyconst flex_int16_t yy_def[177] =
+static yyconst flex_int16_t yy_def[183] =
     {   0,
-      174,    1,  174,  174,  174,  174,  175,  174,  174,  174,
-      174,  174,  174,  174,  174,  174,  174,  174,  174,  176,
-      176,  176,  176,  176,  176,  176,  176,  176,  176,  176,
-      176,  176,  176,  176,  176,  176,  176,  176,  175,  174,
-      175,  174,  174,  174,  174,  174,  174,  176,  176,  176,
-      176,  176,  176,  176,  176,  176,  176,  176,  176,  176,
-      176,  176,  176,  176,  176,  176,  176,  176,  176,  176,
-      176,  176,  176,  176,  176,  176,  176,  176,  176,  176,
-      176,  176,  176,  176,  176,  176,  176,  176,  176,  176,
-      176,  176,  176,  176,  176,  176,  176,  176,  176,  176,
-
-      176,  176,  176,  176,  176,  176,  176,  176,  176,  176,
-      176,  176,  176,  176,  176,  176,  176,  176,  176,  176,
-      176,  176,  176,  176,  176,  176,  176,  176,  176,  176,
-      176,  176,  176,  176,  176,  176,  176,  176,  176,  176,
-      176,  176,  176,  176,  176,  176,  176,  176,  176,  176,
-      176,  176,  176,  176,  176,  176,  176,  176,  176,  176,
-      176,  176,  176,  176,  176,  176,  176,  176,  176,  176,
-      176,  176,  176,    0,  174,  174
+      182,    1,  182,  182,  182,  182,  182,  182,  182,  182,
+      182,  182,  182,  182,  182,  182,  182,  182,  182,   19,
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+       19,   19,   19,   19,   19,   19,   19,    7,  182,    7,
+       14,   13,   14,  182,  182,  182,   19,   19,   19,   19,
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+       19,    0
     } ;
 
-static yyconst flex_int16_t yy_nxt[232] =
+static yyconst flex_int16_t yy_nxt[298] =
     {   0,
         4,    5,    6,    7,    8,    9,   10,   11,   12,   13,
-       14,   15,   16,   17,   18,   19,   20,    4,   21,   22,
-       23,   24,   25,   26,   20,   20,   27,   28,   20,   20,
-       29,   30,   31,   32,   33,   34,   35,   36,   37,   38,
-       20,   20,   40,   42,   43,   42,   43,   45,   46,   51,
-       54,   58,   42,   43,   55,   52,   41,   59,   53,   60,
-       70,   63,   40,   71,   61,   65,   56,   64,   73,   66,
-       74,   89,   98,   75,  104,   48,   41,  173,  105,  172,
-       99,  171,  170,  169,  168,   90,   91,   39,   39,  167,
-      166,  165,  164,  163,  162,  161,  160,  159,  158,  157,
-
-      156,  155,  154,  153,  152,  151,  150,  149,  148,  147,
-      146,  145,  144,  143,  142,  141,  140,  139,  138,  137,
-      136,  135,  134,  133,  132,  131,  130,  129,  128,  127,
-      126,  125,  124,  123,  122,  121,  120,  119,  118,  117,
-      116,  115,  114,  113,  112,  111,  110,  109,  108,  107,
-      106,  103,  102,  101,  100,   97,   96,   95,   94,   93,
-       92,   88,   87,   86,   85,   84,   83,   82,   81,   80,
-       79,   78,   44,   44,  174,   77,   76,   72,   69,   68,
-       67,   62,   57,   50,   49,   47,   44,  174,    3,  174,
-      174,  174,  174,  174,  174,  174,  174,  174,  174,  174,
-
-      174,  174,  174,  174,  174,  174,  174,  174,  174,  174,
-      174,  174,  174,  174,  174,  174,  174,  174,  174,  174,
-      174,  174,  174,  174,  174,  174,  174,  174,  174,  174,
-      174
+       14,   13,   15,   16,   17,   18,   19,    4,   20,   21,
+       22,   23,   24,   25,   19,   19,   26,   27,   19,   19,
+       28,   29,   30,   31,   32,   33,   34,   35,   36,   37,
+       19,   19,  182,   38,   38,   38,   39,   38,   38,   38,
+       38,   38,   38,   38,   38,   38,   38,   38,   38,   38,
+       40,   38,   38,   38,   38,   38,   38,   38,   38,   38,
+       38,   38,   38,   38,   38,   38,   38,   38,   38,   38,
+       38,   38,   38,   38,   38,   41,   42,   43,   44,   45,
+       46,   47,   48,   49,   56,   61,   47,   66,   47,   47,
+
+       47,   47,   47,   47,   47,   47,   47,   47,   47,   47,
+       47,   47,   47,   47,   47,   47,   47,   47,   47,   47,
+       47,   47,   50,   53,   57,   67,   62,   54,   51,   59,
+       58,   52,   63,   64,   60,   68,   71,   65,   69,   55,
+       72,   70,   73,   75,   76,   74,  182,   38,   77,   78,
+       79,   80,   81,   82,   83,   84,   85,   86,   87,   88,
+       89,   38,   92,   93,   94,   95,   96,   97,   98,  100,
+      101,  102,  103,  104,   90,   91,   99,  105,  106,  108,
+      109,  110,  111,  112,  113,  114,  107,  115,  116,  117,
+      118,  119,  120,  121,  122,  123,  124,  125,  126,  127,
+
+      128,  129,  130,  131,  132,  133,  134,  135,  136,  137,
+      138,  139,  140,  141,  142,  143,  144,  145,  146,  147,
+      148,  149,  150,  151,  152,  153,  154,  155,  156,  157,
+      158,  159,  160,  161,  162,  163,  164,  165,  166,  167,
+      168,  169,  170,  171,  172,  173,  174,  175,  176,  177,
+      178,  179,  180,  181,    3,  182,  182,  182,  182,  182,
+      182,  182,  182,  182,  182,  182,  182,  182,  182,  182,
+      182,  182,  182,  182,  182,  182,  182,  182,  182,  182,
+      182,  182,  182,  182,  182,  182,  182,  182,  182,  182,
+      182,  182,  182,  182,  182,  182,  182
     } ;
 
-static yyconst flex_int16_t yy_chk[232] =
+static yyconst flex_int16_t yy_chk[298] =
     {   0,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    7,   13,   13,   15,   15,   17,   17,   23,
-       24,   26,   43,   43,   24,   23,    7,   26,   23,   27,
-       34,   29,   39,   34,   27,   30,   24,   29,   36,   30,
-       36,   60,   70,   36,   75,  176,   39,  170,   75,  169,
-       70,  166,  165,  159,  158,   60,   60,  175,  175,  156,
-      155,  153,  149,  147,  146,  145,  144,  143,  142,  141,
-
-      140,  138,  137,  136,  135,  134,  132,  131,  130,  129,
-      128,  127,  125,  124,  122,  119,  118,  116,  115,  113,
-      112,  111,  110,  108,  107,  106,  105,  103,  102,  101,
-      100,   98,   97,   96,   95,   94,   91,   90,   89,   88,
-       87,   86,   85,   84,   83,   82,   81,   80,   79,   77,
-       76,   74,   73,   72,   71,   69,   68,   67,   64,   63,
-       62,   59,   58,   57,   56,   55,   54,   53,   52,   51,
-       50,   49,   44,   42,   41,   38,   37,   35,   33,   32,
-       31,   28,   25,   22,   21,   19,   14,    3,  174,  174,
-      174,  174,  174,  174,  174,  174,  174,  174,  174,  174,
-
-      174,  174,  174,  174,  174,  174,  174,  174,  174,  174,
-      174,  174,  174,  174,  174,  174,  174,  174,  174,  174,
-      174,  174,  174,  174,  174,  174,  174,  174,  174,  174,
-      174
+        1,    1,    3,    7,    7,    7,    7,    7,    7,    7,
+        7,    7,    7,    7,    7,    7,    7,    7,    7,    7,
+        7,    7,    7,    7,    7,    7,    7,    7,    7,    7,
+        7,    7,    7,    7,    7,    7,    7,    7,    7,    7,
+        7,    7,    7,    7,    7,   13,   13,   14,   16,   16,
+       18,   19,   20,   21,   24,   27,   19,   30,   19,   19,
+
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+       19,   19,   22,   23,   25,   31,   28,   23,   22,   26,
+       25,   22,   28,   29,   26,   32,   34,   29,   33,   23,
+       35,   33,   35,   36,   37,   35,   40,   40,   48,   49,
+       50,   51,   52,   53,   54,   55,   56,   57,   58,   59,
+       59,   40,   61,   62,   63,   66,   67,   68,   69,   70,
+       71,   72,   73,   74,   59,   59,   69,   74,   75,   76,
+       78,   79,   80,   81,   82,   83,   75,   84,   85,   86,
+       87,   88,   89,   90,   91,   94,   95,   96,   97,   98,
+
+      100,  101,  102,  103,  105,  106,  107,  108,  109,  111,
+      112,  113,  114,  116,  117,  119,  120,  121,  124,  126,
+      127,  129,  130,  131,  132,  133,  134,  135,  137,  138,
+      139,  140,  141,  143,  144,  145,  146,  147,  148,  149,
+      150,  151,  153,  154,  158,  160,  161,  162,  164,  165,
+      172,  173,  177,  178,  182,  182,  182,  182,  182,  182,
+      182,  182,  182,  182,  182,  182,  182,  182,  182,  182,
+      182,  182,  182,  182,  182,  182,  182,  182,  182,  182,
+      182,  182,  182,  182,  182,  182,  182,  182,  182,  182,
+      182,  182,  182,  182,  182,  182,  182
     } ;
 
 /* Table of booleans, true if rule could match eol. */
-static yyconst flex_int32_t yy_rule_can_match_eol[57] =
+static yyconst flex_int32_t yy_rule_can_match_eol[59] =
     {   0,
 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0,     };
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0,     };
 
 static yy_state_type yy_last_accepting_state;
 static char *yy_last_accepting_cpos;
@@ -574,14 +589,14 @@ int yy_flex_debug = 0;
 #define YY_MORE_ADJ 0
 #define YY_RESTORE_YY_MORE_OFFSET
 char *yytext;
-#line 1 "minisql.l"
 #line 2 "minisql.l"
+#line 3 "minisql.l"
     #include <stdio.h>
     #include "parser/parser.h"
     #include "parser/minisql_yacc.h"
     int yywrap();
     extern YYSTYPE yylval;
-#line 585 "../../parser/minisql_lex.c"
+#line 600 "../../parser/minisql_lex.c"
 
 #define INITIAL 0
 
@@ -763,10 +778,10 @@ YY_DECL
 	register char *yy_cp, *yy_bp;
 	register int yy_act;
     
-#line 15 "minisql.l"
+#line 16 "minisql.l"
 
 
-#line 770 "../../parser/minisql_lex.c"
+#line 785 "../../parser/minisql_lex.c"
 
 	if ( !(yy_init) )
 		{
@@ -819,13 +834,13 @@ yy_match:
 			while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 				{
 				yy_current_state = (int) yy_def[yy_current_state];
-				if ( yy_current_state >= 175 )
+				if ( yy_current_state >= 183 )
 					yy_c = yy_meta[(unsigned int) yy_c];
 				}
 			yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
 			++yy_cp;
 			}
-		while ( yy_base[yy_current_state] != 189 );
+		while ( yy_base[yy_current_state] != 255 );
 
 yy_find_action:
 		yy_act = yy_accept[yy_current_state];
@@ -962,7 +977,7 @@ YY_RULE_SETUP
 #line 78 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return SHOW;
+  return VACUUM;
 }
 	YY_BREAK
 case 14:
@@ -970,7 +985,7 @@ YY_RULE_SETUP
 #line 83 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return USE;
+  return SHOW;
 }
 	YY_BREAK
 case 15:
@@ -978,7 +993,7 @@ YY_RULE_SETUP
 #line 88 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return USING;
+  return USE;
 }
 	YY_BREAK
 case 16:
@@ -986,7 +1001,7 @@ YY_RULE_SETUP
 #line 93 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return DATABASE;
+  return USING;
 }
 	YY_BREAK
 case 17:
@@ -994,7 +1009,7 @@ YY_RULE_SETUP
 #line 98 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return DATABASES;
+  return DATABASE;
 }
 	YY_BREAK
 case 18:
@@ -1002,7 +1017,7 @@ YY_RULE_SETUP
 #line 103 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return TABLE;
+  return DATABASES;
 }
 	YY_BREAK
 case 19:
@@ -1010,7 +1025,7 @@ YY_RULE_SETUP
 #line 108 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return TABLES;
+  return TABLE;
 }
 	YY_BREAK
 case 20:
@@ -1018,7 +1033,7 @@ YY_RULE_SETUP
 #line 113 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return INDEX;
+  return TABLES;
 }
 	YY_BREAK
 case 21:
@@ -1026,7 +1041,7 @@ YY_RULE_SETUP
 #line 118 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return INDEXES;
+  return INDEX;
 }
 	YY_BREAK
 case 22:
@@ -1034,7 +1049,7 @@ YY_RULE_SETUP
 #line 123 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return ON;
+  return INDEXES;
 }
 	YY_BREAK
 case 23:
@@ -1042,7 +1057,7 @@ YY_RULE_SETUP
 #line 128 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return FROM;
+  return ON;
 }
 	YY_BREAK
 case 24:
@@ -1050,7 +1065,7 @@ YY_RULE_SETUP
 #line 133 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return WHERE;
+  return FROM;
 }
 	YY_BREAK
 case 25:
@@ -1058,7 +1073,7 @@ YY_RULE_SETUP
 #line 138 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return INTO;
+  return WHERE;
 }
 	YY_BREAK
 case 26:
@@ -1066,7 +1081,7 @@ YY_RULE_SETUP
 #line 143 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return SET;
+  return INTO;
 }
 	YY_BREAK
 case 27:
@@ -1074,7 +1089,7 @@ YY_RULE_SETUP
 #line 148 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return VALUES;
+  return SET;
 }
 	YY_BREAK
 case 28:
@@ -1082,7 +1097,7 @@ YY_RULE_SETUP
 #line 153 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return PRIMARY;
+  return VALUES;
 }
 	YY_BREAK
 case 29:
@@ -1090,7 +1105,7 @@ YY_RULE_SETUP
 #line 158 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return KEY;
+  return PRIMARY;
 }
 	YY_BREAK
 case 30:
@@ -1098,7 +1113,7 @@ YY_RULE_SETUP
 #line 163 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return UNIQUE;
+  return KEY;
 }
 	YY_BREAK
 case 31:
@@ -1106,7 +1121,7 @@ YY_RULE_SETUP
 #line 168 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return CHAR;
+  return UNIQUE;
 }
 	YY_BREAK
 case 32:
@@ -1114,7 +1129,7 @@ YY_RULE_SETUP
 #line 173 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return INT;
+  return INCLUDE;
 }
 	YY_BREAK
 case 33:
@@ -1122,7 +1137,7 @@ YY_RULE_SETUP
 #line 178 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return FLOAT;
+  return CHAR;
 }
 	YY_BREAK
 case 34:
@@ -1130,7 +1145,7 @@ YY_RULE_SETUP
 #line 183 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return AND;
+  return INT;
 }
 	YY_BREAK
 case 35:
@@ -1138,7 +1153,7 @@ YY_RULE_SETUP
 #line 188 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return OR;
+  return FLOAT;
 }
 	YY_BREAK
 case 36:
@@ -1146,7 +1161,7 @@ YY_RULE_SETUP
 #line 193 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return NOT;
+  return AND;
 }
 	YY_BREAK
 case 37:
@@ -1154,7 +1169,7 @@ YY_RULE_SETUP
 #line 198 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return IS;
+  return OR;
 }
 	YY_BREAK
 case 38:
@@ -1162,7 +1177,7 @@ YY_RULE_SETUP
 #line 203 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return FLAGNULL;
+  return NOT;
 }
 	YY_BREAK
 case 39:
@@ -1170,42 +1185,42 @@ YY_RULE_SETUP
 #line 208 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  yylval.syntax_node = CreateSyntaxNode(kNodeIdentifier, yytext);
-  return IDENTIFIER;
+  return IS;
 }
 	YY_BREAK
 case 40:
 YY_RULE_SETUP
-#line 214 "minisql.l"
+#line 213 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  yylval.syntax_node = CreateSyntaxNode(kNodeNumber, yytext);
-  return NUMBER;
+  return FLAGNULL;
 }
 	YY_BREAK
 case 41:
 YY_RULE_SETUP
-#line 220 "minisql.l"
+#line 218 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  yylval.syntax_node = CreateSyntaxNode(kNodeNumber, yytext);
-  return NUMBER;
+  yylval.syntax_node = CreateSyntaxNode(kNodeIdentifier, yytext);
+  return IDENTIFIER;
 }
 	YY_BREAK
 case 42:
 YY_RULE_SETUP
-#line 226 "minisql.l"
+#line 224 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return EQ;
+  yylval.syntax_node = CreateSyntaxNode(kNodeNumber, yytext);
+  return NUMBER;
 }
 	YY_BREAK
 case 43:
 YY_RULE_SETUP
-#line 231 "minisql.l"
+#line 230 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return NE;
+  yylval.syntax_node = CreateSyntaxNode(kNodeNumber, yytext);
+  return NUMBER;
 }
 	YY_BREAK
 case 44:
@@ -1213,7 +1228,7 @@ YY_RULE_SETUP
 #line 236 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return LE;
+  return EQ;
 }
 	YY_BREAK
 case 45:
@@ -1221,7 +1236,7 @@ YY_RULE_SETUP
 #line 241 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return GE;
+  return NE;
 }
 	YY_BREAK
 case 46:
@@ -1229,7 +1244,7 @@ YY_RULE_SETUP
 #line 246 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return (',');
+  return LE;
 }
 	YY_BREAK
 case 47:
@@ -1237,7 +1252,7 @@ YY_RULE_SETUP
 #line 251 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return ('*');
+  return GE;
 }
 	YY_BREAK
 case 48:
@@ -1245,7 +1260,7 @@ YY_RULE_SETUP
 #line 256 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return (';');
+  return (',');
 }
 	YY_BREAK
 case 49:
@@ -1253,7 +1268,7 @@ YY_RULE_SETUP
 #line 261 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return ('\'');
+  return ('*');
 }
 	YY_BREAK
 case 50:
@@ -1261,7 +1276,7 @@ YY_RULE_SETUP
 #line 266 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return ('<');
+  return (';');
 }
 	YY_BREAK
 case 51:
@@ -1269,7 +1284,7 @@ YY_RULE_SETUP
 #line 271 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return ('>');
+  return ('\'');
 }
 	YY_BREAK
 case 52:
@@ -1277,7 +1292,7 @@ YY_RULE_SETUP
 #line 276 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return ('(');
+  return ('<');
 }
 	YY_BREAK
 case 53:
@@ -1285,32 +1300,48 @@ YY_RULE_SETUP
 #line 281 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
-  return (')');
+  return ('>');
 }
 	YY_BREAK
 case 54:
-/* rule 54 can match eol */
 YY_RULE_SETUP
 #line 286 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
+  return ('(');
 }
 	YY_BREAK
 case 55:
 YY_RULE_SETUP
-#line 290 "minisql.l"
+#line 291 "minisql.l"
+{
+  MinisqlParserMovePos(yylineno, yytext);
+  return (')');
+}
+	YY_BREAK
+case 56:
+/* rule 56 can match eol */
+YY_RULE_SETUP
+#line 296 "minisql.l"
+{
+  MinisqlParserMovePos(yylineno, yytext);
+}
+	YY_BREAK
+case 57:
+YY_RULE_SETUP
+#line 300 "minisql.l"
 {
   char str[128] = {0};
   sprintf(str, "Unrecognized token [%s] in input sql.", yytext);
   MinisqlParserSetError(str);
 }
 	YY_BREAK
-case 56:
+case 58:
 YY_RULE_SETUP
-#line 296 "minisql.l"
+#line 306 "minisql.l"
 ECHO;
 	YY_BREAK
-#line 1314 "../../parser/minisql_lex.c"
+#line 1345 "../../parser/minisql_lex.c"
 case YY_STATE_EOF(INITIAL):
 	yyterminate();
 
@@ -1602,7 +1633,7 @@ static int yy_get_next_buffer (void)
 		while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 			{
 			yy_current_state = (int) yy_def[yy_current_state];
-			if ( yy_current_state >= 175 )
+			if ( yy_current_state >= 183 )
 				yy_c = yy_meta[(unsigned int) yy_c];
 			}
 		yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
@@ -1630,11 +1661,11 @@ static int yy_get_next_buffer (void)
 	while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 		{
 		yy_current_state = (int) yy_def[yy_current_state];
-		if ( yy_current_state >= 175 )
+		if ( yy_current_state >= 183 )
 			yy_c = yy_meta[(unsigned int) yy_c];
 		}
 	yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
-	yy_is_jam = (yy_current_state == 174);
+	yy_is_jam = (yy_current_state == 182);
 
 	return yy_is_jam ? 0 : yy_current_state;
 }
@@ -2319,7 +2350,7 @@ void yyfree (void * ptr )
 
 #define YYTABLES_NAME "yytables"
 
-#line 296 "minisql.l"
+#line 306 "minisql.l"
 
 
 int yywrap() {
@@ -169,6 +169,14 @@ const char *GetSyntaxNodeTypeStr(SyntaxNodeType type) {
       return "kNodeTrxCommit";
     case kNodeTrxRollback:
       return "kNodeTrxRollback";
+    case kNodeVacuum:
+      return "kNodeVacuum";
+    case kNodeSetVariable:
+      return "kNodeSetVariable";
+    case kNodeTableLayout:
+      return "kNodeTableLayout";
+    case kNodeColumnOption:
+      return "kNodeColumnOption";
     default:
       return "error type";
   }
@@ -3,6 +3,9 @@
 //
 #include <algorithm>
 #include "planner/planner.h"
+#include "planner/expressions/comparison_expression.h"
+#include "planner/expressions/logic_expression.h"
+#include "record/column_dictionary.h"
 
 void Planner::PlanQuery(pSyntaxNode ast) {
   switch (ast->type_) {
@@ -37,23 +40,40 @@ void Planner::PlanQuery(pSyntaxNode ast) {
 AbstractPlanNodeRef Planner::PlanSelect(std::shared_ptr<SelectStatement> statement) {
   auto out_schema = MakeOutputSchema(statement->column_list_);
   vector<IndexInfo *> indexes;
+  vector<IndexInfo *> leading_index;
   vector<IndexInfo *> available_index;
   context_->GetCatalog()->GetTableIndexes(statement->table_name_, indexes);
   for (auto index : indexes) {
-    if (index->GetIndexKeySchema()->GetColumns().size() == 1) {
-      auto col_id = index->GetIndexKeySchema()->GetColumn(0)->GetTableInd();
-      if (std::find(statement->column_in_condition_.begin(), statement->column_in_condition_.end(), col_id) !=
-          statement->column_in_condition_.end()) {
+    // an index is only read through a prefix of its key columns, its first column has to be in the condition
+    auto col_id = index->GetIndexKeySchema()->GetColumn(0)->GetTableInd();
+    if (std::find(statement->column_in_condition_.begin(), statement->column_in_condition_.end(), col_id) !=
+        statement->column_in_condition_.end()) {
+      leading_index.push_back(index);
+      if (index->GetIndexKeySchema()->GetColumns().size() == 1) {
         available_index.push_back(index);
       }
     }
   }
-  if (available_index.empty() || statement->has_or) {
-    return make_shared<SeqScanPlanNode>(out_schema, statement->table_name_, statement->where_);
+  if (!leading_index.empty() && !statement->has_or) {
+    bool complete = false;
+    auto range = PlanIndexRange(statement->where_, leading_index, &complete);
+    if (range.index_ != nullptr || !available_index.empty()) {
+      bool need_filter = range.index_ != nullptr ? !complete
+                                                 : available_index.size() != statement->column_in_condition_.size();
+      // the predicate is only read by the filter, a range deciding it needs none of its columns
+      bool index_only = range.index_ != nullptr &&
+                        IndexCovers(range.index_, NeededColumns(out_schema, need_filter ? statement->where_ : nullptr));
+      return make_shared<IndexScanPlanNode>(out_schema, statement->table_name_, available_index, need_filter,
+                                            statement->where_, NeededColumns(out_schema, statement->where_),
+                                            std::move(range), index_only);
+    }
   }
-  return make_shared<IndexScanPlanNode>(out_schema, statement->table_name_, available_index,
-                                        available_index.size() != statement->column_in_condition_.size(),
-                                        statement->where_);
+  TableInfo *info = nullptr;
+  context_->GetCatalog()->GetTable(statement->table_name_, info);
+  std::vector<DictionaryFilter> filters;
+  auto predicate = ExtractDictionaryFilters(info->GetSchema(), statement->where_, &filters);
+  return make_shared<SeqScanPlanNode>(out_schema, statement->table_name_, predicate,
+                                      NeededColumns(out_schema, predicate), std::move(filters));
 }
 
 AbstractPlanNodeRef Planner::PlanInsert(std::shared_ptr<InsertStatement> statement) {
@@ -64,14 +84,20 @@ AbstractPlanNodeRef Planner::PlanInsert(std::shared_ptr<InsertStatement> stateme
 AbstractPlanNodeRef Planner::PlanDelete(std::shared_ptr<DeleteStatement> statement) {
   TableInfo *info = nullptr;
   context_->GetCatalog()->GetTable(statement->table_name_, info);
-  auto scan_plan = make_shared<SeqScanPlanNode>(info->GetSchema(), statement->table_name_, statement->where_);
+  std::vector<DictionaryFilter> filters;
+  auto predicate = ExtractDictionaryFilters(info->GetSchema(), statement->where_, &filters);
+  auto scan_plan = make_shared<SeqScanPlanNode>(info->GetSchema(), statement->table_name_, predicate,
+                                                std::vector<uint32_t>{}, std::move(filters));
   return std::make_shared<DeletePlanNode>(info->GetSchema(), scan_plan, statement->table_name_);
 }
 
 AbstractPlanNodeRef Planner::PlanUpdate(std::shared_ptr<UpdateStatement> statement) {
   TableInfo *info = nullptr;
   context_->GetCatalog()->GetTable(statement->table_name_, info);
-  auto scan_plan = make_shared<SeqScanPlanNode>(info->GetSchema(), statement->table_name_, statement->where_);
+  std::vector<DictionaryFilter> filters;
+  auto predicate = ExtractDictionaryFilters(info->GetSchema(), statement->where_, &filters);
+  auto scan_plan = make_shared<SeqScanPlanNode>(info->GetSchema(), statement->table_name_, predicate,
+                                                std::vector<uint32_t>{}, std::move(filters));
   return std::make_shared<UpdatePlanNode>(info->GetSchema(), scan_plan, statement->table_name_,
                                           statement->update_attrs);
 }
@@ -90,3 +116,201 @@ Schema *Planner::MakeOutputSchema(const vector<std::pair<std::string, AbstractEx
   }
   return new Schema(cols);
 }
+
+std::vector<uint32_t> Planner::NeededColumns(const Schema *out_schema, const AbstractExpressionRef &predicate) {
+  std::vector<uint32_t> columns;
+  for (auto column : out_schema->GetColumns()) {
+    columns.push_back(column->GetTableInd());
+  }
+  std::vector<AbstractExpressionRef> stack;
+  if (predicate != nullptr) {
+    stack.push_back(predicate);
+  }
+  while (!stack.empty()) {
+    auto expr = stack.back();
+    stack.pop_back();
+    if (expr->GetType() == ExpressionType::ColumnExpression) {
+      columns.push_back(dynamic_pointer_cast<ColumnValueExpression>(expr)->GetColIdx());
+    }
+    for (auto &child : expr->GetChildren()) {
+      stack.push_back(child);
+    }
+  }
+  std::sort(columns.begin(), columns.end());
+  columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+  return columns;
+}
+
+AbstractExpressionRef Planner::ExtractDictionaryFilters(const Schema *table_schema,
+                                                        const AbstractExpressionRef &predicate,
+                                                        std::vector<DictionaryFilter> *filters) {
+  if (predicate == nullptr) {
+    return nullptr;
+  }
+  if (predicate->GetType() == ExpressionType::LogicExpression) {
+    // only the top-level AND chain, a filter inside an OR cannot be checked on its own
+    if (dynamic_pointer_cast<LogicExpression>(predicate)->logic_type_ != LogicType::And) {
+      return predicate;
+    }
+    auto left = ExtractDictionaryFilters(table_schema, predicate->GetChildAt(0), filters);
+    auto right = ExtractDictionaryFilters(table_schema, predicate->GetChildAt(1), filters);
+    if (left == nullptr || right == nullptr) {
+      return left == nullptr ? right : left;
+    }
+    if (left == predicate->GetChildAt(0) && right == predicate->GetChildAt(1)) {
+      return predicate;
+    }
+    return make_shared<LogicExpression>(left, right, LogicType::And);
+  }
+  if (predicate->GetType() != ExpressionType::ComparisonExpression) {
+    return predicate;
+  }
+  auto &lhs = predicate->GetChildAt(0);
+  auto &rhs = predicate->GetChildAt(1);
+  std::string op = dynamic_pointer_cast<ComparisonExpression>(predicate)->GetComparisonType();
+  if ((op != "=" && op != "<>") || lhs->GetType() != ExpressionType::ColumnExpression ||
+      rhs->GetType() != ExpressionType::ConstantExpression) {
+    return predicate;
+  }
+  uint32_t column = dynamic_pointer_cast<ColumnValueExpression>(lhs)->GetColIdx();
+  const Field &constant = dynamic_pointer_cast<ConstantValueExpression>(rhs)->val_;
+  ColumnDictionary *dictionary = table_schema->GetDictionary(column);
+  if (dictionary == nullptr || constant.IsNull() || constant.GetTypeId() != TypeId::kTypeChar) {
+    return predicate;
+  }
+  filters->push_back({column, dictionary->Lookup(constant.GetData(), constant.GetLength()), op == "="});
+  return nullptr;
+}
+
+IndexScanRange Planner::PlanIndexRange(const AbstractExpressionRef &predicate, const std::vector<IndexInfo *> &indexes,
+                                       bool *complete) {
+  *complete = false;
+  // the comparisons of the top-level AND chain, an OR anywhere above a comparison leaves no range
+  std::vector<AbstractExpressionRef> conjuncts;
+  std::vector<AbstractExpressionRef> stack;
+  if (predicate != nullptr) {
+    stack.push_back(predicate);
+  }
+  while (!stack.empty()) {
+    auto expr = stack.back();
+    stack.pop_back();
+    if (expr->GetType() == ExpressionType::LogicExpression) {
+      if (dynamic_pointer_cast<LogicExpression>(expr)->logic_type_ != LogicType::And) {
+        return {};
+      }
+      stack.push_back(expr->GetChildAt(0));
+      stack.push_back(expr->GetChildAt(1));
+    } else {
+      conjuncts.push_back(expr);
+    }
+  }
+  IndexScanRange best;
+  int best_rank = 0;
+  size_t best_folded = 0;
+  for (auto index : indexes) {
+    const Schema *key_schema = index->GetIndexKeySchema();
+    IndexScanRange range;
+    range.index_ = index;
+    int rank = 0;
+    size_t folded = 0;
+    uint32_t points = 0;
+    // every leading key column fixed by an equality extends the prefix of both bounds, the column after them may
+    // bound the range on its own
+    for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+      IndexScanRange column;
+      size_t column_folded = FoldColumnBounds(conjuncts, key_schema->GetColumn(i)->GetTableInd(), &column);
+      if (column_folded == 0) {
+        break;
+      }
+      folded += column_folded;
+      bool point = !column.lower_.empty() && !column.upper_.empty() && column.lower_inclusive_ &&
+                   column.upper_inclusive_ && column.lower_[0].CompareEquals(column.upper_[0]) == CmpBool::kTrue;
+      if (point) {
+        range.lower_.push_back(column.lower_[0]);
+        range.upper_.push_back(column.upper_[0]);
+        rank += 3;
+        points++;
+        continue;
+      }
+      if (!column.lower_.empty()) {
+        range.lower_.push_back(column.lower_[0]);
+        range.lower_inclusive_ = column.lower_inclusive_;
+      }
+      if (!column.upper_.empty()) {
+        range.upper_.push_back(column.upper_[0]);
+        range.upper_inclusive_ = column.upper_inclusive_;
+      }
+      rank += static_cast<int>(!column.lower_.empty()) + static_cast<int>(!column.upper_.empty());
+      break;
+    }
+    // a hash index only looks up a full key, then it reads fewer pages than a tree of the same equalities
+    if (index->GetIndexType() == "hash") {
+      if (points != key_schema->GetColumnCount()) {
+        continue;
+      }
+      rank++;
+    }
+    if (rank > best_rank || (rank > 0 && rank == best_rank && folded > best_folded)) {
+      best = std::move(range);
+      best_rank = rank;
+      best_folded = folded;
+    }
+  }
+  *complete = best_rank > 0 && best_folded == conjuncts.size();
+  return best;
+}
+
+bool Planner::IndexCovers(IndexInfo *index, const std::vector<uint32_t> &columns) {
+  if (index->GetIndexType() != "bptree") {
+    return false;
+  }
+  const Schema *key_schema = index->GetIndexKeySchema();
+  return std::all_of(columns.begin(), columns.end(), [&](uint32_t column) {
+    for (auto key_column : key_schema->GetColumns()) {
+      if (key_column->GetTableInd() == column) {
+        return true;
+      }
+    }
+    return false;
+  });
+}
+
+size_t Planner::FoldColumnBounds(const std::vector<AbstractExpressionRef> &conjuncts, uint32_t column,
+                                 IndexScanRange *bounds) {
+  size_t folded = 0;
+  for (auto &expr : conjuncts) {
+    if (expr->GetType() != ExpressionType::ComparisonExpression) {
+      continue;
+    }
+    auto &lhs = expr->GetChildAt(0);
+    auto &rhs = expr->GetChildAt(1);
+    if (lhs->GetType() != ExpressionType::ColumnExpression || rhs->GetType() != ExpressionType::ConstantExpression ||
+        dynamic_pointer_cast<ColumnValueExpression>(lhs)->GetColIdx() != column) {
+      continue;
+    }
+    std::string op = dynamic_pointer_cast<ComparisonExpression>(expr)->GetComparisonType();
+    const Field &constant = dynamic_pointer_cast<ConstantValueExpression>(rhs)->val_;
+    if (constant.IsNull() || (op != "=" && op != "<" && op != "<=" && op != ">" && op != ">=")) {
+      continue;
+    }
+    // keep the tighter bound, of equal values the exclusive one
+    if (op != "<" && op != "<=") {
+      bool inclusive = op != ">";
+      if (bounds->lower_.empty() || constant.CompareGreaterThan(bounds->lower_[0]) == CmpBool::kTrue ||
+          (!inclusive && constant.CompareEquals(bounds->lower_[0]) == CmpBool::kTrue)) {
+        bounds->lower_.assign(1, constant);
+        bounds->lower_inclusive_ = inclusive;
+      }
+    }
+    if (op != ">" && op != ">=") {
+      bool inclusive = op != "<";
+      if (bounds->upper_.empty() || constant.CompareLessThan(bounds->upper_[0]) == CmpBool::kTrue ||
+          (!inclusive && constant.CompareEquals(bounds->upper_[0]) == CmpBool::kTrue)) {
+        bounds->upper_.assign(1, constant);
+        bounds->upper_inclusive_ = inclusive;
+      }
+    }
+    folded++;
+  }
+  return folded;
+}
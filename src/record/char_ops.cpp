@@ -0,0 +1,287 @@
+#include "record/char_ops.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CHAR_OPS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+inline uint64_t LoadWord(const char *data) {
+  uint64_t word;
+  memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+inline uint32_t LoadHalfWord(const char *data) {
+  uint32_t word;
+  memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+/**
+ * Order two different little-endian words by their first differing byte.
+ */
+inline int CompareWords(uint64_t lhs, uint64_t rhs) {
+  lhs = __builtin_bswap64(lhs);
+  rhs = __builtin_bswap64(rhs);
+  return lhs < rhs ? -1 : 1;
+}
+
+inline int CompareLengths(uint32_t lhs_len, uint32_t rhs_len) {
+  return lhs_len < rhs_len ? -1 : (lhs_len > rhs_len ? 1 : 0);
+}
+
+inline int CompareBytes(const char *lhs, const char *rhs, uint32_t len) {
+  for (uint32_t i = 0; i < len; i++) {
+    if (lhs[i] != rhs[i]) {
+      return static_cast<unsigned char>(lhs[i]) < static_cast<unsigned char>(rhs[i]) ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Compare the first len bytes eight at a time, bytes are ordered unsigned like memcmp.
+ */
+inline int CompareTail(const char *lhs, const char *rhs, uint32_t len) {
+  uint32_t i = 0;
+  for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+    uint64_t l = LoadWord(lhs + i);
+    uint64_t r = LoadWord(rhs + i);
+    if (l != r) {
+      return CompareWords(l, r);
+    }
+  }
+  return CompareBytes(lhs + i, rhs + i, len - i);
+}
+
+/**
+ * Equality of the first len (< 16) bytes with two overlapping loads.
+ */
+inline bool EqualsShort(const char *lhs, const char *rhs, uint32_t len) {
+  if (len >= sizeof(uint64_t)) {
+    uint32_t last = len - sizeof(uint64_t);
+    return ((LoadWord(lhs) ^ LoadWord(rhs)) | (LoadWord(lhs + last) ^ LoadWord(rhs + last))) == 0;
+  }
+  if (len >= sizeof(uint32_t)) {
+    uint32_t last = len - sizeof(uint32_t);
+    return ((LoadHalfWord(lhs) ^ LoadHalfWord(rhs)) | (LoadHalfWord(lhs + last) ^ LoadHalfWord(rhs + last))) == 0;
+  }
+  for (uint32_t i = 0; i < len; i++) {
+    if (lhs[i] != rhs[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/** CRC32C (Castagnoli, reflected polynomial 0x82F63B78), the checksum computed by the SSE4.2 crc32 instruction */
+struct Crc32cTable {
+  constexpr Crc32cTable() : entries_() {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t crc = i;
+      for (int bit = 0; bit < 8; bit++) {
+        crc = (crc >> 1) ^ ((crc & 1) ? 0x82F63B78u : 0);
+      }
+      entries_[i] = crc;
+    }
+  }
+
+  uint32_t entries_[256];
+};
+
+constexpr Crc32cTable kCrc32c;
+
+/**
+ * Spread the 32 bit checksum and the length over 64 bits (murmur3 finalizer).
+ */
+inline uint64_t FinishHash(uint32_t crc, uint32_t len) {
+  uint64_t h = (static_cast<uint64_t>(~crc) << 32) | len;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+int CompareScalar(const char *lhs, uint32_t lhs_len, const char *rhs, uint32_t rhs_len) {
+  int cmp = CompareTail(lhs, rhs, lhs_len < rhs_len ? lhs_len : rhs_len);
+  return cmp != 0 ? cmp : CompareLengths(lhs_len, rhs_len);
+}
+
+bool EqualsScalar(const char *lhs, const char *rhs, uint32_t len) {
+  uint32_t i = 0;
+  for (; i + 2 * sizeof(uint64_t) <= len; i += 2 * sizeof(uint64_t)) {
+    if (((LoadWord(lhs + i) ^ LoadWord(rhs + i)) | (LoadWord(lhs + i + 8) ^ LoadWord(rhs + i + 8))) != 0) {
+      return false;
+    }
+  }
+  return EqualsShort(lhs + i, rhs + i, len - i);
+}
+
+uint64_t HashScalar(const char *data, uint32_t len) {
+  uint32_t crc = ~0u;
+  for (uint32_t i = 0; i < len; i++) {
+    crc = kCrc32c.entries_[(crc ^ static_cast<unsigned char>(data[i])) & 0xff] ^ (crc >> 8);
+  }
+  return FinishHash(crc, len);
+}
+
+#ifdef CHAR_OPS_X86
+
+/**
+ * @return index of the first differing byte of two 16 byte blocks, 16 if they are equal
+ */
+__attribute__((target("sse4.2"))) inline uint32_t Mismatch16(const char *lhs, const char *rhs) {
+  __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lhs));
+  __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs));
+  uint32_t diff = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(l, r))) & 0xffffu;
+  return diff == 0 ? 16 : static_cast<uint32_t>(__builtin_ctz(diff));
+}
+
+__attribute__((target("avx2"))) inline uint32_t Mismatch32(const char *lhs, const char *rhs) {
+  __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lhs));
+  __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs));
+  uint32_t diff = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(l, r)));
+  return diff == 0 ? 32 : static_cast<uint32_t>(__builtin_ctz(diff));
+}
+
+inline int CompareAt(const char *lhs, const char *rhs, uint32_t pos) {
+  return static_cast<unsigned char>(lhs[pos]) < static_cast<unsigned char>(rhs[pos]) ? -1 : 1;
+}
+
+__attribute__((target("sse4.2"))) int CompareSse42(const char *lhs, uint32_t lhs_len, const char *rhs,
+                                                   uint32_t rhs_len) {
+  uint32_t len = lhs_len < rhs_len ? lhs_len : rhs_len;
+  uint32_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    uint32_t pos = Mismatch16(lhs + i, rhs + i);
+    if (pos != 16) {
+      return CompareAt(lhs, rhs, i + pos);
+    }
+  }
+  int cmp = CompareTail(lhs + i, rhs + i, len - i);
+  return cmp != 0 ? cmp : CompareLengths(lhs_len, rhs_len);
+}
+
+__attribute__((target("sse4.2"))) bool EqualsSse42(const char *lhs, const char *rhs, uint32_t len) {
+  if (len < 16) {
+    return EqualsShort(lhs, rhs, len);
+  }
+  for (uint32_t i = 0; i + 16 < len; i += 16) {
+    if (Mismatch16(lhs + i, rhs + i) != 16) {
+      return false;
+    }
+  }
+  return Mismatch16(lhs + len - 16, rhs + len - 16) == 16;
+}
+
+__attribute__((target("sse4.2"))) uint64_t HashSse42(const char *data, uint32_t len) {
+  uint64_t crc = ~0u;
+  uint32_t i = 0;
+  for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+    crc = _mm_crc32_u64(crc, LoadWord(data + i));
+  }
+  uint32_t crc32 = static_cast<uint32_t>(crc);
+  for (; i < len; i++) {
+    crc32 = _mm_crc32_u8(crc32, static_cast<unsigned char>(data[i]));
+  }
+  return FinishHash(crc32, len);
+}
+
+__attribute__((target("avx2"))) int CompareAvx2(const char *lhs, uint32_t lhs_len, const char *rhs, uint32_t rhs_len) {
+  uint32_t len = lhs_len < rhs_len ? lhs_len : rhs_len;
+  uint32_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    uint32_t pos = Mismatch32(lhs + i, rhs + i);
+    if (pos != 32) {
+      return CompareAt(lhs, rhs, i + pos);
+    }
+  }
+  if (i + 16 <= len) {
+    uint32_t pos = Mismatch16(lhs + i, rhs + i);
+    if (pos != 16) {
+      return CompareAt(lhs, rhs, i + pos);
+    }
+    i += 16;
+  }
+  int cmp = CompareTail(lhs + i, rhs + i, len - i);
+  return cmp != 0 ? cmp : CompareLengths(lhs_len, rhs_len);
+}
+
+__attribute__((target("avx2"))) bool EqualsAvx2(const char *lhs, const char *rhs, uint32_t len) {
+  if (len < 16) {
+    return EqualsShort(lhs, rhs, len);
+  }
+  if (len <= 32) {
+    return Mismatch16(lhs, rhs) == 16 && Mismatch16(lhs + len - 16, rhs + len - 16) == 16;
+  }
+  for (uint32_t i = 0; i + 32 < len; i += 32) {
+    if (Mismatch32(lhs + i, rhs + i) != 32) {
+      return false;
+    }
+  }
+  return Mismatch32(lhs + len - 32, rhs + len - 32) == 32;
+}
+
+#endif  // CHAR_OPS_X86
+
+}  // namespace
+
+CharOps::Impl CharOps::impl_{CharOps::Isa::kScalar, CompareScalar, EqualsScalar, HashScalar};
+
+bool CharOps::IsSupported(Isa isa) {
+  switch (isa) {
+    case Isa::kScalar:
+      return true;
+#ifdef CHAR_OPS_X86
+    case Isa::kSse42:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("sse4.2");
+    case Isa::kAvx2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("avx2");
+#endif
+    default:
+      return false;
+  }
+}
+
+CharOps::Isa CharOps::GetBestIsa() {
+  if (IsSupported(Isa::kAvx2)) {
+    return Isa::kAvx2;
+  }
+  return IsSupported(Isa::kSse42) ? Isa::kSse42 : Isa::kScalar;
+}
+
+bool CharOps::SetIsa(Isa isa) {
+  if (!IsSupported(isa)) {
+    return false;
+  }
+  impl_ = Select(isa);
+  return true;
+}
+
+CharOps::Impl CharOps::Select(Isa isa) {
+  switch (isa) {
+#ifdef CHAR_OPS_X86
+    case Isa::kSse42:
+      return {isa, CompareSse42, EqualsSse42, HashSse42};
+    case Isa::kAvx2:
+      return {isa, CompareAvx2, EqualsAvx2, HashSse42};
+#endif
+    default:
+      return {Isa::kScalar, CompareScalar, EqualsScalar, HashScalar};
+  }
+}
+
+namespace {
+
+/** bind the best kernels before main, callers running earlier use the scalar ones */
+const bool kCharOpsBound = CharOps::SetIsa(CharOps::GetBestIsa());
+
+}  // namespace
@@ -0,0 +1,53 @@
+#include "record/column_dictionary.h"
+
+uint16_t ColumnDictionary::Encode(const char *data, uint32_t len) {
+  uint16_t code = Lookup(data, len);
+  if (code != INVALID_CODE) {
+    return code;
+  }
+  if (values_.size() >= INVALID_CODE || serialized_size_ + sizeof(uint32_t) + len > max_bytes_) {
+    return INVALID_CODE;
+  }
+  Append(data, len);
+  dirty_ = true;
+  return static_cast<uint16_t>(values_.size() - 1);
+}
+
+void ColumnDictionary::Append(const char *data, uint32_t len) {
+  values_.emplace_back(data, len);
+  codes_.emplace(values_.back(), static_cast<uint16_t>(values_.size() - 1));
+  serialized_size_ += sizeof(uint32_t) + len;
+}
+
+uint32_t ColumnDictionary::SerializeTo(char *buf) const {
+  char *p = buf;
+  MACH_WRITE_UINT32(buf, DICTIONARY_MAGIC_NUM);
+  buf += 4;
+  MACH_WRITE_UINT32(buf, values_.size());
+  buf += 4;
+  for (auto &value : values_) {
+    MACH_WRITE_UINT32(buf, value.length());
+    buf += 4;
+    MACH_WRITE_STRING(buf, value);
+    buf += value.length();
+  }
+  ASSERT(buf - p == serialized_size_, "Unexpected serialize size.");
+  return buf - p;
+}
+
+uint32_t ColumnDictionary::DeserializeFrom(char *buf, ColumnDictionary *&dictionary) {
+  char *p = buf;
+  uint32_t magic_num = MACH_READ_UINT32(buf);
+  buf += 4;
+  ASSERT(magic_num == DICTIONARY_MAGIC_NUM, "Failed to deserialize column dictionary.");
+  uint32_t count = MACH_READ_UINT32(buf);
+  buf += 4;
+  dictionary = new ColumnDictionary();
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t len = MACH_READ_UINT32(buf);
+    buf += 4;
+    dictionary->Append(buf, len);
+    buf += len;
+  }
+  return buf - p;
+}
@@ -0,0 +1,45 @@
+#include "record/field_compare.h"
+
+FieldCompare::Kernel FieldCompare::BindKernel(TypeId type, Op op) {
+  switch (type) {
+    case TypeId::kTypeInt:
+      return BindKernel<TypeId::kTypeInt>(op);
+    case TypeId::kTypeFloat:
+      return BindKernel<TypeId::kTypeFloat>(op);
+    case TypeId::kTypeChar:
+      return BindKernel<TypeId::kTypeChar>(op);
+    default:
+      return nullptr;
+  }
+}
+
+template <TypeId type>
+FieldCompare::Kernel FieldCompare::BindKernel(Op op) {
+  switch (op) {
+    case Op::kEq:
+      return &Apply<type, Op::kEq>;
+    case Op::kNe:
+      return &Apply<type, Op::kNe>;
+    case Op::kLt:
+      return &Apply<type, Op::kLt>;
+    case Op::kLe:
+      return &Apply<type, Op::kLe>;
+    case Op::kGt:
+      return &Apply<type, Op::kGt>;
+    case Op::kGe:
+      return &Apply<type, Op::kGe>;
+  }
+  return nullptr;
+}
+
+bool FieldCompare::ParseOp(const std::string &op, Op *out) {
+  static const std::pair<const char *, Op> ops[] = {{"=", Op::kEq},  {"<>", Op::kNe}, {"<", Op::kLt},
+                                                    {"<=", Op::kLe}, {">", Op::kGt},  {">=", Op::kGe}};
+  for (auto &entry : ops) {
+    if (op == entry.first) {
+      *out = entry.second;
+      return true;
+    }
+  }
+  return false;
+}
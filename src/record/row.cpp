@@ -1,4 +1,6 @@
 #include "record/row.h"
+
+#include "record/column_dictionary.h"
 //#define ROW_MAGIC_NUM 10117//jy added
 /**
  * TODO: Student Implement
@@ -75,127 +77,134 @@
 uint32_t Row::SerializeTo(char *buf, Schema *schema) const {
   ASSERT(schema != nullptr, "Invalid schema before serialize.");
   ASSERT(schema->GetColumnCount() == fields_.size(), "Fields size do not match schema's column size.");
-//  uint32_t ofs = 0;
-//
-//  //write magic num
-//  MACH_WRITE_TO(uint32_t,buf+ofs,ROW_MAGIC_NUM);
-//  ofs += sizeof(uint32_t);
-//  //end write magic num
-//
-//  //write field size
-//  MACH_WRITE_UINT32(buf+ofs,fields_.size());
-//  ofs += sizeof(uint32_t);
-//  //end write field size
-//
-//  uint32_t bitmap_size = (fields_.size()+7) / 8;
-//  char null_bitmap[bitmap_size];//(fields_.size()+7) / 8
-//  memset(null_bitmap,0, sizeof(null_bitmap));
-//
-//  for(int i = 0; i < fields_.size();i++)
-//    if(fields_.at(i)==nullptr)//set null fields to 1
-//      null_bitmap[i/8] = null_bitmap[i/8]|(1<<(i%8));
-//
-//  //write bitmap
-//  for(int i = 0; i < bitmap_size; i++){//(fields_.size()+7)/8
-//    MACH_WRITE_TO(char,buf+ofs,null_bitmap[i]);
-//    ofs += sizeof(char);
-//  }
-//  //end write bitmap
-//
-//  //write fields
-//  for(int i = 0; i < fields_.size();i++)
-//    if(fields_.at(i)!=nullptr){
-//      MACH_WRITE_TO(TypeId,buf+ofs,fields_.at(i)->GetTypeId());
-//      ofs = ofs + 4;
-//      ofs = ofs + fields_.at(i)->SerializeTo(buf+ofs);
-//    }
-//  //end write fields
-//  return ofs;
-  if(this == nullptr) return 0;
-  uint32_t ofs = 0;
-  uint32_t num = fields_.size();//get field nums
-  uint32_t psize = num / 8;
-  if(num % 8) psize++;
-  char p[psize+1]; memset(p,0,psize);//initial null bitmap to 0
-  //write magic num
-  MACH_WRITE_TO(uint32_t,buf+ofs,ROW_MAGIC_NUM); ofs+=sizeof(uint32_t);
-  //end write magic num
-  for(int i = 0 ; i < num ; i++)
-    if(fields_[i]->IsNull())
-      p[i/8] |= (1<<(7-i%8));//set null bitmap
-  //write field num
-  MACH_WRITE_TO(uint32_t, buf+ofs, num); ofs+=sizeof(uint32_t);
-  //end write field num
-
-  //write null bitmap
-  memcpy(buf+ofs, p, psize); ofs+=psize;
-  //end write null bitmap
-  for(int i = 0 ; i < num ; i++)
-    ofs += fields_[i]->SerializeTo(buf+ofs);//if fields[i]==null, ofs+=0
-  return ofs;
+  ASSERT(GetSerializedSize(schema) <= UINT16_MAX, "Row is too large for 2 byte char offsets.");
+  uint32_t header_size = GetHeaderSize(schema);
+  char *fixed = buf + header_size;
+  MACH_WRITE_TO(uint8_t, buf, ROW_FORMAT_VERSION);
+  memset(buf + sizeof(uint8_t), 0, header_size - sizeof(uint8_t));
+  uint32_t varlen_ofs = header_size + schema->GetFixedSize();
+  for (uint32_t i = 0; i < fields_.size(); i++) {
+    const Field *field = &fields_[i];
+    char *slot = fixed + schema->GetFixedOffset(i);
+    if (field->IsNull()) {
+      buf[sizeof(uint8_t) + i / 8] |= static_cast<char>(1 << (7 - i % 8));
+    }
+    ColumnDictionary *dictionary = schema->GetDictionary(i);
+    if (dictionary != nullptr) {
+      uint16_t code = 0;
+      if (!field->IsNull()) {
+        code = dictionary->Lookup(field->GetData(), field->GetLength());
+        ASSERT(code != ColumnDictionary::INVALID_CODE, "Value is not in the column dictionary.");
+      }
+      MACH_WRITE_TO(uint16_t, slot, code);
+    } else if (schema->GetColumn(i)->GetType() == TypeId::kTypeChar) {
+      if (!field->IsNull()) {
+        memcpy(buf + varlen_ofs, field->GetData(), field->GetLength());
+        varlen_ofs += field->GetLength();
+      }
+      MACH_WRITE_TO(uint16_t, slot, static_cast<uint16_t>(varlen_ofs));
+    } else if (field->IsNull()) {
+      memset(slot, 0, Type::GetTypeSize(field->GetTypeId()));
+    } else {
+      field->SerializeTo(slot);
+    }
+  }
+  return varlen_ofs;
 }
 
 uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
   ASSERT(schema != nullptr, "Invalid schema before serialize.");
   ASSERT(fields_.empty(), "Non empty field in row.");
-//  uint32_t ofs = 0;
+  if (MACH_READ_FROM(uint8_t, buf) != ROW_FORMAT_VERSION) {
+    return DeserializeLegacyFrom(buf, schema);
+  }
+  uint32_t header_size = GetHeaderSize(schema);
+  char *fixed = buf + header_size;
+  uint32_t varlen_ofs = header_size + schema->GetFixedSize();
+  uint32_t column_count = schema->GetColumnCount();
+  fields_.reserve(column_count);
+  for (uint32_t i = 0; i < column_count; i++) {
+    TypeId type = schema->GetColumn(i)->GetType();
+    char *slot = fixed + schema->GetFixedOffset(i);
+    bool is_null = (buf[sizeof(uint8_t) + i / 8] & (1 << (7 - i % 8))) != 0;
+    if (schema->GetDictionary(i) != nullptr) {
+      AppendCode(schema->GetDictionary(i), slot, is_null);
+    } else if (type == TypeId::kTypeChar) {
+      uint32_t end = MACH_READ_FROM(uint16_t, slot);
+      AppendValue(type, slot, is_null, buf + varlen_ofs, end - varlen_ofs);
+      varlen_ofs = end;
+    } else {
+      AppendValue(type, slot, is_null, nullptr, 0);
+    }
+  }
+  return varlen_ofs;
+}
 
-//  //read magic num
-//  uint32_t row_magic_num_read = MACH_READ_FROM(uint32_t,buf+ofs);
-//  ofs += sizeof(uint32_t);
-//  //end read magic num
-//  ASSERT(row_magic_num_read==ROW_MAGIC_NUM,"row magic num Error when Deserializing!");
-//
-//  //read field size
-//  uint32_t field_size_read = MACH_READ_FROM(uint32_t,buf+ofs);
-//  ofs += sizeof(uint32_t);
-//  //end read field size
-//
-//  uint32_t null_bitmap_size = (field_size_read + 7) / 8;
-//  char null_bitmap[null_bitmap_size];
-//
-//  //read null bitmap
-//  memset(null_bitmap,0,sizeof(null_bitmap));
-//  for(int i = 0; i < null_bitmap_size;i++){
-//    null_bitmap[i] = MACH_READ_FROM(char,buf+ofs);
-//    ofs += sizeof(char);
-//  }
-//  //end read null bitmap
-//
-//  for(int i = 0; i < field_size_read; i++){
-//    bool is_null = (null_bitmap[i/8])&(1<<(i%8));
-//    if(is_null)
-//      fields_.push_back(nullptr);
-//    else{
-//      fields_.push_back(nullptr);
-//      TypeId type_id = MACH_READ_FROM(TypeId,buf+ofs);
-//      ofs = ofs + 4;
-//      ofs = ofs + Field::DeserializeFrom(buf+ofs,type_id,&fields_.at(i),false);
-//    }
-//  }
-//  return ofs;
+uint32_t Row::DeserializeFrom(char *buf, Schema *schema, const std::vector<uint32_t> &columns) {
+  ASSERT(schema != nullptr, "Invalid schema before serialize.");
+  ASSERT(fields_.empty(), "Non empty field in row.");
+  if (MACH_READ_FROM(uint8_t, buf) != ROW_FORMAT_VERSION) {
+    // the old layout has no fixed offsets, every column is decoded and the unlisted ones are dropped again
+    uint32_t size = DeserializeLegacyFrom(buf, schema);
+    auto next = columns.begin();
+    for (uint32_t i = 0; i < fields_.size(); i++) {
+      if (next != columns.end() && *next == i) {
+        ++next;
+      } else {
+        fields_[i] = Field(fields_[i].GetTypeId());
+      }
+    }
+    return size;
+  }
+  uint32_t header_size = GetHeaderSize(schema);
+  char *fixed = buf + header_size;
+  uint32_t varlen_base = header_size + schema->GetFixedSize();
+  uint32_t column_count = schema->GetColumnCount();
+  fields_.reserve(column_count);
+  auto next = columns.begin();
+  for (uint32_t i = 0; i < column_count; i++) {
+    TypeId type = schema->GetColumn(i)->GetType();
+    bool is_null = (buf[sizeof(uint8_t) + i / 8] & (1 << (7 - i % 8))) != 0;
+    if (next == columns.end() || *next != i) {
+      AppendValue(type, nullptr, true, nullptr, 0);
+      continue;
+    }
+    ++next;
+    char *slot = fixed + schema->GetFixedOffset(i);
+    if (schema->GetDictionary(i) != nullptr) {
+      AppendCode(schema->GetDictionary(i), slot, is_null);
+    } else if (type == TypeId::kTypeChar && !is_null) {
+      int32_t prev = schema->GetPrevVarlenColumn(i);
+      uint32_t start = prev < 0 ? varlen_base : MACH_READ_FROM(uint16_t, fixed + schema->GetFixedOffset(prev));
+      uint32_t end = MACH_READ_FROM(uint16_t, slot);
+      AppendValue(type, slot, false, buf + start, end - start);
+    } else {
+      AppendValue(type, slot, is_null, nullptr, 0);
+    }
+  }
+  ASSERT(next == columns.end(), "Columns are not ascending table column indexes.");
+  int32_t last = schema->GetLastVarlenColumn();
+  return last < 0 ? varlen_base : MACH_READ_FROM(uint16_t, fixed + schema->GetFixedOffset(last));
+}
 
-  uint32_t num=0,ofs=0,row_magic_num;//RowId rid;
-  //read magic num
-  row_magic_num= MACH_READ_FROM(uint32_t,buf+ofs); ofs+=sizeof(uint32_t);
-  //end read magic num
-  ASSERT(row_magic_num==10117,"Error!");
-  //read field num
-  num=MACH_READ_FROM(uint32_t,buf+ofs);
-  ofs+=sizeof(uint32_t);
-  //end read field num
-  //read null bitmap
-  uint32_t psize = num / 8;
-  if(num % 8) psize++;
-  char p[psize+1];memset(p,0,sizeof(p));
-  memcpy(p,buf+ofs,psize); ofs+=psize;
-  //end read null bitmap
-  for(int i=0;i<num;i++){
-    fields_.emplace_back(nullptr);//set to null for next step
-    if(p[i/8]&(1<<(7-i%8)))//original field is null
-      ofs+=Field::DeserializeFrom(buf+ofs,schema->GetColumn(i)->GetType(),&(fields_[i]),true);
-    else//original field is not null
-      ofs+=Field::DeserializeFrom(buf+ofs,schema->GetColumn(i)->GetType(),&(fields_[i]),false);
+uint32_t Row::DeserializeLegacyFrom(char *buf, Schema *schema) {
+  ASSERT(MACH_READ_UINT32(buf) == ROW_MAGIC_NUM, "Unknown row format version.");
+  uint32_t column_count = MACH_READ_UINT32(buf + sizeof(uint32_t));
+  ASSERT(column_count == schema->GetColumnCount(), "Fields size do not match schema's column size.");
+  const char *null_bitmap = buf + 2 * sizeof(uint32_t);
+  uint32_t ofs = 2 * sizeof(uint32_t) + (column_count + 7) / 8;
+  fields_.reserve(column_count);
+  for (uint32_t i = 0; i < column_count; i++) {
+    TypeId type = schema->GetColumn(i)->GetType();
+    bool is_null = (null_bitmap[i / 8] & (1 << (7 - i % 8))) != 0;
+    if (type == TypeId::kTypeChar && !is_null) {
+      uint32_t len = MACH_READ_UINT32(buf + ofs);
+      AppendValue(type, nullptr, false, buf + ofs + sizeof(uint32_t), len);
+      ofs += sizeof(uint32_t) + len;
+    } else {
+      AppendValue(type, buf + ofs, is_null, nullptr, 0);
+      ofs += is_null ? 0 : Type::GetTypeSize(type);
+    }
   }
   return ofs;
 }
@@ -203,40 +212,62 @@ uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
 uint32_t Row::GetSerializedSize(Schema *schema) const {
   ASSERT(schema != nullptr, "Invalid schema before serialize.");
   ASSERT(schema->GetColumnCount() == fields_.size(), "Fields size do not match schema's column size.");
-//  uint32_t ofs = 2*sizeof(uint32_t);//magic num + field size      //4
-//  ofs += (fields_.size()+7)/8;//bitmap size
-//  for(int i = 0; i < fields_.size();i++)
-//    if(fields_.at(i)!=nullptr)
-//      ofs += fields_.at(i)->GetSerializedSize() + 4;//fields size
-//  return ofs;
-  if(this== nullptr) return 0;
-  uint32_t ofs = 0;
-  //get magic num
-  ofs += sizeof(uint32_t);
-  //end get magic num
+  if (fields_.empty()) {
+    return 0;
+  }
+  uint32_t size = GetHeaderSize(schema) + schema->GetFixedSize();
+  for (uint32_t i = 0; i < fields_.size(); i++) {
+    if (fields_[i].GetTypeId() == TypeId::kTypeChar && !fields_[i].IsNull() && schema->GetDictionary(i) == nullptr) {
+      size += fields_[i].GetLength();
+    }
+  }
+  return size;
+}
 
-  //get field num
-  ofs += sizeof(uint32_t);
-  //end get field num
+void Row::AppendField(const Field &field) {
+  if (field.GetTypeId() != TypeId::kTypeChar || field.IsNull()) {
+    fields_.emplace_back(field);
+    return;
+  }
+  uint32_t len = field.GetLength();
+  if (heap_ == nullptr || len <= Field::INLINE_CHAR_SIZE) {
+    fields_.emplace_back(TypeId::kTypeChar, const_cast<char *>(field.GetData()), len, true);
+  } else {
+    char *data = static_cast<char *>(heap_->Allocate(len));
+    memcpy(data, field.GetData(), len);
+    fields_.emplace_back(TypeId::kTypeChar, data, len, false);
+  }
+}
 
-  for(int i = 0 ; i < fields_.size() ; i++)
-    ofs += fields_[i]->GetSerializedSize();
-  //get null bitmap size
-  ofs += fields_.size()/8;
-  if(fields_.size()%8)
-    ofs++;
-  //end get null bitmap size
-  return ofs;//+sizeof(uint32_t)
+void Row::AppendValue(TypeId type, const char *slot, bool is_null, char *chars, uint32_t len) {
+  if (is_null) {
+    fields_.emplace_back(type);
+  } else if (type == TypeId::kTypeInt) {
+    fields_.emplace_back(type, MACH_READ_INT32(slot));
+  } else if (type == TypeId::kTypeFloat) {
+    fields_.emplace_back(type, MACH_READ_FROM(float, slot));
+  } else {
+    AppendField(Field(type, chars, len, false));
+  }
+}
+
+void Row::AppendCode(const ColumnDictionary *dictionary, const char *slot, bool is_null) {
+  if (is_null) {
+    fields_.emplace_back(TypeId::kTypeChar);
+    return;
+  }
+  const std::string &value = dictionary->Decode(MACH_READ_FROM(uint16_t, slot));
+  AppendField(Field(TypeId::kTypeChar, const_cast<char *>(value.data()), value.length(), false));
 }
 
 void Row::GetKeyFromRow(const Schema *schema, const Schema *key_schema, Row &key_row) {
   auto columns = key_schema->GetColumns();
-  std::vector<Field> fields;
   uint32_t idx;
+  key_row.destroy();
+  key_row.SetRowId(RowId());
   for (auto column : columns) {
     schema->GetColumnIndex(column->GetName(), idx);
-    fields.emplace_back(*this->GetField(idx));
+    key_row.AppendField(*this->GetField(idx));
   }
-  key_row = Row(fields);
 }
 
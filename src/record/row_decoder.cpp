@@ -0,0 +1,156 @@
+#include "record/row_decoder.h"
+
+#include "record/column_dictionary.h"
+
+const char *ColumnBatch::GetChars(uint32_t column, uint32_t row) const {
+  ColumnDictionary *dictionary = schema_->GetDictionary(column);
+  if (dictionary != nullptr) {
+    return dictionary->Decode(columns_[column].codes_[row]).data();
+  }
+  return columns_[column].chars_[row];
+}
+
+uint32_t ColumnBatch::GetCharLength(uint32_t column, uint32_t row) const {
+  ColumnDictionary *dictionary = schema_->GetDictionary(column);
+  if (dictionary != nullptr) {
+    return dictionary->Decode(columns_[column].codes_[row]).length();
+  }
+  return columns_[column].lengths_[row];
+}
+
+Field ColumnBatch::GetField(uint32_t column, uint32_t row) const {
+  TypeId type = schema_->GetColumn(column)->GetType();
+  if (IsNull(column, row)) {
+    return Field(type);
+  }
+  switch (type) {
+    case TypeId::kTypeInt:
+      return Field(type, GetInt(column, row));
+    case TypeId::kTypeFloat:
+      return Field(type, GetFloat(column, row));
+    case TypeId::kTypeChar:
+      return Field(type, const_cast<char *>(GetChars(column, row)), GetCharLength(column, row), false);
+    default:
+      ASSERT(false, "Unsupported column type.");
+      return Field(type);
+  }
+}
+
+void ColumnBatch::Materialize(uint32_t row, Row *out) const {
+  ASSERT(row < row_count_, "Row out of range.");
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    if (IsDecoded(i)) {
+      out->AppendField(GetField(i, row));
+    } else {
+      out->AppendField(Field(schema_->GetColumn(i)->GetType()));
+    }
+  }
+}
+
+void ColumnBatch::View(uint32_t row, Row *out) const {
+  ASSERT(row < row_count_, "Row out of range.");
+  auto &fields = out->GetFields();
+  fields.resize(columns_.size(), Field(TypeId::kTypeInt));
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    fields[i] = IsDecoded(i) ? GetField(i, row) : Field(schema_->GetColumn(i)->GetType());
+  }
+}
+
+RowDecoder::RowDecoder(const Schema *schema) : schema_(schema) {
+  std::vector<uint32_t> columns(schema->GetColumnCount());
+  for (uint32_t i = 0; i < columns.size(); i++) {
+    columns[i] = i;
+  }
+  Compile(columns);
+}
+
+RowDecoder::RowDecoder(const Schema *schema, const std::vector<uint32_t> &columns) : schema_(schema) {
+  Compile(columns);
+}
+
+void RowDecoder::Compile(const std::vector<uint32_t> &columns) {
+  uint32_t header_size = Row::GetHeaderSize(schema_);
+  program_.reserve(columns.size());
+  for (auto column : columns) {
+    ASSERT(column < schema_->GetColumnCount(), "Column out of range.");
+    Step step{};
+    step.column_ = column;
+    step.null_byte_ = sizeof(uint8_t) + column / 8;
+    step.null_mask_ = static_cast<uint8_t>(1 << (7 - column % 8));
+    step.slot_ = header_size + schema_->GetFixedOffset(column);
+    switch (schema_->GetColumn(column)->GetType()) {
+      case TypeId::kTypeInt:
+        step.kind_ = StepKind::kInt;
+        break;
+      case TypeId::kTypeFloat:
+        step.kind_ = StepKind::kFloat;
+        break;
+      case TypeId::kTypeChar: {
+        step.kind_ = schema_->GetDictionary(column) != nullptr ? StepKind::kCode : StepKind::kChar;
+        int32_t prev = schema_->GetPrevVarlenColumn(column);
+        step.first_varlen_ = prev < 0;
+        step.start_ = prev < 0 ? header_size + schema_->GetFixedSize()
+                               : header_size + schema_->GetFixedOffset(static_cast<uint32_t>(prev));
+        break;
+      }
+      default:
+        ASSERT(false, "Unsupported column type.");
+    }
+    program_.push_back(step);
+  }
+}
+
+void RowDecoder::Decode(const char *const *tuples, uint32_t count, ColumnBatch *batch) const {
+  ASSERT(batch->schema_ == schema_, "Batch is created for another schema.");
+  uint32_t base = batch->row_count_;
+  for (auto &step : program_) {
+    auto &column = batch->columns_[step.column_];
+    column.nulls_.resize(base + count);
+    uint8_t *nulls = column.nulls_.data() + base;
+    for (uint32_t i = 0; i < count; i++) {
+      nulls[i] = (tuples[i][step.null_byte_] & step.null_mask_) != 0;
+    }
+    // null values keep a zeroed slot and an empty char range, so the values are read without a branch
+    switch (step.kind_) {
+      case StepKind::kInt: {
+        column.ints_.resize(base + count);
+        int32_t *out = column.ints_.data() + base;
+        for (uint32_t i = 0; i < count; i++) {
+          out[i] = MACH_READ_FROM(int32_t, tuples[i] + step.slot_);
+        }
+        break;
+      }
+      case StepKind::kFloat: {
+        column.floats_.resize(base + count);
+        float *out = column.floats_.data() + base;
+        for (uint32_t i = 0; i < count; i++) {
+          out[i] = MACH_READ_FROM(float, tuples[i] + step.slot_);
+        }
+        break;
+      }
+      case StepKind::kCode: {
+        column.codes_.resize(base + count);
+        uint16_t *out = column.codes_.data() + base;
+        for (uint32_t i = 0; i < count; i++) {
+          out[i] = MACH_READ_FROM(uint16_t, tuples[i] + step.slot_);
+        }
+        break;
+      }
+      case StepKind::kChar: {
+        column.chars_.resize(base + count);
+        column.lengths_.resize(base + count);
+        const char **chars = column.chars_.data() + base;
+        uint32_t *lengths = column.lengths_.data() + base;
+        for (uint32_t i = 0; i < count; i++) {
+          const char *tuple = tuples[i];
+          uint32_t start = step.first_varlen_ ? step.start_ : MACH_READ_FROM(uint16_t, tuple + step.start_);
+          uint32_t end = MACH_READ_FROM(uint16_t, tuple + step.slot_);
+          chars[i] = tuple + start;
+          lengths[i] = end - start;
+        }
+        break;
+      }
+    }
+  }
+  batch->row_count_ = base + count;
+}
@@ -1,4 +1,28 @@
 #include "record/schema.h"
+
+#include "record/types.h"
+
+void Schema::ComputeRowLayout() {
+  fixed_offsets_.resize(columns_.size());
+  prev_varlen_.resize(columns_.size());
+  dictionaries_.resize(columns_.size(), nullptr);
+  last_varlen_ = -1;
+  uint32_t ofs = 0;
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    fixed_offsets_[i] = ofs;
+    prev_varlen_[i] = last_varlen_;
+    if (dictionaries_[i] != nullptr) {
+      ofs += sizeof(uint16_t);
+    } else if (columns_[i]->GetType() == TypeId::kTypeChar) {
+      ofs += sizeof(uint16_t);
+      last_varlen_ = static_cast<int32_t>(i);
+    } else {
+      ofs += Type::GetTypeSize(columns_[i]->GetType());
+    }
+  }
+  fixed_size_ = ofs;
+}
+
 uint32_t Schema::SerializeTo(char *buf) const {
   uint32_t ofs = 0;
 
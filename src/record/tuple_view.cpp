@@ -0,0 +1,134 @@
+#include "record/tuple_view.h"
+
+#include "page/pax_page.h"
+#include "record/column_dictionary.h"
+
+TupleView::TupleView(char *page_data, const PaxLayout *layout, RowId rid)
+    : data_(page_data), schema_(layout->GetSchema()), rid_(rid), pax_layout_(layout) {}
+
+uint32_t TupleView::GetColumnCount() const {
+  if (pax_layout_ != nullptr) {
+    return pax_layout_->GetColumnCount();
+  }
+  return schema_->GetColumnCount();
+}
+
+bool TupleView::IsNull(uint32_t idx) const {
+  ASSERT(idx < GetColumnCount(), "Failed to access column");
+  if (pax_layout_ != nullptr) {
+    return pax_layout_->IsNull(data_, idx, rid_.GetSlotNum());
+  }
+  return (data_[sizeof(uint8_t) + idx / 8] & (1 << (7 - idx % 8))) != 0;
+}
+
+int32_t TupleView::GetInt(uint32_t idx) const {
+  ASSERT(schema_->GetColumn(idx)->GetType() == TypeId::kTypeInt, "Invalid type.");
+  return MACH_READ_FROM(int32_t, GetValue(idx));
+}
+
+float TupleView::GetFloat(uint32_t idx) const {
+  ASSERT(schema_->GetColumn(idx)->GetType() == TypeId::kTypeFloat, "Invalid type.");
+  return MACH_READ_FROM(float_t, GetValue(idx));
+}
+
+const char *TupleView::GetChars(uint32_t idx) const {
+  ASSERT(schema_->GetColumn(idx)->GetType() == TypeId::kTypeChar, "Invalid type.");
+  if (schema_->GetDictionary(idx) != nullptr) {
+    return schema_->GetDictionary(idx)->Decode(GetCode(idx)).data();
+  }
+  if (pax_layout_ != nullptr) {
+    return GetValue(idx);
+  }
+  return data_ + GetVarlenStart(idx);
+}
+
+uint32_t TupleView::GetCharLength(uint32_t idx) const {
+  ASSERT(schema_->GetColumn(idx)->GetType() == TypeId::kTypeChar, "Invalid type.");
+  if (schema_->GetDictionary(idx) != nullptr) {
+    return schema_->GetDictionary(idx)->Decode(GetCode(idx)).length();
+  }
+  if (pax_layout_ != nullptr) {
+    return pax_layout_->GetCharLength(data_, idx, rid_.GetSlotNum());
+  }
+  return MACH_READ_FROM(uint16_t, GetValue(idx)) - GetVarlenStart(idx);
+}
+
+uint16_t TupleView::GetCode(uint32_t idx) const {
+  ASSERT(schema_->GetDictionary(idx) != nullptr, "Column is not dictionary-encoded.");
+  return MACH_READ_FROM(uint16_t, GetValue(idx));
+}
+
+Field TupleView::GetField(uint32_t idx) const {
+  TypeId type = schema_->GetColumn(idx)->GetType();
+  if (IsNull(idx)) {
+    return Field(type);
+  }
+  switch (type) {
+    case TypeId::kTypeInt:
+      return Field(type, GetInt(idx));
+    case TypeId::kTypeFloat:
+      return Field(type, GetFloat(idx));
+    case TypeId::kTypeChar:
+      return Field(type, const_cast<char *>(GetChars(idx)), GetCharLength(idx), false);
+    default:
+      ASSERT(false, "Unsupported column type.");
+      return Field(type);
+  }
+}
+
+uint32_t TupleView::Materialize(Row *row) const {
+  ASSERT(IsValid(), "Materialize an invalid view.");
+  row->destroy();
+  row->SetRowId(rid_);
+  if (pax_layout_ == nullptr) {
+    return row->DeserializeFrom(data_, schema_);
+  }
+  return MaterializePax(row, [](uint32_t) { return true; });
+}
+
+uint32_t TupleView::Materialize(Row *row, const std::vector<uint32_t> &columns) const {
+  ASSERT(IsValid(), "Materialize an invalid view.");
+  row->destroy();
+  row->SetRowId(rid_);
+  if (pax_layout_ == nullptr) {
+    return row->DeserializeFrom(data_, schema_, columns);
+  }
+  auto next = columns.begin();
+  return MaterializePax(row, [&next, &columns](uint32_t idx) {
+    if (next != columns.end() && *next == idx) {
+      ++next;
+      return true;
+    }
+    return false;
+  });
+}
+
+template <typename Needed>
+uint32_t TupleView::MaterializePax(Row *row, Needed needed) const {
+  uint32_t read_bytes = 0;
+  for (uint32_t i = 0; i < GetColumnCount(); i++) {
+    TypeId type = schema_->GetColumn(i)->GetType();
+    if (!needed(i) || IsNull(i)) {
+      row->AppendField(Field(type));
+      continue;
+    }
+    row->AppendField(GetField(i));
+    read_bytes += type == TypeId::kTypeChar ? GetCharLength(i) : Type::GetTypeSize(type);
+  }
+  return read_bytes;
+}
+
+const char *TupleView::GetValue(uint32_t idx) const {
+  if (pax_layout_ != nullptr) {
+    return pax_layout_->GetValue(data_, idx, rid_.GetSlotNum());
+  }
+  return data_ + Row::GetHeaderSize(schema_) + schema_->GetFixedOffset(idx);
+}
+
+uint32_t TupleView::GetVarlenStart(uint32_t idx) const {
+  int32_t prev = schema_->GetPrevVarlenColumn(idx);
+  if (prev < 0) {
+    return Row::GetHeaderSize(schema_) + schema_->GetFixedSize();
+  }
+  return MACH_READ_FROM(uint16_t, GetValue(static_cast<uint32_t>(prev)));
+}
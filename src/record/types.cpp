@@ -1,6 +1,7 @@
 #include "record/types.h"
 
 #include "common/macros.h"
+#include "record/char_ops.h"
 #include "record/field.h"
 
 inline int CompareStrings(const char *str1, int len1, const char *str2, int len2) {
@@ -8,11 +9,7 @@ inline int CompareStrings(const char *str1, int len1, const char *str2, int len2
   assert(len1 >= 0);
   assert(str2 != nullptr);
   assert(len2 >= 0);
-  int ret = memcmp(str1, str2, static_cast<size_t>(std::min(len1, len2)));
-  if (ret == 0 && len1 != len2) {
-    ret = len1 - len2;
-  }
-  return ret;
+  return CharOps::Compare(str1, static_cast<uint32_t>(len1), str2, static_cast<uint32_t>(len2));
 }
 
 // ==============================Type=============================
@@ -266,7 +263,7 @@ CmpBool TypeChar::CompareEquals(const Field &left, const Field &right) const {
   if (left.IsNull() || right.IsNull()) {
     return CmpBool::kNull;
   }
-  return GetCmpBool(CompareStrings(left.GetData(), left.GetLength(), right.GetData(), right.GetLength()) == 0);
+  return GetCmpBool(CharOps::Equals(left.GetData(), left.GetLength(), right.GetData(), right.GetLength()));
 }
 
 CmpBool TypeChar::CompareNotEquals(const Field &left, const Field &right) const {
@@ -274,7 +271,7 @@ CmpBool TypeChar::CompareNotEquals(const Field &left, const Field &right) const
   if (left.IsNull() || right.IsNull()) {
     return CmpBool::kNull;
   }
-  return GetCmpBool(CompareStrings(left.GetData(), left.GetLength(), right.GetData(), right.GetLength()) != 0);
+  return GetCmpBool(!CharOps::Equals(left.GetData(), left.GetLength(), right.GetData(), right.GetLength()));
 }
 
 CmpBool TypeChar::CompareLessThan(const Field &left, const Field &right) const {
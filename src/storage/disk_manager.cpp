@@ -24,7 +24,24 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
       throw std::exception();
     }
   }
-  ReadPhysicalPage(META_PAGE_ID, meta_data_);
+  LoadMetaData();
+}
+
+void DiskManager::LoadMetaData() {
+  memset(meta_data_, 0, PAGE_SIZE);
+  DiskFileMetaPage *disk_meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  int file_size = GetFileSize(file_name_);
+  page_id_t physical_pages = file_size <= 0 ? 0 : (file_size + PAGE_SIZE - 1) / PAGE_SIZE;
+  BitmapPage<PAGE_SIZE> bitmap_page;
+  for (uint32_t i = 0; i < MAX_EXTENT_NUMS && GetBitmapPhysicalPageId(i) < physical_pages; i++) {
+    ReadPhysicalPage(GetBitmapPhysicalPageId(i), reinterpret_cast<char *>(&bitmap_page));
+    if (bitmap_page.Recount()) {
+      WritePhysicalPage(GetBitmapPhysicalPageId(i), reinterpret_cast<const char *>(&bitmap_page));
+    }
+    disk_meta_page->extent_used_page_[i] = bitmap_page.GetAllocatedPages();
+    disk_meta_page->num_allocated_pages_ += bitmap_page.GetAllocatedPages();
+    disk_meta_page->num_extents_++;
+  }
 }
 
 void DiskManager::Close() {
@@ -47,63 +64,66 @@ void DiskManager::WritePage(page_id_t logical_page_id, const char *page_data) {
 
 page_id_t DiskManager::AllocatePage() {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-  DiskFileMetaPage *disk_meta_page = reinterpret_cast<DiskFileMetaPage*>(meta_data_);
+  DiskFileMetaPage *disk_meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
   uint32_t *extent_used_page = disk_meta_page->extent_used_page_;
-  //try to fit in the free pages
-  for(uint32_t i = 0; i < disk_meta_page->GetExtentNums(); i++) {
-    BitmapPage<PAGE_SIZE> bitmap_page;
-    ReadPhysicalPage(i, reinterpret_cast<char *>(&bitmap_page));
-    uint32_t page_offset;
-    if(bitmap_page.AllocatePage(page_offset)) {//allocated successfully
-      WritePhysicalPage(i, reinterpret_cast<const char *>(&bitmap_page));
-//      disk_meta_page->num_extents_++;
+  BitmapPage<PAGE_SIZE> bitmap_page;
+  uint32_t page_offset;
+  // try to fit in an extent which still has free pages
+  for (uint32_t i = 0; i < disk_meta_page->GetExtentNums(); i++) {
+    if (extent_used_page[i] >= BITMAP_SIZE) {
+      continue;
+    }
+    ReadPhysicalPage(GetBitmapPhysicalPageId(i), reinterpret_cast<char *>(&bitmap_page));
+    if (bitmap_page.AllocatePage(page_offset)) {
+      WritePhysicalPage(GetBitmapPhysicalPageId(i), reinterpret_cast<const char *>(&bitmap_page));
       disk_meta_page->num_allocated_pages_++;
       extent_used_page[i]++;
-      return i * BITMAP_SIZE + extent_used_page[i] - 1;
+      return i * BITMAP_SIZE + page_offset;
     }
   }
-  //no free pages
-  char empty_page[PAGE_SIZE] = {0};
-  BitmapPage<PAGE_SIZE> bitmap_page;//new bitmap page
-  uint32_t page_offset;
-  bitmap_page.AllocatePage(page_offset); // Allocate the first page for bitmap
-  disk_meta_page->num_allocated_pages_++;
-  for(size_t i = 0; i < BITMAP_SIZE + 1; i++) {
-    if (i == 0) {
-      WritePhysicalPage(disk_meta_page->GetExtentNums() * (BITMAP_SIZE + 1) + i, reinterpret_cast<const char*>(&bitmap_page));
-    } else {
-      WritePhysicalPage(disk_meta_page->GetExtentNums() * (BITMAP_SIZE + 1) + i, empty_page);
-    }
+  // no free pages, start a new extent
+  uint32_t extent_id = disk_meta_page->GetExtentNums();
+  if (extent_id >= MAX_EXTENT_NUMS) {
+    LOG(ERROR) << "Disk file is full.";
+    return INVALID_PAGE_ID;
   }
-//  disk_meta_page->num_allocated_pages_++;
+  ReadPhysicalPage(GetBitmapPhysicalPageId(extent_id), reinterpret_cast<char *>(&bitmap_page));
+  bitmap_page.AllocatePage(page_offset);
+  WritePhysicalPage(GetBitmapPhysicalPageId(extent_id), reinterpret_cast<const char *>(&bitmap_page));
   disk_meta_page->num_extents_++;
-  extent_used_page[disk_meta_page->GetExtentNums() - 1]++;
-//  return (disk_meta_page->GetExtentNums()) * BITMAP_SIZE;
-  return (disk_meta_page->GetExtentNums() - 1) * BITMAP_SIZE + extent_used_page[disk_meta_page->GetExtentNums() - 1] - 1;
-
+  disk_meta_page->num_allocated_pages_++;
+  extent_used_page[extent_id] = 1;
+  return extent_id * BITMAP_SIZE + page_offset;
 }
 
 void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-  DiskFileMetaPage *disk_meta_page = reinterpret_cast<DiskFileMetaPage*>(meta_data_);
-  uint32_t *extent_used_page = disk_meta_page->extent_used_page_;
-  BitmapPage<PAGE_SIZE> bitmap_page;
+  DiskFileMetaPage *disk_meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
   uint32_t extent_id = logical_page_id / BITMAP_SIZE;
   uint32_t page_offset = logical_page_id % BITMAP_SIZE;
-  ReadPhysicalPage(extent_id, reinterpret_cast<char*>(&bitmap_page));
-  bitmap_page.DeAllocatePage(page_offset);
-  extent_used_page[extent_id]--;
+  if (extent_id >= disk_meta_page->GetExtentNums()) {
+    return;
+  }
+  BitmapPage<PAGE_SIZE> bitmap_page;
+  ReadPhysicalPage(GetBitmapPhysicalPageId(extent_id), reinterpret_cast<char *>(&bitmap_page));
+  if (!bitmap_page.DeAllocatePage(page_offset)) {
+    return;
+  }
+  WritePhysicalPage(GetBitmapPhysicalPageId(extent_id), reinterpret_cast<const char *>(&bitmap_page));
+  disk_meta_page->extent_used_page_[extent_id]--;
   disk_meta_page->num_allocated_pages_--;
-  WritePage(extent_id, reinterpret_cast<const char *>(&bitmap_page));
 }
 
 bool DiskManager::IsPageFree(page_id_t logical_page_id) {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-  BitmapPage<PAGE_SIZE> bitmap_page;
+  DiskFileMetaPage *disk_meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
   uint32_t extent_id = logical_page_id / BITMAP_SIZE;
   uint32_t page_offset = logical_page_id % BITMAP_SIZE;
-  ReadPhysicalPage(extent_id, reinterpret_cast<char *>(&bitmap_page));
-
+  if (extent_id >= disk_meta_page->GetExtentNums()) {
+    return true;
+  }
+  BitmapPage<PAGE_SIZE> bitmap_page;
+  ReadPhysicalPage(GetBitmapPhysicalPageId(extent_id), reinterpret_cast<char *>(&bitmap_page));
   return bitmap_page.IsPageFree(page_offset);
 }
 
@@ -111,7 +131,7 @@ page_id_t DiskManager::MapPageId(page_id_t logical_page_id) {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   uint32_t extent_id = logical_page_id / BITMAP_SIZE;
   uint32_t page_offset = logical_page_id % BITMAP_SIZE;
-  return extent_id * (BITMAP_SIZE + 1) + 1 + page_offset;
+  return GetBitmapPhysicalPageId(extent_id) + 1 + page_offset;
 }
 
 int DiskManager::GetFileSize(const std::string &file_name) {
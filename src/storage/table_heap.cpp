@@ -1,4 +1,6 @@
 //#include "storage/table_heap.h"
+
+#include "record/column_dictionary.h"
 //#include <iostream>
 ///**
 // * TODO: Student Implement
@@ -59,7 +61,7 @@
 ///**
 // * TODO: Student Implement
 // */
-//bool TableHeap::UpdateTuple(const Row &row, const RowId &rid, Transaction *txn) {
+//bool TableHeap::UpdateTuple(Row &row, const RowId &rid, Transaction *txn) {
 //  auto page = (TablePage *)buffer_pool_manager_->FetchPage(rid.GetPageId());
 //
 //  if (page == nullptr) return false;
@@ -166,22 +168,40 @@
  * TODO: Student Implement
  */
 bool TableHeap::InsertTuple(Row &row, Transaction *txn) {
+  if (!EncodeDictionaries(row)) {
+    return false;
+  }
+  // a tuple which can never fit into an empty page would grow the chain forever
+  if (pax_layout_ != nullptr) {
+    return pax_layout_->Fits(row) && InsertTupleImpl<PaxPage>(row, *pax_layout_, txn);
+  }
+  return row.GetSerializedSize(schema_) <= TablePage::SIZE_MAX_ROW && InsertTupleImpl<TablePage>(row, schema_, txn);
+}
+
+template <typename PageType, typename Format>
+bool TableHeap::InsertTupleImpl(Row &row, const Format &format, Transaction *txn) {
 
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+  auto page = reinterpret_cast<PageType *>(buffer_pool_manager_->FetchPage(first_page_id_));
 
-  while(!page->InsertTuple(row,schema_,txn,lock_manager_,log_manager_)){
+  while(!page->InsertTuple(row,format,txn,lock_manager_,log_manager_)){
 
     page_id_t next_page_id = page->GetNextPageId();
+    PageType *next_page;
     if(next_page_id==INVALID_PAGE_ID){
-      auto next_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(next_page_id));
-      if(next_page_id==INVALID_PAGE_ID) return false;
+      next_page = reinterpret_cast<PageType *>(buffer_pool_manager_->NewPage(next_page_id));
+      if(next_page==nullptr){
+        buffer_pool_manager_->UnpinPage(page->GetPageId(),false);
+        return false;
+      }
       next_page->Init(next_page_id,page->GetPageId(),log_manager_,txn);
       page->SetNextPageId(next_page->GetPageId());
       buffer_pool_manager_->UnpinPage(page->GetPageId(),true);
     }
-    else
+    else{
       buffer_pool_manager_->UnpinPage(page->GetPageId(),page->IsDirty());
-    page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
+      next_page = reinterpret_cast<PageType *>(buffer_pool_manager_->FetchPage(next_page_id));
+    }
+    page = next_page;
   }
   buffer_pool_manager_->UnpinPage(page->GetPageId(),true);
   return true;
@@ -189,33 +209,77 @@ bool TableHeap::InsertTuple(Row &row, Transaction *txn) {
 
 bool TableHeap::MarkDelete(const RowId &rid, Transaction *txn) {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  Page *page = buffer_pool_manager_->FetchPage(rid.GetPageId());
   // If the page could not be found, then abort the transaction.
   if (page == nullptr) {
     return false;
   }
   // Otherwise, mark the tuple as deleted.
   page->WLatch();
-  page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  bool deleted;
+  if (pax_layout_ != nullptr) {
+    deleted = reinterpret_cast<PaxPage *>(page)->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  } else {
+    deleted = reinterpret_cast<TablePage *>(page)->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  }
   page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
-  return true;
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), deleted);
+  return deleted;
 }
 
 /**
  * TODO: Student Implement
  */
-bool TableHeap::UpdateTuple(const Row &row, const RowId &rid, Transaction *txn) {
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-  Row *old_row = new Row(rid);
-  buffer_pool_manager_->UnpinPage(page->GetPageId(),page->IsDirty());
-  bool temp_res = page->UpdateTuple(row,old_row,schema_,txn,lock_manager_,log_manager_);
-  if(temp_res==true) return true;
-  else if(temp_res==false){
-    Row new_row(row);
-    page->MarkDelete(rid,txn,lock_manager_,log_manager_);
-    return InsertTuple(new_row,txn);
+bool TableHeap::UpdateTuple(Row &row, const RowId &rid, Transaction *txn) {
+  if (!EncodeDictionaries(row)) {
+    return false;
+  }
+  if (pax_layout_ != nullptr) {
+    return UpdateTupleImpl<PaxPage>(row, rid, *pax_layout_, txn);
+  }
+  return UpdateTupleImpl<TablePage>(row, rid, schema_, txn);
+}
+
+template <typename PageType, typename Format>
+bool TableHeap::UpdateTupleImpl(Row &row, const RowId &rid, const Format &format, Transaction *txn) {
+  auto page = reinterpret_cast<PageType *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  if (page == nullptr) {
+    return false;
+  }
+  Row old_row(rid);
+  page->WLatch();
+  bool updated = page->UpdateTuple(row, &old_row, format, txn, lock_manager_, log_manager_);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), updated);
+  if (updated) {
+    row.SetRowId(rid);
+    return true;
+  }
+  // the new tuple does not fit into the old page, move it, a tuple which does not exist is not moved
+  if (!MarkDelete(rid, txn)) {
+    return false;
   }
+  if (!InsertTuple(row, txn)) {
+    RollbackDelete(rid, txn);
+    return false;
+  }
+  return true;
+}
+
+bool TableHeap::EncodeDictionaries(const Row &row) {
+  bool grown = false;
+  for (uint32_t i = 0; i < schema_->GetColumnCount() && i < row.GetFieldCount(); i++) {
+    ColumnDictionary *dictionary = schema_->GetDictionary(i);
+    const Field *field = row.GetField(i);
+    if (dictionary == nullptr || field->IsNull()) {
+      continue;
+    }
+    if (dictionary->Encode(field->GetData(), field->GetLength()) == ColumnDictionary::INVALID_CODE) {
+      return false;
+    }
+    grown = grown || dictionary->IsDirty();
+  }
+  return !grown || dictionary_writer_ == nullptr || dictionary_writer_();
 }
 
 /**
@@ -224,30 +288,205 @@ bool TableHeap::UpdateTuple(const Row &row, const RowId &rid, Transaction *txn)
 void TableHeap::ApplyDelete(const RowId &rid, Transaction *txn) {
   // Step1: Find the page which contains the tuple.
   // Step2: Delete the tuple from the page.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-  page->ApplyDelete(rid,txn,log_manager_);
-  buffer_pool_manager_->UnpinPage(page->GetPageId(),true);
-  return;
+  Page *page = buffer_pool_manager_->FetchPage(rid.GetPageId());
+  if (pax_layout_ != nullptr) {
+    reinterpret_cast<PaxPage *>(page)->ApplyDelete(rid, txn, log_manager_);
+  } else {
+    reinterpret_cast<TablePage *>(page)->ApplyDelete(rid, txn, log_manager_);
+  }
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
 }
 
 void TableHeap::RollbackDelete(const RowId &rid, Transaction *txn) {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  Page *page = buffer_pool_manager_->FetchPage(rid.GetPageId());
   assert(page != nullptr);
   // Rollback to delete.
   page->WLatch();
-  page->RollbackDelete(rid, txn, log_manager_);
+  if (pax_layout_ != nullptr) {
+    reinterpret_cast<PaxPage *>(page)->RollbackDelete(rid, txn, log_manager_);
+  } else {
+    reinterpret_cast<TablePage *>(page)->RollbackDelete(rid, txn, log_manager_);
+  }
   page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
 }
 
 /**
  * TODO: Student Implement
  */
 bool TableHeap::GetTuple(Row *row, Transaction *txn) {
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(row->GetRowId().GetPageId()));
-  buffer_pool_manager_->UnpinPage(row->GetRowId().GetPageId(),true);
-  return page->GetTuple(row,schema_,txn,lock_manager_);
+  if (pax_layout_ != nullptr) {
+    return GetTupleImpl<PaxPage>(row, *pax_layout_, txn);
+  }
+  return GetTupleImpl<TablePage>(row, schema_, txn);
+}
+
+bool TableHeap::GetTuple(Row *row, const std::vector<uint32_t> &columns, [[maybe_unused]] Transaction *txn) {
+  auto page = buffer_pool_manager_->FetchPage(row->GetRowId().GetPageId());
+  if (page == nullptr) {
+    return false;
+  }
+  TupleView view;
+  bool ret = GetTupleView(page, row->GetRowId(), &view);
+  if (ret) {
+    view.Materialize(row, columns);
+  }
+  buffer_pool_manager_->UnpinPage(row->GetRowId().GetPageId(), false);
+  return ret;
+}
+
+template <typename PageType, typename Format>
+bool TableHeap::GetTupleImpl(Row *row, const Format &format, Transaction *txn) {
+  auto page = reinterpret_cast<PageType *>(buffer_pool_manager_->FetchPage(row->GetRowId().GetPageId()));
+  if (page == nullptr) {
+    return false;
+  }
+  bool ret = page->GetTuple(row, format, txn, lock_manager_);
+  buffer_pool_manager_->UnpinPage(row->GetRowId().GetPageId(), false);
+  return ret;
+}
+
+uint32_t TableHeap::Vacuum(std::vector<std::pair<RowId, RowId>> &moved, Transaction *txn) {
+  if (pax_layout_ != nullptr) {
+    return VacuumImpl<PaxPage>(moved, *pax_layout_, txn);
+  }
+  return VacuumImpl<TablePage>(moved, schema_, txn);
+}
+
+uint32_t TableHeap::UpgradeRows(std::vector<std::pair<RowId, RowId>> &moved, Transaction *txn) {
+  if (pax_layout_ != nullptr) {
+    return 0;
+  }
+  std::vector<RowId> legacy_rids;
+  ScanPages(
+      [&legacy_rids](const std::vector<TupleView> &views) {
+        for (auto &view : views) {
+          if (MACH_READ_FROM(uint8_t, view.GetData()) != Row::ROW_FORMAT_VERSION) {
+            legacy_rids.push_back(view.GetRowId());
+          }
+        }
+        return true;
+      },
+      txn);
+  // the old layout is still decoded by Row, writing the row back stores it in the current one
+  for (auto &rid : legacy_rids) {
+    Row row(rid);
+    if (GetTuple(&row, txn) && UpdateTuple(row, rid, txn) && !(row.GetRowId() == rid)) {
+      moved.emplace_back(rid, row.GetRowId());
+    }
+  }
+  return legacy_rids.size();
+}
+
+template <typename PageType, typename Format>
+uint32_t TableHeap::VacuumImpl(std::vector<std::pair<RowId, RowId>> &moved, const Format &format, Transaction *txn) {
+  // Step1: reclaim the space held by tuples that were marked deleted but never applied.
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<PageType *>(buffer_pool_manager_->FetchPage(page_id));
+    page->WLatch();
+    page->Vacuum(txn, log_manager_);
+    page->WUnlatch();
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    page_id = next_page_id;
+  }
+
+  // Step2: fill the pages at the head of the chain with the tuples of the pages behind them.
+  uint32_t freed_pages = 0;
+  page_id_t target_page_id = first_page_id_;
+  auto target_page = reinterpret_cast<PageType *>(buffer_pool_manager_->FetchPage(target_page_id));
+  page_id_t source_page_id = target_page->GetNextPageId();
+  while (source_page_id != INVALID_PAGE_ID) {
+    auto source_page = reinterpret_cast<PageType *>(buffer_pool_manager_->FetchPage(source_page_id));
+    RowId rid;
+    bool has_tuple = source_page->GetFirstTupleRid(&rid);
+    while (has_tuple && target_page_id != source_page_id) {
+      Row row(rid);
+      source_page->GetTuple(&row, format, txn, lock_manager_);
+      if (target_page->InsertTuple(row, format, txn, lock_manager_, log_manager_)) {
+        moved.emplace_back(rid, row.GetRowId());
+        source_page->ApplyDelete(rid, txn, log_manager_);
+        has_tuple = source_page->GetNextTupleRid(rid, &rid);
+        continue;
+      }
+      // the target page is full, move on to the next one (which is at most the source page itself)
+      page_id_t next_page_id = target_page->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(target_page_id, true);
+      target_page_id = next_page_id;
+      target_page = target_page_id == source_page_id
+                        ? source_page
+                        : reinterpret_cast<PageType *>(buffer_pool_manager_->FetchPage(target_page_id));
+    }
+    page_id_t next_source_page_id = source_page->GetNextPageId();
+    if (target_page_id == source_page_id) {
+      // the source page became the target page, it stays pinned as the target
+    } else if (!has_tuple) {
+      // the source page is empty now, unlink it from the chain and release it
+      page_id_t prev_page_id = source_page->GetPrevPageId();
+      if (prev_page_id == target_page_id) {
+        target_page->SetNextPageId(next_source_page_id);
+      } else {
+        auto prev_page = reinterpret_cast<PageType *>(buffer_pool_manager_->FetchPage(prev_page_id));
+        prev_page->SetNextPageId(next_source_page_id);
+        buffer_pool_manager_->UnpinPage(prev_page_id, true);
+      }
+      if (next_source_page_id != INVALID_PAGE_ID) {
+        auto next_page = reinterpret_cast<PageType *>(buffer_pool_manager_->FetchPage(next_source_page_id));
+        next_page->SetPrevPageId(prev_page_id);
+        buffer_pool_manager_->UnpinPage(next_source_page_id, true);
+      }
+      buffer_pool_manager_->UnpinPage(source_page_id, false);
+      buffer_pool_manager_->DeletePage(source_page_id);
+      freed_pages++;
+    } else {
+      buffer_pool_manager_->UnpinPage(source_page_id, true);
+    }
+    source_page_id = next_source_page_id;
+  }
+  buffer_pool_manager_->UnpinPage(target_page_id, true);
+  return freed_pages;
+}
+
+void TableHeap::ScanPages(const PageVisitor &visitor, Transaction *txn) {
+  bool keep_going = true;
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID && keep_going) {
+    page_id = ScanPage(page_id, visitor, txn, &keep_going);
+  }
+}
+
+page_id_t TableHeap::ScanPage(page_id_t page_id, const PageVisitor &visitor, [[maybe_unused]] Transaction *txn,
+                              bool *keep_going) {
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  ASSERT(page != nullptr, "Can not fetch table page.");
+  std::vector<TupleView> views;
+  page->RLatch();
+  if (pax_layout_ != nullptr) {
+    reinterpret_cast<PaxPage *>(page)->GetTupleViews(*pax_layout_, views);
+  } else {
+    page->GetTupleViews(schema_, views);
+  }
+  bool ret = views.empty() || visitor(views);
+  page_id_t next_page_id = page->GetNextPageId();
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  if (keep_going != nullptr) {
+    *keep_going = ret;
+  }
+  return next_page_id;
+}
+
+void TableHeap::GetPageIds(std::vector<page_id_t> &page_ids) {
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    page_ids.push_back(page_id);
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
 }
 
 void TableHeap::DeleteTable(page_id_t page_id) {
@@ -266,16 +505,19 @@ void TableHeap::DeleteTable(page_id_t page_id) {
  * TODO: Student Implement
  */
 TableIterator TableHeap::Begin(Transaction *txn) {
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+  page_id_t page_id = first_page_id_;
   RowId row_id;
-  while(!page->GetFirstTupleRid(&row_id)){
-    buffer_pool_manager_->UnpinPage(page->GetPageId(),page->IsDirty());
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    bool found = GetFirstTupleRid(page, &row_id);
     page_id_t next_page_id = page->GetNextPageId();
-    if(next_page_id==INVALID_PAGE_ID) return TableHeap::End();
-    page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    if (found) {
+      return TableIterator(this, row_id, txn);
+    }
+    page_id = next_page_id;
   }
-  buffer_pool_manager_->UnpinPage(page->GetPageId(),page->IsDirty());
-  return TableIterator(this,row_id,txn);
+  return TableHeap::End();
 }
 
 /**
@@ -287,3 +529,24 @@ TableIterator TableHeap::End() {
   static TableIterator end(this,row_id,nullptr);
   return end;
 }
+
+bool TableHeap::GetFirstTupleRid(Page *page, RowId *rid) {
+  if (pax_layout_ != nullptr) {
+    return reinterpret_cast<PaxPage *>(page)->GetFirstTupleRid(rid);
+  }
+  return reinterpret_cast<TablePage *>(page)->GetFirstTupleRid(rid);
+}
+
+bool TableHeap::GetNextTupleRid(Page *page, const RowId &cur_rid, RowId *next_rid) {
+  if (pax_layout_ != nullptr) {
+    return reinterpret_cast<PaxPage *>(page)->GetNextTupleRid(cur_rid, next_rid);
+  }
+  return reinterpret_cast<TablePage *>(page)->GetNextTupleRid(cur_rid, next_rid);
+}
+
+bool TableHeap::GetTupleView(Page *page, const RowId &rid, TupleView *view) {
+  if (pax_layout_ != nullptr) {
+    return reinterpret_cast<PaxPage *>(page)->GetTupleView(rid, *pax_layout_, view);
+  }
+  return reinterpret_cast<TablePage *>(page)->GetTupleView(rid, schema_, view);
+}
@@ -96,26 +96,22 @@
 /**
  * TODO: Student Implement
  */
-TableIterator::TableIterator() : table_heap_(nullptr) {
+TableIterator::TableIterator() : row_(new Row()) {
   row_id_.Set(INVALID_PAGE_ID, 0);
-  row_ = new Row(row_id_);
 }
 
-TableIterator::TableIterator(TableHeap *table_heap, RowId row_id, Transaction *txn){
-  txn_ = txn;
-  table_heap_ = table_heap;
-  row_id_ = row_id;
-  if(row_id_.GetPageId()!=INVALID_PAGE_ID){
-    row_ = new Row(row_id_);
-    table_heap_->GetTuple(row_,txn_);
-  }
+TableIterator::TableIterator(TableHeap *table_heap, RowId row_id, Transaction *txn)
+    : txn_(txn), table_heap_(table_heap), row_id_(row_id), row_(new Row()) {
+  PinPage();
 }
 
-TableIterator::TableIterator(const TableIterator &other) :
-                                                           txn_(other.txn_), table_heap_(other.table_heap_), row_id_(other.row_id_), row_(new Row(other.row_id_)){
+TableIterator::TableIterator(const TableIterator &other)
+    : txn_(other.txn_), table_heap_(other.table_heap_), row_id_(other.row_id_), row_(new Row()) {
+  PinPage();
 }
 
 TableIterator::~TableIterator() {
+  UnpinPage();
   delete row_;
 }
 
@@ -128,65 +124,87 @@ bool TableIterator::operator!=(const TableIterator &itr) const {
 }
 
 const Row &TableIterator::operator*() {
-
+  if (!row_materialized_ && page_ != nullptr) {
+    GetTupleView().Materialize(row_);
+    row_materialized_ = true;
+  }
   return *(this->row_);
 }
 
 Row *TableIterator::operator->() {
+  return &const_cast<Row &>(**this);
+}
 
-  return this->row_;
+TupleView TableIterator::GetTupleView() const {
+  TupleView view;
+  if (page_ != nullptr) {
+    table_heap_->GetTupleView(page_, row_id_, &view);
+  }
+  return view;
 }
 
 TableIterator &TableIterator::operator=(const TableIterator &itr) noexcept {
+  if (this == &itr) {
+    return *this;
+  }
+  UnpinPage();
   this->table_heap_ = itr.table_heap_;
   this->txn_ = itr.txn_;
   this->row_id_ = itr.row_id_;
-  this->row_ = new Row(*itr.row_);
   row_->destroy();
-  if(row_id_.GetPageId()!=INVALID_PAGE_ID)
-    table_heap_->GetTuple(row_,txn_);
+  row_materialized_ = false;
+  PinPage();
+  return *this;
 }
 
-// ++iter
 TableIterator &TableIterator::operator++() {
-  auto page = reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(row_id_.GetPageId()));
+  if (page_ == nullptr) {
+    return *this;
+  }
+  row_->destroy();
+  row_materialized_ = false;
   RowId row_id;
-  while(!page->GetNextTupleRid(row_id_,&row_id)){
-    table_heap_->buffer_pool_manager_->UnpinPage(row_id_.GetPageId(),false);
-    page_id_t next_page_id = page->GetNextPageId();
-    if(next_page_id==INVALID_PAGE_ID){
-      row_id_.Set(INVALID_PAGE_ID,0);
+  if (table_heap_->GetNextTupleRid(page_, row_id_, &row_id)) {
+    row_id_ = row_id;
+    return *this;
+  }
+  // move on to the next page holding a live tuple, the current page is released first
+  // (both page layouts share the header, so the chain is followed through TablePage)
+  page_id_t next_page_id = reinterpret_cast<TablePage *>(page_)->GetNextPageId();
+  UnpinPage();
+  BufferPoolManager *bpm = table_heap_->buffer_pool_manager_;
+  while (next_page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<TablePage *>(bpm->FetchPage(next_page_id));
+    if (table_heap_->GetFirstTupleRid(page, &row_id)) {
+      page_ = page;
+      row_id_ = row_id;
       return *this;
     }
-    page = reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(next_page_id));
-    row_id_.Set(page->GetPageId(),-1);
+    page_id_t page_id = next_page_id;
+    next_page_id = page->GetNextPageId();
+    bpm->UnpinPage(page_id, false);
   }
-  row_id_ = row_id;
-  row_->SetRowId(row_id_);
-  row_->destroy();
-  table_heap_->GetTuple(row_,txn_);
+  row_id_.Set(INVALID_PAGE_ID, 0);
   return *this;
 }
 
-// iter++
 TableIterator TableIterator::operator++(int) {
-  TableIterator temp = TableIterator(*this);
-  auto page = reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(row_id_.GetPageId()));
-  RowId row_id;
-  while(!page->GetNextTupleRid(row_id_,&row_id)){
-    table_heap_->buffer_pool_manager_->UnpinPage(row_id_.GetPageId(),false);
-    page_id_t next_page_id = page->GetNextPageId();
-    if(next_page_id==INVALID_PAGE_ID){
-      row_id_.Set(INVALID_PAGE_ID,0);
-      return temp;
-    }
-    page = reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(next_page_id));
-    row_id_.Set(page->GetPageId(),-1);
+  TableIterator temp(*this);
+  ++(*this);
+  return temp;
+}
+
+void TableIterator::PinPage() {
+  if (table_heap_ == nullptr || row_id_.GetPageId() == INVALID_PAGE_ID) {
+    return;
   }
-  row_id_ = row_id;
-  row_->SetRowId(row_id_);
-  row_->destroy();
-  table_heap_->GetTuple(row_,txn_);
+  page_ = table_heap_->buffer_pool_manager_->FetchPage(row_id_.GetPageId());
+}
 
-  return temp;
+void TableIterator::UnpinPage() {
+  if (page_ == nullptr) {
+    return;
+  }
+  table_heap_->buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+  page_ = nullptr;
 }
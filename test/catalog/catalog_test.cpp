@@ -1,6 +1,7 @@
 #include "catalog/catalog.h"
 
 #include "common/instance.h"
+#include "record/column_dictionary.h"
 #include "gtest/gtest.h"
 #include "utils/utils.h"
 
@@ -46,6 +47,18 @@ TEST(CatalogTest, CatalogIndexTest) {
     ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(row, ret, &txn));
     ASSERT_EQ(rid.Get(), ret[i].Get());
   }
+  IndexInfo *name_index = nullptr;
+  std::vector<std::string> name_keys{"name"};
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-2", name_keys, &txn, name_index, "bptree", false));
+  ASSERT_FALSE(name_index->IsUnique());
+  // the included columns follow the key, a column of the key is not repeated
+  IndexInfo *covering_index = nullptr;
+  ASSERT_EQ(DB_FAILED, catalog_01->CreateIndex("table-1", "index-3", name_keys, &txn, covering_index, "hash", false,
+                                               {"account"}));
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-3", name_keys, &txn, covering_index, "bptree", false,
+                                                {"account", "name", "id"}));
+  ASSERT_EQ(1u, covering_index->GetKeyColumnCount());
+  ASSERT_EQ(3u, covering_index->GetIndexKeySchema()->GetColumnCount());
   delete db_01;
   /** Stage 2: Testing catalog loading */
   auto db_02 = new DBStorageEngine(db_file_name, false);
@@ -54,6 +67,16 @@ TEST(CatalogTest, CatalogIndexTest) {
   ASSERT_EQ(DB_INDEX_ALREADY_EXIST, r4);
   IndexInfo *index_info_02 = nullptr;
   ASSERT_EQ(DB_SUCCESS, catalog_02->GetIndex("table-1", "index-1", index_info_02));
+  ASSERT_TRUE(index_info_02->IsUnique());
+  IndexInfo *name_index_02 = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_02->GetIndex("table-1", "index-2", name_index_02));
+  ASSERT_FALSE(name_index_02->IsUnique());
+  IndexInfo *covering_index_02 = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_02->GetIndex("table-1", "index-3", covering_index_02));
+  ASSERT_EQ(1u, covering_index_02->GetKeyColumnCount());
+  ASSERT_EQ(2u, covering_index_02->GetIndexKeySchema()->GetColumn(1)->GetTableInd());
+  ASSERT_EQ(0u, covering_index_02->GetIndexKeySchema()->GetColumn(2)->GetTableInd());
+  ASSERT_EQ(2u, index_info_02->GetKeyColumnCount());
   //add the insert entries
   for (int i = 0; i < 10; i++) {
     std::vector<Field> fields{Field(TypeId::kTypeInt, i),
@@ -136,3 +159,81 @@ TEST(CatalogTest, CatalogTableTest) {
   ASSERT_EQ(DB_SUCCESS, catalog_02->GetTable("table-1", table_info_03));
   delete db_02;
 }
+
+TEST(CatalogTest, CatalogDictionaryTest) {
+  /** Stage 1: a dictionary-encoded column stores codes */
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  auto &catalog_01 = db_01->catalog_mgr_;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("status", TypeId::kTypeChar, 32, 1, true, false),
+                                   new Column("note", TypeId::kTypeChar, 64, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  Transaction txn;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_FAILED, catalog_01->CreateTable("table-0", schema.get(), &txn, table_info, TableLayout::kRow, {0}));
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateTable("table-1", schema.get(), &txn, table_info, TableLayout::kRow, {1}));
+  ColumnDictionary *dictionary = table_info->GetSchema()->GetDictionary(1);
+  ASSERT_TRUE(dictionary != nullptr);
+  ASSERT_EQ(nullptr, table_info->GetSchema()->GetDictionary(2));
+  const char *statuses[] = {"active", "inactive", "pending"};
+  for (int i = 0; i < 30; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              i == 29 ? Field(TypeId::kTypeChar)
+                                      : Field(TypeId::kTypeChar, const_cast<char *>(statuses[i % 3]),
+                                              strlen(statuses[i % 3]), true),
+                              Field(TypeId::kTypeChar, const_cast<char *>("note"), 4, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+    // the status takes its 2 byte code in the fixed area, only the note has char data
+    ASSERT_EQ(Row::GetHeaderSize(table_info->GetSchema()) + table_info->GetSchema()->GetFixedSize() + 4,
+              row.GetSerializedSize(table_info->GetSchema()));
+    // a new value is written to the metadata page by the insert itself, not only when the catalog is closed
+    ASSERT_FALSE(table_info->GetTableMetaData()->HasDirtyDictionary());
+  }
+  ASSERT_EQ(3, dictionary->GetSize());
+  delete db_01;
+  /** Stage 2: the dictionary is loaded with the table and keeps growing */
+  auto db_02 = new DBStorageEngine(db_file_name, false);
+  auto &catalog_02 = db_02->catalog_mgr_;
+  ASSERT_EQ(DB_SUCCESS, catalog_02->GetTable("table-1", table_info));
+  dictionary = table_info->GetSchema()->GetDictionary(1);
+  ASSERT_TRUE(dictionary != nullptr);
+  ASSERT_EQ(3, dictionary->GetSize());
+  int count = 0;
+  for (auto iter = table_info->GetTableHeap()->Begin(&txn); iter != table_info->GetTableHeap()->End(); iter++) {
+    const Row &row = *iter;
+    if (count == 29) {
+      ASSERT_TRUE(row.GetField(1)->IsNull());
+    } else {
+      ASSERT_EQ(std::string(statuses[count % 3]), std::string(row.GetField(1)->GetData(), row.GetField(1)->GetLength()));
+    }
+    ASSERT_EQ(std::string("note"), std::string(row.GetField(2)->GetData(), row.GetField(2)->GetLength()));
+    count++;
+  }
+  ASSERT_EQ(30, count);
+  // values are added until the dictionary no longer fits into the metadata page
+  uint32_t inserted = 0;
+  for (int i = 0; i < 1000; i++) {
+    std::string status = "status-" + std::to_string(i) + "-with-a-long-name";
+    std::vector<Field> fields{Field(TypeId::kTypeInt, 100 + i),
+                              Field(TypeId::kTypeChar, const_cast<char *>(status.c_str()), status.length(), true),
+                              Field(TypeId::kTypeChar)};
+    Row row(fields);
+    if (!table_info->GetTableHeap()->InsertTuple(row, &txn)) {
+      break;
+    }
+    ASSERT_FALSE(table_info->GetTableMetaData()->HasDirtyDictionary());
+    inserted++;
+  }
+  ASSERT_GT(inserted, 0);
+  ASSERT_LT(inserted, 1000);
+  ASSERT_EQ(3 + inserted, dictionary->GetSize());
+  ASSERT_EQ(0, dictionary->Lookup("active", 6));
+  ASSERT_EQ(ColumnDictionary::INVALID_CODE, dictionary->Lookup("missing", 7));
+  delete db_02;
+  /** Stage 3: the full dictionary was written back */
+  auto db_03 = new DBStorageEngine(db_file_name, false);
+  ASSERT_EQ(DB_SUCCESS, db_03->catalog_mgr_->GetTable("table-1", table_info));
+  ASSERT_EQ(3 + inserted, table_info->GetSchema()->GetDictionary(1)->GetSize());
+  delete db_03;
+}
@@ -1,12 +1,16 @@
 //
 // Created by njz on 2023/1/26.
 //
+#include "executor/executors/seq_scan_executor.h"
 #include "executor/plans/delete_plan.h"
+#include "executor/plans/index_scan_plan.h"
 #include "executor/plans/insert_plan.h"
 #include "executor/plans/seq_scan_plan.h"
 #include "executor/plans/update_plan.h"
 #include "executor/plans/values_plan.h"
 #include "executor_test_util.h"  // NOLINT
+#include "planner/expressions/logic_expression.h"
+#include "planner/planner.h"
 
 // SELECT id FROM table-1 WHERE id < 500
 TEST_F(ExecutorTest, SimpleSeqScanTest) {
@@ -31,6 +35,279 @@ TEST_F(ExecutorTest, SimpleSeqScanTest) {
   }
 }
 
+// SELECT id, name FROM table-1 WHERE id < 500, scanned by 4 threads
+TEST_F(ExecutorTest, ParallelSeqScanTest) {
+  TableInfo *table_info;
+  GetExecutorContext()->GetCatalog()->GetTable("table-1", table_info);
+  const Schema *schema = table_info->GetSchema();
+  auto col_a = MakeColumnValueExpression(*schema, 0, "id");
+  auto col_b = MakeColumnValueExpression(*schema, 0, "name");
+  auto const500 = MakeConstantValueExpression(Field(kTypeInt, 500));
+  auto predicate = MakeComparisonExpression(col_a, const500, "<");
+  auto out_schema = MakeOutputSchema({{"id", col_a}, {"name", col_b}});
+  auto plan = make_shared<SeqScanPlanNode>(out_schema, table_info->GetTableName(), predicate);
+
+  std::vector<Row> serial_result{};
+  GetExecutionEngine()->ExecutePlan(plan, &serial_result, GetTxn(), GetExecutorContext());
+  GetExecutorContext()->SetParallelDegree(4);
+  std::vector<Row> parallel_result{};
+  GetExecutionEngine()->ExecutePlan(plan, &parallel_result, GetTxn(), GetExecutorContext());
+  GetExecutorContext()->SetParallelDegree(1);
+
+  // the morsels are merged in page order, so the output matches the serial scan row by row
+  ASSERT_EQ(500, parallel_result.size());
+  ASSERT_EQ(serial_result.size(), parallel_result.size());
+  for (size_t i = 0; i < parallel_result.size(); i++) {
+    ASSERT_EQ(serial_result[i].GetRowId(), parallel_result[i].GetRowId());
+    ASSERT_TRUE(parallel_result[i].GetField(0)->CompareEquals(*serial_result[i].GetField(0)));
+  }
+  ASSERT_TRUE(GetExecutorContext()->GetBufferPoolManager()->CheckAllUnpinned());
+}
+
+// SELECT id FROM table-1 on a table with more morsels than the workers may scan ahead of the consumer
+TEST_F(ExecutorTest, ParallelSeqScanStreamTest) {
+  TableInfo *table_info;
+  GetExecutorContext()->GetCatalog()->GetTable("table-1", table_info);
+  for (int i = 1000; i < 8000; i++) {
+    Row row(std::vector<Field>{Field(kTypeInt, i), Field(kTypeChar, const_cast<char *>("name"), 4, true),
+                               Field(kTypeFloat, 1.0f)});
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, GetTxn()));
+  }
+  const Schema *schema = table_info->GetSchema();
+  auto col_a = MakeColumnValueExpression(*schema, 0, "id");
+  auto out_schema = MakeOutputSchema({{"id", col_a}});
+  auto plan = make_shared<SeqScanPlanNode>(out_schema, table_info->GetTableName(), nullptr);
+
+  std::vector<Row> serial_result{};
+  GetExecutionEngine()->ExecutePlan(plan, &serial_result, GetTxn(), GetExecutorContext());
+  GetExecutorContext()->SetParallelDegree(4);
+  std::vector<Row> parallel_result{};
+  GetExecutionEngine()->ExecutePlan(plan, &parallel_result, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(8000, serial_result.size());
+  ASSERT_EQ(serial_result.size(), parallel_result.size());
+  for (size_t i = 0; i < parallel_result.size(); i++) {
+    ASSERT_EQ(serial_result[i].GetRowId(), parallel_result[i].GetRowId());
+  }
+
+  // a scan abandoned after a few rows stops its workers and leaves no page pinned
+  WorkerPool pool;
+  pool.Reserve(4);
+  GetExecutorContext()->SetWorkerPool(&pool);
+  {
+    SeqScanExecutor executor(GetExecutorContext(), plan.get());
+    executor.Init();
+    Row row;
+    RowId rid;
+    for (int i = 0; i < 10; i++) {
+      ASSERT_TRUE(executor.Next(&row, &rid));
+    }
+    // scanning again restarts the workers from the first page
+    executor.Init();
+    ASSERT_TRUE(executor.Next(&row, &rid));
+    ASSERT_EQ(serial_result[0].GetRowId(), rid);
+  }
+  GetExecutorContext()->SetWorkerPool(nullptr);
+  GetExecutorContext()->SetParallelDegree(1);
+  ASSERT_TRUE(GetExecutorContext()->GetBufferPoolManager()->CheckAllUnpinned());
+}
+
+// SELECT id FROM table-1 WHERE id >= 100 AND id > 150 AND id < 300 AND id <= 300, read as one index range
+TEST_F(ExecutorTest, IndexRangeScanTest) {
+  TableInfo *table_info;
+  GetExecutorContext()->GetCatalog()->GetTable("table-1", table_info);
+  IndexInfo *index_info;
+  ASSERT_EQ(DB_SUCCESS, GetExecutorContext()->GetCatalog()->CreateIndex("table-1", "index-id", {"id"}, GetTxn(),
+                                                                         index_info, "bptree"));
+  const Schema *schema = table_info->GetSchema();
+  auto col_a = MakeColumnValueExpression(*schema, 0, "id");
+  auto col_c = MakeColumnValueExpression(*schema, 0, "account");
+  auto compare = [&](AbstractExpressionRef column, Field value, std::string op) {
+    return MakeComparisonExpression(column, MakeConstantValueExpression(value), op);
+  };
+  auto conjunction = [](AbstractExpressionRef lhs, AbstractExpressionRef rhs) {
+    return std::make_shared<LogicExpression>(lhs, rhs, LogicType::And);
+  };
+  AbstractExpressionRef predicate =
+      conjunction(conjunction(compare(col_a, Field(kTypeInt, 100), ">="), compare(col_a, Field(kTypeInt, 150), ">")),
+                  conjunction(compare(col_a, Field(kTypeInt, 300), "<"), compare(col_a, Field(kTypeInt, 300), "<=")));
+  bool complete;
+  IndexScanRange range = Planner::PlanIndexRange(predicate, {index_info}, &complete);
+  ASSERT_EQ(index_info, range.index_);
+  ASSERT_TRUE(complete);
+  ASSERT_EQ(CmpBool::kTrue, range.lower_[0].CompareEquals(Field(kTypeInt, 150)));
+  ASSERT_EQ(CmpBool::kTrue, range.upper_[0].CompareEquals(Field(kTypeInt, 300)));
+  ASSERT_FALSE(range.lower_inclusive_);
+  ASSERT_FALSE(range.upper_inclusive_);
+  auto out_schema = MakeOutputSchema({{"id", col_a}});
+  auto plan = make_shared<IndexScanPlanNode>(out_schema, table_info->GetTableName(),
+                                             std::vector<IndexInfo *>{index_info}, !complete, predicate,
+                                             std::vector<uint32_t>{}, range);
+  std::vector<Row> result_set{};
+  GetExecutionEngine()->ExecutePlan(plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(149, result_set.size());
+  for (size_t i = 0; i < result_set.size(); i++) {
+    ASSERT_EQ(CmpBool::kTrue, result_set[i].GetField(0)->CompareEquals(Field(kTypeInt, 151 + static_cast<int>(i))));
+  }
+  ASSERT_TRUE(GetExecutorContext()->GetBufferPoolManager()->CheckAllUnpinned());
+  // a comparison on another column is left to the filter
+  auto mixed = conjunction(compare(col_a, Field(kTypeInt, 500), "="), compare(col_c, Field(kTypeFloat, 0.f), ">"));
+  range = Planner::PlanIndexRange(mixed, {index_info}, &complete);
+  ASSERT_EQ(index_info, range.index_);
+  ASSERT_FALSE(complete);
+  // a disjunction is not a range
+  auto disjunction = std::make_shared<LogicExpression>(compare(col_a, Field(kTypeInt, 5), "<"),
+                                                       compare(col_a, Field(kTypeInt, 900), ">"), LogicType::Or);
+  range = Planner::PlanIndexRange(disjunction, {index_info}, &complete);
+  ASSERT_EQ(nullptr, range.index_);
+  // a hash index is picked for an equality, but never for a range
+  IndexInfo *hash_info;
+  ASSERT_EQ(DB_SUCCESS, GetExecutorContext()->GetCatalog()->CreateIndex("table-1", "index-id-hash", {"id"}, GetTxn(),
+                                                                         hash_info, "hash"));
+  range = Planner::PlanIndexRange(compare(col_a, Field(kTypeInt, 500), "="), {index_info, hash_info}, &complete);
+  ASSERT_EQ(hash_info, range.index_);
+  ASSERT_TRUE(complete);
+  auto point_plan = make_shared<IndexScanPlanNode>(out_schema, table_info->GetTableName(), std::vector<IndexInfo *>{},
+                                                   false, nullptr, std::vector<uint32_t>{}, range);
+  result_set.clear();
+  GetExecutionEngine()->ExecutePlan(point_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(1, result_set.size());
+  ASSERT_EQ(CmpBool::kTrue, result_set[0].GetField(0)->CompareEquals(Field(kTypeInt, 500)));
+  range = Planner::PlanIndexRange(predicate, {hash_info, index_info}, &complete);
+  ASSERT_EQ(index_info, range.index_);
+}
+
+// SELECT c FROM table-2 WHERE a = 3 AND b >= 10 AND b < 20, read as one range of the index on (a, b)
+TEST_F(ExecutorTest, CompositeIndexRangeScanTest) {
+  std::vector<Column *> columns = {new Column("a", TypeId::kTypeInt, 0, false, false),
+                                   new Column("b", TypeId::kTypeInt, 1, false, false),
+                                   new Column("c", TypeId::kTypeInt, 2, false, false)};
+  TableInfo *table_info = nullptr;
+  auto catalog = GetExecutorContext()->GetCatalog();
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("table-2", new Schema(columns), GetTxn(), table_info));
+  for (int i = 0; i < 1000; i++) {
+    Row row(std::vector<Field>{Field(kTypeInt, i / 100), Field(kTypeInt, i % 100), Field(kTypeInt, i)});
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, GetTxn()));
+  }
+  IndexInfo *index_info;
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateIndex("table-2", "index-ab", {"a", "b"}, GetTxn(), index_info, "bptree"));
+  const Schema *schema = table_info->GetSchema();
+  auto col_a = MakeColumnValueExpression(*schema, 0, "a");
+  auto col_b = MakeColumnValueExpression(*schema, 0, "b");
+  auto col_c = MakeColumnValueExpression(*schema, 0, "c");
+  auto compare = [&](AbstractExpressionRef column, int value, std::string op) {
+    return MakeComparisonExpression(column, MakeConstantValueExpression(Field(kTypeInt, value)), op);
+  };
+  auto conjunction = [](AbstractExpressionRef lhs, AbstractExpressionRef rhs) {
+    return std::make_shared<LogicExpression>(lhs, rhs, LogicType::And);
+  };
+  auto out_schema = MakeOutputSchema({{"c", col_c}});
+  // the rows come in key order, which is the order of c, and are c = first to first + count - 1
+  auto scan_is = [&](const AbstractExpressionRef &predicate, bool expect_complete, int first, size_t count) {
+    bool complete;
+    IndexScanRange range = Planner::PlanIndexRange(predicate, {index_info}, &complete);
+    EXPECT_EQ(index_info, range.index_);
+    EXPECT_EQ(expect_complete, complete);
+    auto plan = make_shared<IndexScanPlanNode>(out_schema, table_info->GetTableName(), std::vector<IndexInfo *>{},
+                                               !complete, predicate, std::vector<uint32_t>{}, range);
+    std::vector<Row> result_set{};
+    GetExecutionEngine()->ExecutePlan(plan, &result_set, GetTxn(), GetExecutorContext());
+    if (result_set.size() != count) {
+      return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+      if (result_set[i].GetField(0)->CompareEquals(Field(kTypeInt, first + static_cast<int>(i))) != CmpBool::kTrue) {
+        return false;
+      }
+    }
+    return true;
+  };
+  // equality on the first column and a range on the second
+  auto predicate = conjunction(compare(col_a, 3, "="), conjunction(compare(col_b, 10, ">="), compare(col_b, 20, "<")));
+  ASSERT_TRUE(scan_is(predicate, true, 310, 10));
+  // equality on the full key
+  ASSERT_TRUE(scan_is(conjunction(compare(col_b, 42, "="), compare(col_a, 7, "=")), true, 742, 1));
+  // equality on the first column only reads its prefix
+  ASSERT_TRUE(scan_is(compare(col_a, 5, "="), true, 500, 100));
+  // exclusive bounds on a prefix leave out every key of the prefix
+  ASSERT_TRUE(scan_is(conjunction(compare(col_a, 2, ">"), compare(col_a, 5, "<")), true, 300, 200));
+  // a range on the first column does not bound the second one
+  ASSERT_TRUE(scan_is(conjunction(compare(col_a, 9, ">="), compare(col_b, 50, ">=")), false, 950, 50));
+  // a comparison on a column outside the key is left to the filter
+  ASSERT_TRUE(scan_is(conjunction(compare(col_a, 1, "="), compare(col_c, 120, "=")), false, 120, 1));
+  ASSERT_TRUE(GetExecutorContext()->GetBufferPoolManager()->CheckAllUnpinned());
+  // a key column after the first one does not start a range
+  bool complete;
+  ASSERT_EQ(nullptr, Planner::PlanIndexRange(compare(col_b, 5, "="), {index_info}, &complete).index_);
+}
+
+// SELECT name, id FROM table-3 WHERE id >= 100 AND id < 200, read from the entries of an index including name
+TEST_F(ExecutorTest, IndexOnlyScanTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 32, 1, false, false),
+                                   new Column("score", TypeId::kTypeInt, 2, false, false)};
+  TableInfo *table_info = nullptr;
+  auto catalog = GetExecutorContext()->GetCatalog();
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("table-3", new Schema(columns), GetTxn(), table_info));
+  auto name_of = [](int i) { return "name-of-row-" + std::to_string(i); };
+  std::vector<RowId> row_ids;
+  for (int i = 0; i < 1000; i++) {
+    std::string name = name_of(i);
+    Row row(std::vector<Field>{Field(kTypeInt, i),
+                               Field(kTypeChar, const_cast<char *>(name.c_str()), name.size(), true),
+                               Field(kTypeInt, i * 2)});
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, GetTxn()));
+    row_ids.push_back(row.GetRowId());
+  }
+  IndexInfo *index_info;
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateIndex("table-3", "index-id", {"id"}, GetTxn(), index_info, "bptree", true,
+                                             {"name"}));
+  const Schema *schema = table_info->GetSchema();
+  auto col_id = MakeColumnValueExpression(*schema, 0, "id");
+  auto col_name = MakeColumnValueExpression(*schema, 0, "name");
+  auto col_score = MakeColumnValueExpression(*schema, 0, "score");
+  auto out_schema = MakeOutputSchema({{"name", col_name}, {"id", col_id}});
+  ASSERT_TRUE(Planner::IndexCovers(index_info, Planner::NeededColumns(out_schema, nullptr)));
+  ASSERT_FALSE(Planner::IndexCovers(index_info, Planner::NeededColumns(MakeOutputSchema({{"score", col_score}}),
+                                                                        nullptr)));
+  auto predicate = std::make_shared<LogicExpression>(
+      MakeComparisonExpression(col_id, MakeConstantValueExpression(Field(kTypeInt, 100)), ">="),
+      MakeComparisonExpression(col_id, MakeConstantValueExpression(Field(kTypeInt, 200)), "<"), LogicType::And);
+  bool complete;
+  IndexScanRange range = Planner::PlanIndexRange(predicate, {index_info}, &complete);
+  ASSERT_TRUE(complete);
+  auto plan = make_shared<IndexScanPlanNode>(out_schema, table_info->GetTableName(), std::vector<IndexInfo *>{}, false,
+                                             predicate, Planner::NeededColumns(out_schema, predicate), range, true);
+  // the table is not read, the rows removed from it behind the back of the index are still returned
+  for (int i = 100; i < 110; i++) {
+    table_info->GetTableHeap()->MarkDelete(row_ids[i], GetTxn());
+    table_info->GetTableHeap()->ApplyDelete(row_ids[i], GetTxn());
+  }
+  std::vector<Row> result_set{};
+  GetExecutionEngine()->ExecutePlan(plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(100, result_set.size());
+  for (int i = 0; i < 100; i++) {
+    std::string name = name_of(100 + i);
+    ASSERT_EQ(name, result_set[i].GetField(0)->toString());
+    ASSERT_TRUE(result_set[i].GetField(1)->CompareEquals(Field(kTypeInt, 100 + i)));
+    ASSERT_EQ(row_ids[100 + i], result_set[i].GetRowId());
+  }
+  // a comparison on an included column is checked on the entries
+  auto name = name_of(150);
+  auto filter = std::make_shared<LogicExpression>(
+      predicate,
+      MakeComparisonExpression(
+          col_name, MakeConstantValueExpression(Field(kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)),
+          "="),
+      LogicType::And);
+  plan = make_shared<IndexScanPlanNode>(out_schema, table_info->GetTableName(), std::vector<IndexInfo *>{}, true,
+                                        filter, Planner::NeededColumns(out_schema, filter), range, true);
+  result_set.clear();
+  GetExecutionEngine()->ExecutePlan(plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(1, result_set.size());
+  ASSERT_TRUE(result_set[0].GetField(1)->CompareEquals(Field(kTypeInt, 150)));
+  ASSERT_TRUE(GetExecutorContext()->GetBufferPoolManager()->CheckAllUnpinned());
+}
+
 // DELETE FROM table-1 WHERE id == 50;
 TEST_F(ExecutorTest, SimpleDeleteTest) {
   // Construct query plan
@@ -155,3 +432,50 @@ TEST_F(ExecutorTest, SimpleUpdateTest) {
     ASSERT_TRUE(row.GetField(1)->CompareEquals(Field(kTypeChar, const_cast<char *>("minisql"), 7, false)));
   }
 }
+
+// UPDATE table-1 SET name = <64 chars> WHERE id < 20, the grown tuples leave their full pages
+TEST_F(ExecutorTest, UpdateMovedTupleTest) {
+  TableInfo *table_info;
+  GetExecutorContext()->GetCatalog()->GetTable("table-1", table_info);
+  IndexInfo *index_info;
+  ASSERT_EQ(DB_SUCCESS, GetExecutorContext()->GetCatalog()->CreateIndex("table-1", "index-id", {"id"}, GetTxn(),
+                                                                         index_info, "bptree"));
+  const Schema *schema = table_info->GetSchema();
+  auto col_a = MakeColumnValueExpression(*schema, 0, "id");
+  auto predicate = MakeComparisonExpression(col_a, MakeConstantValueExpression(Field(kTypeInt, 20)), "<");
+  auto scan_plan = make_shared<SeqScanPlanNode>(schema, table_info->GetTableName(), predicate);
+  std::vector<Row> before{};
+  GetExecutionEngine()->ExecutePlan(scan_plan, &before, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(20, before.size());
+
+  std::string name(64, 'm');
+  auto content = MakeConstantValueExpression(Field(kTypeChar, const_cast<char *>(name.c_str()), 64, true));
+  std::unordered_map<uint32_t, AbstractExpressionRef> update_attrs{};
+  update_attrs.emplace(1, content);
+  auto update_scan_plan = make_shared<SeqScanPlanNode>(schema, table_info->GetTableName(), predicate);
+  auto update_plan = std::make_shared<UpdatePlanNode>(schema, update_scan_plan, "table-1", update_attrs);
+  // a moved tuple is updated once, though the scan reaches its new page later
+  std::vector<Row> updated{};
+  GetExecutionEngine()->ExecutePlan(update_plan, &updated, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(before.size(), updated.size());
+
+  std::vector<Row> after{};
+  GetExecutionEngine()->ExecutePlan(scan_plan, &after, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(20, after.size());
+  std::unordered_map<int64_t, RowId> old_rids;
+  for (auto &row : before) {
+    old_rids.emplace(row.GetRowId().Get(), row.GetRowId());
+  }
+  uint32_t moved = 0;
+  for (auto &row : after) {
+    ASSERT_EQ(name, row.GetField(1)->toString());
+    moved += old_rids.count(row.GetRowId().Get()) == 0;
+    // the index follows the tuple to its new place
+    std::vector<RowId> rids;
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(Row(std::vector<Field>{*row.GetField(0)}), rids, GetTxn()));
+    ASSERT_EQ(1, rids.size());
+    ASSERT_EQ(row.GetRowId(), rids[0]);
+  }
+  ASSERT_GT(moved, 0);
+  ASSERT_TRUE(GetExecutorContext()->GetBufferPoolManager()->CheckAllUnpinned());
+}
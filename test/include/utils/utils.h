@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "record/row.h"
 #include "storage/disk_manager.h"
 
 template <typename T>
@@ -42,4 +43,29 @@ class RandomUtils {
   }
 };
 
+/**
+ * Serialize fields the way Row::SerializeTo did before the compact row format, to test reading old database files.
+ * @return serialized size of the row
+ */
+inline uint32_t SerializeLegacyRow(const std::vector<Field> &fields, char *buf) {
+  uint32_t ofs = 0;
+  uint32_t num = fields.size();
+  uint32_t psize = (num + 7) / 8;
+  MACH_WRITE_TO(uint32_t, buf + ofs, Row::ROW_MAGIC_NUM);
+  ofs += sizeof(uint32_t);
+  MACH_WRITE_TO(uint32_t, buf + ofs, num);
+  ofs += sizeof(uint32_t);
+  memset(buf + ofs, 0, psize);
+  for (uint32_t i = 0; i < num; i++) {
+    if (fields[i].IsNull()) {
+      buf[ofs + i / 8] |= static_cast<char>(1 << (7 - i % 8));
+    }
+  }
+  ofs += psize;
+  for (auto &field : fields) {
+    ofs += field.SerializeTo(buf + ofs);
+  }
+  return ofs;
+}
+
 #endif  // MINISQL_UTILS_H
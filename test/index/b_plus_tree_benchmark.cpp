@@ -0,0 +1,92 @@
+#include "index/b_plus_tree.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/key_sorter.h"
+#include "utils/utils.h"
+
+static const std::string db_name = "bp_tree_benchmark.db";
+
+TEST(BPlusTreeBenchmark, ConcurrentInsertTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {
+      new Column("int", TypeId::kTypeInt, 0, false, false),
+  };
+  Schema *table_schema = new Schema(columns);
+  KeyManager KP(table_schema, 8);
+  const int n = 40000;
+  const int max_threads = std::max(2, std::min(8, static_cast<int>(std::thread::hardware_concurrency())));
+  for (int threads = 1; threads <= max_threads; threads *= 2) {
+    BPlusTree tree(threads, engine.bpm_, KP);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+      workers.emplace_back([&, t] {
+        GenericKey *key = KP.InitKey();
+        vector<RowId> ans;
+        // 7919 is prime to n, the threads insert interleaved keys into the same leaves
+        for (int i = t; i < n; i += threads) {
+          int value = static_cast<int>(static_cast<int64_t>(i) * 7919 % n);
+          std::vector<Field> fields{Field(TypeId::kTypeInt, value)};
+          KP.SerializeFromKey(key, Row(fields), table_schema);
+          ans.clear();
+          tree.Insert(key, RowId(value));
+          tree.GetValue(key, ans);
+        }
+        free(key);
+      });
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%d threads: %.0f inserts and lookups per second\n", threads, 2 * n / seconds);
+  }
+  delete table_schema;
+}
+
+TEST(BPlusTreeBenchmark, BulkLoadTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {
+      new Column("int", TypeId::kTypeInt, 0, false, false),
+  };
+  Schema *table_schema = new Schema(columns);
+  KeyManager KP(table_schema, 8);
+  GenericKey *key = KP.InitKey();
+  auto set_key = [&](int value) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, value)};
+    KP.SerializeFromKey(key, Row(fields), table_schema);
+  };
+  // bottom up build against inserts one by one
+  const int n = 50000;
+  vector<int> values;
+  for (int i = 0; i < n; i++) {
+    values.push_back(i);
+  }
+  ShuffleArray(values);
+  auto start = std::chrono::steady_clock::now();
+  BPlusTree inserted(0, engine.bpm_, KP);
+  for (int value : values) {
+    set_key(value);
+    inserted.Insert(key, RowId(value));
+  }
+  auto insert_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  start = std::chrono::steady_clock::now();
+  KeySorter sorter(KP);
+  for (int value : values) {
+    set_key(value);
+    sorter.Add(key, RowId(value));
+  }
+  sorter.Finish();
+  BPlusTree loaded(1, engine.bpm_, KP);
+  loaded.BulkLoad(&sorter);
+  auto load_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  printf("%d keys: inserted in %.3fs, bulk loaded in %.3fs\n", n, insert_time, load_time);
+  free(key);
+  delete table_schema;
+}
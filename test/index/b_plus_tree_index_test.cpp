@@ -1,10 +1,13 @@
 #include "index/b_plus_tree_index.h"
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 
 #include "common/instance.h"
 #include "gtest/gtest.h"
 #include "index/generic_key.h"
+#include "utils/utils.h"
 
 static const std::string db_name = "bp_tree_index_test.db";
 
@@ -67,4 +70,265 @@ TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
     i++;
   }
   delete index;
-}
\ No newline at end of file
+}
+TEST(BPlusTreeTests, MemcomparableKeyTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, true, false),
+                                   new Column("name", TypeId::kTypeChar, 8, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  const TableSchema table_schema(columns);
+  auto *key_schema = Schema::ShallowCopySchema(&table_schema, {0, 1, 2});
+  // null flag + int, null flag + 8 padded bytes + length, null flag + float
+  ASSERT_EQ(5 + 11 + 5, KeyManager::GetEncodedSize(key_schema));
+  KeyManager KP(key_schema, 32);
+  std::vector<Field> ints{Field(TypeId::kTypeInt),          Field(TypeId::kTypeInt, INT32_MIN),
+                          Field(TypeId::kTypeInt, -65537),  Field(TypeId::kTypeInt, -1),
+                          Field(TypeId::kTypeInt, 0),       Field(TypeId::kTypeInt, 255),
+                          Field(TypeId::kTypeInt, 256),     Field(TypeId::kTypeInt, INT32_MAX)};
+  std::vector<Field> chars{Field(TypeId::kTypeChar),
+                           Field(TypeId::kTypeChar, const_cast<char *>(""), 0, true),
+                           Field(TypeId::kTypeChar, const_cast<char *>("\0"), 1, true),
+                           Field(TypeId::kTypeChar, const_cast<char *>("\0\0"), 2, true),
+                           Field(TypeId::kTypeChar, const_cast<char *>("a"), 1, true),
+                           Field(TypeId::kTypeChar, const_cast<char *>("a\0"), 2, true),
+                           Field(TypeId::kTypeChar, const_cast<char *>("ab"), 2, true),
+                           Field(TypeId::kTypeChar, const_cast<char *>("b"), 1, true),
+                           Field(TypeId::kTypeChar, const_cast<char *>("\xff\xff\xff\xff\xff\xff\xff\xff"), 8, true)};
+  std::vector<Field> floats{Field(TypeId::kTypeFloat),         Field(TypeId::kTypeFloat, -1e30f),
+                            Field(TypeId::kTypeFloat, -2.5f),  Field(TypeId::kTypeFloat, -1e-30f),
+                            Field(TypeId::kTypeFloat, 0.0f),   Field(TypeId::kTypeFloat, 1e-30f),
+                            Field(TypeId::kTypeFloat, 2.5f),   Field(TypeId::kTypeFloat, 1e30f)};
+  // every list is ascending with null first, keys of the same column compare like their values
+  auto check_order = [&](const std::vector<Field> &values, uint32_t column) {
+    for (size_t i = 0; i < values.size(); i++) {
+      for (size_t j = 0; j < values.size(); j++) {
+        std::vector<Field> lhs_fields{ints[4], chars[4], floats[4]};
+        std::vector<Field> rhs_fields{ints[4], chars[4], floats[4]};
+        lhs_fields[column] = values[i];
+        rhs_fields[column] = values[j];
+        GenericKey *lhs = KP.InitKey();
+        GenericKey *rhs = KP.InitKey();
+        KP.SerializeFromKey(lhs, Row(lhs_fields), key_schema);
+        KP.SerializeFromKey(rhs, Row(rhs_fields), key_schema);
+        int cmp = KP.CompareKeys(lhs, rhs);
+        ASSERT_EQ(i < j, cmp < 0) << "column " << column << " " << i << " " << j;
+        ASSERT_EQ(i == j, cmp == 0) << "column " << column << " " << i << " " << j;
+        // the key decodes back to its row
+        Row decoded;
+        KP.DeserializeToKey(lhs, decoded, key_schema);
+        ASSERT_EQ(values[i].IsNull(), decoded.GetField(column)->IsNull());
+        if (!values[i].IsNull()) {
+          ASSERT_EQ(CmpBool::kTrue, decoded.GetField(column)->CompareEquals(values[i]));
+        }
+        free(lhs);
+        free(rhs);
+      }
+    }
+  };
+  check_order(ints, 0);
+  check_order(chars, 1);
+  check_order(floats, 2);
+  // the first column decides before the later ones
+  GenericKey *lhs = KP.InitKey();
+  GenericKey *rhs = KP.InitKey();
+  KP.SerializeFromKey(lhs, Row(std::vector<Field>{ints[4], chars[8], floats[7]}), key_schema);
+  KP.SerializeFromKey(rhs, Row(std::vector<Field>{ints[5], chars[1], floats[1]}), key_schema);
+  ASSERT_GT(0, KP.CompareKeys(lhs, rhs));
+  // -0.0 and 0.0 are the same key
+  KP.SerializeFromKey(lhs, Row(std::vector<Field>{ints[4], chars[4], Field(TypeId::kTypeFloat, -0.0f)}), key_schema);
+  KP.SerializeFromKey(rhs, Row(std::vector<Field>{ints[4], chars[4], floats[4]}), key_schema);
+  ASSERT_EQ(0, KP.CompareKeys(lhs, rhs));
+  free(lhs);
+  free(rhs);
+  delete key_schema;
+}
+
+TEST(BPlusTreeTests, RangeScanTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, {0});
+  auto *index = new BPlusTreeIndex(0, index_schema, 8, engine.bpm_);
+  // even keys from 0 to 2 * (n - 1), spread over several leaves
+  const int n = 2000;
+  for (int i = 0; i < n; i++) {
+    Row row(std::vector<Field>{Field(TypeId::kTypeInt, 2 * i)});
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(row, RowId(i), nullptr));
+  }
+  auto key = [](int value) { return Row(std::vector<Field>{Field(TypeId::kTypeInt, value)}); };
+  auto scan = [&](const Row *lower, const Row *upper, bool lower_inclusive, bool upper_inclusive) {
+    std::vector<int64_t> ids;
+    auto cursor = index->Scan(lower, upper, lower_inclusive, upper_inclusive, nullptr);
+    RowId row_id;
+    while (cursor->Next(&row_id)) {
+      ids.push_back(row_id.Get());
+    }
+    return ids;
+  };
+  auto range = [](int64_t first, int64_t last) {
+    std::vector<int64_t> ids;
+    for (int64_t i = first; i <= last; i++) {
+      ids.push_back(i);
+    }
+    return ids;
+  };
+  Row k100 = key(100), k101 = key(101), k3000 = key(3000), k_low = key(-5), k_high = key(2 * n);
+  ASSERT_EQ(range(0, n - 1), scan(nullptr, nullptr, true, true));
+  ASSERT_EQ(range(50, 1500), scan(&k100, &k3000, true, true));
+  ASSERT_EQ(range(51, 1499), scan(&k100, &k3000, false, false));
+  ASSERT_EQ(range(51, 1500), scan(&k101, &k3000, false, true));
+  ASSERT_EQ(range(50, 50), scan(&k100, &k100, true, true));
+  ASSERT_TRUE(scan(&k100, &k100, false, true).empty());
+  ASSERT_TRUE(scan(&k101, &k101, true, true).empty());
+  ASSERT_TRUE(scan(&k3000, &k100, true, true).empty());
+  ASSERT_EQ(range(0, 49), scan(nullptr, &k100, true, false));
+  ASSERT_EQ(range(1500, n - 1), scan(&k3000, nullptr, true, true));
+  ASSERT_TRUE(scan(&k_high, nullptr, true, true).empty());
+  ASSERT_TRUE(scan(nullptr, &k_low, true, true).empty());
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  // a cursor stopped early keeps only its current leaf pinned until it is destroyed
+  {
+    auto cursor = index->Scan(&k100, nullptr, true, true, nullptr);
+    RowId row_id;
+    for (int i = 0; i < 10; i++) {
+      ASSERT_TRUE(cursor->Next(&row_id));
+      ASSERT_EQ(50 + i, row_id.Get());
+    }
+    ASSERT_FALSE(engine.bpm_->CheckAllUnpinned());
+  }
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  // the comparisons of ScanKey
+  std::vector<RowId> ret;
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(k100, ret, nullptr, "<>"));
+  ASSERT_EQ(static_cast<size_t>(n - 1), ret.size());
+  ret.clear();
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(k100, ret, nullptr, "<="));
+  ASSERT_EQ(51u, ret.size());
+  ret.clear();
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(k100, ret, nullptr, ">"));
+  ASSERT_EQ(static_cast<size_t>(n - 51), ret.size());
+  ret.clear();
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(k101, ret, nullptr, "="));
+  delete index;
+}
+
+TEST(BPlusTreeTests, NonUniqueIndexTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {new Column("status", TypeId::kTypeInt, 0, false, false)};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, {0});
+  // 5 bytes of the int and 8 of the row id
+  ASSERT_EQ(5u, KeyManager::GetEncodedSize(index_schema));
+  auto *index = new BPlusTreeIndex(0, index_schema, 16, engine.bpm_, false);
+  auto key = [](int value) { return Row(std::vector<Field>{Field(TypeId::kTypeInt, value)}); };
+  // 10 statuses of 300 rows each, inserted in a shuffled order
+  const int n = 3000;
+  std::vector<int> rows;
+  for (int i = 0; i < n; i++) {
+    rows.push_back(i);
+  }
+  ShuffleArray(rows);
+  for (int i : rows) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(key(i % 10), RowId(i / 100, i % 100), nullptr));
+  }
+  // a duplicate of both the key and the row id is refused
+  ASSERT_EQ(DB_FAILED, index->InsertEntry(key(3), RowId(0, 3), nullptr));
+  // the point lookup returns every row of the key in row id order
+  std::vector<RowId> ret;
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(key(3), ret, nullptr));
+  ASSERT_EQ(300u, ret.size());
+  for (size_t i = 0; i < ret.size(); i++) {
+    ASSERT_EQ(3u, (ret[i].GetPageId() * 100 + ret[i].GetSlotNum()) % 10);
+    if (i > 0) {
+      ASSERT_TRUE(ret[i - 1] < ret[i]);
+    }
+  }
+  ret.clear();
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(key(10), ret, nullptr));
+  // the bounds take in or leave out every row of their key
+  auto count = [](Index *scanned, const Row *lower, const Row *upper, bool lower_inclusive, bool upper_inclusive) {
+    auto cursor = scanned->Scan(lower, upper, lower_inclusive, upper_inclusive, nullptr);
+    RowId row_id;
+    int rows_read = 0;
+    while (cursor->Next(&row_id)) {
+      rows_read++;
+    }
+    return rows_read;
+  };
+  Row k2 = key(2), k5 = key(5);
+  ASSERT_EQ(1200, count(index, &k2, &k5, true, true));
+  ASSERT_EQ(600, count(index, &k2, &k5, false, false));
+  ASSERT_EQ(900, count(index, &k2, &k5, true, false));
+  ASSERT_EQ(1500, count(index, nullptr, &k5, true, false));
+  ASSERT_EQ(1500, count(index, &k5, nullptr, true, true));
+  // removing an entry leaves the other rows of its key
+  ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(key(3), RowId(0, 3), nullptr));
+  ret.clear();
+  index->ScanKey(key(3), ret, nullptr);
+  ASSERT_EQ(299u, ret.size());
+  ASSERT_TRUE(std::find(ret.begin(), ret.end(), RowId(0, 3)) == ret.end());
+  // a bulk build keeps every row of a key
+  auto *built = new BPlusTreeIndex(1, index_schema, 16, engine.bpm_, false);
+  int next_row = 0;
+  built->BuildFrom(
+      [&](Row &row_key, RowId &row_id) {
+        if (next_row == n) {
+          return false;
+        }
+        row_key = key(next_row % 10);
+        row_id = RowId(next_row / 100, next_row % 100);
+        next_row++;
+        return true;
+      },
+      nullptr);
+  ASSERT_EQ(n, count(built, nullptr, nullptr, true, true));
+  ret.clear();
+  built->ScanKey(key(7), ret, nullptr);
+  ASSERT_EQ(300u, ret.size());
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  delete built;
+  delete index;
+}
+
+TEST(BPlusTreeTests, OverlongCharKeyTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {new Column("name", TypeId::kTypeChar, 4, 0, false, false)};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, {0});
+  auto key = [](const char *value) {
+    return Row(std::vector<Field>{Field(TypeId::kTypeChar, const_cast<char *>(value), strlen(value), true)});
+  };
+  const char *names[] = {"abc", "abcd", "abce", "b"};
+  // a constant longer than the column, e.g. from name = "abcdefgh" on a char(4) column
+  Row overlong = key("abcdefgh");
+  // the unique key takes the whole encoded width, the non unique one is followed by the row id
+  for (bool unique : {true, false}) {
+    auto *index = new BPlusTreeIndex(unique ? 0 : 1, index_schema, 16, engine.bpm_, unique);
+    for (int i = 0; i < 4; i++) {
+      ASSERT_EQ(DB_SUCCESS, index->InsertEntry(key(names[i]), RowId(0, i), nullptr));
+    }
+    std::vector<RowId> ret;
+    ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(overlong, ret, nullptr, "="));
+    ASSERT_TRUE(ret.empty());
+    // the stored values below "abcdefgh" are abc and abcd, the ones above abce and b
+    for (const char *op : {"<", "<=", ">", ">="}) {
+      ret.clear();
+      ASSERT_EQ(DB_SUCCESS, index->ScanKey(overlong, ret, nullptr, op));
+      std::sort(ret.begin(), ret.end());
+      RowId first = op[0] == '<' ? RowId(0, 0) : RowId(0, 2);
+      ASSERT_EQ(2u, ret.size()) << op;
+      ASSERT_EQ(first, ret[0]) << op;
+      ASSERT_EQ(RowId(first.GetPageId(), first.GetSlotNum() + 1), ret[1]) << op;
+    }
+    ret.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(overlong, ret, nullptr, "<>"));
+    ASSERT_EQ(4u, ret.size());
+    for (bool lower_inclusive : {true, false}) {
+      for (bool upper_inclusive : {true, false}) {
+        auto cursor = index->Scan(&overlong, &overlong, lower_inclusive, upper_inclusive, nullptr);
+        RowId row_id;
+        ASSERT_FALSE(cursor->Next(&row_id));
+      }
+    }
+    delete index;
+  }
+}
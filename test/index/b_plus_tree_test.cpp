@@ -1,8 +1,14 @@
 #include "index/b_plus_tree.h"
 
+#include <atomic>
+#include <thread>
+
 #include "common/instance.h"
 #include "gtest/gtest.h"
 #include "index/comparator.h"
+#include "index/key_search.h"
+#include "index/key_sorter.h"
+#include "page/index_roots_page.h"
 #include "utils/tree_file_mgr.h"
 #include "utils/utils.h"
 
@@ -72,3 +78,557 @@ TEST(BPlusTreeTests, SampleTest) {
     ASSERT_EQ(kv_map[delete_seq[i]], ans[ans.size() - 1]);
   }
 }
+
+TEST(BPlusTreeTests, PackedKeyTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {
+      new Column("int", TypeId::kTypeInt, 0, false, false),
+  };
+  Schema *table_schema = new Schema(columns);
+  KeyManager KP(table_schema, 8);
+  ASSERT_TRUE(KP.IsPacked());
+  const int n = 5000;
+  vector<int> values;
+  for (int i = 0; i < n; i++) {
+    values.push_back(i * 7 - n * 3);
+  }
+  // pages filled by the key size, and tiny pages for a deep tree
+  vector<std::pair<int, int>> max_sizes{{UNDEFINED_SIZE, UNDEFINED_SIZE}, {4, 3}};
+  for (uint32_t t = 0; t < max_sizes.size(); t++) {
+    BPlusTree tree(t, engine.bpm_, KP, max_sizes[t].first, max_sizes[t].second);
+    GenericKey *key = KP.InitKey();
+    auto set_key = [&](int value) {
+      std::vector<Field> fields{Field(TypeId::kTypeInt, value)};
+      KP.SerializeFromKey(key, Row(fields), table_schema);
+    };
+    ShuffleArray(values);
+    for (int value : values) {
+      set_key(value);
+      ASSERT_TRUE(tree.Insert(key, RowId(value)));
+    }
+    set_key(values[0]);
+    ASSERT_FALSE(tree.Insert(key, RowId(0)));
+    ASSERT_TRUE(tree.Check());
+    // ordered scan
+    int count = 0;
+    int last = INT32_MIN;
+    for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+      int value = static_cast<int>((*iter).second.Get());
+      ASSERT_LT(last, value);
+      last = value;
+      count++;
+    }
+    ASSERT_EQ(n, count);
+    // remove two thirds of the keys
+    ShuffleArray(values);
+    for (int i = 0; i < n; i++) {
+      if (i % 3 != 0) {
+        set_key(values[i]);
+        tree.Remove(key);
+      }
+    }
+    ASSERT_TRUE(tree.Check());
+    vector<RowId> ans;
+    for (int i = 0; i < n; i++) {
+      set_key(values[i]);
+      ans.clear();
+      ASSERT_EQ(i % 3 == 0, tree.GetValue(key, ans));
+      if (i % 3 == 0) {
+        ASSERT_EQ(values[i], static_cast<int>(ans[0].Get()));
+      }
+    }
+    // the range scan starts at the first key not less than the search key
+    set_key(values[0] - 1);
+    auto iter = tree.Begin(key);
+    ASSERT_TRUE(iter != tree.End());
+    ASSERT_LE(values[0], static_cast<int>((*iter).second.Get()));
+    iter = tree.End();
+    for (int i = 0; i < n; i += 3) {
+      set_key(values[i]);
+      tree.Remove(key);
+    }
+    ASSERT_TRUE(tree.IsEmpty());
+    ASSERT_TRUE(tree.Check());
+    free(key);
+  }
+  delete table_schema;
+}
+
+TEST(BPlusTreeTests, BulkLoadTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {
+      new Column("int", TypeId::kTypeInt, 0, false, false),
+  };
+  Schema *table_schema = new Schema(columns);
+  KeyManager KP(table_schema, 8);
+  GenericKey *key = KP.InitKey();
+  auto set_key = [&](int value) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, value)};
+    KP.SerializeFromKey(key, Row(fields), table_schema);
+  };
+  struct Case {
+    int n;
+    int leaf_max_size;
+    int internal_max_size;
+    double fill_factor;
+    size_t memory_budget;
+  };
+  // empty and single page trees, trees of tiny pages at several fill factors, and sorts spilled to many runs
+  vector<Case> cases{{0, UNDEFINED_SIZE, UNDEFINED_SIZE, 0.9, INDEX_SORT_BUFFER_SIZE},
+                     {1, UNDEFINED_SIZE, UNDEFINED_SIZE, 0.9, INDEX_SORT_BUFFER_SIZE},
+                     {5, 4, 3, 0.9, INDEX_SORT_BUFFER_SIZE},
+                     {2000, 4, 3, 1.0, INDEX_SORT_BUFFER_SIZE},
+                     {2000, 6, 5, 0.5, 1000},
+                     {2001, 5, 4, 0.7, 1000},
+                     {10000, UNDEFINED_SIZE, UNDEFINED_SIZE, 0.9, 16 << 10}};
+  for (uint32_t t = 0; t < cases.size(); t++) {
+    const Case &c = cases[t];
+    vector<int> values;
+    for (int i = 0; i < c.n; i++) {
+      values.push_back(i * 7 - c.n * 3);
+    }
+    ShuffleArray(values);
+    KeySorter sorter(KP, c.memory_budget);
+    for (int value : values) {
+      set_key(value);
+      sorter.Add(key, RowId(value));
+    }
+    // a duplicate key keeps the entry of the smallest row id
+    if (c.n > 0) {
+      set_key(values[0]);
+      sorter.Add(key, RowId(INT32_MAX));
+    }
+    sorter.Finish();
+    ASSERT_EQ(c.memory_budget < INDEX_SORT_BUFFER_SIZE, sorter.GetRunCount() > 1);
+    BPlusTree tree(t, engine.bpm_, KP, c.leaf_max_size, c.internal_max_size);
+    tree.BulkLoad(&sorter, c.fill_factor);
+    ASSERT_EQ(c.n == 0, tree.IsEmpty());
+    ASSERT_TRUE(tree.Check());
+    int count = 0;
+    int last = INT32_MIN;
+    for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+      int value = static_cast<int>((*iter).second.Get());
+      ASSERT_LT(last, value);
+      last = value;
+      count++;
+    }
+    ASSERT_EQ(c.n, count);
+    vector<RowId> ans;
+    for (int value : values) {
+      set_key(value);
+      ans.clear();
+      ASSERT_TRUE(tree.GetValue(key, ans));
+      ASSERT_EQ(value, static_cast<int>(ans[0].Get()));
+    }
+    // the loaded tree keeps the invariants of inserts and removes
+    set_key(c.n * 7);
+    ASSERT_TRUE(tree.Insert(key, RowId(c.n * 7)));
+    tree.Remove(key);
+    for (int value : values) {
+      set_key(value);
+      tree.Remove(key);
+    }
+    ASSERT_TRUE(tree.IsEmpty());
+    ASSERT_TRUE(tree.Check());
+  }
+  // bottom up build against inserts one by one
+  const int n = 50000;
+  vector<int> values;
+  for (int i = 0; i < n; i++) {
+    values.push_back(i);
+  }
+  ShuffleArray(values);
+  BPlusTree inserted(cases.size(), engine.bpm_, KP);
+  for (int value : values) {
+    set_key(value);
+    ASSERT_TRUE(inserted.Insert(key, RowId(value)));
+  }
+  KeySorter sorter(KP);
+  for (int value : values) {
+    set_key(value);
+    sorter.Add(key, RowId(value));
+  }
+  sorter.Finish();
+  BPlusTree loaded(cases.size() + 1, engine.bpm_, KP);
+  loaded.BulkLoad(&sorter);
+  // the leaves from left to right hold the keys in order
+  auto leaf_sizes = [&](BPlusTree &tree) {
+    vector<int> sizes;
+    int next = 0;
+    Page *page = tree.FindLeafPage(key, INVALID_PAGE_ID, true);
+    while (page != nullptr) {
+      auto *leaf = reinterpret_cast<BPlusTreeLeafPage *>(page->GetData());
+      for (int i = 0; i < leaf->GetSize(); i++) {
+        EXPECT_EQ(next++, static_cast<int>(leaf->ValueAt(i).Get()));
+      }
+      sizes.push_back(leaf->GetSize());
+      page_id_t next_page_id = leaf->GetNextPageId();
+      engine.bpm_->UnpinPage(page->GetPageId(), false);
+      page = next_page_id == INVALID_PAGE_ID ? nullptr : engine.bpm_->FetchPage(next_page_id);
+    }
+    EXPECT_EQ(n, next);
+    return sizes;
+  };
+  vector<int> loaded_sizes = leaf_sizes(loaded);
+  vector<int> inserted_sizes = leaf_sizes(inserted);
+  // every leaf but the last two is filled to the fill factor, the last two share what is left
+  int max_size = BPlusTreeLeafPage::GetMaxCapacity(KP.GetKeySize());
+  int fill_size = std::max(static_cast<int>(max_size * INDEX_FILL_FACTOR), max_size / 2);
+  ASSERT_LE(2u, loaded_sizes.size());
+  for (size_t i = 0; i + 2 < loaded_sizes.size(); i++) {
+    ASSERT_EQ(fill_size, loaded_sizes[i]) << "leaf " << i;
+  }
+  ASSERT_LE(max_size / 2, loaded_sizes[loaded_sizes.size() - 2]);
+  ASSERT_LE(max_size / 2, loaded_sizes.back());
+  // random inserts leave the leaves emptier than the build
+  ASSERT_LT(loaded_sizes.size(), inserted_sizes.size());
+  vector<RowId> ans;
+  for (int i = 0; i < n; i++) {
+    set_key(i);
+    ans.clear();
+    ASSERT_TRUE(loaded.GetValue(key, ans)) << i;
+    ASSERT_EQ(i, static_cast<int>(ans[0].Get()));
+  }
+  ASSERT_TRUE(inserted.Check());
+  ASSERT_TRUE(loaded.Check());
+  free(key);
+  delete table_schema;
+}
+
+TEST(BPlusTreeTests, KeySearchTest) {
+  std::vector<Column *> columns = {
+      new Column("int", TypeId::kTypeInt, 0, false, false),
+  };
+  Schema *schema = new Schema(columns);
+  KeyManager packed(schema, 8);
+  KeyManager bytes(schema, 16);
+  GenericKey *packed_key = packed.InitKey();
+  GenericKey *bytes_key = bytes.InitKey();
+  vector<bool> simd_modes{false};
+  if (KeySearch::SetSimd(true)) {
+    simd_modes.push_back(true);
+  }
+  for (int size : {0, 1, 3, 4, 15, 16, 17, 33, 100, 500}) {
+    vector<int> sorted;
+    for (int i = 0; i < size; i++) {
+      // duplicates and negative values
+      sorted.push_back(RandomUtils::RandomInt(-50, 50) * 3);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    vector<char> packed_keys(size * 8 + 1);
+    vector<char> bytes_keys(size * 16 + 1);
+    for (int i = 0; i < size; i++) {
+      std::vector<Field> fields{Field(TypeId::kTypeInt, sorted[i])};
+      packed.SerializeFromKey(reinterpret_cast<GenericKey *>(packed_keys.data() + i * 8), Row(fields), schema);
+      bytes.SerializeFromKey(reinterpret_cast<GenericKey *>(bytes_keys.data() + i * 16), Row(fields), schema);
+    }
+    for (bool simd : simd_modes) {
+      ASSERT_TRUE(KeySearch::SetSimd(simd));
+      for (int probe = -160; probe <= 160; probe++) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, probe)};
+        packed.SerializeFromKey(packed_key, Row(fields), schema);
+        bytes.SerializeFromKey(bytes_key, Row(fields), schema);
+        int lower = std::lower_bound(sorted.begin(), sorted.end(), probe) - sorted.begin();
+        int upper = std::upper_bound(sorted.begin(), sorted.end(), probe) - sorted.begin();
+        ASSERT_EQ(lower, KeySearch::LowerBound(packed_keys.data(), size, packed_key, packed));
+        ASSERT_EQ(upper, KeySearch::UpperBound(packed_keys.data(), size, packed_key, packed));
+        ASSERT_EQ(lower, KeySearch::LowerBound(bytes_keys.data(), size, bytes_key, bytes));
+        ASSERT_EQ(upper, KeySearch::UpperBound(bytes_keys.data(), size, bytes_key, bytes));
+      }
+    }
+  }
+  KeySearch::SetSimd(true);
+  free(packed_key);
+  free(bytes_key);
+  delete schema;
+}
+
+TEST(BPlusTreeTests, ConcurrentInsertTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {
+      new Column("int", TypeId::kTypeInt, 0, false, false),
+  };
+  Schema *table_schema = new Schema(columns);
+  KeyManager KP(table_schema, 8);
+  const int n = 40000;
+  const int max_threads = std::max(2, std::min(8, static_cast<int>(std::thread::hardware_concurrency())));
+  for (int threads = 1; threads <= max_threads; threads *= 2) {
+    BPlusTree tree(threads, engine.bpm_, KP);
+    std::atomic<int> failures{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+      workers.emplace_back([&, t] {
+        GenericKey *key = KP.InitKey();
+        vector<RowId> ans;
+        // 7919 is prime to n, the threads insert interleaved keys into the same leaves
+        for (int i = t; i < n; i += threads) {
+          int value = static_cast<int>(static_cast<int64_t>(i) * 7919 % n);
+          std::vector<Field> fields{Field(TypeId::kTypeInt, value)};
+          KP.SerializeFromKey(key, Row(fields), table_schema);
+          ans.clear();
+          if (!tree.Insert(key, RowId(value)) || !tree.GetValue(key, ans) || ans[0].Get() != value) {
+            failures++;
+          }
+        }
+        free(key);
+      });
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    ASSERT_EQ(0, failures.load());
+    // every key is found once all threads are done, and the leaves hold the keys in order
+    GenericKey *key = KP.InitKey();
+    vector<RowId> ans;
+    for (int i = 0; i < n; i++) {
+      std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+      KP.SerializeFromKey(key, Row(fields), table_schema);
+      ans.clear();
+      ASSERT_TRUE(tree.GetValue(key, ans)) << threads << " threads, key " << i;
+      ASSERT_EQ(1u, ans.size());
+      ASSERT_EQ(i, static_cast<int>(ans[0].Get()));
+    }
+    free(key);
+    int count = 0;
+    for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+      ASSERT_EQ(count, static_cast<int>((*iter).second.Get()));
+      count++;
+    }
+    ASSERT_EQ(n, count);
+    ASSERT_TRUE(tree.Check());
+  }
+  delete table_schema;
+}
+
+TEST(BPlusTreeTests, ConcurrentMixedTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {
+      new Column("int", TypeId::kTypeInt, 0, false, false),
+  };
+  Schema *table_schema = new Schema(columns);
+  KeyManager KP(table_schema, 8);
+  // small pages, most operations split or merge pages
+  BPlusTree tree(0, engine.bpm_, KP, 8, 6);
+  const int n = 3000;
+  const int threads = 4;
+  GenericKey *key = KP.InitKey();
+  auto set_key = [&](GenericKey *key, int value) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, value)};
+    KP.SerializeFromKey(key, Row(fields), table_schema);
+  };
+  for (int i = 0; i < n; i++) {
+    set_key(key, i);
+    ASSERT_TRUE(tree.Insert(key, RowId(i)));
+  }
+  // removers take the even keys, inserters add [n, 2n), readers find the odd keys and scan in order
+  std::atomic<int> failures{0};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&, t] {
+      GenericKey *key = KP.InitKey();
+      for (int i = t * 2; i < n; i += threads * 2) {
+        set_key(key, i);
+        tree.Remove(key);
+      }
+      free(key);
+    });
+    workers.emplace_back([&, t] {
+      GenericKey *key = KP.InitKey();
+      for (int i = n + t; i < 2 * n; i += threads) {
+        set_key(key, i);
+        if (!tree.Insert(key, RowId(i))) {
+          failures++;
+        }
+      }
+      free(key);
+    });
+    workers.emplace_back([&, t] {
+      GenericKey *key = KP.InitKey();
+      vector<RowId> ans;
+      for (int i = t * 2 + 1; i < n; i += threads * 2) {
+        set_key(key, i);
+        ans.clear();
+        if (!tree.GetValue(key, ans) || ans[0].Get() != i) {
+          failures++;
+        }
+      }
+      int64_t last = -1;
+      for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+        if ((*iter).second.Get() <= last) {
+          failures++;
+        }
+        last = (*iter).second.Get();
+      }
+      free(key);
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  ASSERT_EQ(0, failures.load());
+  vector<RowId> ans;
+  for (int i = 0; i < 2 * n; i++) {
+    set_key(key, i);
+    ans.clear();
+    ASSERT_EQ(i >= n || i % 2 == 1, tree.GetValue(key, ans));
+  }
+  ASSERT_TRUE(tree.Check());
+  free(key);
+  delete table_schema;
+}
+
+TEST(BPlusTreeTests, PrefixCompressionTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {
+      new Column("name", TypeId::kTypeChar, 64, 0, false, false),
+  };
+  Schema *table_schema = new Schema(columns);
+  KeyManager KP(table_schema, 68);
+  GenericKey *key = KP.InitKey();
+  auto set_key = [&](const std::string &prefix, int value) {
+    char digits[16];
+    snprintf(digits, sizeof(digits), "%06d", value);
+    std::string name = prefix + digits;
+    std::vector<Field> fields{Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+    KP.SerializeFromKey(key, Row(fields), table_schema);
+  };
+  auto count_leaves = [&](BPlusTree &tree) {
+    int leaves = 0;
+    page_id_t page_id = tree.FindLeafPage(nullptr, INVALID_PAGE_ID, true)->GetPageId();
+    engine.bpm_->UnpinPage(page_id, false);
+    while (page_id != INVALID_PAGE_ID) {
+      auto *leaf = reinterpret_cast<BPlusTreeLeafPage *>(engine.bpm_->FetchPage(page_id)->GetData());
+      leaves++;
+      engine.bpm_->UnpinPage(page_id, false);
+      page_id = leaf->GetNextPageId();
+    }
+    return leaves;
+  };
+  // keys sharing their first 48 characters, a leaf without the prefix takes no more than this many
+  const std::string prefix = "warehouse/region-eu-west/aisle-0042/shelf-00017/";
+  const int n = 20000;
+  const int uncompressed = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / (68 + sizeof(RowId)) - 1;
+  vector<int> values;
+  for (int i = 0; i < n; i++) {
+    values.push_back(i);
+  }
+  ShuffleArray(values);
+  BPlusTree tree(0, engine.bpm_, KP);
+  for (int value : values) {
+    set_key(prefix, value);
+    ASSERT_TRUE(tree.Insert(key, RowId(value)));
+  }
+  ASSERT_LT(count_leaves(tree), n / uncompressed / 2);
+  // keys of other prefixes come before and after the leaves of the shared one
+  for (int i = 0; i < 300; i++) {
+    set_key("a/", i);
+    ASSERT_TRUE(tree.Insert(key, RowId(n + i)));
+    set_key("z/", i);
+    ASSERT_TRUE(tree.Insert(key, RowId(n + 300 + i)));
+  }
+  vector<RowId> ans;
+  for (int i = 0; i < n; i++) {
+    set_key(prefix, i);
+    ans.clear();
+    ASSERT_TRUE(tree.GetValue(key, ans));
+    ASSERT_EQ(i, static_cast<int>(ans[0].Get()));
+  }
+  set_key(prefix, n);
+  ASSERT_FALSE(tree.GetValue(key, ans));
+  // the leaves put their keys back together in order
+  std::string last;
+  int count = 0;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    Row row;
+    KP.DeserializeToKey((*iter).first, row, table_schema);
+    std::string name(row.GetField(0)->GetData(), row.GetField(0)->GetLength());
+    ASSERT_LT(last, name);
+    last = name;
+    count++;
+  }
+  ASSERT_EQ(n + 600, count);
+  // removes merge the leaves of keys sharing prefixes
+  for (int value : values) {
+    if (value % 4 != 0) {
+      set_key(prefix, value);
+      tree.Remove(key);
+    }
+  }
+  for (int i = 0; i < n; i++) {
+    set_key(prefix, i);
+    ans.clear();
+    ASSERT_EQ(i % 4 == 0, tree.GetValue(key, ans));
+  }
+  for (int i = 0; i < 300; i++) {
+    set_key("a/", i);
+    tree.Remove(key);
+    set_key("z/", i);
+    tree.Remove(key);
+  }
+  for (int i = 0; i < n; i += 4) {
+    set_key(prefix, i);
+    tree.Remove(key);
+  }
+  ASSERT_TRUE(tree.IsEmpty());
+  ASSERT_TRUE(tree.Check());
+  // a bulk build packs the leaves as tight
+  KeySorter sorter(KP);
+  for (int value : values) {
+    set_key(prefix, value);
+    sorter.Add(key, RowId(value));
+  }
+  sorter.Finish();
+  BPlusTree loaded(1, engine.bpm_, KP);
+  loaded.BulkLoad(&sorter);
+  ASSERT_LT(count_leaves(loaded), n / uncompressed / 2);
+  for (int i = 0; i < n; i++) {
+    set_key(prefix, i);
+    ans.clear();
+    ASSERT_TRUE(loaded.GetValue(key, ans));
+  }
+  ASSERT_TRUE(loaded.Check());
+  free(key);
+  delete table_schema;
+}
+
+TEST(BPlusTreeTests, DestroyTest) {
+  DBStorageEngine engine(db_name, true, 256);
+  std::vector<Column *> columns = {
+      new Column("int", TypeId::kTypeInt, 0, false, false),
+  };
+  Schema *table_schema = new Schema(columns);
+  KeyManager KP(table_schema, 8);
+  GenericKey *key = KP.InitKey();
+  auto *disk_meta = reinterpret_cast<DiskFileMetaPage *>(engine.disk_mgr_->GetMetaData());
+  uint32_t allocated = disk_meta->GetAllocatedPages();
+  // tiny pages make a deep tree of more pages than the buffer pool holds
+  BPlusTree tree(0, engine.bpm_, KP, 8, 6);
+  const int n = 20000;
+  vector<int> values;
+  for (int i = 0; i < n; i++) {
+    values.push_back(i);
+  }
+  ShuffleArray(values);
+  for (int value : values) {
+    KP.SerializeFromKey(key, Row(std::vector<Field>{Field(TypeId::kTypeInt, value)}), table_schema);
+    ASSERT_TRUE(tree.Insert(key, RowId(value)));
+  }
+  ASSERT_GT(disk_meta->GetAllocatedPages(), allocated + n / 8);
+  // every page of the tree is freed, and the tree forgets its root
+  tree.Destroy();
+  ASSERT_TRUE(tree.IsEmpty());
+  ASSERT_EQ(allocated, disk_meta->GetAllocatedPages());
+  Page *page = engine.bpm_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  page_id_t root_page_id;
+  ASSERT_FALSE(reinterpret_cast<IndexRootsPage *>(page->GetData())->GetRootId(0, &root_page_id));
+  engine.bpm_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  // the emptied tree takes keys again
+  ASSERT_TRUE(tree.Insert(key, RowId(0)));
+  vector<RowId> ans;
+  ASSERT_TRUE(tree.GetValue(key, ans));
+  tree.Destroy();
+  ASSERT_EQ(allocated, disk_meta->GetAllocatedPages());
+  free(key);
+  delete table_schema;
+}
@@ -0,0 +1,134 @@
+#include "index/hash_index.h"
+
+#include <algorithm>
+#include <string>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/generic_key.h"
+#include "utils/utils.h"
+
+static const std::string db_name = "hash_index_test.db";
+
+namespace {
+
+Row IntKey(int value) {
+  return Row(std::vector<Field>{Field(TypeId::kTypeInt, value)});
+}
+
+int CountScan(Index *index, const Row *lower, const Row *upper, bool lower_inclusive, bool upper_inclusive) {
+  auto cursor = index->Scan(lower, upper, lower_inclusive, upper_inclusive, nullptr);
+  RowId row_id;
+  int rows_read = 0;
+  while (cursor->Next(&row_id)) {
+    rows_read++;
+  }
+  return rows_read;
+}
+
+}  // namespace
+
+TEST(HashIndexTests, UniqueIndexTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, {0});
+  auto *index = new HashIndex(0, index_schema, KeyManager::GetEncodedSize(index_schema), engine.bpm_);
+  const int n = 20000;
+  std::vector<int> keys;
+  for (int i = 0; i < n; i++) {
+    keys.push_back(i);
+  }
+  ShuffleArray(keys);
+  for (int key : keys) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(IntKey(key), RowId(key / 100, key % 100), nullptr));
+  }
+  // a unique index refuses a second row of a key
+  ASSERT_EQ(DB_FAILED, index->InsertEntry(IntKey(7), RowId(500, 0), nullptr));
+  std::vector<RowId> ret;
+  for (int i = 0; i < n; i++) {
+    ret.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(IntKey(i), ret, nullptr));
+    ASSERT_EQ(1u, ret.size());
+    ASSERT_EQ(RowId(i / 100, i % 100), ret[0]);
+  }
+  ret.clear();
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(IntKey(n), ret, nullptr));
+  // ranges visit every bucket
+  Row k100 = IntKey(100), k200 = IntKey(200);
+  ASSERT_EQ(101, CountScan(index, &k100, &k200, true, true));
+  ASSERT_EQ(99, CountScan(index, &k100, &k200, false, false));
+  ASSERT_EQ(100, CountScan(index, nullptr, &k100, true, false));
+  ASSERT_EQ(1, CountScan(index, &k200, &k200, true, true));
+  ret.clear();
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(k200, ret, nullptr, ">="));
+  ASSERT_EQ(static_cast<size_t>(n - 200), ret.size());
+  // removing every other key leaves the others
+  for (int i = 0; i < n; i += 2) {
+    ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(IntKey(i), RowId(i / 100, i % 100), nullptr));
+  }
+  for (int i = 0; i < n; i++) {
+    ret.clear();
+    ASSERT_EQ(i % 2 == 0 ? DB_KEY_NOT_FOUND : DB_SUCCESS, index->ScanKey(IntKey(i), ret, nullptr));
+  }
+  ASSERT_EQ(n / 2, CountScan(index, nullptr, nullptr, true, true));
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  delete index;
+}
+
+TEST(HashIndexTests, DirectoryGrowAndShrinkTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, {0});
+  KeyManager KP(index_schema, KeyManager::GetEncodedSize(index_schema));
+  ExtendibleHashTable table(0, engine.bpm_, KP);
+  GenericKey *key = KP.InitKey();
+  const int n = 10000;
+  for (int i = 0; i < n; i++) {
+    KP.SerializeFromKey(key, IntKey(i), index_schema);
+    ASSERT_TRUE(table.Insert(key, RowId(i, 0)));
+  }
+  // about 300 pairs of 5 byte keys fill a bucket, so the directory takes at least 32 slots
+  ASSERT_GE(table.GetGlobalDepth(), 5u);
+  for (int i = 0; i < n; i++) {
+    KP.SerializeFromKey(key, IntKey(i), index_schema);
+    ASSERT_TRUE(table.Remove(key, RowId(i, 0)));
+  }
+  // the emptied buckets merge back into one
+  ASSERT_EQ(0u, table.GetGlobalDepth());
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  table.Destroy();
+  ASSERT_TRUE(table.IsEmpty());
+  free(key);
+}
+
+TEST(HashIndexTests, NonUniqueIndexTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {new Column("status", TypeId::kTypeInt, 0, false, false)};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, {0});
+  auto *index = new HashIndex(0, index_schema, KeyManager::GetEncodedSize(index_schema), engine.bpm_, false);
+  // 10 statuses of 1000 rows each, more than a bucket takes, so the rows of a status overflow into a chain
+  const int n = 10000;
+  for (int i = 0; i < n; i++) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(IntKey(i % 10), RowId(i / 100, i % 100), nullptr));
+  }
+  ASSERT_EQ(DB_FAILED, index->InsertEntry(IntKey(3), RowId(0, 3), nullptr));
+  std::vector<RowId> ret;
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(IntKey(3), ret, nullptr));
+  ASSERT_EQ(1000u, ret.size());
+  for (auto &row_id : ret) {
+    ASSERT_EQ(3u, (row_id.GetPageId() * 100 + row_id.GetSlotNum()) % 10);
+  }
+  Row k2 = IntKey(2), k5 = IntKey(5);
+  ASSERT_EQ(4000, CountScan(index, &k2, &k5, true, true));
+  ASSERT_EQ(2000, CountScan(index, &k2, &k5, false, false));
+  ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(IntKey(3), RowId(0, 3), nullptr));
+  ret.clear();
+  index->ScanKey(IntKey(3), ret, nullptr);
+  ASSERT_EQ(999u, ret.size());
+  ASSERT_TRUE(std::find(ret.begin(), ret.end(), RowId(0, 3)) == ret.end());
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  delete index;
+}
@@ -0,0 +1,54 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "record/char_ops.h"
+
+static const CharOps::Isa kIsas[] = {CharOps::Isa::kScalar, CharOps::Isa::kSse42, CharOps::Isa::kAvx2};
+
+static const char *IsaName(CharOps::Isa isa) {
+  switch (isa) {
+    case CharOps::Isa::kSse42:
+      return "sse4.2";
+    case CharOps::Isa::kAvx2:
+      return "avx2";
+    default:
+      return "scalar";
+  }
+}
+
+/** Rebinds the kernels picked at startup when a benchmark is done, whatever instruction set it left bound */
+class CharOpsBenchmark : public ::testing::Test {
+ protected:
+  void TearDown() override { ASSERT_TRUE(CharOps::SetIsa(CharOps::GetBestIsa())); }
+};
+
+TEST_F(CharOpsBenchmark, KernelTest) {
+  const uint32_t kIterations = 200000;
+  const uint32_t kLengths[] = {4, 8, 16, 32, 64, 128, 256};
+  volatile int64_t sink = 0;
+  printf("length  isa      compare(ns)  equals(ns)  hash(ns)\n");
+  for (auto len : kLengths) {
+    // equal values compare every byte, the worst case of compare and equals
+    std::string lhs(len, 'a');
+    std::string rhs(len, 'a');
+    for (auto isa : kIsas) {
+      if (!CharOps::SetIsa(isa)) {
+        continue;
+      }
+      auto measure = [&](auto &&op) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < kIterations; i++) {
+          sink += op();
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / kIterations;
+      };
+      double compare = measure([&] { return CharOps::Compare(lhs.data(), len, rhs.data(), len); });
+      double equals = measure([&] { return CharOps::Equals(lhs.data(), len, rhs.data(), len); });
+      double hash = measure([&] { return static_cast<int64_t>(CharOps::Hash(lhs.data(), len)); });
+      printf("%6u  %-7s  %11.2f  %10.2f  %8.2f\n", len, IsaName(isa), compare, equals, hash);
+    }
+  }
+}
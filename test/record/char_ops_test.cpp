@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "record/char_ops.h"
+
+static const CharOps::Isa kIsas[] = {CharOps::Isa::kScalar, CharOps::Isa::kSse42, CharOps::Isa::kAvx2};
+
+static const char *IsaName(CharOps::Isa isa) {
+  switch (isa) {
+    case CharOps::Isa::kSse42:
+      return "sse4.2";
+    case CharOps::Isa::kAvx2:
+      return "avx2";
+    default:
+      return "scalar";
+  }
+}
+
+static int Sign(int value) { return (value > 0) - (value < 0); }
+
+static int ReferenceCompare(const std::string &lhs, const std::string &rhs) {
+  int ret = memcmp(lhs.data(), rhs.data(), std::min(lhs.size(), rhs.size()));
+  if (ret == 0) {
+    ret = static_cast<int>(lhs.size()) - static_cast<int>(rhs.size());
+  }
+  return Sign(ret);
+}
+
+/** Rebinds the kernels picked at startup when a test is done, whatever instruction set it left bound */
+class CharOpsTest : public ::testing::Test {
+ protected:
+  void TearDown() override { ASSERT_TRUE(CharOps::SetIsa(CharOps::GetBestIsa())); }
+};
+
+TEST_F(CharOpsTest, StartupIsaTest) {
+  // the kernels bound before main are the fastest the cpu runs
+  ASSERT_EQ(CharOps::GetBestIsa(), CharOps::GetIsa());
+  ASSERT_TRUE(CharOps::IsSupported(CharOps::GetIsa()));
+}
+
+TEST_F(CharOpsTest, CompareAndEqualsTest) {
+  std::mt19937 rng(20221019);
+  std::uniform_int_distribution<int> byte_dist(0, 255);
+  for (auto isa : kIsas) {
+    if (!CharOps::SetIsa(isa)) {
+      continue;
+    }
+    for (uint32_t len = 0; len <= 300; len++) {
+      std::string base(len, '\0');
+      for (auto &c : base) {
+        c = static_cast<char>(byte_dist(rng));
+      }
+      // equal values, the same value with one byte changed at every position, prefixes and extensions
+      ASSERT_EQ(0, CharOps::Compare(base.data(), len, base.data(), len));
+      ASSERT_TRUE(CharOps::Equals(base.data(), len, base.data(), len));
+      for (uint32_t pos = 0; pos < len; pos++) {
+        std::string other = base;
+        other[pos] = static_cast<char>(other[pos] ^ (1 << (pos % 8)));
+        ASSERT_EQ(ReferenceCompare(base, other), Sign(CharOps::Compare(base.data(), len, other.data(), len)))
+            << IsaName(isa) << " len " << len << " pos " << pos;
+        ASSERT_EQ(ReferenceCompare(other, base), Sign(CharOps::Compare(other.data(), len, base.data(), len)));
+        ASSERT_FALSE(CharOps::Equals(base.data(), len, other.data(), len)) << IsaName(isa) << " len " << len;
+        ASSERT_TRUE(CharOps::StartsWith(base.data(), len, other.data(), pos));
+        ASSERT_FALSE(CharOps::StartsWith(base.data(), len, other.data(), pos + 1));
+      }
+      std::string longer = base + static_cast<char>(byte_dist(rng));
+      ASSERT_GT(0, CharOps::Compare(base.data(), len, longer.data(), len + 1));
+      ASSERT_LT(0, CharOps::Compare(longer.data(), len + 1, base.data(), len));
+      ASSERT_FALSE(CharOps::Equals(base.data(), len, longer.data(), len + 1));
+    }
+  }
+}
+
+TEST_F(CharOpsTest, HashTest) {
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> byte_dist(0, 255);
+  std::vector<std::string> values;
+  for (uint32_t len = 0; len <= 300; len++) {
+    std::string value(len, '\0');
+    for (auto &c : value) {
+      c = static_cast<char>(byte_dist(rng));
+    }
+    values.push_back(value);
+    if (len > 0) {
+      values.emplace_back(len, '\0');
+    }
+  }
+  ASSERT_TRUE(CharOps::SetIsa(CharOps::Isa::kScalar));
+  std::vector<uint64_t> expected;
+  for (auto &value : values) {
+    expected.push_back(CharOps::Hash(value.data(), value.size()));
+  }
+  // every kernel computes the same hash, values of zero bytes differing only in length do not collide
+  for (auto isa : kIsas) {
+    if (!CharOps::SetIsa(isa)) {
+      continue;
+    }
+    for (size_t i = 0; i < values.size(); i++) {
+      ASSERT_EQ(expected[i], CharOps::Hash(values[i].data(), values[i].size())) << IsaName(isa) << " " << i;
+    }
+  }
+  std::sort(expected.begin(), expected.end());
+  ASSERT_EQ(expected.end(), std::unique(expected.begin(), expected.end()));
+  // a single flipped bit changes the hash
+  const std::string &base = values[values.size() - 2];
+  for (uint32_t pos = 0; pos < base.size(); pos++) {
+    std::string value = base;
+    value[pos] = static_cast<char>(value[pos] ^ 1);
+    ASSERT_NE(CharOps::Hash(base.data(), base.size()), CharOps::Hash(value.data(), value.size()));
+  }
+}
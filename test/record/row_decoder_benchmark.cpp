@@ -0,0 +1,52 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "common/config.h"
+#include "gtest/gtest.h"
+#include "record/row.h"
+#include "record/row_decoder.h"
+#include "record/schema.h"
+
+TEST(RowDecoderBenchmark, DeserializeAndDecodeTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false),
+                                   new Column("note", TypeId::kTypeChar, 16, 3, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  std::vector<Field> fields = {Field(TypeId::kTypeInt, 188),
+                               Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false),
+                               Field(TypeId::kTypeFloat, 19.99f),
+                               Field(TypeId::kTypeChar, const_cast<char *>("db"), strlen("db"), false)};
+  char buffer[PAGE_SIZE];
+  Row(fields).SerializeTo(buffer, schema.get());
+  const uint32_t kTuples = 256;
+  const uint32_t kRounds = 2000;
+  std::vector<const char *> tuples(kTuples, buffer);
+  volatile int64_t sink = 0;
+  auto measure = [&](auto &&op) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < kRounds; i++) {
+      op();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (kRounds * kTuples);
+  };
+  ArenaHeap heap;
+  double deserialize = measure([&] {
+    for (uint32_t i = 0; i < kTuples; i++) {
+      Row row(&heap);
+      row.DeserializeFrom(const_cast<char *>(tuples[i]), schema.get());
+      sink += row.GetFieldCount();
+    }
+    heap.Reset();
+  });
+  RowDecoder decoder(schema.get());
+  ColumnBatch batch(schema.get());
+  double decode = measure([&] {
+    batch.Clear();
+    decoder.Decode(tuples.data(), kTuples, &batch);
+    sink += batch.GetInt(0, kTuples - 1);
+  });
+  printf("row deserialize: %.2f ns/row, columnar decode: %.2f ns/row\n", deserialize, decode);
+}
@@ -1,11 +1,30 @@
+#include <cstdlib>
 #include <cstring>
 
 #include "common/instance.h"
 #include "gtest/gtest.h"
 #include "page/table_page.h"
+#include "record/column_dictionary.h"
 #include "record/field.h"
+#include "record/field_compare.h"
 #include "record/row.h"
+#include "record/row_decoder.h"
 #include "record/schema.h"
+#include "record/tuple_view.h"
+#include "utils/utils.h"
+
+/** Heap counting its allocations, see RowAllocationTest */
+class CountingHeap : public MemHeap {
+ public:
+  void *Allocate(size_t size) override {
+    allocation_count_++;
+    return malloc(size);
+  }
+
+  void Free(void *ptr) override { free(ptr); }
+
+  size_t allocation_count_{0};
+};
 
 char *chars[] = {const_cast<char *>(""), const_cast<char *>("hello"), const_cast<char *>("world!"),
                  const_cast<char *>("\0")};
@@ -94,12 +113,341 @@ TEST(TupleTest, RowTest) {
   ASSERT_EQ(row.GetRowId(), first_tuple_rid);
   Row row2(row.GetRowId());
   ASSERT_TRUE(table_page.GetTuple(&row2, schema.get(), nullptr, nullptr));
-  std::vector<Field *> &row2_fields = row2.GetFields();
+  std::vector<Field> &row2_fields = row2.GetFields();
   ASSERT_EQ(3, row2_fields.size());
   for (size_t i = 0; i < row2_fields.size(); i++) {
-    ASSERT_EQ(CmpBool::kTrue, row2_fields[i]->CompareEquals(fields[i]));
+    ASSERT_EQ(CmpBool::kTrue, row2_fields[i].CompareEquals(fields[i]));
   }
   ASSERT_TRUE(table_page.MarkDelete(row.GetRowId(), nullptr, nullptr, nullptr));
   table_page.ApplyDelete(row.GetRowId(), nullptr, nullptr);
   
-}
\ No newline at end of file
+}
+TEST(TupleTest, RowFormatTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false),
+                                   new Column("nick", TypeId::kTypeChar, 16, 3, true, false),
+                                   new Column("note", TypeId::kTypeChar, 16, 4, true, false)};
+  std::vector<Field> fields = {Field(TypeId::kTypeInt, 188),
+                               Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false),
+                               Field(TypeId::kTypeFloat),
+                               Field(TypeId::kTypeChar),
+                               Field(TypeId::kTypeChar, const_cast<char *>("db"), strlen("db"), false)};
+  auto schema = std::make_shared<Schema>(columns);
+  Row row(fields);
+  // version + bitmap, int + float, three 2 byte char offsets, char data
+  uint32_t expected_size = 1 + 1 + 4 + 4 + 3 * 2 + strlen("minisql") + strlen("db");
+  ASSERT_EQ(expected_size, row.GetSerializedSize(schema.get()));
+  char buffer[PAGE_SIZE];
+  ASSERT_EQ(expected_size, row.SerializeTo(buffer, schema.get()));
+
+  Row row2;
+  ASSERT_EQ(expected_size, row2.DeserializeFrom(buffer, schema.get()));
+  ASSERT_EQ(fields.size(), row2.GetFieldCount());
+  for (size_t i = 0; i < fields.size(); i++) {
+    ASSERT_EQ(fields[i].IsNull(), row2.GetField(i)->IsNull());
+    if (!fields[i].IsNull()) {
+      ASSERT_EQ(CmpBool::kTrue, row2.GetField(i)->CompareEquals(fields[i]));
+    }
+  }
+
+  // every column is read in place without decoding the ones before it
+  TupleView view(buffer, schema.get(), RowId(0, 0));
+  ASSERT_EQ(5, view.GetColumnCount());
+  ASSERT_EQ(188, view.GetInt(0));
+  ASSERT_TRUE(view.IsNull(2));
+  ASSERT_TRUE(view.IsNull(3));
+  ASSERT_EQ(strlen("db"), view.GetCharLength(4));
+  ASSERT_EQ(0, memcmp("db", view.GetChars(4), strlen("db")));
+  ASSERT_EQ(strlen("minisql"), view.GetCharLength(1));
+  ASSERT_EQ(0, memcmp("minisql", view.GetChars(1), strlen("minisql")));
+}
+
+TEST(TupleTest, ProjectedDeserializeTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false),
+                                   new Column("note", TypeId::kTypeChar, 16, 3, true, false)};
+  std::vector<Field> fields = {Field(TypeId::kTypeInt, 188),
+                               Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false),
+                               Field(TypeId::kTypeFloat, 19.99f),
+                               Field(TypeId::kTypeChar, const_cast<char *>("db"), strlen("db"), false)};
+  auto schema = std::make_shared<Schema>(columns);
+  Row row(fields);
+  char buffer[PAGE_SIZE];
+  uint32_t size = row.SerializeTo(buffer, schema.get());
+
+  Row projected;
+  ASSERT_EQ(size, projected.DeserializeFrom(buffer, schema.get(), {2, 3}));
+  ASSERT_EQ(fields.size(), projected.GetFieldCount());
+  ASSERT_TRUE(projected.GetField(0)->IsNull());
+  ASSERT_TRUE(projected.GetField(1)->IsNull());
+  ASSERT_EQ(CmpBool::kTrue, projected.GetField(2)->CompareEquals(fields[2]));
+  ASSERT_EQ(CmpBool::kTrue, projected.GetField(3)->CompareEquals(fields[3]));
+
+  Row view_row;
+  TupleView(buffer, schema.get(), RowId(0, 0)).Materialize(&view_row, {1});
+  ASSERT_TRUE(view_row.GetField(0)->IsNull());
+  ASSERT_EQ(CmpBool::kTrue, view_row.GetField(1)->CompareEquals(fields[1]));
+  ASSERT_TRUE(view_row.GetField(3)->IsNull());
+}
+
+TEST(TupleTest, LegacyRowFormatTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false),
+                                   new Column("note", TypeId::kTypeChar, 16, 3, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  std::vector<Field> fields = {Field(TypeId::kTypeInt, 188),
+                               Field(TypeId::kTypeChar, const_cast<char *>("minisql"), 7, true),
+                               Field(TypeId::kTypeFloat),
+                               Field(TypeId::kTypeChar, const_cast<char *>("db"), 2, true)};
+  char buffer[PAGE_SIZE];
+  uint32_t size = SerializeLegacyRow(fields, buffer);
+
+  Row row;
+  ASSERT_EQ(size, row.DeserializeFrom(buffer, schema.get()));
+  ASSERT_EQ(4, row.GetFieldCount());
+  ASSERT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(fields[0]));
+  ASSERT_EQ("minisql", row.GetField(1)->toString());
+  ASSERT_TRUE(row.GetField(2)->IsNull());
+  ASSERT_EQ("db", row.GetField(3)->toString());
+  Row projected;
+  ASSERT_EQ(size, projected.DeserializeFrom(buffer, schema.get(), {1}));
+  ASSERT_TRUE(projected.GetField(0)->IsNull());
+  ASSERT_EQ("minisql", projected.GetField(1)->toString());
+  ASSERT_TRUE(projected.GetField(3)->IsNull());
+
+  // the bytes of a row of (1, null) as the old format wrote them, the null bitmap is filled from its high bit
+  std::vector<Column *> pair_columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                        new Column("name", TypeId::kTypeChar, 8, 1, true, false)};
+  auto pair_schema = std::make_shared<Schema>(pair_columns);
+  const unsigned char legacy[] = {0x85, 0x27, 0, 0, 2, 0, 0, 0, 0x40, 1, 0, 0, 0};
+  memcpy(buffer, legacy, sizeof(legacy));
+  Row pair;
+  ASSERT_EQ(sizeof(legacy), pair.DeserializeFrom(buffer, pair_schema.get()));
+  ASSERT_EQ(CmpBool::kTrue, pair.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, 1)));
+  ASSERT_TRUE(pair.GetField(1)->IsNull());
+  ASSERT_EQ(sizeof(legacy), SerializeLegacyRow(pair.GetFields(), buffer + sizeof(legacy)));
+  ASSERT_EQ(0, memcmp(legacy, buffer + sizeof(legacy), sizeof(legacy)));
+  // written back, the row takes the current format
+  ASSERT_EQ(1 + 1 + 4 + 2, pair.SerializeTo(buffer, pair_schema.get()));
+  ASSERT_EQ(Row::ROW_FORMAT_VERSION, MACH_READ_FROM(uint8_t, buffer));
+}
+
+TEST(TupleTest, ArenaRowTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  // longer than the inline buffer of a field, so the arena holds it
+  char long_name[] = "a name longer than the inline buffer";
+  std::vector<Field> fields = {Field(TypeId::kTypeInt, 188),
+                               Field(TypeId::kTypeChar, long_name, strlen(long_name), false),
+                               Field(TypeId::kTypeFloat, 19.99f)};
+  auto schema = std::make_shared<Schema>(columns);
+  Row row(fields);
+  char buffer[PAGE_SIZE];
+  row.SerializeTo(buffer, schema.get());
+
+  ArenaHeap heap(256);
+  std::vector<Row> copies;
+  for (int i = 0; i < 100; i++) {
+    Row arena_row(RowId(0, i), &heap);
+    arena_row.DeserializeFrom(buffer, schema.get());
+    // a copy owns its fields, it survives the reset of the arena
+    copies.push_back(arena_row);
+  }
+  ASSERT_GT(heap.GetAllocatedBytes(), 100 * strlen(long_name));
+  // the arena overwrites everything it handed out before
+  heap.Reset();
+  ASSERT_EQ(0, heap.GetAllocatedBytes());
+  for (int i = 0; i < 100; i++) {
+    memset(heap.Allocate(64), 0xff, 64);
+  }
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(RowId(0, i), copies[i].GetRowId());
+    for (size_t j = 0; j < fields.size(); j++) {
+      ASSERT_EQ(CmpBool::kTrue, copies[i].GetField(j)->CompareEquals(fields[j]));
+    }
+  }
+}
+
+TEST(TupleTest, RowAllocationTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  char short_name[] = "minisql";
+  char long_name[] = "a name longer than the inline buffer";
+  char short_buffer[PAGE_SIZE];
+  char long_buffer[PAGE_SIZE];
+  std::vector<Field> short_fields = {Field(TypeId::kTypeInt, 188),
+                                     Field(TypeId::kTypeChar, short_name, strlen(short_name), false),
+                                     Field(TypeId::kTypeFloat, 19.99f)};
+  Row(short_fields).SerializeTo(short_buffer, schema.get());
+  std::vector<Field> long_fields = {Field(TypeId::kTypeInt, 188),
+                                    Field(TypeId::kTypeChar, long_name, strlen(long_name), false),
+                                    Field(TypeId::kTypeFloat, 19.99f)};
+  Row(long_fields).SerializeTo(long_buffer, schema.get());
+
+  // short char values live inside their field, only a long one is allocated from the heap of the row
+  CountingHeap heap;
+  Row row(&heap);
+  row.DeserializeFrom(short_buffer, schema.get());
+  ASSERT_EQ(0, heap.allocation_count_);
+  Row long_row(&heap);
+  long_row.DeserializeFrom(long_buffer, schema.get());
+  ASSERT_EQ(1, heap.allocation_count_);
+  ASSERT_EQ(CmpBool::kTrue, row.GetField(1)->CompareEquals(short_fields[1]));
+  ASSERT_EQ(CmpBool::kTrue, long_row.GetField(1)->CompareEquals(long_fields[1]));
+
+  // a copy owns its data and never allocates from the heap of the original
+  Row copy(long_row);
+  ASSERT_EQ(1, heap.allocation_count_);
+  ASSERT_NE(long_row.GetField(1)->GetData(), copy.GetField(1)->GetData());
+  ASSERT_EQ(CmpBool::kTrue, copy.GetField(1)->CompareEquals(long_fields[1]));
+
+  // a move takes the data over as it is
+  const char *data = long_row.GetField(1)->GetData();
+  Row moved(std::move(long_row));
+  Row assigned;
+  assigned = std::move(moved);
+  ASSERT_EQ(1, heap.allocation_count_);
+  ASSERT_EQ(data, assigned.GetField(1)->GetData());
+
+  // the arena takes the long value without a heap allocation of the field
+  ArenaHeap arena;
+  Row arena_row(&arena);
+  arena_row.DeserializeFrom(long_buffer, schema.get());
+  ASSERT_LT(0, arena.GetAllocatedBytes());
+  ASSERT_EQ(CmpBool::kTrue, arena_row.GetField(1)->CompareEquals(long_fields[1]));
+}
+
+TEST(TupleTest, CompareKernelTest) {
+  using Op = FieldCompare::Op;
+  auto check = [](Field *fields, size_t count, Field &null_field) {
+    TypeId type = fields[0].GetTypeId();
+    std::vector<std::pair<Op, CmpBool (Field::*)(const Field &) const>> ops = {
+        {Op::kEq, &Field::CompareEquals},      {Op::kNe, &Field::CompareNotEquals},
+        {Op::kLt, &Field::CompareLessThan},    {Op::kLe, &Field::CompareLessThanEquals},
+        {Op::kGt, &Field::CompareGreaterThan}, {Op::kGe, &Field::CompareGreaterThanEquals}};
+    for (auto &op : ops) {
+      auto kernel = FieldCompare::BindKernel(type, op.first);
+      ASSERT_NE(nullptr, kernel);
+      for (size_t i = 0; i < count; i++) {
+        for (size_t j = 0; j < count; j++) {
+          ASSERT_EQ((fields[i].*op.second)(fields[j]), kernel(fields[i], fields[j]));
+        }
+        ASSERT_EQ(CmpBool::kNull, kernel(fields[i], null_field));
+        ASSERT_EQ(CmpBool::kNull, kernel(null_field, fields[i]));
+      }
+    }
+  };
+  check(int_fields, sizeof(int_fields) / sizeof(Field), null_fields[0]);
+  check(float_fields, sizeof(float_fields) / sizeof(Field), null_fields[1]);
+  check(char_fields, sizeof(char_fields) / sizeof(Field), null_fields[2]);
+
+  FieldCompare::Op parsed;
+  ASSERT_TRUE(FieldCompare::ParseOp("<=", &parsed));
+  ASSERT_EQ(Op::kLe, parsed);
+  ASSERT_FALSE(FieldCompare::ParseOp("is", &parsed));
+  ASSERT_EQ(CmpBool::kTrue, FieldCompare::AsCmpBool(Field(TypeId::kTypeInt, 1)));
+  ASSERT_EQ(CmpBool::kFalse, FieldCompare::AsCmpBool(Field(TypeId::kTypeInt, 0)));
+  ASSERT_EQ(CmpBool::kNull, FieldCompare::AsCmpBool(Field(TypeId::kTypeInt)));
+}
+
+TEST(TupleTest, RowDecoderTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, true, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false),
+                                   new Column("status", TypeId::kTypeChar, 16, 3, true, false),
+                                   new Column("note", TypeId::kTypeChar, 16, 4, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  ColumnDictionary dictionary;
+  schema->SetDictionary(3, &dictionary);
+  const char *statuses[] = {"active", "inactive", "pending"};
+  std::vector<std::string> buffers;
+  std::vector<std::vector<Field>> rows;
+  for (int i = 0; i < 64; i++) {
+    std::string name = "name-" + std::to_string(i * 7919);
+    std::string note(i % 5, 'n');
+    const char *status = statuses[i % 3];
+    dictionary.Encode(status, strlen(status));
+    Field name_field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.length(), true);
+    Field status_field(TypeId::kTypeChar, const_cast<char *>(status), strlen(status), true);
+    std::vector<Field> fields = {i % 7 == 0 ? Field(TypeId::kTypeInt) : Field(TypeId::kTypeInt, i * 31 - 500),
+                                 i % 5 == 1 ? Field(TypeId::kTypeChar) : name_field,
+                                 i % 3 == 2 ? Field(TypeId::kTypeFloat) : Field(TypeId::kTypeFloat, i * 0.5f),
+                                 i % 4 == 3 ? Field(TypeId::kTypeChar) : status_field,
+                                 Field(TypeId::kTypeChar, const_cast<char *>(note.c_str()), note.length(), true)};
+    Row row(fields);
+    std::string buffer(row.GetSerializedSize(schema.get()), '\0');
+    row.SerializeTo(&buffer[0], schema.get());
+    buffers.push_back(std::move(buffer));
+    rows.push_back(std::move(fields));
+  }
+  std::vector<const char *> tuples;
+  for (auto &buffer : buffers) {
+    tuples.push_back(buffer.data());
+  }
+  auto check = [&](const ColumnBatch &batch, uint32_t row, uint32_t column) {
+    const Field &expected = rows[row][column];
+    ASSERT_EQ(expected.IsNull(), batch.IsNull(column, row)) << "row " << row << " column " << column;
+    if (!expected.IsNull()) {
+      ASSERT_EQ(CmpBool::kTrue, batch.GetField(column, row).CompareEquals(expected)) << "row " << row;
+    }
+  };
+
+  // every column, decoded in two calls appending to the same batch
+  RowDecoder decoder(schema.get());
+  ASSERT_EQ(5, decoder.GetStepCount());
+  ColumnBatch batch(schema.get());
+  decoder.Decode(tuples.data(), 40, &batch);
+  decoder.Decode(tuples.data() + 40, tuples.size() - 40, &batch);
+  ASSERT_EQ(tuples.size(), batch.GetRowCount());
+  for (uint32_t i = 0; i < batch.GetRowCount(); i++) {
+    for (uint32_t j = 0; j < schema->GetColumnCount(); j++) {
+      check(batch, i, j);
+    }
+    if (!rows[i][3].IsNull()) {
+      ASSERT_EQ(dictionary.Lookup(rows[i][3].GetData(), rows[i][3].GetLength()), batch.GetCode(3, i));
+    }
+  }
+
+  // a projected decoder only fills its columns, materialized rows get null placeholders for the others
+  RowDecoder projected(schema.get(), {2, 4});
+  batch.Clear();
+  projected.Decode(tuples.data(), tuples.size(), &batch);
+  Row view;
+  for (uint32_t i = 0; i < batch.GetRowCount(); i++) {
+    check(batch, i, 2);
+    check(batch, i, 4);
+    Row row;
+    batch.Materialize(i, &row);
+    ASSERT_EQ(schema->GetColumnCount(), row.GetFieldCount());
+    ASSERT_TRUE(row.GetField(0)->IsNull());
+    ASSERT_TRUE(row.GetField(3)->IsNull());
+    ASSERT_EQ(rows[i][4].GetLength(), row.GetField(4)->GetLength());
+    // a view reused for every row refers to the values of the batch instead of copying them
+    batch.View(i, &view);
+    ASSERT_EQ(schema->GetColumnCount(), view.GetFieldCount());
+    ASSERT_TRUE(view.GetField(0)->IsNull());
+    ASSERT_TRUE(view.GetField(3)->IsNull());
+    ASSERT_EQ(rows[i][2].IsNull(), view.GetField(2)->IsNull());
+    ASSERT_EQ(rows[i][4].IsNull(), view.GetField(4)->IsNull());
+    if (!rows[i][4].IsNull()) {
+      ASSERT_EQ(batch.GetChars(4, i), view.GetField(4)->GetData());
+      ASSERT_EQ(CmpBool::kTrue, view.GetField(4)->CompareEquals(rows[i][4]));
+    }
+  }
+
+  // a cleared batch is refilled from scratch
+  batch.Clear();
+  decoder.Decode(tuples.data(), tuples.size(), &batch);
+  ASSERT_EQ(tuples.size(), batch.GetRowCount());
+  for (uint32_t i = 0; i < batch.GetRowCount(); i++) {
+    for (uint32_t j = 0; j < schema->GetColumnCount(); j++) {
+      check(batch, i, j);
+    }
+  }
+}
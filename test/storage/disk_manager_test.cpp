@@ -59,4 +59,43 @@ TEST(DiskManagerTest, FreePageAllocationTest) {
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 2, meta_page->GetExtentUsedPage(0));
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 3, meta_page->GetExtentUsedPage(1));
   remove(db_name.c_str());
-}
\ No newline at end of file
+}
+TEST(DiskManagerTest, ReopenTest) {
+  std::string db_name = "disk_reopen_test.db";
+  remove(db_name.c_str());
+  DiskManager *disk_mgr = new DiskManager(db_name);
+  const uint32_t page_nums = DiskManager::BITMAP_SIZE + 10;
+  char data[PAGE_SIZE];
+  for (uint32_t i = 0; i < page_nums; i++) {
+    ASSERT_EQ(static_cast<page_id_t>(i), disk_mgr->AllocatePage());
+  }
+  memset(data, 'a', PAGE_SIZE);
+  disk_mgr->WritePage(0, data);
+  memset(data, 'b', PAGE_SIZE);
+  disk_mgr->WritePage(DiskManager::BITMAP_SIZE, data);
+  disk_mgr->DeAllocatePage(3);
+  disk_mgr->DeAllocatePage(DiskManager::BITMAP_SIZE + 1);
+  delete disk_mgr;
+  // logical pages keep the physical places they always had, page 0 of extent 0 is the second page of the file
+  std::ifstream file(db_name, std::ios::binary);
+  file.seekg(PAGE_SIZE);
+  file.read(data, PAGE_SIZE);
+  ASSERT_EQ('a', data[0]);
+  file.seekg((DiskManager::BITMAP_SIZE + 2) * PAGE_SIZE);
+  file.read(data, PAGE_SIZE);
+  ASSERT_EQ('b', data[0]);
+  file.close();
+  // the page counts are rebuilt from the bitmaps
+  disk_mgr = new DiskManager(db_name);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(2u, meta_page->GetExtentNums());
+  EXPECT_EQ(page_nums - 2, meta_page->GetAllocatedPages());
+  EXPECT_EQ(DiskManager::BITMAP_SIZE - 1, meta_page->GetExtentUsedPage(0));
+  EXPECT_EQ(9u, meta_page->GetExtentUsedPage(1));
+  EXPECT_TRUE(disk_mgr->IsPageFree(3));
+  EXPECT_FALSE(disk_mgr->IsPageFree(4));
+  EXPECT_EQ(3, disk_mgr->AllocatePage());
+  EXPECT_EQ(static_cast<page_id_t>(DiskManager::BITMAP_SIZE + 1), disk_mgr->AllocatePage());
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
@@ -1,6 +1,7 @@
 #include "storage/table_heap.h"
 #include <cstdlib>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <iostream>
 #include "common/instance.h"
@@ -10,10 +11,16 @@
 #include "utils/utils.h"
 
 static string db_file_name = "table_heap_test.db";
+static string vacuum_db_file_name = "table_heap_vacuum_test.db";
+static string view_db_file_name = "table_heap_view_test.db";
+static string pax_db_file_name = "table_heap_pax_test.db";
+static string update_db_file_name = "table_heap_update_test.db";
+static string upgrade_db_file_name = "table_heap_upgrade_test.db";
 using Fields = std::vector<Field>;
 
 TEST(TableHeapTest, TableHeapSampleTest) {
   // init testing instance
+  remove(db_file_name.c_str());
   auto disk_mgr_ = new DiskManager(db_file_name);
   auto bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
   const int row_nums = 110;
@@ -88,3 +95,359 @@ TEST(TableHeapTest, TableHeapSampleTest) {
   }
   ASSERT_EQ(size, 0);
 }
+
+TEST(TableHeapTest, TableHeapVacuumTest) {
+  remove(vacuum_db_file_name.c_str());
+  auto disk_mgr_ = new DiskManager(vacuum_db_file_name);
+  auto bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+  const int row_nums = 1000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    char characters[32];
+    RandomUtils::RandomString(characters, 32);
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, characters, 32, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  auto count_pages = [&]() {
+    uint32_t pages = 0;
+    for (page_id_t page_id = table_heap->GetFirstPageId(); page_id != INVALID_PAGE_ID; pages++) {
+      auto page = reinterpret_cast<TablePage *>(bpm_->FetchPage(page_id));
+      page_id_t next_page_id = page->GetNextPageId();
+      bpm_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+    return pages;
+  };
+  uint32_t pages_before = count_pages();
+  // keep every 10th row, half of the deleted ones are only marked
+  std::unordered_map<int64_t, int> alive;
+  for (int i = 0; i < row_nums; i++) {
+    if (i % 10 == 0) {
+      alive.emplace(rids[i].Get(), i);
+      continue;
+    }
+    ASSERT_TRUE(table_heap->MarkDelete(rids[i], nullptr));
+    if (i % 2) {
+      table_heap->ApplyDelete(rids[i], nullptr);
+    }
+  }
+  std::vector<std::pair<RowId, RowId>> moved;
+  uint32_t freed = table_heap->Vacuum(moved, nullptr);
+  ASSERT_GT(freed, 0);
+  ASSERT_EQ(pages_before - freed, count_pages());
+  ASSERT_TRUE(bpm_->CheckAllUnpinned());
+  for (auto &move : moved) {
+    auto iter = alive.find(move.first.Get());
+    ASSERT_TRUE(iter != alive.end());
+    int id = iter->second;
+    alive.erase(iter);
+    alive.emplace(move.second.Get(), id);
+  }
+  ASSERT_EQ(row_nums / 10, alive.size());
+  uint32_t scanned = 0;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); iter++) {
+    auto found = alive.find(iter->GetRowId().Get());
+    ASSERT_TRUE(found != alive.end());
+    ASSERT_EQ(CmpBool::kTrue, iter->GetField(0)->CompareEquals(Field(TypeId::kTypeInt, found->second)));
+    scanned++;
+  }
+  ASSERT_EQ(row_nums / 10, scanned);
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+  remove(vacuum_db_file_name.c_str());
+}
+
+TEST(TableHeapTest, TableHeapUpdateMoveTest) {
+  remove(update_db_file_name.c_str());
+  auto disk_mgr_ = new DiskManager(update_db_file_name);
+  // two frames: one for the table page and one held below, so the heap can not grow while it is held
+  auto bpm_ = new BufferPoolManager(2, disk_mgr_);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  page_id_t held_page_id;
+  ASSERT_NE(nullptr, bpm_->NewPage(held_page_id));
+  std::vector<RowId> rids;
+  char characters[64];
+  for (int i = 0;; i++) {
+    RandomUtils::RandomString(characters, 8);
+    Row row(Fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, characters, 8, true)});
+    if (!table_heap->InsertTuple(row, nullptr)) {
+      break;
+    }
+    rids.push_back(row.GetRowId());
+  }
+  ASSERT_GT(rids.size(), 1);
+  // the grown tuple fits neither into its page nor into a new one, the old tuple must survive
+  RandomUtils::RandomString(characters, 64);
+  Row grown(Fields{Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeChar, characters, 64, true)});
+  ASSERT_FALSE(table_heap->UpdateTuple(grown, rids[0], nullptr));
+  Row old_row(rids[0]);
+  ASSERT_TRUE(table_heap->GetTuple(&old_row, nullptr));
+  ASSERT_EQ(8, old_row.GetField(1)->GetLength());
+  // once the heap can grow the tuple moves to a new page and the new rid is handed back
+  bpm_->UnpinPage(held_page_id, false);
+  ASSERT_TRUE(table_heap->UpdateTuple(grown, rids[0], nullptr));
+  ASSERT_NE(rids[0].GetPageId(), grown.GetRowId().GetPageId());
+  Row deleted_row(rids[0]);
+  ASSERT_FALSE(table_heap->GetTuple(&deleted_row, nullptr));
+  Row moved_row(grown.GetRowId());
+  ASSERT_TRUE(table_heap->GetTuple(&moved_row, nullptr));
+  ASSERT_EQ(std::string(characters, 64), std::string(moved_row.GetField(1)->GetData(), 64));
+  // an update in place keeps the rid
+  Row shrunk(Fields{Field(TypeId::kTypeInt, 1), Field(TypeId::kTypeChar)});
+  ASSERT_TRUE(table_heap->UpdateTuple(shrunk, rids[1], nullptr));
+  ASSERT_EQ(rids[1], shrunk.GetRowId());
+  ASSERT_TRUE(bpm_->CheckAllUnpinned());
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+  remove(update_db_file_name.c_str());
+}
+
+TEST(TableHeapTest, TableHeapUpgradeRowsTest) {
+  remove(upgrade_db_file_name.c_str());
+  auto disk_mgr_ = new DiskManager(upgrade_db_file_name);
+  auto bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+  const int row_nums = 500;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  // a name of len + 9 chars takes as many bytes in the current format as a name of len chars in the old one
+  std::unordered_map<int64_t, int> ids;
+  for (int i = 0; i < row_nums; i++) {
+    std::string name(i % 20 + 9, 'n');
+    Row row(Fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()),
+                                                     name.size(), true)});
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    ids.emplace(row.GetRowId().Get(), i);
+  }
+  // overwrite every tuple with the row the old format wrote
+  table_heap->ScanPages(
+      [&](const std::vector<TupleView> &views) {
+        for (auto &view : views) {
+          int id = ids[view.GetRowId().Get()];
+          uint32_t size = Row::GetHeaderSize(schema.get()) + schema->GetFixedSize() + view.GetCharLength(1);
+          std::string name(id % 20, 'o');
+          Fields fields{Field(TypeId::kTypeInt, id),
+                        Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+          EXPECT_EQ(size, SerializeLegacyRow(fields, const_cast<char *>(view.GetData())));
+        }
+        return true;
+      },
+      nullptr);
+  for (auto &entry : ids) {
+    Row row(RowId(entry.first));
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    ASSERT_EQ(std::string(entry.second % 20, 'o'), row.GetField(1)->toString());
+  }
+
+  std::vector<std::pair<RowId, RowId>> moved;
+  ASSERT_EQ(row_nums, table_heap->UpgradeRows(moved, nullptr));
+  // the rows shrink, none of them has to leave its page
+  ASSERT_TRUE(moved.empty());
+  int scanned = 0;
+  table_heap->ScanPages(
+      [&](const std::vector<TupleView> &views) {
+        for (auto &view : views) {
+          EXPECT_EQ(Row::ROW_FORMAT_VERSION, MACH_READ_FROM(uint8_t, view.GetData()));
+          EXPECT_EQ(ids[view.GetRowId().Get()], view.GetInt(0));
+          EXPECT_EQ(static_cast<uint32_t>(view.GetInt(0) % 20), view.GetCharLength(1));
+          scanned++;
+        }
+        return true;
+      },
+      nullptr);
+  ASSERT_EQ(row_nums, scanned);
+  ASSERT_EQ(0, table_heap->UpgradeRows(moved, nullptr));
+  ASSERT_TRUE(bpm_->CheckAllUnpinned());
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+  remove(upgrade_db_file_name.c_str());
+}
+
+TEST(TableHeapTest, TupleViewIteratorTest) {
+  remove(view_db_file_name.c_str());
+  auto disk_mgr_ = new DiskManager(view_db_file_name);
+  auto bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+  const int row_nums = 500;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  std::unordered_map<int64_t, std::pair<int, std::string>> inserted;
+  for (int i = 0; i < row_nums; i++) {
+    int32_t len = RandomUtils::RandomInt(1, 63);
+    char characters[64];
+    RandomUtils::RandomString(characters, len);
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, characters, len, true),
+                  i % 3 ? Field(TypeId::kTypeFloat, 1.5f * i) : Field(TypeId::kTypeFloat)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    inserted.emplace(row.GetRowId().Get(), std::make_pair(i, std::string(characters, len)));
+  }
+  int scanned = 0;
+  {
+    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter, scanned++) {
+      TupleView view = iter.GetTupleView();
+      ASSERT_TRUE(view.IsValid());
+      ASSERT_EQ(3, view.GetColumnCount());
+      auto found = inserted.find(view.GetRowId().Get());
+      ASSERT_TRUE(found != inserted.end());
+      int i = found->second.first;
+      ASSERT_EQ(i, view.GetInt(0));
+      ASSERT_EQ(found->second.second, std::string(view.GetChars(1), view.GetCharLength(1)));
+      ASSERT_EQ(i % 3 == 0, view.IsNull(2));
+      if (i % 3) {
+        ASSERT_FLOAT_EQ(1.5f * i, view.GetFloat(2));
+      }
+      // materialized rows and views agree
+      if (i % 7 == 0) {
+        for (uint32_t j = 0; j < 3; j++) {
+          Field field = view.GetField(j);
+          ASSERT_EQ(field.IsNull(), iter->GetField(j)->IsNull());
+          if (!field.IsNull()) {
+            ASSERT_EQ(CmpBool::kTrue, field.CompareEquals(*iter->GetField(j)));
+          }
+        }
+      }
+    }
+  }
+  ASSERT_EQ(row_nums, scanned);
+  ASSERT_TRUE(bpm_->CheckAllUnpinned());
+  // page at a time scan sees the same tuples, one batch per page
+  std::unordered_set<page_id_t> visited_pages;
+  scanned = 0;
+  table_heap->ScanPages(
+      [&](const std::vector<TupleView> &views) {
+        EXPECT_TRUE(visited_pages.insert(views[0].GetRowId().GetPageId()).second);
+        for (auto &view : views) {
+          EXPECT_EQ(views[0].GetRowId().GetPageId(), view.GetRowId().GetPageId());
+          EXPECT_EQ(inserted[view.GetRowId().Get()].first, view.GetInt(0));
+          scanned++;
+        }
+        return true;
+      },
+      nullptr);
+  ASSERT_EQ(row_nums, scanned);
+  ASSERT_GT(visited_pages.size(), 1);
+  ASSERT_TRUE(bpm_->CheckAllUnpinned());
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+  remove(view_db_file_name.c_str());
+}
+
+TEST(TableHeapTest, PaxTableHeapTest) {
+  remove(pax_db_file_name.c_str());
+  auto disk_mgr_ = new DiskManager(pax_db_file_name);
+  auto bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+  const int row_nums = 1000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 16, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr, TableLayout::kPax);
+  ASSERT_EQ(TableLayout::kPax, table_heap->GetLayout());
+  ASSERT_GT(table_heap->GetPaxLayout()->GetSlotCapacity(), 1);
+  // every 7th row has a null name, the length of the names varies
+  std::unordered_map<int64_t, int> rid_to_id;
+  std::vector<std::string> names(row_nums);
+  for (int i = 0; i < row_nums; i++) {
+    names[i] = std::string(i % 16 + 1, static_cast<char>('a' + i % 26));
+    Fields fields{Field(TypeId::kTypeInt, i),
+                  i % 7 ? Field(TypeId::kTypeChar, const_cast<char *>(names[i].c_str()), names[i].size(), true)
+                        : Field(TypeId::kTypeChar),
+                  Field(TypeId::kTypeFloat, i * 0.5f)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rid_to_id.emplace(row.GetRowId().Get(), i);
+  }
+  ASSERT_EQ(row_nums, rid_to_id.size());
+  // a name longer than the column is rejected instead of spilling over
+  std::string too_long(17, 'x');
+  Fields bad_fields{Field(TypeId::kTypeInt, -1), Field(TypeId::kTypeChar, const_cast<char *>(too_long.c_str()), 17, true),
+                    Field(TypeId::kTypeFloat, 0.f)};
+  Row bad_row(bad_fields);
+  ASSERT_FALSE(table_heap->InsertTuple(bad_row, nullptr));
+  auto check_row = [&](const Row &row, int id) {
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, id)));
+    if (id % 7) {
+      ASSERT_EQ(names[id], row.GetField(1)->toString());
+    } else {
+      ASSERT_TRUE(row.GetField(1)->IsNull());
+    }
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(2)->CompareEquals(Field(TypeId::kTypeFloat, id * 0.5f)));
+  };
+  for (auto &entry : rid_to_id) {
+    Row row{RowId(entry.first)};
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    check_row(row, entry.second);
+  }
+  // views read single columns straight from their minipages
+  uint32_t viewed = 0;
+  table_heap->ScanPages(
+      [&](const std::vector<TupleView> &views) {
+        for (auto &view : views) {
+          int id = rid_to_id.at(view.GetRowId().Get());
+          EXPECT_EQ(id, view.GetInt(0));
+          EXPECT_EQ(id % 7 == 0, view.IsNull(1));
+          EXPECT_FLOAT_EQ(id * 0.5f, view.GetFloat(2));
+          viewed++;
+        }
+        return true;
+      },
+      nullptr);
+  ASSERT_EQ(row_nums, viewed);
+  // update in place, then delete every other row and compact the table
+  for (auto &entry : rid_to_id) {
+    if (entry.second % 2) {
+      continue;
+    }
+    Fields fields{Field(TypeId::kTypeInt, entry.second), Field(TypeId::kTypeChar),
+                  Field(TypeId::kTypeFloat, entry.second * 0.5f)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->UpdateTuple(row, RowId(entry.first), nullptr));
+    ASSERT_EQ(RowId(entry.first), row.GetRowId());
+    names[entry.second].clear();
+  }
+  std::unordered_map<int64_t, int> alive;
+  for (auto &entry : rid_to_id) {
+    if (entry.second % 2 == 0) {
+      alive.insert(entry);
+      continue;
+    }
+    ASSERT_TRUE(table_heap->MarkDelete(RowId(entry.first), nullptr));
+  }
+  std::vector<std::pair<RowId, RowId>> moved;
+  ASSERT_GT(table_heap->Vacuum(moved, nullptr), 0);
+  ASSERT_TRUE(bpm_->CheckAllUnpinned());
+  for (auto &move : moved) {
+    int id = alive.at(move.first.Get());
+    alive.erase(move.first.Get());
+    alive.emplace(move.second.Get(), id);
+  }
+  uint32_t scanned = 0;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); iter++) {
+    int id = alive.at(iter->GetRowId().Get());
+    ASSERT_EQ(CmpBool::kTrue, iter->GetField(0)->CompareEquals(Field(TypeId::kTypeInt, id)));
+    ASSERT_TRUE(iter->GetField(1)->IsNull());
+    scanned++;
+  }
+  ASSERT_EQ(row_nums / 2, scanned);
+  delete table_heap;
+  delete bpm_;
+  delete disk_mgr_;
+  remove(pax_db_file_name.c_str());
+}